@@ -0,0 +1,62 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_BENCHMARK__
+#define _SSTL_BENCHMARK__
+
+#include <cstddef>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+namespace sstl_benchmark
+{
+   using clock = std::chrono::steady_clock;
+
+   // prevents the compiler from optimizing away the computation of a value
+   template<class T>
+   void do_not_optimize(const T& value)
+   {
+      static volatile char sink;
+      sink = *reinterpret_cast<const volatile char*>(&value);
+      (void) sink;
+   }
+
+   // runs the specified function (that performs 'operations' operations) the
+   // specified number of times and returns the best time per operation in nanoseconds
+   template<class TFunction>
+   double measure_ns_per_operation(size_t operations, TFunction function, size_t repetitions = 5)
+   {
+      double best = 0;
+      for(size_t i=0; i<repetitions; ++i)
+      {
+         auto start = clock::now();
+         function();
+         auto stop = clock::now();
+         auto ns = std::chrono::duration<double, std::nano>(stop - start).count() / operations;
+         if(i == 0 || ns < best)
+            best = ns;
+      }
+      return best;
+   }
+
+   inline void print_header(const std::string& title)
+   {
+      std::cout << std::endl << title << std::endl;
+      std::cout << std::string(title.size(), '=') << std::endl;
+   }
+
+   inline void print_result(const std::string& name, double value, const std::string& unit = "ns/op")
+   {
+      std::cout << std::left << std::setw(48) << name
+                << std::right << std::setw(12) << std::fixed << std::setprecision(2) << value
+                << " " << unit << std::endl;
+   }
+}
+
+#endif
@@ -0,0 +1,164 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <string>
+#include <map>
+#include <sstl/map.h>
+#include <sstl/btree_map.h>
+
+#include "benchmark.h"
+
+namespace
+{
+const size_t NUMBER_OF_OPERATIONS = 1000000;
+
+uint64_t next_random(uint64_t& state)
+{
+   state ^= state << 13;
+   state ^= state >> 7;
+   state ^= state << 17;
+   return state;
+}
+
+template<class TKey>
+std::vector<TKey> random_keys(size_t count, uint64_t seed)
+{
+   auto keys = std::vector<TKey>{};
+   for(size_t i=0; i<count; ++i)
+   {
+      keys.push_back(static_cast<TKey>(next_random(seed)));
+   }
+   return keys;
+}
+
+template<class TMap, class TKey>
+void fill(TMap& map, const std::vector<TKey>& keys)
+{
+   for(auto key : keys)
+   {
+      map.insert(std::make_pair(key, key));
+   }
+}
+
+// lookups of keys that are all present
+template<class TMap, class TKey, class TMakeMap>
+double find(size_t size, TMakeMap make_map)
+{
+   auto keys = random_keys<TKey>(size, 88172645463325252ull);
+   auto map = make_map();
+   fill(*map, keys);
+   return sstl_benchmark::measure_ns_per_operation(NUMBER_OF_OPERATIONS, [&map, &keys]()
+   {
+      uint64_t sum = 0;
+      for(size_t i=0, idx=0; i<NUMBER_OF_OPERATIONS; ++i)
+      {
+         sum += map->find(keys[idx])->second;
+         idx = idx+1 < keys.size() ? idx+1 : 0;
+      }
+      sstl_benchmark::do_not_optimize(sum);
+   });
+}
+
+// lower_bound of random keys, mostly absent
+template<class TMap, class TKey, class TMakeMap>
+double lower_bound(size_t size, TMakeMap make_map)
+{
+   auto keys = random_keys<TKey>(size, 88172645463325252ull);
+   auto lookups = random_keys<TKey>(size, 1234567ull);
+   auto map = make_map();
+   fill(*map, keys);
+   return sstl_benchmark::measure_ns_per_operation(NUMBER_OF_OPERATIONS, [&map, &lookups]()
+   {
+      uint64_t sum = 0;
+      for(size_t i=0, idx=0; i<NUMBER_OF_OPERATIONS; ++i)
+      {
+         auto it = map->lower_bound(lookups[idx]);
+         sum += it != map->end() ? it->second : 1;
+         idx = idx+1 < lookups.size() ? idx+1 : 0;
+      }
+      sstl_benchmark::do_not_optimize(sum);
+   });
+}
+
+// each repetition fills a new map with random keys
+template<class TMap, class TKey, class TMakeMap>
+double insert(size_t size, TMakeMap make_map)
+{
+   auto keys = random_keys<TKey>(size, 88172645463325252ull);
+   return sstl_benchmark::measure_ns_per_operation(size, [&keys, &make_map]()
+   {
+      auto map = make_map();
+      fill(*map, keys);
+      sstl_benchmark::do_not_optimize(map->size());
+   });
+}
+
+template<class TMap, class TKey, class TMakeMap>
+double iterate(size_t size, TMakeMap make_map)
+{
+   auto keys = random_keys<TKey>(size, 88172645463325252ull);
+   auto map = make_map();
+   fill(*map, keys);
+   return sstl_benchmark::measure_ns_per_operation(map->size(), [&map]()
+   {
+      uint64_t sum = 0;
+      for(const auto& value : *map)
+      {
+         sum += value.second;
+      }
+      sstl_benchmark::do_not_optimize(sum);
+   });
+}
+
+template<class TKey, size_t CAPACITY>
+void compare(const std::string& title)
+{
+   using sstl_btree_map = sstl::btree_map<TKey, uint64_t, CAPACITY>;
+   using sstl_map = sstl::map<TKey, uint64_t, CAPACITY>;
+   using std_map = std::map<TKey, uint64_t>;
+   auto make_sstl_btree_map = [](){ return std::unique_ptr<sstl_btree_map>(new sstl_btree_map); };
+   auto make_sstl_map = [](){ return std::unique_ptr<sstl_map>(new sstl_map); };
+   auto make_std_map = [](){ return std::unique_ptr<std_map>(new std_map); };
+
+   sstl_benchmark::print_header(title + ": find (hit)");
+   sstl_benchmark::print_result("sstl::btree_map", find<sstl_btree_map, TKey>(CAPACITY, make_sstl_btree_map));
+   sstl_benchmark::print_result("sstl::map", find<sstl_map, TKey>(CAPACITY, make_sstl_map));
+   sstl_benchmark::print_result("std::map", find<std_map, TKey>(CAPACITY, make_std_map));
+
+   sstl_benchmark::print_header(title + ": lower_bound");
+   sstl_benchmark::print_result("sstl::btree_map", lower_bound<sstl_btree_map, TKey>(CAPACITY, make_sstl_btree_map));
+   sstl_benchmark::print_result("sstl::map", lower_bound<sstl_map, TKey>(CAPACITY, make_sstl_map));
+   sstl_benchmark::print_result("std::map", lower_bound<std_map, TKey>(CAPACITY, make_std_map));
+
+   sstl_benchmark::print_header(title + ": insert");
+   sstl_benchmark::print_result("sstl::btree_map", insert<sstl_btree_map, TKey>(CAPACITY, make_sstl_btree_map), "ns/element");
+   sstl_benchmark::print_result("sstl::map", insert<sstl_map, TKey>(CAPACITY, make_sstl_map), "ns/element");
+   sstl_benchmark::print_result("std::map", insert<std_map, TKey>(CAPACITY, make_std_map), "ns/element");
+
+   sstl_benchmark::print_header(title + ": iteration");
+   sstl_benchmark::print_result("sstl::btree_map", iterate<sstl_btree_map, TKey>(CAPACITY, make_sstl_btree_map), "ns/element");
+   sstl_benchmark::print_result("sstl::map", iterate<sstl_map, TKey>(CAPACITY, make_sstl_map), "ns/element");
+   sstl_benchmark::print_result("std::map", iterate<std_map, TKey>(CAPACITY, make_std_map), "ns/element");
+}
+}
+
+int main()
+{
+   compare<uint64_t, 4096>("4k uint64 keys");
+   compare<uint64_t, 131072>("128k uint64 keys");
+   //the keys of 32 bits are compared with SIMD instructions
+   compare<uint32_t, 4096>("4k uint32 keys");
+   compare<uint32_t, 131072>("128k uint32 keys");
+   compare<uint32_t, 1048576>("1M uint32 keys");
+
+   return 0;
+}
@@ -0,0 +1,116 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <sstl/vector.h>
+#include <sstl/set.h>
+#include <sstl/btree_set.h>
+#include <sstl/frozen_set.h>
+
+#include "benchmark.h"
+
+namespace
+{
+const size_t NUMBER_OF_OPERATIONS = 1000000;
+
+uint64_t next_random(uint64_t& state)
+{
+   state ^= state << 13;
+   state ^= state >> 7;
+   state ^= state << 17;
+   return state;
+}
+
+std::vector<uint32_t> random_keys(size_t count, uint64_t seed)
+{
+   auto keys = std::vector<uint32_t>{};
+   for(size_t i=0; i<count; ++i)
+   {
+      keys.push_back(static_cast<uint32_t>(next_random(seed)));
+   }
+   return keys;
+}
+
+// distinct sorted keys, as a lookup table built at startup
+std::vector<uint32_t> sorted_keys(size_t count)
+{
+   auto keys = random_keys(count, 88172645463325252ull);
+   std::sort(keys.begin(), keys.end());
+   keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+   return keys;
+}
+
+// lower_bound of random keys, mostly absent
+template<class TLowerBound>
+double lower_bound(size_t size, TLowerBound lower_bound)
+{
+   auto lookups = random_keys(size, 1234567ull);
+   return sstl_benchmark::measure_ns_per_operation(NUMBER_OF_OPERATIONS, [&lookups, &lower_bound]()
+   {
+      uint64_t sum = 0;
+      for(size_t i=0, idx=0; i<NUMBER_OF_OPERATIONS; ++i)
+      {
+         sum += lower_bound(lookups[idx]);
+         idx = idx+1 < lookups.size() ? idx+1 : 0;
+      }
+      sstl_benchmark::do_not_optimize(sum);
+   });
+}
+
+template<size_t CAPACITY>
+void compare(const std::string& title)
+{
+   using sstl_frozen_set = sstl::frozen_set<uint32_t, CAPACITY>;
+   using sstl_btree_set = sstl::btree_set<uint32_t, CAPACITY>;
+   using sstl_set = sstl::set<uint32_t, CAPACITY>;
+   using sstl_vector = sstl::vector<uint32_t, CAPACITY>;
+
+   auto keys = sorted_keys(CAPACITY);
+   auto frozen_set = std::unique_ptr<sstl_frozen_set>(new sstl_frozen_set(keys.cbegin(), keys.cend()));
+   auto btree_set = std::unique_ptr<sstl_btree_set>(new sstl_btree_set(keys.cbegin(), keys.cend()));
+   auto set = std::unique_ptr<sstl_set>(new sstl_set);
+   set->assign_sorted(keys.cbegin(), keys.cend());
+   auto vector = std::unique_ptr<sstl_vector>(new sstl_vector(keys.cbegin(), keys.cend()));
+
+   sstl_benchmark::print_header(title + ": lower_bound");
+   sstl_benchmark::print_result("sstl::frozen_set", lower_bound(CAPACITY, [&frozen_set](uint32_t key)
+   {
+      auto it = frozen_set->lower_bound(key);
+      return it != frozen_set->end() ? *it : 1;
+   }));
+   sstl_benchmark::print_result("sstl::btree_set", lower_bound(CAPACITY, [&btree_set](uint32_t key)
+   {
+      auto it = btree_set->lower_bound(key);
+      return it != btree_set->end() ? *it : 1;
+   }));
+   sstl_benchmark::print_result("sstl::set", lower_bound(CAPACITY, [&set](uint32_t key)
+   {
+      auto it = set->lower_bound(key);
+      return it != set->end() ? *it : 1;
+   }));
+   sstl_benchmark::print_result("std::lower_bound on sstl::vector", lower_bound(CAPACITY, [&vector](uint32_t key)
+   {
+      auto it = std::lower_bound(vector->cbegin(), vector->cend(), key);
+      return it != vector->cend() ? *it : 1;
+   }));
+}
+}
+
+int main()
+{
+   compare<4096>("4k keys");
+   compare<262144>("256k keys");
+   //a table much larger than the L2 cache
+   compare<4194304>("4M keys");
+
+   return 0;
+}
@@ -0,0 +1,161 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <functional>
+#include <unordered_set>
+#include <sstl/hash.h>
+
+#include "benchmark.h"
+
+namespace
+{
+const size_t NUMBER_OF_KEYS = 16384;
+const size_t NUMBER_OF_OPERATIONS = 1000000;
+
+uint64_t next_random(uint64_t& state)
+{
+   state ^= state << 13;
+   state ^= state >> 7;
+   state ^= state << 17;
+   return state;
+}
+
+// what the hash tables compute on top of std::hash
+template<class Key>
+struct std_hash_mixed
+{
+   size_t operator()(const Key& key) const
+   {
+      return sstl::_hash_mix(std::hash<Key>()(key));
+   }
+};
+
+template<class THash, class Key>
+double ns_per_hash(const std::vector<Key>& keys)
+{
+   return sstl_benchmark::measure_ns_per_operation(NUMBER_OF_OPERATIONS, [&keys]()
+   {
+      auto hasher = THash();
+      size_t sum = 0;
+      for(size_t i=0, idx=0; i<NUMBER_OF_OPERATIONS; ++i)
+      {
+         sum += hasher(keys[idx]);
+         idx = idx+1 < keys.size() ? idx+1 : 0;
+      }
+      sstl_benchmark::do_not_optimize(sum);
+   });
+}
+
+// the keys that land in an occupied bucket of a power-of-two table twice as large
+// as the number of keys, indexed by the low bits of the hash (as the hash tables do)
+template<class THash, class Key>
+double bucket_collisions(const std::vector<Key>& keys)
+{
+   auto buckets = std::vector<bool>(2 * keys.size());
+   auto hasher = THash();
+   size_t collisions = 0;
+   for(const auto& key : keys)
+   {
+      auto bucket = hasher(key) & (buckets.size() - 1);
+      collisions += buckets[bucket] ? 1 : 0;
+      buckets[bucket] = true;
+   }
+   return static_cast<double>(collisions);
+}
+
+// keys with the same full hash value
+template<class THash, class Key>
+double hash_collisions(const std::vector<Key>& keys)
+{
+   auto hashes = std::unordered_set<size_t>{};
+   auto hasher = THash();
+   for(const auto& key : keys)
+   {
+      hashes.insert(hasher(key));
+   }
+   return static_cast<double>(keys.size() - hashes.size());
+}
+
+double expected_bucket_collisions(size_t keys)
+{
+   auto buckets = static_cast<double>(2 * keys);
+   auto filled = buckets * (1.0 - std::pow(1.0 - 1.0 / buckets, static_cast<double>(keys)));
+   return static_cast<double>(keys) - filled;
+}
+
+template<class Key>
+void compare(const std::string& title, const std::vector<Key>& keys)
+{
+   sstl_benchmark::print_header(title + ": hash");
+   sstl_benchmark::print_result("std::hash", ns_per_hash<std::hash<Key>>(keys), "ns/hash");
+   sstl_benchmark::print_result("std::hash + table mixer", ns_per_hash<std_hash_mixed<Key>>(keys), "ns/hash");
+   sstl_benchmark::print_result("sstl::hash", ns_per_hash<sstl::hash<Key>>(keys), "ns/hash");
+
+   sstl_benchmark::print_header(title + ": bucket collisions (load factor 0.5)");
+   sstl_benchmark::print_result("random function (expected)", expected_bucket_collisions(keys.size()), "keys");
+   sstl_benchmark::print_result("std::hash", bucket_collisions<std::hash<Key>>(keys), "keys");
+   sstl_benchmark::print_result("std::hash + table mixer", bucket_collisions<std_hash_mixed<Key>>(keys), "keys");
+   sstl_benchmark::print_result("sstl::hash", bucket_collisions<sstl::hash<Key>>(keys), "keys");
+
+   sstl_benchmark::print_header(title + ": full hash collisions");
+   sstl_benchmark::print_result("std::hash", hash_collisions<std::hash<Key>>(keys), "keys");
+   sstl_benchmark::print_result("sstl::hash", hash_collisions<sstl::hash<Key>>(keys), "keys");
+}
+
+std::vector<uint64_t> integer_keys(uint64_t first, uint64_t stride)
+{
+   auto keys = std::vector<uint64_t>{};
+   for(size_t i=0; i<NUMBER_OF_KEYS; ++i)
+   {
+      keys.push_back(first + i * stride);
+   }
+   return keys;
+}
+
+std::vector<uint64_t> random_keys()
+{
+   auto keys = std::vector<uint64_t>{};
+   uint64_t state = 88172645463325252ull;
+   for(size_t i=0; i<NUMBER_OF_KEYS; ++i)
+   {
+      keys.push_back(next_random(state));
+   }
+   return keys;
+}
+
+// printf-formatted keys of a fixed size, e.g. "S%05llu" for ticker-like symbols
+std::vector<std::string> string_keys(const char* format, size_t padding)
+{
+   auto keys = std::vector<std::string>{};
+   char buffer[64];
+   for(size_t i=0; i<NUMBER_OF_KEYS; ++i)
+   {
+      std::snprintf(buffer, sizeof(buffer), format, static_cast<unsigned long long>(i * 7919 % 100000));
+      keys.push_back(std::string(buffer) + std::string(padding, 'x'));
+   }
+   return keys;
+}
+}
+
+int main()
+{
+   compare("sequential uint64", integer_keys(1000000, 1));
+   compare("uint64 multiples of 4096", integer_keys(0, 4096));
+   compare("uint64 differing in the high 16 bits", integer_keys(42, uint64_t{ 1 } << 48));
+   compare("random uint64", random_keys());
+   compare("symbols (6 bytes)", string_keys("S%05llu", 0));
+   compare("order ids (20 bytes)", string_keys("ORD-%012llu-XNAS", 0));
+   compare("messages (120 bytes)", string_keys("MSG-%012llu-", 103));
+
+   return 0;
+}
@@ -0,0 +1,81 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <string>
+#include <map>
+#include <sstl/map.h>
+
+#include "benchmark.h"
+
+namespace
+{
+const size_t REPETITIONS = 5;
+
+// sorted keys with gaps, as the ids of a snapshot
+std::vector<std::pair<uint64_t, uint64_t>> sorted_values(size_t count)
+{
+   auto values = std::vector<std::pair<uint64_t, uint64_t>>{};
+   for(size_t i=0; i<count; ++i)
+   {
+      values.push_back(std::make_pair(1000 + i * 3, i));
+   }
+   return values;
+}
+
+// each repetition fills a new map, the maps are destroyed after the measurement
+template<class TMap, class TMakeMap, class TFill>
+double construction(size_t size, TMakeMap make_map, TFill fill)
+{
+   auto values = sorted_values(size);
+   auto maps = std::vector<std::unique_ptr<TMap>>{};
+   for(size_t i=0; i<REPETITIONS; ++i)
+   {
+      maps.push_back(make_map());
+   }
+   size_t next = 0;
+   return sstl_benchmark::measure_ns_per_operation(size, [&]()
+   {
+      auto& map = *maps[next++];
+      fill(map, values);
+      sstl_benchmark::do_not_optimize(map.size());
+   }, REPETITIONS);
+}
+
+template<size_t CAPACITY>
+void compare(const std::string& title)
+{
+   using sstl_map = sstl::map<uint64_t, uint64_t, CAPACITY>;
+   using std_map = std::map<uint64_t, uint64_t>;
+   using values_type = std::vector<std::pair<uint64_t, uint64_t>>;
+   auto make_sstl_map = [](){ return std::unique_ptr<sstl_map>(new sstl_map); };
+   auto make_std_map = [](){ return std::unique_ptr<std_map>(new std_map); };
+
+   sstl_benchmark::print_header(title + ": construction from sorted values");
+   sstl_benchmark::print_result("sstl::map insert(value)", construction<sstl_map>(CAPACITY, make_sstl_map,
+      [](sstl_map& map, const values_type& values) { for(const auto& value : values) map.insert(value); }), "ns/element");
+   sstl_benchmark::print_result("sstl::map insert(end(), value)", construction<sstl_map>(CAPACITY, make_sstl_map,
+      [](sstl_map& map, const values_type& values) { for(const auto& value : values) map.insert(map.cend(), value); }), "ns/element");
+   sstl_benchmark::print_result("sstl::map assign_sorted", construction<sstl_map>(CAPACITY, make_sstl_map,
+      [](sstl_map& map, const values_type& values) { map.assign_sorted(values.cbegin(), values.cend()); }), "ns/element");
+   sstl_benchmark::print_result("std::map insert(end(), value)", construction<std_map>(CAPACITY, make_std_map,
+      [](std_map& map, const values_type& values) { for(const auto& value : values) map.insert(map.cend(), value); }), "ns/element");
+}
+}
+
+int main()
+{
+   compare<64>("64 elements");
+   compare<4096>("4k elements");
+   compare<65536>("64k elements");
+
+   return 0;
+}
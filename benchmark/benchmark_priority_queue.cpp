@@ -0,0 +1,98 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <functional>
+#include <sstl/vector.h>
+#include <sstl/priority_queue.h>
+
+#include "benchmark.h"
+
+namespace
+{
+const size_t CAPACITY = 1 << 16;
+const size_t NUMBER_OF_OPERATIONS = 1000000;
+
+// the former sstl::priority_queue alias
+using std_priority_queue = std::priority_queue<uint64_t, sstl::vector<uint64_t, CAPACITY>>;
+
+template<size_t ARITY>
+using sstl_priority_queue = sstl::priority_queue<uint64_t,
+                                                 CAPACITY,
+                                                 sstl::vector<uint64_t, CAPACITY>,
+                                                 std::less<uint64_t>,
+                                                 ARITY>;
+
+uint64_t next_random(uint64_t& state)
+{
+   state ^= state << 13;
+   state ^= state >> 7;
+   state ^= state << 17;
+   return state;
+}
+
+// fills the queue and then pops the top value and pushes a new one
+// (the typical pattern of an event scheduler)
+template<class TPriorityQueue>
+double pop_and_push()
+{
+   return sstl_benchmark::measure_ns_per_operation(NUMBER_OF_OPERATIONS, []()
+   {
+      uint64_t state = 88172645463325252ull;
+      TPriorityQueue queue;
+      for(size_t i=0; i<CAPACITY-1; ++i)
+      {
+         queue.push(next_random(state));
+      }
+      uint64_t sum = 0;
+      for(size_t i=0; i<NUMBER_OF_OPERATIONS; ++i)
+      {
+         sum += queue.top();
+         queue.pop();
+         queue.push(next_random(state));
+      }
+      sstl_benchmark::do_not_optimize(sum);
+   });
+}
+
+template<size_t ARITY>
+double pop_push()
+{
+   return sstl_benchmark::measure_ns_per_operation(NUMBER_OF_OPERATIONS, []()
+   {
+      uint64_t state = 88172645463325252ull;
+      sstl_priority_queue<ARITY> queue;
+      for(size_t i=0; i<CAPACITY-1; ++i)
+      {
+         queue.push(next_random(state));
+      }
+      uint64_t sum = 0;
+      for(size_t i=0; i<NUMBER_OF_OPERATIONS; ++i)
+      {
+         sum += queue.pop_push(next_random(state));
+      }
+      sstl_benchmark::do_not_optimize(sum);
+   });
+}
+}
+
+int main()
+{
+   sstl_benchmark::print_header("64k values: pop + push");
+   sstl_benchmark::print_result("std::priority_queue<sstl::vector>", pop_and_push<std_priority_queue>());
+   sstl_benchmark::print_result("sstl::priority_queue (2-ary)", pop_and_push<sstl_priority_queue<2>>());
+   sstl_benchmark::print_result("sstl::priority_queue (4-ary)", pop_and_push<sstl_priority_queue<4>>());
+   sstl_benchmark::print_result("sstl::priority_queue (8-ary)", pop_and_push<sstl_priority_queue<8>>());
+
+   sstl_benchmark::print_header("64k values: pop_push");
+   sstl_benchmark::print_result("sstl::priority_queue (2-ary)", pop_push<2>());
+   sstl_benchmark::print_result("sstl::priority_queue (4-ary)", pop_push<4>());
+
+   return 0;
+}
@@ -0,0 +1,111 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <functional>
+#include <sstl/vector.h>
+#include <sstl/priority_queue.h>
+#include <sstl/radix_heap.h>
+
+#include "benchmark.h"
+
+namespace
+{
+const size_t NUMBER_OF_OPERATIONS = 1000000;
+
+template<class Key>
+struct event
+{
+   Key time;
+   uint32_t id;
+
+   bool operator>(const event& rhs) const { return time > rhs.time; }
+};
+
+template<class Key, size_t CAPACITY>
+using event_priority_queue = sstl::priority_queue<event<Key>,
+                                                  CAPACITY,
+                                                  sstl::vector<event<Key>, CAPACITY>,
+                                                  std::greater<event<Key>>>;
+
+uint64_t next_random(uint64_t& state)
+{
+   state ^= state << 13;
+   state ^= state >> 7;
+   state ^= state << 17;
+   return state;
+}
+
+// hold model of a discrete event simulation: the earliest event is popped
+// and a new event is scheduled at its time plus a random delay
+template<class Key, size_t CAPACITY>
+double hold_priority_queue(uint64_t max_delay)
+{
+   return sstl_benchmark::measure_ns_per_operation(NUMBER_OF_OPERATIONS, [max_delay]()
+   {
+      uint64_t state = 88172645463325252ull;
+      auto queue = std::unique_ptr<event_priority_queue<Key, CAPACITY>>(new event_priority_queue<Key, CAPACITY>);
+      for(uint32_t i=0; i<CAPACITY-1; ++i)
+      {
+         queue->push(event<Key>{ static_cast<Key>(next_random(state) % max_delay), i });
+      }
+      uint64_t sum = 0;
+      for(size_t i=0; i<NUMBER_OF_OPERATIONS; ++i)
+      {
+         auto e = queue->top();
+         queue->pop();
+         sum += e.id;
+         queue->push(event<Key>{ static_cast<Key>(e.time + next_random(state) % max_delay), e.id });
+      }
+      sstl_benchmark::do_not_optimize(sum);
+   });
+}
+
+template<class Key, size_t CAPACITY>
+double hold_radix_heap(uint64_t max_delay)
+{
+   return sstl_benchmark::measure_ns_per_operation(NUMBER_OF_OPERATIONS, [max_delay]()
+   {
+      uint64_t state = 88172645463325252ull;
+      auto heap = std::unique_ptr<sstl::radix_heap<Key, uint32_t, CAPACITY>>(new sstl::radix_heap<Key, uint32_t, CAPACITY>);
+      for(uint32_t i=0; i<CAPACITY-1; ++i)
+      {
+         heap->push(static_cast<Key>(next_random(state) % max_delay), i);
+      }
+      uint64_t sum = 0;
+      for(size_t i=0; i<NUMBER_OF_OPERATIONS; ++i)
+      {
+         auto time = heap->top_key();
+         auto id = heap->top_value();
+         heap->pop();
+         sum += id;
+         heap->push(static_cast<Key>(time + next_random(state) % max_delay), id);
+      }
+      sstl_benchmark::do_not_optimize(sum);
+   });
+}
+
+template<class Key, size_t CAPACITY>
+void compare(const char* title, uint64_t max_delay)
+{
+   sstl_benchmark::print_header(title);
+   sstl_benchmark::print_result("sstl::priority_queue (4-ary)", hold_priority_queue<Key, CAPACITY>(max_delay));
+   sstl_benchmark::print_result("sstl::radix_heap", hold_radix_heap<Key, CAPACITY>(max_delay));
+}
+}
+
+int main()
+{
+   compare<uint32_t, 1024>("1k events, 32 bit timestamps, delays < 1000: pop + push", 1000);
+   compare<uint32_t, 65536>("64k events, 32 bit timestamps, delays < 1000: pop + push", 1000);
+   compare<uint64_t, 1024>("1k events, 64 bit timestamps, delays < 10^9: pop + push", 1000000000);
+   compare<uint64_t, 65536>("64k events, 64 bit timestamps, delays < 10^9: pop + push", 1000000000);
+
+   return 0;
+}
@@ -0,0 +1,114 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iterator>
+#include <sstl/set.h>
+
+#include "benchmark.h"
+
+namespace
+{
+const size_t REPETITIONS = 5;
+
+uint64_t next_random(uint64_t& state)
+{
+   state ^= state << 13;
+   state ^= state >> 7;
+   state ^= state << 17;
+   return state;
+}
+
+// distinct sorted keys, drawn from a range where about half of the keys of two sets match
+std::vector<uint32_t> sorted_keys(size_t count, uint64_t seed)
+{
+   auto keys = std::vector<uint32_t>{};
+   for(size_t i=0; i<count; ++i)
+   {
+      keys.push_back(static_cast<uint32_t>(next_random(seed) % (count * 2)));
+   }
+   std::sort(keys.begin(), keys.end());
+   keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+   return keys;
+}
+
+// each repetition works on new sets, the sets are destroyed after the measurement
+template<class TSet, class TOperation>
+double set_operation(size_t size, TOperation operation)
+{
+   auto first_keys = sorted_keys(size / 2, 88172645463325252ull);
+   auto second_keys = sorted_keys(size / 2, 1234567ull);
+   auto firsts = std::vector<std::unique_ptr<TSet>>{};
+   auto seconds = std::vector<std::unique_ptr<TSet>>{};
+   auto destinations = std::vector<std::unique_ptr<TSet>>{};
+   for(size_t i=0; i<REPETITIONS; ++i)
+   {
+      firsts.push_back(std::unique_ptr<TSet>(new TSet));
+      firsts.back()->assign_sorted(first_keys.cbegin(), first_keys.cend());
+      seconds.push_back(std::unique_ptr<TSet>(new TSet));
+      seconds.back()->assign_sorted(second_keys.cbegin(), second_keys.cend());
+      destinations.push_back(std::unique_ptr<TSet>(new TSet));
+   }
+   size_t next = 0;
+   auto elements = first_keys.size() + second_keys.size();
+   return sstl_benchmark::measure_ns_per_operation(elements, [&]()
+   {
+      operation(*firsts[next], *seconds[next], *destinations[next]);
+      sstl_benchmark::do_not_optimize(destinations[next]->size() + firsts[next]->size());
+      ++next;
+   }, REPETITIONS);
+}
+
+template<size_t CAPACITY>
+void compare(const std::string& title)
+{
+   using sstl_set = sstl::set<uint32_t, CAPACITY>;
+
+   sstl_benchmark::print_header(title + ": union of two sets");
+   sstl_benchmark::print_result("std::set_union, insert(value)", set_operation<sstl_set>(CAPACITY,
+      [](const sstl_set& first, const sstl_set& second, sstl_set& destination)
+      {
+         std::set_union(first.cbegin(), first.cend(), second.cbegin(), second.cend(), std::inserter(destination, destination.end()));
+      }), "ns/element");
+   sstl_benchmark::print_result("sstl::set_union", set_operation<sstl_set>(CAPACITY,
+      [](const sstl_set& first, const sstl_set& second, sstl_set& destination)
+      {
+         set_union(first, second, destination);
+      }), "ns/element");
+   sstl_benchmark::print_result("sstl::set::merge", set_operation<sstl_set>(CAPACITY,
+      [](sstl_set& first, sstl_set& second, sstl_set&)
+      {
+         first.merge(second);
+      }), "ns/element");
+
+   sstl_benchmark::print_header(title + ": intersection of two sets");
+   sstl_benchmark::print_result("std::set_intersection, insert(value)", set_operation<sstl_set>(CAPACITY,
+      [](const sstl_set& first, const sstl_set& second, sstl_set& destination)
+      {
+         std::set_intersection(first.cbegin(), first.cend(), second.cbegin(), second.cend(), std::inserter(destination, destination.end()));
+      }), "ns/element");
+   sstl_benchmark::print_result("sstl::set_intersection", set_operation<sstl_set>(CAPACITY,
+      [](const sstl_set& first, const sstl_set& second, sstl_set& destination)
+      {
+         set_intersection(first, second, destination);
+      }), "ns/element");
+}
+}
+
+int main()
+{
+   compare<4096>("4k elements");
+   compare<65536>("64k elements");
+   compare<1048576>("1M elements");
+
+   return 0;
+}
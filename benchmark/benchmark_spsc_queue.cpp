@@ -0,0 +1,138 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <sstl/queue.h>
+#include <sstl/spsc_queue.h>
+
+#include "benchmark.h"
+
+namespace
+{
+const size_t CAPACITY = 1024;
+const size_t NUMBER_OF_VALUES = 1000000;
+const size_t NUMBER_OF_ROUND_TRIPS = 100000;
+
+// sstl::queue protected by a mutex, i.e. the setup replaced by sstl::spsc_queue
+class mutex_queue
+{
+public:
+   bool try_push(uint64_t value)
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if(_queue.size() == CAPACITY)
+         return false;
+      _queue.push(value);
+      return true;
+   }
+
+   bool try_pop(uint64_t& value)
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if(_queue.empty())
+         return false;
+      value = _queue.front();
+      _queue.pop();
+      return true;
+   }
+
+private:
+   std::mutex _mutex;
+   sstl::queue<uint64_t, CAPACITY> _queue;
+};
+
+class spsc_queue
+{
+public:
+   bool try_push(uint64_t value)
+   {
+      return _queue.try_push(value);
+   }
+
+   bool try_pop(uint64_t& value)
+   {
+      return _queue.try_pop(value);
+   }
+
+private:
+   sstl::spsc_queue<uint64_t, CAPACITY> _queue;
+};
+
+template<class TQueue>
+double throughput()
+{
+   return sstl_benchmark::measure_ns_per_operation(NUMBER_OF_VALUES, []()
+   {
+      TQueue queue;
+      auto producer = std::thread([&queue]()
+      {
+         for(uint64_t i=0; i<NUMBER_OF_VALUES; ++i)
+         {
+            while(!queue.try_push(i))
+               std::this_thread::yield();
+         }
+      });
+      uint64_t value = 0;
+      uint64_t sum = 0;
+      for(size_t i=0; i<NUMBER_OF_VALUES; ++i)
+      {
+         while(!queue.try_pop(value))
+            std::this_thread::yield();
+         sum += value;
+      }
+      producer.join();
+      sstl_benchmark::do_not_optimize(sum);
+   });
+}
+
+// one value bounces between two threads through two queues,
+// the result is the average round-trip latency
+template<class TQueue>
+double round_trip_latency()
+{
+   return sstl_benchmark::measure_ns_per_operation(NUMBER_OF_ROUND_TRIPS, []()
+   {
+      TQueue ping;
+      TQueue pong;
+      auto echo = std::thread([&ping, &pong]()
+      {
+         uint64_t value;
+         for(size_t i=0; i<NUMBER_OF_ROUND_TRIPS; ++i)
+         {
+            while(!ping.try_pop(value))
+               std::this_thread::yield();
+            pong.try_push(value);
+         }
+      });
+      uint64_t value = 0;
+      for(size_t i=0; i<NUMBER_OF_ROUND_TRIPS; ++i)
+      {
+         ping.try_push(i);
+         while(!pong.try_pop(value))
+            std::this_thread::yield();
+      }
+      echo.join();
+      sstl_benchmark::do_not_optimize(value);
+   });
+}
+}
+
+int main()
+{
+   sstl_benchmark::print_header("one producer + one consumer: throughput");
+   sstl_benchmark::print_result("sstl::queue + std::mutex", throughput<mutex_queue>());
+   sstl_benchmark::print_result("sstl::spsc_queue", throughput<spsc_queue>());
+
+   sstl_benchmark::print_header("one producer + one consumer: round-trip latency");
+   sstl_benchmark::print_result("sstl::queue + std::mutex", round_trip_latency<mutex_queue>());
+   sstl_benchmark::print_result("sstl::spsc_queue", round_trip_latency<spsc_queue>());
+
+   return 0;
+}
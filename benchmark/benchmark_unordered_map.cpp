@@ -0,0 +1,132 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <sstl/map.h>
+#include <sstl/unordered_map.h>
+
+#include "benchmark.h"
+
+namespace
+{
+const size_t NUMBER_OF_OPERATIONS = 1000000;
+
+uint64_t next_random(uint64_t& state)
+{
+   state ^= state << 13;
+   state ^= state >> 7;
+   state ^= state << 17;
+   return state;
+}
+
+std::vector<uint64_t> random_keys(size_t count, uint64_t seed)
+{
+   auto keys = std::vector<uint64_t>{};
+   for(size_t i=0; i<count; ++i)
+   {
+      keys.push_back(next_random(seed));
+   }
+   return keys;
+}
+
+template<class TMap>
+void fill(TMap& map, const std::vector<uint64_t>& keys)
+{
+   for(auto key : keys)
+   {
+      map.insert(std::make_pair(key, key));
+   }
+}
+
+// lookups of keys that are all present (or all absent)
+template<class TMap, class TMakeMap>
+double lookup(size_t size, bool present, TMakeMap make_map)
+{
+   auto keys = random_keys(size, 88172645463325252ull);
+   auto lookups = present ? keys : random_keys(size, 1234567ull);
+   auto map = make_map();
+   fill(*map, keys);
+   return sstl_benchmark::measure_ns_per_operation(NUMBER_OF_OPERATIONS, [&map, &lookups]()
+   {
+      uint64_t sum = 0;
+      for(size_t i=0, idx=0; i<NUMBER_OF_OPERATIONS; ++i)
+      {
+         auto it = map->find(lookups[idx]);
+         sum += it != map->end() ? it->second : 1;
+         idx = idx+1 < lookups.size() ? idx+1 : 0;
+      }
+      sstl_benchmark::do_not_optimize(sum);
+   });
+}
+
+// the map is kept 7/8 full: each operation erases a key and inserts another one
+template<class TMap, class TMakeMap>
+double churn(size_t size, TMakeMap make_map)
+{
+   return sstl_benchmark::measure_ns_per_operation(NUMBER_OF_OPERATIONS, [size, &make_map]()
+   {
+      auto keys = random_keys(size * 7 / 8, 88172645463325252ull);
+      auto map = make_map();
+      fill(*map, keys);
+      uint64_t state = 1234567ull;
+      for(size_t i=0, idx=0; i<NUMBER_OF_OPERATIONS; ++i)
+      {
+         map->erase(keys[idx]);
+         keys[idx] = next_random(state);
+         map->insert(std::make_pair(keys[idx], keys[idx]));
+         idx = idx+1 < keys.size() ? idx+1 : 0;
+      }
+      sstl_benchmark::do_not_optimize(map->size());
+   });
+}
+
+template<size_t CAPACITY>
+void compare(const std::string& title)
+{
+   using sstl_unordered_map = sstl::unordered_map<uint64_t, uint64_t, CAPACITY>;
+   using sstl_map = sstl::map<uint64_t, uint64_t, CAPACITY>;
+   using std_unordered_map = std::unordered_map<uint64_t, uint64_t>;
+   auto make_sstl_unordered_map = [](){ return std::unique_ptr<sstl_unordered_map>(new sstl_unordered_map); };
+   auto make_sstl_map = [](){ return std::unique_ptr<sstl_map>(new sstl_map); };
+   auto make_std_unordered_map = []()
+   {
+      auto map = std::unique_ptr<std_unordered_map>(new std_unordered_map);
+      map->reserve(CAPACITY);
+      return map;
+   };
+
+   sstl_benchmark::print_header(title + ": find (hit)");
+   sstl_benchmark::print_result("sstl::unordered_map", lookup<sstl_unordered_map>(CAPACITY, true, make_sstl_unordered_map));
+   sstl_benchmark::print_result("sstl::map", lookup<sstl_map>(CAPACITY, true, make_sstl_map));
+   sstl_benchmark::print_result("std::unordered_map", lookup<std_unordered_map>(CAPACITY, true, make_std_unordered_map));
+
+   sstl_benchmark::print_header(title + ": find (miss)");
+   sstl_benchmark::print_result("sstl::unordered_map", lookup<sstl_unordered_map>(CAPACITY, false, make_sstl_unordered_map));
+   sstl_benchmark::print_result("sstl::map", lookup<sstl_map>(CAPACITY, false, make_sstl_map));
+   sstl_benchmark::print_result("std::unordered_map", lookup<std_unordered_map>(CAPACITY, false, make_std_unordered_map));
+
+   sstl_benchmark::print_header(title + ": erase + insert");
+   sstl_benchmark::print_result("sstl::unordered_map", churn<sstl_unordered_map>(CAPACITY, make_sstl_unordered_map));
+   sstl_benchmark::print_result("sstl::map", churn<sstl_map>(CAPACITY, make_sstl_map));
+   sstl_benchmark::print_result("std::unordered_map", churn<std_unordered_map>(CAPACITY, make_std_unordered_map));
+}
+}
+
+int main()
+{
+   compare<64>("64 keys");
+   compare<4096>("4k keys");
+   compare<65536>("64k keys");
+
+   return 0;
+}
@@ -0,0 +1,117 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <string>
+#include <unordered_map>
+#include <sstl/multimap.h>
+#include <sstl/unordered_multimap.h>
+
+#include "benchmark.h"
+
+namespace
+{
+const size_t NUMBER_OF_OPERATIONS = 1000000;
+
+uint64_t next_random(uint64_t& state)
+{
+   state ^= state << 13;
+   state ^= state >> 7;
+   state ^= state << 17;
+   return state;
+}
+
+// fan-out index: each symbol maps to ORDERS_PER_SYMBOL orders,
+// an operation visits all the orders of a random symbol
+template<size_t SYMBOLS, size_t ORDERS_PER_SYMBOL, class TMap, class TMakeMap>
+double equal_range(TMakeMap make_map)
+{
+   auto map = make_map();
+   for(uint32_t order=0; order<SYMBOLS*ORDERS_PER_SYMBOL; ++order)
+   {
+      map->insert(std::make_pair(static_cast<uint32_t>(order % SYMBOLS), order));
+   }
+   return sstl_benchmark::measure_ns_per_operation(NUMBER_OF_OPERATIONS, [&map]()
+   {
+      uint64_t state = 88172645463325252ull;
+      uint64_t sum = 0;
+      for(size_t i=0; i<NUMBER_OF_OPERATIONS; ++i)
+      {
+         auto range = map->equal_range(static_cast<uint32_t>(next_random(state) % SYMBOLS));
+         for(auto it = range.first; it != range.second; ++it)
+         {
+            sum += it->second;
+         }
+      }
+      sstl_benchmark::do_not_optimize(sum);
+   });
+}
+
+// an order of a random symbol is cancelled and a new one is placed for another random symbol
+template<size_t SYMBOLS, size_t ORDERS_PER_SYMBOL, class TMap, class TMakeMap>
+double churn(TMakeMap make_map)
+{
+   return sstl_benchmark::measure_ns_per_operation(NUMBER_OF_OPERATIONS, [&make_map]()
+   {
+      auto map = make_map();
+      for(uint32_t order=0; order<SYMBOLS*ORDERS_PER_SYMBOL*7/8; ++order)
+      {
+         map->insert(std::make_pair(static_cast<uint32_t>(order % SYMBOLS), order));
+      }
+      uint64_t state = 88172645463325252ull;
+      for(size_t i=0; i<NUMBER_OF_OPERATIONS; ++i)
+      {
+         auto it = map->find(static_cast<uint32_t>(next_random(state) % SYMBOLS));
+         if(it != map->end())
+         {
+            map->erase(it);
+            map->insert(std::make_pair(static_cast<uint32_t>(next_random(state) % SYMBOLS), static_cast<uint32_t>(i)));
+         }
+      }
+      sstl_benchmark::do_not_optimize(map->size());
+   });
+}
+
+template<size_t SYMBOLS, size_t ORDERS_PER_SYMBOL>
+void compare(const std::string& title)
+{
+   const size_t CAPACITY = SYMBOLS * ORDERS_PER_SYMBOL;
+   using sstl_unordered_multimap = sstl::unordered_multimap<uint32_t, uint32_t, CAPACITY>;
+   using sstl_multimap = sstl::multimap<uint32_t, uint32_t, CAPACITY>;
+   using std_unordered_multimap = std::unordered_multimap<uint32_t, uint32_t>;
+   auto make_sstl_unordered_multimap = [](){ return std::unique_ptr<sstl_unordered_multimap>(new sstl_unordered_multimap); };
+   auto make_sstl_multimap = [](){ return std::unique_ptr<sstl_multimap>(new sstl_multimap); };
+   auto make_std_unordered_multimap = []()
+   {
+      auto map = std::unique_ptr<std_unordered_multimap>(new std_unordered_multimap);
+      map->reserve(CAPACITY);
+      return map;
+   };
+
+   sstl_benchmark::print_header(title + ": equal_range + scan");
+   sstl_benchmark::print_result("sstl::unordered_multimap", equal_range<SYMBOLS, ORDERS_PER_SYMBOL, sstl_unordered_multimap>(make_sstl_unordered_multimap));
+   sstl_benchmark::print_result("sstl::multimap", equal_range<SYMBOLS, ORDERS_PER_SYMBOL, sstl_multimap>(make_sstl_multimap));
+   sstl_benchmark::print_result("std::unordered_multimap", equal_range<SYMBOLS, ORDERS_PER_SYMBOL, std_unordered_multimap>(make_std_unordered_multimap));
+
+   sstl_benchmark::print_header(title + ": erase + insert");
+   sstl_benchmark::print_result("sstl::unordered_multimap", churn<SYMBOLS, ORDERS_PER_SYMBOL, sstl_unordered_multimap>(make_sstl_unordered_multimap));
+   sstl_benchmark::print_result("sstl::multimap", churn<SYMBOLS, ORDERS_PER_SYMBOL, sstl_multimap>(make_sstl_multimap));
+   sstl_benchmark::print_result("std::unordered_multimap", churn<SYMBOLS, ORDERS_PER_SYMBOL, std_unordered_multimap>(make_std_unordered_multimap));
+}
+}
+
+int main()
+{
+   compare<64, 4>("64 symbols x 4 orders");
+   compare<1024, 8>("1k symbols x 8 orders");
+   compare<8192, 4>("8k symbols x 4 orders");
+
+   return 0;
+}
@@ -0,0 +1,57 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_BACKOFF__
+#define _SSTL_BACKOFF__
+
+#include <cstddef>
+#include <thread>
+
+#include "_preprocessor.h"
+
+#if _is_msvc() && (defined(_M_IX86) || defined(_M_X64))
+   #include <intrin.h>
+   #define _sstl_cpu_relax() _mm_pause()
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+   #define _sstl_cpu_relax() __builtin_ia32_pause()
+#else
+   #define _sstl_cpu_relax()
+#endif
+
+namespace sstl
+{
+
+// waiting strategy for the blocking operations of the lock-free containers:
+// spins for an exponentially increasing number of iterations and,
+// once the spinning limit is reached, yields the thread's time slice
+class _backoff
+{
+public:
+   void operator()()
+   {
+      if(_spins <= _max_spins)
+      {
+         for(size_t i=0; i<_spins; ++i)
+         {
+            _sstl_cpu_relax();
+         }
+         _spins *= 2;
+      }
+      else
+      {
+         std::this_thread::yield();
+      }
+   }
+
+private:
+   static const size_t _max_spins = 64;
+   size_t _spins{ 1 };
+};
+
+}
+
+#endif
@@ -0,0 +1,108 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_BIT_WIDTH__
+#define _SSTL_BIT_WIDTH__
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "_preprocessor.h"
+#include "_except.h"
+
+#if _is_msvc()
+   #include <intrin.h>
+#endif
+
+namespace sstl
+{
+
+// number of bits required to represent the specified value, i.e. one plus the
+// index of the most significant set bit (zero if the value is zero)
+inline size_t _bit_width(uint32_t value) _sstl_noexcept_
+{
+   if(value == 0)
+      return 0;
+   #if _sstl_is_gcc() || defined(__clang__)
+   return 32 - static_cast<size_t>(__builtin_clz(value));
+   #elif _is_msvc()
+   unsigned long idx;
+   _BitScanReverse(&idx, value);
+   return static_cast<size_t>(idx) + 1;
+   #else
+   size_t width = 0;
+   while(value != 0)
+   {
+      value >>= 1;
+      ++width;
+   }
+   return width;
+   #endif
+}
+
+inline size_t _bit_width(uint64_t value) _sstl_noexcept_
+{
+   if(value == 0)
+      return 0;
+   #if _sstl_is_gcc() || defined(__clang__)
+   return 64 - static_cast<size_t>(__builtin_clzll(value));
+   #elif _is_msvc() && defined(_M_X64)
+   unsigned long idx;
+   _BitScanReverse64(&idx, value);
+   return static_cast<size_t>(idx) + 1;
+   #else
+   auto high = static_cast<uint32_t>(value >> 32);
+   return high != 0 ? 32 + _bit_width(high) : _bit_width(static_cast<uint32_t>(value));
+   #endif
+}
+
+// number of zero bits below the least significant set bit, the value must not be zero
+inline size_t _countr_zero(uint32_t value) _sstl_noexcept_
+{
+   #if _sstl_is_gcc() || defined(__clang__)
+   return static_cast<size_t>(__builtin_ctz(value));
+   #elif _is_msvc()
+   unsigned long idx;
+   _BitScanForward(&idx, value);
+   return static_cast<size_t>(idx);
+   #else
+   size_t count = 0;
+   while((value & 1) == 0)
+   {
+      value >>= 1;
+      ++count;
+   }
+   return count;
+   #endif
+}
+
+inline size_t _countr_zero(uint64_t value) _sstl_noexcept_
+{
+   #if _sstl_is_gcc() || defined(__clang__)
+   return static_cast<size_t>(__builtin_ctzll(value));
+   #elif _is_msvc() && defined(_M_X64)
+   unsigned long idx;
+   _BitScanForward64(&idx, value);
+   return static_cast<size_t>(idx);
+   #else
+   auto low = static_cast<uint32_t>(value);
+   return low != 0 ? _countr_zero(low) : 32 + _countr_zero(static_cast<uint32_t>(value >> 32));
+   #endif
+}
+
+// dispatches any unsigned integral type of 32 or 64 bits to the matching overload
+template<class T, class = typename std::enable_if<std::is_unsigned<T>::value>::type>
+size_t _bit_width_of(T value) _sstl_noexcept_
+{
+   using width_type = typename std::conditional<sizeof(T) <= sizeof(uint32_t), uint32_t, uint64_t>::type;
+   return _bit_width(static_cast<width_type>(value));
+}
+
+}
+
+#endif
@@ -0,0 +1,1346 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_BTREE__
+#define _SSTL_BTREE__
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+#include <array>
+
+#include <sstl_assert.h>
+
+#include "_preprocessor.h"
+#include "_except.h"
+#include "_utility.h"
+#include "_iterator.h"
+#include "_bit_width.h"
+#include "_cache_line.h"
+#include "_aligned_storage.h"
+
+#if !defined(_SSTL_DISABLE_SIMD) && (defined(__SSE2__) || (_is_msvc() && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))))
+   #define _sstl_btree_has_sse2() 1
+   #include <emmintrin.h>
+#else
+   #define _sstl_btree_has_sse2() 0
+#endif
+
+namespace sstl
+{
+
+// B-tree with all the values stored in the nodes (as in abseil's btree_map). A node holds up to
+// values_per_node sorted values, sized so that a node spans a few cache lines: a lookup touches
+// one node per level instead of one node per comparison as in the binary trees.
+// The arithmetic keys ordered by std::less are searched by a linear scan of the node, comparing
+// a whole register of keys at once with SSE2 (a branch-free loop for the 64 bits integers or
+// without SSE2). The maps keep a copy of the keys of a node in a contiguous array for the scan.
+// Every node but the root holds at least min_values values: the leaves and the internal nodes
+// come from two fixed pools, sized at compile time for the worst case of the requested number
+// of values. Insertions and erasures invalidate all the iterators.
+
+// comparison of a register of keys: bit i of the mask is set if keys[i] < key
+template<class T, class = void>
+struct _btree_simd
+{
+   static const size_t lanes = 0;
+};
+
+#if _sstl_btree_has_sse2()
+template<class T>
+using _btree_is_simd_integer = std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value>;
+
+template<class T>
+struct _btree_simd<T, typename std::enable_if<std::is_same<T, float>::value>::type>
+{
+   static const size_t lanes = 4;
+
+   static uint32_t less_mask(const T* keys, T key) _sstl_noexcept_
+   {
+      return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(keys), _mm_set1_ps(key))));
+   }
+};
+
+template<class T>
+struct _btree_simd<T, typename std::enable_if<std::is_same<T, double>::value>::type>
+{
+   static const size_t lanes = 2;
+
+   static uint32_t less_mask(const T* keys, T key) _sstl_noexcept_
+   {
+      return static_cast<uint32_t>(_mm_movemask_pd(_mm_cmplt_pd(_mm_loadu_pd(keys), _mm_set1_pd(key))));
+   }
+};
+
+//the unsigned keys are compared as signed ones after flipping their sign bits
+template<class T>
+struct _btree_simd<T, typename std::enable_if<_btree_is_simd_integer<T>::value && sizeof(T) == 4>::type>
+{
+   static const size_t lanes = 4;
+
+   static uint32_t less_mask(const T* keys, T key) _sstl_noexcept_
+   {
+      auto bias = _mm_set1_epi32(std::is_signed<T>::value ? 0 : (-2147483647 - 1));
+      auto lhs = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)), bias);
+      auto rhs = _mm_xor_si128(_mm_set1_epi32(static_cast<int32_t>(key)), bias);
+      return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(lhs, rhs))));
+   }
+};
+
+template<class T>
+struct _btree_simd<T, typename std::enable_if<_btree_is_simd_integer<T>::value && sizeof(T) == 2>::type>
+{
+   static const size_t lanes = 8;
+
+   static uint32_t less_mask(const T* keys, T key) _sstl_noexcept_
+   {
+      auto bias = _mm_set1_epi16(static_cast<int16_t>(std::is_signed<T>::value ? 0 : -32768));
+      auto lhs = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)), bias);
+      auto rhs = _mm_xor_si128(_mm_set1_epi16(static_cast<int16_t>(key)), bias);
+      //one byte per lane
+      auto less = _mm_packs_epi16(_mm_cmplt_epi16(lhs, rhs), _mm_setzero_si128());
+      return static_cast<uint32_t>(_mm_movemask_epi8(less));
+   }
+};
+
+template<class T>
+struct _btree_simd<T, typename std::enable_if<_btree_is_simd_integer<T>::value && sizeof(T) == 1>::type>
+{
+   static const size_t lanes = 16;
+
+   static uint32_t less_mask(const T* keys, T key) _sstl_noexcept_
+   {
+      auto bias = _mm_set1_epi8(static_cast<char>(std::is_signed<T>::value ? 0 : -128));
+      auto lhs = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)), bias);
+      auto rhs = _mm_xor_si128(_mm_set1_epi8(static_cast<char>(key)), bias);
+      return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmplt_epi8(lhs, rhs)));
+   }
+};
+#endif
+
+// position of the first of the sorted keys that is not less than key
+template<class TKey>
+size_t _btree_scan_lower_bound(const TKey* keys, size_t count, TKey key, std::true_type /*simd*/) _sstl_noexcept_
+{
+   using simd = _btree_simd<TKey>;
+   const auto all_less = static_cast<uint32_t>((uint32_t{ 1 } << simd::lanes) - 1);
+   size_t position = 0;
+   for(; position + simd::lanes <= count; position += simd::lanes)
+   {
+      auto mask = simd::less_mask(keys + position, key);
+      //the keys are sorted: the mask is a run of ones from the lowest bit
+      if(mask != all_less)
+         return position + _countr_zero(static_cast<uint32_t>(~mask));
+   }
+   while(position < count && keys[position] < key)
+   {
+      ++position;
+   }
+   return position;
+}
+
+template<class TKey>
+size_t _btree_scan_lower_bound(const TKey* keys, size_t count, TKey key, std::false_type /*simd*/) _sstl_noexcept_
+{
+   //branch-free count of the smaller keys (vectorized by the compiler where the instruction set allows)
+   size_t position = 0;
+   for(size_t i=0; i<count; ++i)
+   {
+      position += keys[i] < key ? 1 : 0;
+   }
+   return position;
+}
+
+template<class TKey, class TCompare>
+struct _btree_scans_keys : std::integral_constant<bool, std::is_arithmetic<TKey>::value
+                                                        && !std::is_same<TKey, bool>::value
+                                                        && std::is_same<TCompare, std::less<TKey>>::value>
+{};
+
+template<class TKey, size_t VALUES, bool>
+struct _btree_node_keys
+{
+   void _set_key(size_t, const TKey&) _sstl_noexcept_
+   {}
+};
+
+//copy of the keys of the node for the linear scan
+template<class TKey, size_t VALUES>
+struct _btree_node_keys<TKey, VALUES, true>
+{
+   void _set_key(size_t idx, const TKey& key) _sstl_noexcept_
+   {
+      _keys[idx] = key;
+   }
+
+   TKey _keys[VALUES];
+};
+
+template<class TKey, class TValue, size_t VALUES, bool KEY_CACHE>
+struct _btree_internal_node;
+
+template<class TKey, class TValue, size_t VALUES, bool KEY_CACHE>
+struct _btree_node : _btree_node_keys<TKey, VALUES, KEY_CACHE>
+{
+   using _value_storage = typename _aligned_storage<sizeof(TValue), std::alignment_of<TValue>::value>::type;
+   using _internal_node = _btree_internal_node<TKey, TValue, VALUES, KEY_CACHE>;
+
+   TValue& value(size_t idx) _sstl_noexcept_
+   {
+      return *reinterpret_cast<TValue*>(&_values[idx]);
+   }
+
+   //available only in the internal nodes
+   _btree_node*& child(size_t idx) _sstl_noexcept_
+   {
+      sstl_assert(!_leaf);
+      return static_cast<_internal_node*>(this)->_children[idx];
+   }
+
+   _btree_node* _parent;
+   uint16_t _position; //index of the node among the children of its parent
+   uint16_t _count;
+   bool _leaf;
+   _value_storage _values[VALUES];
+};
+
+template<class TKey, class TValue, size_t VALUES, bool KEY_CACHE>
+struct _btree_internal_node : _btree_node<TKey, TValue, VALUES, KEY_CACHE>
+{
+   _btree_node<TKey, TValue, VALUES, KEY_CACHE>* _children[VALUES + 1];
+};
+
+template<class TKey, class TValue, class TCompare>
+struct _btree_node_traits
+{
+   static const bool scans_keys = _btree_scans_keys<TKey, TCompare>::value;
+   static const bool has_key_cache = scans_keys && !std::is_same<TKey, TValue>::value;
+   static const size_t node_bytes = 4 * _cache_line_size;
+   static const size_t bytes_per_value = sizeof(TValue) + (has_key_cache ? sizeof(TKey) : 0);
+   static const size_t values_per_node = node_bytes / bytes_per_value > 3 ? node_bytes / bytes_per_value : 3;
+   static const size_t min_values = (values_per_node - 1) / 2;
+
+   using node = _btree_node<TKey, TValue, values_per_node, has_key_cache>;
+   using internal_node = _btree_internal_node<TKey, TValue, values_per_node, has_key_cache>;
+};
+
+// number of nodes of a tree that holds up to MAX_SIZE values: every node but the root holds
+// at least min_values values and every internal node but the root has at least min_values+1 children
+template<class TNodeTraits, size_t MAX_SIZE>
+struct _btree_capacity
+{
+   static const size_t leaves = MAX_SIZE <= TNodeTraits::values_per_node ? 1 : (MAX_SIZE - 1) / TNodeTraits::min_values + 1;
+   static const size_t internal_nodes = leaves < 2 ? 0 : (leaves - 2) / TNodeTraits::min_values + 1;
+};
+
+// the node pools of a tree that holds up to MAX_SIZE values, a base class of the derived containers
+template<class TKey, class TValue, class TCompare, size_t MAX_SIZE>
+struct _btree_storage
+{
+   using _node_traits = _btree_node_traits<TKey, TValue, TCompare>;
+   using _tree_capacity = _btree_capacity<_node_traits, MAX_SIZE>;
+   using _leaf_type = typename _node_traits::node;
+   using _internal_node_type = typename _node_traits::internal_node;
+
+   std::array<typename _aligned_storage<sizeof(_leaf_type), std::alignment_of<_leaf_type>::value>::type,
+              _tree_capacity::leaves> _leaves_;
+   std::array<typename _aligned_storage<sizeof(_internal_node_type), std::alignment_of<_internal_node_type>::value>::type,
+              _tree_capacity::internal_nodes> _internal_nodes_;
+};
+
+// fixed array of nodes: the nodes are handed out in order and the released ones are reused first
+// (linked through their parent pointers)
+template<class TNode>
+class _btree_node_pool
+{
+public:
+   _btree_node_pool(void* nodes, size_t capacity) _sstl_noexcept_
+      : _nodes(static_cast<TNode*>(nodes))
+      , _capacity(capacity)
+   {}
+
+   TNode* allocate() _sstl_noexcept_
+   {
+      if(_free != nullptr)
+      {
+         auto node = _free;
+         _free = static_cast<TNode*>(node->_parent);
+         return node;
+      }
+      sstl_assert(_used < _capacity);
+      return new(_nodes + _used++) TNode;
+   }
+
+   void deallocate(TNode* node) _sstl_noexcept_
+   {
+      node->_parent = _free;
+      _free = node;
+   }
+
+   void reset() _sstl_noexcept_
+   {
+      _used = 0;
+      _free = nullptr;
+   }
+
+private:
+   TNode* _nodes;
+   size_t _capacity;
+   size_t _used{ 0 };
+   TNode* _free{ nullptr };
+};
+
+template<class TNode, class T>
+class _btree_iterator
+{
+   template<class, class, class, class, class>
+   friend class _btree;
+
+   template<class, class>
+   friend class _btree_iterator;
+
+public:
+   using iterator_category = std::bidirectional_iterator_tag;
+   using value_type = typename std::remove_const<T>::type;
+   using difference_type = ptrdiff_t;
+   using pointer = T*;
+   using reference = T&;
+
+public:
+   _btree_iterator() _sstl_noexcept_ = default;
+
+   //conversion from iterator to const_iterator
+   template<class U, class = typename std::enable_if<std::is_same<const U, T>::value && !std::is_same<U, T>::value>::type>
+   _btree_iterator(const _btree_iterator<TNode, U>& rhs) _sstl_noexcept_
+      : _node(rhs._node)
+      , _position(rhs._position)
+   {}
+
+   reference operator*() const _sstl_noexcept_
+   {
+      sstl_assert(_node != nullptr && _position < _node->_count);
+      return _node->value(_position);
+   }
+
+   pointer operator->() const _sstl_noexcept_
+   {
+      return &**this;
+   }
+
+   _btree_iterator& operator++() _sstl_noexcept_
+   {
+      sstl_assert(_node != nullptr && _position < _node->_count);
+      if(!_node->_leaf)
+      {
+         //the first value of the right subtree
+         _node = _node->child(_position + 1);
+         while(!_node->_leaf)
+         {
+            _node = _node->child(0);
+         }
+         _position = 0;
+      }
+      else
+      {
+         ++_position;
+         _ascend();
+      }
+      return *this;
+   }
+
+   _btree_iterator operator++(int) _sstl_noexcept_
+   {
+      auto tmp = *this;
+      ++(*this);
+      return tmp;
+   }
+
+   _btree_iterator& operator--() _sstl_noexcept_
+   {
+      sstl_assert(_node != nullptr);
+      if(!_node->_leaf)
+      {
+         //the last value of the left subtree
+         _node = _node->child(_position);
+         while(!_node->_leaf)
+         {
+            _node = _node->child(_node->_count);
+         }
+         _position = _node->_count - 1u;
+      }
+      else if(_position > 0)
+      {
+         --_position;
+      }
+      else
+      {
+         //the value before the first subtree whose first value is not the one of the current leaf
+         while(_node->_position == 0)
+         {
+            sstl_assert(_node->_parent != nullptr);
+            _node = _node->_parent;
+         }
+         _position = _node->_position - 1u;
+         _node = _node->_parent;
+      }
+      return *this;
+   }
+
+   _btree_iterator operator--(int) _sstl_noexcept_
+   {
+      auto tmp = *this;
+      --(*this);
+      return tmp;
+   }
+
+   friend bool operator==(const _btree_iterator& lhs, const _btree_iterator& rhs) _sstl_noexcept_
+   {
+      return lhs._node == rhs._node && lhs._position == rhs._position;
+   }
+
+   friend bool operator!=(const _btree_iterator& lhs, const _btree_iterator& rhs) _sstl_noexcept_
+   {
+      return !(lhs == rhs);
+   }
+
+private:
+   _btree_iterator(const TNode* node, size_t position) _sstl_noexcept_
+      : _node(const_cast<TNode*>(node))
+      , _position(position)
+   {}
+
+   //past the last value of a node: the value after the subtree in the first ancestor that has one,
+   //or end() (the position past the last value of the root)
+   void _ascend() _sstl_noexcept_
+   {
+      while(_position == _node->_count && _node->_parent != nullptr)
+      {
+         _position = _node->_position;
+         _node = _node->_parent;
+      }
+   }
+
+private:
+   TNode* _node{ nullptr };
+   size_t _position{ 0 };
+};
+
+// the implementation shared by btree_map and btree_set: TKeyOfValue::get extracts the
+// key of a value and TIteratorValue is the value type seen through a non-const iterator
+// (const for sets). The derived containers provide the node pools.
+template<class TKey, class TValue, class TIteratorValue, class TKeyOfValue, class TCompare>
+class _btree
+{
+   template<class, class, class, class, class>
+   friend class _btree;
+
+private:
+   using _node_traits = _btree_node_traits<TKey, TValue, TCompare>;
+   using _node = typename _node_traits::node;
+   using _internal_node = typename _node_traits::internal_node;
+
+public:
+   using key_type = TKey;
+   using value_type = TValue;
+   using size_type = size_t;
+   using difference_type = ptrdiff_t;
+   using key_compare = TCompare;
+   using reference = value_type&;
+   using const_reference = const value_type&;
+   using pointer = value_type*;
+   using const_pointer = const value_type*;
+   using iterator = _btree_iterator<_node, TIteratorValue>;
+   using const_iterator = _btree_iterator<_node, const value_type>;
+   using reverse_iterator = std::reverse_iterator<iterator>;
+   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+   static const size_type values_per_node = _node_traits::values_per_node;
+
+private:
+   static const size_type _min_values = _node_traits::min_values;
+   //number of values kept by a node that is split
+   static const size_type _split_point = values_per_node / 2;
+
+   template<class K>
+   using _enable_if_transparent = typename std::enable_if<_is_transparent<key_compare>::value, K>::type;
+
+   using _is_nothrow_erasable = std::integral_constant<bool, std::is_nothrow_destructible<value_type>::value
+                                                             && std::is_nothrow_move_constructible<value_type>::value>;
+
+public:
+   iterator begin() _sstl_noexcept_
+   {
+      if(_root == nullptr)
+         return end();
+      auto node = _root;
+      while(!node->_leaf)
+      {
+         node = node->child(0);
+      }
+      return iterator(node, 0);
+   }
+
+   const_iterator begin() const _sstl_noexcept_
+   {
+      return const_cast<_btree&>(*this).begin();
+   }
+
+   const_iterator cbegin() const _sstl_noexcept_
+   {
+      return begin();
+   }
+
+   iterator end() _sstl_noexcept_
+   {
+      return iterator(_root, _root != nullptr ? _root->_count : 0);
+   }
+
+   const_iterator end() const _sstl_noexcept_
+   {
+      return const_cast<_btree&>(*this).end();
+   }
+
+   const_iterator cend() const _sstl_noexcept_
+   {
+      return end();
+   }
+
+   reverse_iterator rbegin() _sstl_noexcept_
+   {
+      return reverse_iterator(end());
+   }
+
+   const_reverse_iterator rbegin() const _sstl_noexcept_
+   {
+      return const_reverse_iterator(end());
+   }
+
+   const_reverse_iterator crbegin() const _sstl_noexcept_
+   {
+      return rbegin();
+   }
+
+   reverse_iterator rend() _sstl_noexcept_
+   {
+      return reverse_iterator(begin());
+   }
+
+   const_reverse_iterator rend() const _sstl_noexcept_
+   {
+      return const_reverse_iterator(begin());
+   }
+
+   const_reverse_iterator crend() const _sstl_noexcept_
+   {
+      return rend();
+   }
+
+   bool empty() const _sstl_noexcept_
+   {
+      return _size == 0;
+   }
+
+   bool full() const _sstl_noexcept_
+   {
+      return _size == _max_size;
+   }
+
+   size_type size() const _sstl_noexcept_
+   {
+      return _size;
+   }
+
+   size_type max_size() const _sstl_noexcept_
+   {
+      return _max_size;
+   }
+
+   size_type capacity() const _sstl_noexcept_
+   {
+      return _max_size;
+   }
+
+   key_compare key_comp() const
+   {
+      return _compare;
+   }
+
+   void clear() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      if(_root != nullptr)
+      {
+         _destroy_values(_root);
+      }
+      _leaves.reset();
+      _internal_nodes.reset();
+      _root = nullptr;
+      _size = 0;
+   }
+
+   std::pair<iterator, bool> insert(const_reference value)
+   {
+      return _insert(value);
+   }
+
+   std::pair<iterator, bool> insert(value_type&& value)
+   {
+      return _insert(std::move(value));
+   }
+
+   //the hint is ignored: a lookup touches one node per level
+   iterator insert(const_iterator, const_reference value)
+   {
+      return insert(value).first;
+   }
+
+   iterator insert(const_iterator, value_type&& value)
+   {
+      return insert(std::move(value)).first;
+   }
+
+   template<class TIterator, class = typename std::enable_if<_is_input_iterator<TIterator>::value>::type>
+   void insert(TIterator range_begin, TIterator range_end)
+   {
+      while(range_begin != range_end)
+      {
+         insert(*range_begin);
+         ++range_begin;
+      }
+   }
+
+   void insert(std::initializer_list<value_type> init)
+   {
+      insert(init.begin(), init.end());
+   }
+
+   //the value is constructed before the lookup (as required for maps by the standard),
+   //use try_emplace to construct the mapped value only if the key is not present
+   template<class... Args>
+   std::pair<iterator, bool> emplace(Args&&... args)
+   {
+      return _insert(value_type(std::forward<Args>(args)...));
+   }
+
+   template<class... Args>
+   iterator emplace_hint(const_iterator, Args&&... args)
+   {
+      return emplace(std::forward<Args>(args)...).first;
+   }
+
+   //the values that follow in the node, and possibly some values of the neighbouring nodes, are moved
+   iterator erase(const_iterator pos) _sstl_noexcept(_is_nothrow_erasable::value)
+   {
+      sstl_assert(pos._node != nullptr && pos._position < pos._node->_count);
+      auto node = pos._node;
+      auto position = pos._position;
+      auto leaf = node;
+      if(node->_leaf)
+      {
+         node->value(position).~value_type();
+         _shift_values_left(node, position + 1, node->_count);
+      }
+      else
+      {
+         //the value is replaced by its successor, the first value of the leftmost leaf of the right subtree
+         leaf = node->child(position + 1);
+         while(!leaf->_leaf)
+         {
+            leaf = leaf->child(0);
+         }
+         node->value(position).~value_type();
+         _move_value(node, position, leaf, 0);
+         _shift_values_left(leaf, 1, leaf->_count);
+      }
+      --leaf->_count;
+      --_size;
+      auto next = iterator(node, position);
+      _rebalance(leaf, next);
+      if(next._node != nullptr)
+      {
+         next._ascend();
+      }
+      return next;
+   }
+
+   iterator erase(const_iterator range_begin, const_iterator range_end) _sstl_noexcept(_is_nothrow_erasable::value)
+   {
+      //the erasures move the values across the nodes: count them first
+      auto count = std::distance(range_begin, range_end);
+      auto it = iterator(range_begin._node, range_begin._position);
+      while(count-- > 0)
+      {
+         it = erase(it);
+      }
+      return it;
+   }
+
+   size_type erase(const key_type& key)
+   {
+      auto it = find(key);
+      if(it == end())
+         return 0;
+      erase(it);
+      return 1;
+   }
+
+   iterator find(const key_type& key)
+   {
+      return _find(key);
+   }
+
+   const_iterator find(const key_type& key) const
+   {
+      return const_cast<_btree&>(*this).find(key);
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   iterator find(const K& key)
+   {
+      return _find(key);
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   const_iterator find(const K& key) const
+   {
+      return const_cast<_btree&>(*this).find(key);
+   }
+
+   size_type count(const key_type& key) const
+   {
+      return contains(key) ? 1 : 0;
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   size_type count(const K& key) const
+   {
+      return contains(key) ? 1 : 0;
+   }
+
+   bool contains(const key_type& key) const
+   {
+      return const_cast<_btree&>(*this)._lower_bound(key).second;
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   bool contains(const K& key) const
+   {
+      return const_cast<_btree&>(*this)._lower_bound(key).second;
+   }
+
+   iterator lower_bound(const key_type& key)
+   {
+      return _lower_bound(key).first;
+   }
+
+   const_iterator lower_bound(const key_type& key) const
+   {
+      return const_cast<_btree&>(*this).lower_bound(key);
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   iterator lower_bound(const K& key)
+   {
+      return _lower_bound(key).first;
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   const_iterator lower_bound(const K& key) const
+   {
+      return const_cast<_btree&>(*this).lower_bound(key);
+   }
+
+   iterator upper_bound(const key_type& key)
+   {
+      return _upper_bound(key);
+   }
+
+   const_iterator upper_bound(const key_type& key) const
+   {
+      return const_cast<_btree&>(*this).upper_bound(key);
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   iterator upper_bound(const K& key)
+   {
+      return _upper_bound(key);
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   const_iterator upper_bound(const K& key) const
+   {
+      return const_cast<_btree&>(*this).upper_bound(key);
+   }
+
+   std::pair<iterator, iterator> equal_range(const key_type& key)
+   {
+      return _equal_range(key);
+   }
+
+   std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+   {
+      return const_cast<_btree&>(*this).equal_range(key);
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   std::pair<iterator, iterator> equal_range(const K& key)
+   {
+      return _equal_range(key);
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   std::pair<const_iterator, const_iterator> equal_range(const K& key) const
+   {
+      return const_cast<_btree&>(*this).equal_range(key);
+   }
+
+protected:
+   _btree(void* leaves, size_type number_of_leaves,
+          void* internal_nodes, size_type number_of_internal_nodes,
+          size_type max_size, const key_compare& compare)
+      : _leaves(leaves, number_of_leaves)
+      , _internal_nodes(internal_nodes, number_of_internal_nodes)
+      , _max_size(max_size)
+      , _compare(compare)
+   {}
+
+   _btree(const _btree&) = delete;
+   _btree(_btree&&) = delete;
+
+   ~_btree() = default;
+
+   _btree& operator=(const _btree& rhs)
+   {
+      if(this != &rhs)
+      {
+         clear();
+         _compare = rhs._compare;
+         _assign_from(rhs);
+      }
+      return *this;
+   }
+
+   _btree& operator=(_btree&& rhs)
+   {
+      if(this != &rhs)
+      {
+         clear();
+         _compare = rhs._compare;
+         _assign_from(std::move(rhs));
+         rhs.clear();
+      }
+      return *this;
+   }
+
+   void _destructor() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      if(_root != nullptr)
+      {
+         _destroy_values(_root);
+      }
+   }
+
+   //copies (or moves) the values of rhs, this must be empty
+   template<class TTree>
+   void _assign_from(TTree&& rhs)
+   {
+      using rhs_value_reference = typename std::conditional<std::is_lvalue_reference<TTree>::value,
+                                                            const value_type&,
+                                                            value_type&&>::type;
+      sstl_assert(empty());
+      sstl_assert(rhs.size() <= _max_size);
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         for(auto& value : rhs)
+         {
+            _insert(static_cast<rhs_value_reference>(const_cast<value_type&>(value)));
+         }
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         clear();
+         throw;
+      }
+      #endif
+   }
+
+   //looks up the key: returns the position of the equivalent value if present,
+   //otherwise the position where the key must be inserted (see _emplace_at)
+   template<class K>
+   std::pair<iterator, bool> _find_insert_position(const K& key)
+   {
+      auto node = _root;
+      if(node == nullptr)
+         return std::make_pair(end(), false);
+      while(true)
+      {
+         auto position = _lower_bound_in_node(node, key);
+         if(position < node->_count && !_compare(key, TKeyOfValue::get(node->value(position))))
+            return std::make_pair(iterator(node, position), true);
+         if(node->_leaf)
+            return std::make_pair(iterator(node, position), false);
+         node = node->child(position);
+      }
+   }
+
+   //constructs the value at a position returned by _find_insert_position
+   template<class... Args>
+   iterator _emplace_at(const_iterator pos, Args&&... args)
+   {
+      sstl_assert(!full());
+      auto node = pos._node;
+      auto position = pos._position;
+      if(node == nullptr)
+      {
+         node = _root = _allocate_node(true);
+         node->_parent = nullptr;
+      }
+      else if(node->_count == values_per_node)
+      {
+         _split(node);
+         if(position > _split_point)
+         {
+            position -= _split_point + 1;
+            node = node->_parent->child(node->_position + 1u);
+         }
+      }
+      _shift_values_right(node, position, node->_count);
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         new(&node->_values[position]) value_type(std::forward<Args>(args)...);
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         _shift_values_left(node, position + 1, node->_count + 1u);
+         if(node->_count == 0)
+         {
+            _release_node(node);
+            _root = nullptr;
+         }
+         throw;
+      }
+      #endif
+      node->_set_key(position, TKeyOfValue::get(node->value(position)));
+      ++node->_count;
+      ++_size;
+      return iterator(node, position);
+   }
+
+private:
+   template<class TValueReference>
+   std::pair<iterator, bool> _insert(TValueReference&& value)
+   {
+      auto result = _find_insert_position(TKeyOfValue::get(value));
+      if(result.second)
+         return std::make_pair(result.first, false);
+      return std::make_pair(_emplace_at(result.first, std::forward<TValueReference>(value)), true);
+   }
+
+   template<class K>
+   iterator _find(const K& key)
+   {
+      auto result = _lower_bound(key);
+      return result.second ? result.first : end();
+   }
+
+   //the first value whose key is not less than key, and whether its key is equivalent
+   template<class K>
+   std::pair<iterator, bool> _lower_bound(const K& key)
+   {
+      auto result = end();
+      auto node = _root;
+      while(node != nullptr)
+      {
+         auto position = _lower_bound_in_node(node, key);
+         if(position < node->_count)
+         {
+            if(!_compare(key, TKeyOfValue::get(node->value(position))))
+               return std::make_pair(iterator(node, position), true);
+            result = iterator(node, position);
+         }
+         node = node->_leaf ? nullptr : node->child(position);
+      }
+      return std::make_pair(result, false);
+   }
+
+   template<class K>
+   iterator _upper_bound(const K& key)
+   {
+      auto result = _lower_bound(key);
+      if(result.second)
+         ++result.first;
+      return result.first;
+   }
+
+   template<class K>
+   std::pair<iterator, iterator> _equal_range(const K& key)
+   {
+      auto result = _lower_bound(key);
+      auto last = result.first;
+      if(result.second)
+         ++last;
+      return std::make_pair(result.first, last);
+   }
+
+   template<class K>
+   size_type _lower_bound_in_node(_node* node, const K& key) const
+   {
+      return _lower_bound_in_node(node, key, std::integral_constant<bool, _node_traits::scans_keys
+                                                                           && std::is_same<K, key_type>::value>());
+   }
+
+   size_type _lower_bound_in_node(_node* node, const key_type& key, std::true_type /*scan*/) const _sstl_noexcept_
+   {
+      using simd = std::integral_constant<bool, (_btree_simd<key_type>::lanes > 0)>;
+      return _btree_scan_lower_bound(_scanned_keys(node, std::integral_constant<bool, _node_traits::has_key_cache>()),
+                                     node->_count, key, simd());
+   }
+
+   template<class K>
+   size_type _lower_bound_in_node(_node* node, const K& key, std::false_type /*scan*/) const
+   {
+      size_type first = 0;
+      size_type count = node->_count;
+      while(count > 0)
+      {
+         auto step = count / 2;
+         if(_compare(TKeyOfValue::get(node->value(first + step)), key))
+         {
+            first += step + 1;
+            count -= step + 1;
+         }
+         else
+         {
+            count = step;
+         }
+      }
+      return first;
+   }
+
+   static const key_type* _scanned_keys(_node* node, std::true_type /*key cache*/) _sstl_noexcept_
+   {
+      return node->_keys;
+   }
+
+   //the values of the sets are the keys
+   static const key_type* _scanned_keys(_node* node, std::false_type /*key cache*/) _sstl_noexcept_
+   {
+      return reinterpret_cast<const key_type*>(node->_values);
+   }
+
+   _node* _allocate_node(bool leaf) _sstl_noexcept_
+   {
+      auto node = leaf ? _leaves.allocate() : _internal_nodes.allocate();
+      node->_leaf = leaf;
+      node->_count = 0;
+      return node;
+   }
+
+   void _release_node(_node* node) _sstl_noexcept_
+   {
+      if(node->_leaf)
+         _leaves.deallocate(node);
+      else
+         _internal_nodes.deallocate(static_cast<_internal_node*>(node));
+   }
+
+   static void _set_child(_node* node, size_type idx, _node* child) _sstl_noexcept_
+   {
+      node->child(idx) = child;
+      child->_parent = node;
+      child->_position = static_cast<uint16_t>(idx);
+   }
+
+   //moves a value into the raw slot dst_idx, the slot src_idx becomes raw
+   static void _move_value(_node* dst, size_type dst_idx, _node* src, size_type src_idx)
+   {
+      new(&dst->_values[dst_idx]) value_type(std::move(src->value(src_idx)));
+      src->value(src_idx).~value_type();
+      dst->_set_key(dst_idx, TKeyOfValue::get(dst->value(dst_idx)));
+   }
+
+   //moves the values [first, last) one slot to the right, the slot last must be raw
+   static void _shift_values_right(_node* node, size_type first, size_type last)
+   {
+      for(auto idx=last; idx>first; --idx)
+      {
+         _move_value(node, idx, node, idx - 1);
+      }
+   }
+
+   //moves the values [first, last) one slot to the left, the slot first-1 must be raw
+   static void _shift_values_left(_node* node, size_type first, size_type last)
+   {
+      for(auto idx=first; idx<last; ++idx)
+      {
+         _move_value(node, idx - 1, node, idx);
+      }
+   }
+
+   static void _shift_children_right(_node* node, size_type first, size_type last) _sstl_noexcept_
+   {
+      for(auto idx=last; idx>first; --idx)
+      {
+         _set_child(node, idx, node->child(idx - 1));
+      }
+   }
+
+   static void _shift_children_left(_node* node, size_type first, size_type last) _sstl_noexcept_
+   {
+      for(auto idx=first; idx<last; ++idx)
+      {
+         _set_child(node, idx - 1, node->child(idx));
+      }
+   }
+
+   //moves the upper half of a full node to a new right sibling and its median value to the parent
+   //(the parent is split first if it is full as well)
+   void _split(_node* node)
+   {
+      if(node->_parent == nullptr)
+      {
+         _root = _allocate_node(false);
+         _root->_parent = nullptr;
+         _set_child(_root, 0, node);
+      }
+      else if(node->_parent->_count == values_per_node)
+      {
+         _split(node->_parent);
+      }
+      auto parent = node->_parent;
+      auto position = node->_position;
+      auto sibling = _allocate_node(node->_leaf);
+      sibling->_count = static_cast<uint16_t>(values_per_node - _split_point - 1);
+      for(size_type idx=0; idx<sibling->_count; ++idx)
+      {
+         _move_value(sibling, idx, node, _split_point + 1 + idx);
+      }
+      if(!node->_leaf)
+      {
+         for(size_type idx=0; idx<=sibling->_count; ++idx)
+         {
+            _set_child(sibling, idx, node->child(_split_point + 1 + idx));
+         }
+      }
+      _shift_values_right(parent, position, parent->_count);
+      _shift_children_right(parent, position + 1u, parent->_count + 1u);
+      _move_value(parent, position, node, _split_point);
+      _set_child(parent, position + 1u, sibling);
+      ++parent->_count;
+      node->_count = static_cast<uint16_t>(_split_point);
+   }
+
+   //restores the minimum number of values of the nodes from a node that has lost one up to the root,
+   //by borrowing values from the siblings or by merging with them. The iterator is kept on the
+   //same value (or position) while the values move.
+   void _rebalance(_node* node, iterator& it)
+   {
+      while(node != _root)
+      {
+         if(node->_count >= _min_values)
+            return;
+         auto parent = node->_parent;
+         auto position = node->_position;
+         auto left = position > 0 ? parent->child(position - 1u) : nullptr;
+         auto right = position < parent->_count ? parent->child(position + 1u) : nullptr;
+         if(left != nullptr && left->_count > _min_values)
+         {
+            _rotate_right(left, node, it);
+            return;
+         }
+         if(right != nullptr && right->_count > _min_values)
+         {
+            _rotate_left(node, right, it);
+            return;
+         }
+         if(left != nullptr)
+            _merge(left, node, it);
+         else
+            _merge(node, right, it);
+         node = parent;
+      }
+      if(_root->_count == 0)
+      {
+         auto root = _root;
+         if(root->_leaf)
+         {
+            _root = nullptr;
+            it = iterator();
+         }
+         else
+         {
+            _root = root->child(0);
+            _root->_parent = nullptr;
+            if(it._node == root)
+               it = end();
+         }
+         _release_node(root);
+      }
+   }
+
+   //moves the last value of the left sibling to the parent and the separator to the node
+   void _rotate_right(_node* left, _node* node, iterator& it)
+   {
+      auto parent = node->_parent;
+      auto separator = node->_position - 1u;
+      _shift_values_right(node, 0, node->_count);
+      _move_value(node, 0, parent, separator);
+      _move_value(parent, separator, left, left->_count - 1u);
+      if(!node->_leaf)
+      {
+         _shift_children_right(node, 0, node->_count + 1u);
+         _set_child(node, 0, left->child(left->_count));
+      }
+      if(it._node == node)
+         ++it._position;
+      else if(it._node == parent && it._position == separator)
+         it = iterator(node, 0);
+      else if(it._node == left && it._position == left->_count - 1u)
+         it = iterator(parent, separator);
+      --left->_count;
+      ++node->_count;
+   }
+
+   //moves the first value of the right sibling to the parent and the separator to the node
+   void _rotate_left(_node* node, _node* right, iterator& it)
+   {
+      auto parent = node->_parent;
+      auto separator = node->_position;
+      _move_value(node, node->_count, parent, separator);
+      _move_value(parent, separator, right, 0);
+      _shift_values_left(right, 1, right->_count);
+      if(!node->_leaf)
+      {
+         _set_child(node, node->_count + 1u, right->child(0));
+         _shift_children_left(right, 1, right->_count + 1u);
+      }
+      if(it._node == parent && it._position == separator)
+         it = iterator(node, node->_count);
+      else if(it._node == right && it._position == 0)
+         it = iterator(parent, separator);
+      else if(it._node == right)
+         --it._position;
+      ++node->_count;
+      --right->_count;
+   }
+
+   //moves the separator and the values of the right node to the left one, the right node is released
+   void _merge(_node* left, _node* right, iterator& it)
+   {
+      auto parent = left->_parent;
+      auto separator = left->_position;
+      auto offset = left->_count + 1u;
+      _move_value(left, left->_count, parent, separator);
+      for(size_type idx=0; idx<right->_count; ++idx)
+      {
+         _move_value(left, offset + idx, right, idx);
+      }
+      if(!left->_leaf)
+      {
+         for(size_type idx=0; idx<=right->_count; ++idx)
+         {
+            _set_child(left, offset + idx, right->child(idx));
+         }
+      }
+      _shift_values_left(parent, separator + 1u, parent->_count);
+      _shift_children_left(parent, separator + 2u, parent->_count + 1u);
+      if(it._node == parent && it._position == separator)
+         it = iterator(left, left->_count);
+      else if(it._node == right)
+         it = iterator(left, offset + it._position);
+      else if(it._node == parent && it._position > separator)
+         --it._position;
+      left->_count = static_cast<uint16_t>(left->_count + 1u + right->_count);
+      --parent->_count;
+      _release_node(right);
+   }
+
+   void _destroy_values(_node* node) _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      if(std::is_trivially_destructible<value_type>::value)
+         return;
+      for(size_type idx=0; idx<node->_count; ++idx)
+      {
+         node->value(idx).~value_type();
+      }
+      if(!node->_leaf)
+      {
+         for(size_type idx=0; idx<=node->_count; ++idx)
+         {
+            _destroy_values(node->child(idx));
+         }
+      }
+   }
+
+private:
+   _node* _root{ nullptr };
+   _btree_node_pool<_node> _leaves;
+   _btree_node_pool<_internal_node> _internal_nodes;
+   size_type _size{ 0 };
+   size_type _max_size;
+   key_compare _compare;
+};
+
+template<class TKey, class TValue, class TIteratorValue, class TKeyOfValue, class TCompare>
+const size_t _btree<TKey, TValue, TIteratorValue, TKeyOfValue, TCompare>::values_per_node;
+
+template<class TKey, class TValue, class TIteratorValue, class TKeyOfValue, class TCompare>
+bool operator==(const _btree<TKey, TValue, TIteratorValue, TKeyOfValue, TCompare>& lhs,
+                const _btree<TKey, TValue, TIteratorValue, TKeyOfValue, TCompare>& rhs)
+{
+   return lhs.size() == rhs.size() && std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin());
+}
+
+template<class TKey, class TValue, class TIteratorValue, class TKeyOfValue, class TCompare>
+bool operator!=(const _btree<TKey, TValue, TIteratorValue, TKeyOfValue, TCompare>& lhs,
+                const _btree<TKey, TValue, TIteratorValue, TKeyOfValue, TCompare>& rhs)
+{
+   return !(lhs == rhs);
+}
+
+template<class TKey, class TValue, class TIteratorValue, class TKeyOfValue, class TCompare>
+bool operator<(const _btree<TKey, TValue, TIteratorValue, TKeyOfValue, TCompare>& lhs,
+               const _btree<TKey, TValue, TIteratorValue, TKeyOfValue, TCompare>& rhs)
+{
+   return std::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+}
+
+template<class TKey, class TValue, class TIteratorValue, class TKeyOfValue, class TCompare>
+bool operator>(const _btree<TKey, TValue, TIteratorValue, TKeyOfValue, TCompare>& lhs,
+               const _btree<TKey, TValue, TIteratorValue, TKeyOfValue, TCompare>& rhs)
+{
+   return rhs < lhs;
+}
+
+template<class TKey, class TValue, class TIteratorValue, class TKeyOfValue, class TCompare>
+bool operator<=(const _btree<TKey, TValue, TIteratorValue, TKeyOfValue, TCompare>& lhs,
+                const _btree<TKey, TValue, TIteratorValue, TKeyOfValue, TCompare>& rhs)
+{
+   return !(rhs < lhs);
+}
+
+template<class TKey, class TValue, class TIteratorValue, class TKeyOfValue, class TCompare>
+bool operator>=(const _btree<TKey, TValue, TIteratorValue, TKeyOfValue, TCompare>& lhs,
+                const _btree<TKey, TValue, TIteratorValue, TKeyOfValue, TCompare>& rhs)
+{
+   return !(lhs < rhs);
+}
+
+}
+
+#endif
@@ -0,0 +1,33 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_CACHE_LINE__
+#define _SSTL_CACHE_LINE__
+
+#include <cstddef>
+
+#ifndef _SSTL_CACHE_LINE_SIZE
+// feel free to define this macro to match the cache line size of your target
+#define _SSTL_CACHE_LINE_SIZE 64
+#endif
+
+namespace sstl
+{
+
+static const size_t _cache_line_size = _SSTL_CACHE_LINE_SIZE;
+
+// padding placed between members that are written by different threads,
+// in order to prevent them from sharing the same cache line (false sharing)
+template<size_t USED_BYTES = 0>
+struct _cache_line_padding
+{
+   char _bytes[_cache_line_size - (USED_BYTES % _cache_line_size)];
+};
+
+}
+
+#endif
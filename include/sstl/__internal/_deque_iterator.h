@@ -94,30 +94,20 @@ public:
 
    _dequeng_iterator& operator+=(difference_type inc) _sstl_noexcept_
    {
-      if(_pos == nullptr)
-      {
-         sstl_assert(inc <= 0);
-         _pos = _deque->_derived()._last_pointer;
-         ++inc;
-      }
-      _pos = _deque->_apply_offset_to_pointer(_pos, inc);
-      if(_deque->_is_pointer_one_past_last_pointer(_pos))
+      //the offset is applied to the linearized position, because in a full deque
+      //the pointer one past the last element is also the pointer to the first element
+      auto new_linearized_pos = _linearized_pos() + inc;
+      sstl_assert(new_linearized_pos >= 0 && new_linearized_pos <= static_cast<difference_type>(_deque->size()));
+      if(new_linearized_pos == static_cast<difference_type>(_deque->size()))
          _pos = nullptr;
+      else
+         _pos = _deque->_apply_offset_to_pointer(_deque->_derived()._first_pointer, new_linearized_pos);
       return *this;
    }
 
    _dequeng_iterator& operator-=(difference_type dec) _sstl_noexcept_
    {
-      if(_pos == nullptr)
-      {
-         sstl_assert(dec >= 0);
-         _pos = _deque->_derived()._last_pointer;
-         --dec;
-      }
-      _pos = _deque->_apply_offset_to_pointer(_pos, -dec);
-      if(_deque->_is_pointer_one_past_last_pointer(_pos))
-         _pos = nullptr;
-      return *this;
+      return operator+=(-dec);
    }
 
    friend _dequeng_iterator operator+(const _dequeng_iterator& lhs, difference_type rhs) _sstl_noexcept_
@@ -0,0 +1,587 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_EYTZINGER__
+#define _SSTL_EYTZINGER__
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <array>
+
+#include <sstl_assert.h>
+
+#include "_preprocessor.h"
+#include "_except.h"
+#include "_utility.h"
+#include "_iterator.h"
+#include "_bit_width.h"
+#include "_cache_line.h"
+#include "_aligned_storage.h"
+
+#if _is_msvc()
+   #include <xmmintrin.h>
+#endif
+
+namespace sstl
+{
+
+// Read-only sorted array in Eytzinger layout: the values are stored in the order of a breadth-first
+// traversal of a complete binary search tree, the root at index 1 and the children of index k at
+// indices 2k and 2k+1 (index 0 is not used). A lookup descends the implicit tree without branching
+// on the comparisons, and the top levels of the tree share a few cache lines that stay hot.
+// The 2^d descendants of index k found d levels below are contiguous: each step prefetches
+// the descendants that fill one cache line, so that the memory latency of the next levels
+// overlaps the comparisons of the current ones (see "Array layouts for comparison-based searching",
+// Khuong and Morin). The values are placed once from a sorted range and never modified.
+
+inline void _eytzinger_prefetch(const void* address) _sstl_noexcept_
+{
+   #if _sstl_is_gcc() || defined(__clang__)
+   __builtin_prefetch(address);
+   #elif _is_msvc()
+   _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+   #else
+   (void)address;
+   #endif
+}
+
+// the index of the value that follows (or precedes) the value at index k in sorted order
+// in a tree of size values, zero past the last (or before the first) value
+inline size_t _eytzinger_next(size_t k, size_t size) _sstl_noexcept_
+{
+   if(2 * k + 1 <= size)
+   {
+      //the leftmost value of the right subtree
+      k = 2 * k + 1;
+      while(2 * k <= size)
+      {
+         k = 2 * k;
+      }
+      return k;
+   }
+   //up to the first ancestor reached from its left subtree
+   return k >> (_countr_zero(~static_cast<uint64_t>(k)) + 1);
+}
+
+inline size_t _eytzinger_prev(size_t k, size_t size) _sstl_noexcept_
+{
+   if(k == 0)
+   {
+      //the rightmost value of the tree
+      k = 1;
+      while(2 * k + 1 <= size)
+      {
+         k = 2 * k + 1;
+      }
+      return k;
+   }
+   if(2 * k <= size)
+   {
+      //the rightmost value of the left subtree
+      k = 2 * k;
+      while(2 * k + 1 <= size)
+      {
+         k = 2 * k + 1;
+      }
+      return k;
+   }
+   //up to the first ancestor reached from its right subtree
+   return k >> (_countr_zero(static_cast<uint64_t>(k)) + 1);
+}
+
+// the index of the first value in sorted order (the leftmost one), zero if the tree is empty
+inline size_t _eytzinger_first(size_t size) _sstl_noexcept_
+{
+   return size != 0 ? size_t{1} << (_bit_width(static_cast<uint64_t>(size)) - 1) : 0;
+}
+
+// the greatest power of two not greater than n (one if n is zero)
+constexpr size_t _eytzinger_floor_power_of_two(size_t n)
+{
+   return n <= 1 ? 1 : 2 * _eytzinger_floor_power_of_two(n / 2);
+}
+
+template<class TValue, size_t CAPACITY>
+struct _eytzinger_storage
+{
+   //one more slot than values: the tree is indexed from one
+   std::array<typename _aligned_storage<sizeof(TValue), std::alignment_of<TValue>::value>::type, CAPACITY + 1> _values_;
+};
+
+// the iterators traverse the tree in sorted order (the values are never modified)
+template<class TValue>
+class _eytzinger_iterator
+{
+   template<class, class, class, class>
+   friend class _eytzinger;
+
+public:
+   using iterator_category = std::bidirectional_iterator_tag;
+   using value_type = TValue;
+   using difference_type = ptrdiff_t;
+   using pointer = const TValue*;
+   using reference = const TValue&;
+
+public:
+   _eytzinger_iterator() _sstl_noexcept_ = default;
+
+   reference operator*() const _sstl_noexcept_
+   {
+      sstl_assert(_index != 0 && _index <= _size);
+      return _values[_index];
+   }
+
+   pointer operator->() const _sstl_noexcept_
+   {
+      return &**this;
+   }
+
+   _eytzinger_iterator& operator++() _sstl_noexcept_
+   {
+      sstl_assert(_index != 0);
+      _index = _eytzinger_next(_index, _size);
+      return *this;
+   }
+
+   _eytzinger_iterator operator++(int) _sstl_noexcept_
+   {
+      auto tmp = *this;
+      ++(*this);
+      return tmp;
+   }
+
+   _eytzinger_iterator& operator--() _sstl_noexcept_
+   {
+      sstl_assert(_size != 0);
+      _index = _eytzinger_prev(_index, _size);
+      return *this;
+   }
+
+   _eytzinger_iterator operator--(int) _sstl_noexcept_
+   {
+      auto tmp = *this;
+      --(*this);
+      return tmp;
+   }
+
+   friend bool operator==(const _eytzinger_iterator& lhs, const _eytzinger_iterator& rhs) _sstl_noexcept_
+   {
+      return lhs._values == rhs._values && lhs._index == rhs._index;
+   }
+
+   friend bool operator!=(const _eytzinger_iterator& lhs, const _eytzinger_iterator& rhs) _sstl_noexcept_
+   {
+      return !(lhs == rhs);
+   }
+
+private:
+   _eytzinger_iterator(const TValue* values, size_t size, size_t index) _sstl_noexcept_
+      : _values(values)
+      , _size(size)
+      , _index(index)
+   {}
+
+private:
+   const TValue* _values{ nullptr };
+   size_t _size{ 0 };
+   //zero is end()
+   size_t _index{ 0 };
+};
+
+// the implementation shared by frozen_map and frozen_set: TKeyOfValue::get extracts the
+// key of a value. The derived containers provide the storage of the values.
+template<class TKey, class TValue, class TKeyOfValue, class TCompare>
+class _eytzinger
+{
+   template<class, class, class, class>
+   friend class _eytzinger;
+
+public:
+   using key_type = TKey;
+   using value_type = TValue;
+   using size_type = size_t;
+   using difference_type = ptrdiff_t;
+   using key_compare = TCompare;
+   using reference = const value_type&;
+   using const_reference = const value_type&;
+   using pointer = const value_type*;
+   using const_pointer = const value_type*;
+   using iterator = _eytzinger_iterator<value_type>;
+   using const_iterator = iterator;
+   using reverse_iterator = std::reverse_iterator<iterator>;
+   using const_reverse_iterator = reverse_iterator;
+
+private:
+   //number of descendants prefetched at each step: as many values as fit in a cache line
+   static const size_type _prefetch_distance = _eytzinger_floor_power_of_two(_cache_line_size / sizeof(value_type));
+
+   template<class K>
+   using _enable_if_transparent = typename std::enable_if<_is_transparent<key_compare>::value, K>::type;
+
+public:
+   const_iterator begin() const _sstl_noexcept_
+   {
+      return const_iterator(_values, _size, _eytzinger_first(_size));
+   }
+
+   const_iterator cbegin() const _sstl_noexcept_
+   {
+      return begin();
+   }
+
+   const_iterator end() const _sstl_noexcept_
+   {
+      return const_iterator(_values, _size, 0);
+   }
+
+   const_iterator cend() const _sstl_noexcept_
+   {
+      return end();
+   }
+
+   const_reverse_iterator rbegin() const _sstl_noexcept_
+   {
+      return const_reverse_iterator(end());
+   }
+
+   const_reverse_iterator crbegin() const _sstl_noexcept_
+   {
+      return rbegin();
+   }
+
+   const_reverse_iterator rend() const _sstl_noexcept_
+   {
+      return const_reverse_iterator(begin());
+   }
+
+   const_reverse_iterator crend() const _sstl_noexcept_
+   {
+      return rend();
+   }
+
+   bool empty() const _sstl_noexcept_
+   {
+      return _size == 0;
+   }
+
+   size_type size() const _sstl_noexcept_
+   {
+      return _size;
+   }
+
+   size_type max_size() const _sstl_noexcept_
+   {
+      return _max_size;
+   }
+
+   size_type capacity() const _sstl_noexcept_
+   {
+      return _max_size;
+   }
+
+   key_compare key_comp() const
+   {
+      return _compare;
+   }
+
+   const_iterator find(const key_type& key) const
+   {
+      return _find(key);
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   const_iterator find(const K& key) const
+   {
+      return _find(key);
+   }
+
+   size_type count(const key_type& key) const
+   {
+      return contains(key) ? 1 : 0;
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   size_type count(const K& key) const
+   {
+      return contains(key) ? 1 : 0;
+   }
+
+   bool contains(const key_type& key) const
+   {
+      return _find(key) != end();
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   bool contains(const K& key) const
+   {
+      return _find(key) != end();
+   }
+
+   const_iterator lower_bound(const key_type& key) const
+   {
+      return const_iterator(_values, _size, _lower_bound(key));
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   const_iterator lower_bound(const K& key) const
+   {
+      return const_iterator(_values, _size, _lower_bound(key));
+   }
+
+   const_iterator upper_bound(const key_type& key) const
+   {
+      return const_iterator(_values, _size, _upper_bound(key));
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   const_iterator upper_bound(const K& key) const
+   {
+      return const_iterator(_values, _size, _upper_bound(key));
+   }
+
+   std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+   {
+      return _equal_range(key);
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   std::pair<const_iterator, const_iterator> equal_range(const K& key) const
+   {
+      return _equal_range(key);
+   }
+
+protected:
+   _eytzinger(void* values, size_type max_size, const key_compare& compare)
+      : _values(static_cast<value_type*>(values))
+      , _max_size(max_size)
+      , _compare(compare)
+   {}
+
+   _eytzinger(const _eytzinger&) = delete;
+   _eytzinger(_eytzinger&&) = delete;
+
+   ~_eytzinger() = default;
+
+   _eytzinger& operator=(const _eytzinger& rhs)
+   {
+      if(this != &rhs)
+      {
+         _clear();
+         _compare = rhs._compare;
+         _assign_from(rhs);
+      }
+      return *this;
+   }
+
+   _eytzinger& operator=(_eytzinger&& rhs)
+   {
+      if(this != &rhs)
+      {
+         _clear();
+         _compare = rhs._compare;
+         _assign_from(std::move(rhs));
+         rhs._clear();
+      }
+      return *this;
+   }
+
+   void _destructor() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _clear();
+   }
+
+   //places the values of a range sorted by key_compare without equivalent keys (checked by
+   //an assertion): the values are constructed in sorted order along an in-order traversal
+   template<class TIterator>
+   void _assign_sorted(TIterator range_begin, TIterator range_end)
+   {
+      static_assert(_is_forward_iterator<TIterator>::value, "the values are counted before being placed");
+      sstl_assert(empty());
+      auto size = static_cast<size_type>(std::distance(range_begin, range_end));
+      sstl_assert(size <= _max_size);
+      size_type placed = 0;
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         size_type previous = 0;
+         for(auto k = _eytzinger_first(size); range_begin != range_end; k = _eytzinger_next(k, size), ++range_begin)
+         {
+            new(&_values[k]) value_type(*range_begin);
+            ++placed;
+            sstl_assert(previous == 0 || _compare(TKeyOfValue::get(_values[previous]), TKeyOfValue::get(_values[k])));
+            previous = k;
+         }
+         (void)previous;
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         for(auto k = _eytzinger_first(size); placed > 0; k = _eytzinger_next(k, size), --placed)
+         {
+            _values[k].~value_type();
+         }
+         throw;
+      }
+      #endif
+      _size = size;
+   }
+
+   //copies (or moves) the values of rhs, this must be empty:
+   //trees of the same size share the same layout
+   template<class TEytzinger>
+   void _assign_from(TEytzinger&& rhs)
+   {
+      using rhs_value_reference = typename std::conditional<std::is_lvalue_reference<TEytzinger>::value,
+                                                            const value_type&,
+                                                            value_type&&>::type;
+      sstl_assert(empty());
+      sstl_assert(rhs.size() <= _max_size);
+      size_type k = 1;
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         for(; k <= rhs._size; ++k)
+         {
+            new(&_values[k]) value_type(static_cast<rhs_value_reference>(rhs._values[k]));
+         }
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         while(--k > 0)
+         {
+            _values[k].~value_type();
+         }
+         throw;
+      }
+      #endif
+      _size = rhs._size;
+   }
+
+   void _clear() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      for(size_type k = 1; k <= _size; ++k)
+      {
+         _values[k].~value_type();
+      }
+      _size = 0;
+   }
+
+private:
+   //the comparison selects the child: the index keeps the path taken as its bits, the lower bound
+   //is the last node whose left subtree was taken, found by dropping the trailing right turns (ones)
+   //and the final left turn. No turn to the left means that all the keys are less than key (end).
+   template<class K>
+   size_type _lower_bound(const K& key) const
+   {
+      size_type k = 1;
+      while(k <= _size)
+      {
+         _prefetch(k * _prefetch_distance);
+         k = 2 * k + static_cast<size_type>(_compare(TKeyOfValue::get(_values[k]), key));
+      }
+      return k >> (_countr_zero(~static_cast<uint64_t>(k)) + 1);
+   }
+
+   template<class K>
+   size_type _upper_bound(const K& key) const
+   {
+      size_type k = 1;
+      while(k <= _size)
+      {
+         _prefetch(k * _prefetch_distance);
+         k = 2 * k + static_cast<size_type>(!_compare(key, TKeyOfValue::get(_values[k])));
+      }
+      return k >> (_countr_zero(~static_cast<uint64_t>(k)) + 1);
+   }
+
+   template<class K>
+   const_iterator _find(const K& key) const
+   {
+      auto k = _lower_bound(key);
+      if(k != 0 && _compare(key, TKeyOfValue::get(_values[k])))
+         k = 0;
+      return const_iterator(_values, _size, k);
+   }
+
+   template<class K>
+   std::pair<const_iterator, const_iterator> _equal_range(const K& key) const
+   {
+      auto first = lower_bound(key);
+      auto last = first;
+      if(last != end() && !_compare(key, TKeyOfValue::get(*last)))
+         ++last;
+      return std::make_pair(first, last);
+   }
+
+   //the index may be past the end of the tree: the address is computed as an integer,
+   //a prefetch doesn't fault on an invalid address
+   void _prefetch(size_type k) const _sstl_noexcept_
+   {
+      _eytzinger_prefetch(reinterpret_cast<const void*>(reinterpret_cast<uintptr_t>(_values) + k * sizeof(value_type)));
+   }
+
+private:
+   value_type* _values;
+   size_type _size{ 0 };
+   size_type _max_size;
+   key_compare _compare;
+};
+
+template<class TKey, class TValue, class TKeyOfValue, class TCompare>
+bool operator==(const _eytzinger<TKey, TValue, TKeyOfValue, TCompare>& lhs,
+                const _eytzinger<TKey, TValue, TKeyOfValue, TCompare>& rhs)
+{
+   return lhs.size() == rhs.size() && std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin());
+}
+
+template<class TKey, class TValue, class TKeyOfValue, class TCompare>
+bool operator!=(const _eytzinger<TKey, TValue, TKeyOfValue, TCompare>& lhs,
+                const _eytzinger<TKey, TValue, TKeyOfValue, TCompare>& rhs)
+{
+   return !(lhs == rhs);
+}
+
+template<class TKey, class TValue, class TKeyOfValue, class TCompare>
+bool operator<(const _eytzinger<TKey, TValue, TKeyOfValue, TCompare>& lhs,
+               const _eytzinger<TKey, TValue, TKeyOfValue, TCompare>& rhs)
+{
+   return std::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+}
+
+template<class TKey, class TValue, class TKeyOfValue, class TCompare>
+bool operator>(const _eytzinger<TKey, TValue, TKeyOfValue, TCompare>& lhs,
+               const _eytzinger<TKey, TValue, TKeyOfValue, TCompare>& rhs)
+{
+   return rhs < lhs;
+}
+
+template<class TKey, class TValue, class TKeyOfValue, class TCompare>
+bool operator<=(const _eytzinger<TKey, TValue, TKeyOfValue, TCompare>& lhs,
+                const _eytzinger<TKey, TValue, TKeyOfValue, TCompare>& rhs)
+{
+   return !(rhs < lhs);
+}
+
+template<class TKey, class TValue, class TKeyOfValue, class TCompare>
+bool operator>=(const _eytzinger<TKey, TValue, TKeyOfValue, TCompare>& lhs,
+                const _eytzinger<TKey, TValue, TKeyOfValue, TCompare>& rhs)
+{
+   return !(lhs < rhs);
+}
+
+}
+
+#endif
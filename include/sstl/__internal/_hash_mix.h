@@ -0,0 +1,88 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_HASH_MIX__
+#define _SSTL_HASH_MIX__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "_preprocessor.h"
+#include "_except.h"
+#include "_utility.h"
+
+#if _is_msvc()
+   #include <intrin.h>
+#endif
+
+namespace sstl
+{
+
+// the 128 bits product of the operands
+inline void _multiply_128(uint64_t lhs, uint64_t rhs, uint64_t& low, uint64_t& high) _sstl_noexcept_
+{
+   #if defined(__SIZEOF_INT128__)
+   __extension__ using uint128 = unsigned __int128;
+   auto product = static_cast<uint128>(lhs) * rhs;
+   low = static_cast<uint64_t>(product);
+   high = static_cast<uint64_t>(product >> 64);
+   #elif _is_msvc() && defined(_M_X64)
+   low = _umul128(lhs, rhs, &high);
+   #else
+   //schoolbook multiplication of the 32 bits halves
+   auto lhs_low = lhs & 0xffffffffu, lhs_high = lhs >> 32;
+   auto rhs_low = rhs & 0xffffffffu, rhs_high = rhs >> 32;
+   auto low_low = lhs_low * rhs_low;
+   auto high_low = lhs_high * rhs_low;
+   auto low_high = lhs_low * rhs_high;
+   auto middle = (low_low >> 32) + (high_low & 0xffffffffu) + (low_high & 0xffffffffu);
+   low = (middle << 32) | (low_low & 0xffffffffu);
+   high = lhs_high * rhs_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+   #endif
+}
+
+// the 128 bits product folded to 64 bits (xor of its halves): each bit of the result
+// depends on all the bits of the operands, the low ones included
+inline uint64_t _folded_multiply(uint64_t lhs, uint64_t rhs) _sstl_noexcept_
+{
+   uint64_t low, high;
+   _multiply_128(lhs, rhs, low, high);
+   return low ^ high;
+}
+
+// fibonacci hashing, applied by the hash tables on top of the user's hash function:
+// std::hash of integers is usually the identity function, thus a key that differs from
+// another one in the high bits only would otherwise land in the same slot
+inline size_t _hash_mix(size_t hash) _sstl_noexcept_
+{
+   #if SIZE_MAX > 0xffffffffu
+   return static_cast<size_t>(_folded_multiply(hash, 0x9E3779B97F4A7C15ull));
+   #else
+   auto product = static_cast<uint64_t>(hash) * 0x9E3779B9u;
+   return static_cast<size_t>(product ^ (product >> 32));
+   #endif
+}
+
+//true if the hash function declares the member type "is_avalanching": each bit of its
+//result depends on all the bits of the key, the tables use it as it is
+template<class T, class = void>
+struct _is_avalanching : std::false_type
+{};
+
+template<class T>
+struct _is_avalanching<T, typename _void_type<typename T::is_avalanching>::type> : std::true_type
+{};
+
+template<class THash>
+size_t _hash_finalize(size_t hash) _sstl_noexcept_
+{
+   return _is_avalanching<THash>::value ? hash : _hash_mix(hash);
+}
+
+}
+
+#endif
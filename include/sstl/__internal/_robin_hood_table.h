@@ -0,0 +1,823 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_ROBIN_HOOD_TABLE__
+#define _SSTL_ROBIN_HOOD_TABLE__
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+#include <array>
+
+#include <sstl_assert.h>
+
+#include "_except.h"
+#include "_utility.h"
+#include "_iterator.h"
+#include "_aligned_storage.h"
+#include "_hash_mix.h"
+#include "_bit_width.h"
+
+namespace sstl
+{
+
+// Open addressing hash table with linear probing and robin hood displacement, for the
+// containers with equivalent keys. The table stores for each slot its distance from the
+// home slot of its value (plus one, zero means empty). Along a cluster the home slots never
+// decrease: an insertion takes the place of the first value that is closer to its home
+// ("richer") than the new value and shifts the rest of the cluster by one slot, and an erasure
+// shifts the rest of the cluster back by one slot (backward-shift deletion), thus no tombstones
+// are needed and the clusters stay short after any amount of churn.
+// A new value is inserted right after the values with an equivalent key, hence equivalent keys
+// are always contiguous and equal_range is a linear scan.
+// The iteration starts after an empty slot (the anchor) and wraps around the end of the table,
+// so that the clusters, and thus the ranges of equivalent keys, are never split by the end of
+// the iteration. A bitmap of the occupied slots lets the iterators skip the empty slots
+// a word at a time.
+// The table does not grow: the derived containers size their arrays at compile time for the
+// requested number of values with a maximum load factor of 7/8.
+
+using _robin_hood_distance_t = uint32_t;
+
+// number of slots of a table that holds up to MAX_SIZE values:
+// the smallest power of two with enough room at 7/8 load
+template<size_t MAX_SIZE>
+struct _robin_hood_table_capacity
+{
+   static constexpr size_t compute(size_t capacity)
+   {
+      return capacity - capacity / 8 >= MAX_SIZE ? capacity : compute(capacity * 2);
+   }
+
+   static const size_t value = compute(8);
+   static_assert(value <= static_cast<_robin_hood_distance_t>(-1), "capacity is too large");
+};
+
+// the arrays of a table that holds up to MAX_SIZE values, a base class of the derived containers
+// (listed before the table, so that the arrays are constructed when the table initializes them)
+template<class TValue, size_t MAX_SIZE>
+struct _robin_hood_table_storage
+{
+   using _table_capacity = _robin_hood_table_capacity<MAX_SIZE>;
+
+   std::array<_robin_hood_distance_t, _table_capacity::value> _distances_;
+   std::array<uint64_t, (_table_capacity::value + 63) / 64> _occupied_;
+   std::array<typename _aligned_storage<sizeof(TValue), std::alignment_of<TValue>::value>::type, _table_capacity::value> _slots_;
+};
+
+template<class TTable, class T>
+class _robin_hood_table_iterator
+{
+   template<class, class, class, class, class, class>
+   friend class _robin_hood_table;
+
+   template<class, class>
+   friend class _robin_hood_table_iterator;
+
+public:
+   using iterator_category = std::forward_iterator_tag;
+   using value_type = typename std::remove_const<T>::type;
+   using difference_type = ptrdiff_t;
+   using pointer = T*;
+   using reference = T&;
+
+public:
+   _robin_hood_table_iterator() _sstl_noexcept_ = default;
+
+   //conversion from iterator to const_iterator
+   template<class U, class = typename std::enable_if<std::is_same<const U, T>::value && !std::is_same<U, T>::value>::type>
+   _robin_hood_table_iterator(const _robin_hood_table_iterator<TTable, U>& rhs) _sstl_noexcept_
+      : _table(rhs._table)
+      , _position(rhs._position)
+   {}
+
+   reference operator*() const _sstl_noexcept_
+   {
+      return *operator->();
+   }
+
+   pointer operator->() const _sstl_noexcept_
+   {
+      sstl_assert(_table != nullptr && _position < _table->_capacity);
+      auto idx = _table->_index_of(_position);
+      sstl_assert(_table->_distances[idx] != 0);
+      return _table->_slots + idx;
+   }
+
+   _robin_hood_table_iterator& operator++() _sstl_noexcept_
+   {
+      sstl_assert(_table != nullptr && _position < _table->_capacity);
+      ++_position;
+      _skip_empty();
+      return *this;
+   }
+
+   _robin_hood_table_iterator operator++(int) _sstl_noexcept_
+   {
+      auto tmp = *this;
+      ++(*this);
+      return tmp;
+   }
+
+   friend bool operator==(const _robin_hood_table_iterator& lhs, const _robin_hood_table_iterator& rhs) _sstl_noexcept_
+   {
+      return lhs._position == rhs._position;
+   }
+
+   friend bool operator!=(const _robin_hood_table_iterator& lhs, const _robin_hood_table_iterator& rhs) _sstl_noexcept_
+   {
+      return lhs._position != rhs._position;
+   }
+
+private:
+   _robin_hood_table_iterator(const TTable* table, size_t position) _sstl_noexcept_
+      : _table(table)
+      , _position(position)
+   {
+      _skip_empty();
+   }
+
+   void _skip_empty() _sstl_noexcept_
+   {
+      _position = _table->_first_occupied(_position);
+   }
+
+private:
+   const TTable* _table{ nullptr };
+   size_t _position{ 0 };
+};
+
+// the implementation shared by unordered_multimap and unordered_multiset: TKeyOfValue::get extracts
+// the key of a value and TIteratorValue is the value type seen through a non-const iterator
+// (const for sets). The derived containers provide the arrays of distances and slots.
+template<class TKey, class TValue, class TIteratorValue, class TKeyOfValue, class THash, class TKeyEqual>
+class _robin_hood_table
+{
+   template<class, class, class, class, class, class>
+   friend class _robin_hood_table;
+
+   template<class, class>
+   friend class _robin_hood_table_iterator;
+
+public:
+   using key_type = TKey;
+   using value_type = TValue;
+   using size_type = size_t;
+   using difference_type = ptrdiff_t;
+   using hasher = THash;
+   using key_equal = TKeyEqual;
+   using reference = value_type&;
+   using const_reference = const value_type&;
+   using pointer = value_type*;
+   using const_pointer = const value_type*;
+   using iterator = _robin_hood_table_iterator<_robin_hood_table, TIteratorValue>;
+   using const_iterator = _robin_hood_table_iterator<_robin_hood_table, const value_type>;
+
+private:
+   using _distance_type = _robin_hood_distance_t;
+
+   //heterogeneous lookup is enabled only if both the hasher and the key equality are transparent
+   template<class K>
+   using _enable_if_transparent = typename std::enable_if<_is_transparent<hasher>::value
+                                                          && _is_transparent<key_equal>::value, K>::type;
+
+public:
+   iterator begin() _sstl_noexcept_
+   {
+      return iterator(this, 0);
+   }
+
+   const_iterator begin() const _sstl_noexcept_
+   {
+      return const_iterator(this, 0);
+   }
+
+   const_iterator cbegin() const _sstl_noexcept_
+   {
+      return begin();
+   }
+
+   iterator end() _sstl_noexcept_
+   {
+      return iterator(this, _capacity);
+   }
+
+   const_iterator end() const _sstl_noexcept_
+   {
+      return const_iterator(this, _capacity);
+   }
+
+   const_iterator cend() const _sstl_noexcept_
+   {
+      return end();
+   }
+
+   bool empty() const _sstl_noexcept_
+   {
+      return _size == 0;
+   }
+
+   bool full() const _sstl_noexcept_
+   {
+      return _size == _max_size;
+   }
+
+   size_type size() const _sstl_noexcept_
+   {
+      return _size;
+   }
+
+   size_type max_size() const _sstl_noexcept_
+   {
+      return _max_size;
+   }
+
+   size_type capacity() const _sstl_noexcept_
+   {
+      return _max_size;
+   }
+
+   //number of slots of the table
+   size_type bucket_count() const _sstl_noexcept_
+   {
+      return _capacity;
+   }
+
+   float load_factor() const _sstl_noexcept_
+   {
+      return static_cast<float>(_size) / static_cast<float>(_capacity);
+   }
+
+   hasher hash_function() const
+   {
+      return _hash;
+   }
+
+   key_equal key_eq() const
+   {
+      return _key_equal;
+   }
+
+   void clear() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _destroy_values();
+      _reset_distances();
+   }
+
+   //the insertions invalidate the iterators, because the values of the cluster are shifted
+   iterator insert(const_reference value)
+   {
+      return _insert(value);
+   }
+
+   iterator insert(value_type&& value)
+   {
+      return _insert(std::move(value));
+   }
+
+   iterator insert(const_iterator, const_reference value)
+   {
+      return insert(value);
+   }
+
+   iterator insert(const_iterator, value_type&& value)
+   {
+      return insert(std::move(value));
+   }
+
+   template<class TIterator, class = typename std::enable_if<_is_input_iterator<TIterator>::value>::type>
+   void insert(TIterator range_begin, TIterator range_end)
+   {
+      while(range_begin != range_end)
+      {
+         insert(*range_begin);
+         ++range_begin;
+      }
+   }
+
+   void insert(std::initializer_list<value_type> init)
+   {
+      insert(init.begin(), init.end());
+   }
+
+   template<class... Args>
+   iterator emplace(Args&&... args)
+   {
+      return _insert(value_type(std::forward<Args>(args)...));
+   }
+
+   template<class... Args>
+   iterator emplace_hint(const_iterator, Args&&... args)
+   {
+      return emplace(std::forward<Args>(args)...);
+   }
+
+   //returns the iterator following the erased value (the values after it are shifted back
+   //by one slot, the iterators to them are invalidated)
+   iterator erase(const_iterator pos) _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      sstl_assert(pos._table == this && pos._position < _capacity);
+      _erase_at(_index_of(pos._position));
+      return iterator(this, pos._position);
+   }
+
+   iterator erase(const_iterator range_begin, const_iterator range_end)
+      _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      //the erased range is contiguous: each erasure shifts the following value back to the same position
+      auto count = std::distance(range_begin, range_end);
+      while(count-- > 0)
+      {
+         range_begin = erase(range_begin);
+      }
+      return iterator(this, range_begin._position);
+   }
+
+   size_type erase(const key_type& key)
+   {
+      auto idx = _find(key);
+      if(idx == _capacity)
+         return 0;
+      auto count = _count_equal_from(idx, key);
+      for(size_type i=0; i<count; ++i)
+      {
+         _erase_at(idx);
+      }
+      return count;
+   }
+
+   iterator find(const key_type& key)
+   {
+      return _iterator_at(_find(key));
+   }
+
+   const_iterator find(const key_type& key) const
+   {
+      return const_cast<_robin_hood_table&>(*this).find(key);
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   iterator find(const K& key)
+   {
+      return _iterator_at(_find(key));
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   const_iterator find(const K& key) const
+   {
+      return const_cast<_robin_hood_table&>(*this).find(key);
+   }
+
+   size_type count(const key_type& key) const
+   {
+      return const_cast<_robin_hood_table&>(*this)._count(key);
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   size_type count(const K& key) const
+   {
+      return const_cast<_robin_hood_table&>(*this)._count(key);
+   }
+
+   bool contains(const key_type& key) const
+   {
+      return const_cast<_robin_hood_table&>(*this)._find(key) != _capacity;
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   bool contains(const K& key) const
+   {
+      return const_cast<_robin_hood_table&>(*this)._find(key) != _capacity;
+   }
+
+   std::pair<iterator, iterator> equal_range(const key_type& key)
+   {
+      return _equal_range(key);
+   }
+
+   std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+   {
+      return const_cast<_robin_hood_table&>(*this).equal_range(key);
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   std::pair<iterator, iterator> equal_range(const K& key)
+   {
+      return _equal_range(key);
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   std::pair<const_iterator, const_iterator> equal_range(const K& key) const
+   {
+      return const_cast<_robin_hood_table&>(*this).equal_range(key);
+   }
+
+protected:
+   _robin_hood_table(_distance_type* distances, uint64_t* occupied, void* slots, size_type capacity,
+                     size_type max_size, const hasher& hash, const key_equal& equal)
+      : _distances(distances)
+      , _occupied(occupied)
+      , _slots(static_cast<value_type*>(slots))
+      , _capacity(capacity)
+      , _max_size(max_size)
+      , _hash(hash)
+      , _key_equal(equal)
+   {
+      _reset_distances();
+   }
+
+   _robin_hood_table(const _robin_hood_table&) = delete;
+   _robin_hood_table(_robin_hood_table&&) = delete;
+
+   ~_robin_hood_table() = default;
+
+   _robin_hood_table& operator=(const _robin_hood_table& rhs)
+   {
+      if(this != &rhs)
+      {
+         clear();
+         _hash = rhs._hash;
+         _key_equal = rhs._key_equal;
+         _assign_from(rhs);
+      }
+      return *this;
+   }
+
+   _robin_hood_table& operator=(_robin_hood_table&& rhs)
+   {
+      if(this != &rhs)
+      {
+         clear();
+         _hash = rhs._hash;
+         _key_equal = rhs._key_equal;
+         _assign_from(std::move(rhs));
+         rhs.clear();
+      }
+      return *this;
+   }
+
+   void _destructor() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _destroy_values();
+   }
+
+   //copies (or moves) the values of rhs, this must be empty
+   template<class TTable>
+   void _assign_from(TTable&& rhs)
+   {
+      using rhs_value_reference = typename std::conditional<std::is_lvalue_reference<TTable>::value,
+                                                            const value_type&,
+                                                            value_type&&>::type;
+      sstl_assert(empty());
+      sstl_assert(rhs.size() <= _max_size);
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         if(rhs._capacity == _capacity)
+         {
+            //same layout: the values keep their slots, no hashing required
+            for(size_type idx=0; idx<_capacity; ++idx)
+            {
+               if(rhs._distances[idx] != 0)
+               {
+                  new(_slots + idx) value_type(static_cast<rhs_value_reference>(rhs._slots[idx]));
+                  _distances[idx] = rhs._distances[idx];
+                  ++_size;
+               }
+            }
+            std::copy(rhs._occupied, rhs._occupied + _occupied_words(), _occupied);
+            _anchor = rhs._anchor;
+         }
+         else
+         {
+            //in iteration order, to keep the order of the equivalent values
+            for(size_type position=0; position<rhs._capacity; ++position)
+            {
+               auto idx = rhs._index_of(position);
+               if(rhs._distances[idx] != 0)
+               {
+                  _insert(static_cast<rhs_value_reference>(rhs._slots[idx]));
+               }
+            }
+         }
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         clear();
+         throw;
+      }
+      #endif
+   }
+
+private:
+   size_type _next(size_type idx) const _sstl_noexcept_
+   {
+      return (idx + 1) & (_capacity - 1);
+   }
+
+   size_type _previous(size_type idx) const _sstl_noexcept_
+   {
+      return (idx - 1) & (_capacity - 1);
+   }
+
+   //the iteration visits the slots from the one following the anchor
+   size_type _index_of(size_type position) const _sstl_noexcept_
+   {
+      return (_anchor + 1 + position) & (_capacity - 1);
+   }
+
+   size_type _position_of(size_type idx) const _sstl_noexcept_
+   {
+      return (idx - _anchor - 1) & (_capacity - 1);
+   }
+
+   //the first position, starting from the given one, of an occupied slot (_capacity if there is none)
+   size_type _first_occupied(size_type position) const _sstl_noexcept_
+   {
+      while(position < _capacity)
+      {
+         auto idx = _index_of(position);
+         auto bits = _occupied[idx / 64] >> (idx % 64);
+         if(bits != 0)
+         {
+            //past the anchor if the iteration wrapped around
+            return std::min(position + _countr_zero(bits), _capacity);
+         }
+         position += std::min(64 - idx % 64, _capacity - idx);
+      }
+      return _capacity;
+   }
+
+   size_type _occupied_words() const _sstl_noexcept_
+   {
+      return (_capacity + 63) / 64;
+   }
+
+   void _set_occupied(size_type idx) _sstl_noexcept_
+   {
+      _occupied[idx / 64] |= uint64_t{ 1 } << (idx % 64);
+   }
+
+   void _reset_occupied(size_type idx) _sstl_noexcept_
+   {
+      _occupied[idx / 64] &= ~(uint64_t{ 1 } << (idx % 64));
+   }
+
+   iterator _iterator_at(size_type idx) _sstl_noexcept_
+   {
+      return iterator(this, idx == _capacity ? _capacity : _position_of(idx));
+   }
+
+   template<class K>
+   size_type _home_of(const K& key) const
+   {
+      return _hash_finalize<hasher>(static_cast<size_type>(_hash(key))) & (_capacity - 1);
+   }
+
+   void _reset_distances() _sstl_noexcept_
+   {
+      std::fill(_distances, _distances + _capacity, _distance_type{ 0 });
+      std::fill(_occupied, _occupied + _occupied_words(), uint64_t{ 0 });
+      _size = 0;
+      _anchor = 0;
+   }
+
+   void _destroy_values() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      if(std::is_trivially_destructible<value_type>::value)
+         return;
+      for(size_type idx=0; idx<_capacity; ++idx)
+      {
+         if(_distances[idx] != 0)
+         {
+            _slots[idx].~value_type();
+         }
+      }
+   }
+
+   //index of the first value with an equivalent key (_capacity if there is none)
+   template<class K>
+   size_type _find(const K& key)
+   {
+      auto idx = _home_of(key);
+      for(_distance_type distance = 1; ; ++distance)
+      {
+         auto stored = _distances[idx];
+         //an empty slot or a richer value: the key would have been placed here
+         if(stored < distance)
+            return _capacity;
+         if(stored == distance && _key_equal(key, TKeyOfValue::get(_slots[idx])))
+            return idx;
+         idx = _next(idx);
+      }
+   }
+
+   //number of values with a key equivalent to the one of the first value at idx
+   template<class K>
+   size_type _count_equal_from(size_type idx, const K& key)
+   {
+      auto distance = _distances[idx];
+      size_type count = 0;
+      do
+      {
+         ++count;
+         ++distance;
+         idx = _next(idx);
+      } while(_distances[idx] == distance && _key_equal(key, TKeyOfValue::get(_slots[idx])));
+      return count;
+   }
+
+   template<class K>
+   size_type _count(const K& key)
+   {
+      auto idx = _find(key);
+      return idx == _capacity ? 0 : _count_equal_from(idx, key);
+   }
+
+   template<class K>
+   std::pair<iterator, iterator> _equal_range(const K& key)
+   {
+      auto idx = _find(key);
+      if(idx == _capacity)
+         return std::make_pair(end(), end());
+      auto position = _position_of(idx);
+      return std::make_pair(iterator(this, position), iterator(this, position + _count_equal_from(idx, key)));
+   }
+
+   template<class TValueReference>
+   iterator _insert(TValueReference&& value)
+   {
+      sstl_assert(!full());
+      if(_is_in_table(value))
+      {
+         //the value would be moved around while making room for its copy
+         return _insert(value_type(value));
+      }
+      const auto& key = TKeyOfValue::get(value);
+      auto idx = _home_of(key);
+      _distance_type distance = 1;
+      while(true)
+      {
+         auto stored = _distances[idx];
+         if(stored < distance)
+            break;
+         if(stored == distance && _key_equal(key, TKeyOfValue::get(_slots[idx])))
+         {
+            //after the values with an equivalent key
+            do
+            {
+               ++distance;
+               idx = _next(idx);
+            } while(_distances[idx] == distance && _key_equal(key, TKeyOfValue::get(_slots[idx])));
+            break;
+         }
+         ++distance;
+         idx = _next(idx);
+      }
+
+      _make_room(idx);
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         new(_slots + idx) value_type(std::forward<TValueReference>(value));
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         _close_gap(idx);
+         throw;
+      }
+      #endif
+      _distances[idx] = distance;
+      ++_size;
+      return _iterator_at(idx);
+   }
+
+   bool _is_in_table(const value_type& value) const _sstl_noexcept_
+   {
+      auto less = std::less<const value_type*>();
+      return !less(&value, _slots) && less(&value, _slots + _capacity);
+   }
+
+   //shifts the values from idx to the end of the cluster forward by one slot
+   void _make_room(size_type idx)
+   {
+      auto last = idx;
+      while(_distances[last] != 0)
+      {
+         last = _next(last);
+      }
+      //the cluster grows by one slot
+      _set_occupied(last);
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         while(last != idx)
+         {
+            auto previous = _previous(last);
+            new(_slots + last) value_type(std::move(_slots[previous]));
+            _distances[last] = _distances[previous] + 1;
+            _slots[previous].~value_type();
+            _distances[previous] = 0;
+            last = previous;
+         }
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         //the cluster has a hole: the table can't be repaired without moving values
+         clear();
+         throw;
+      }
+      #endif
+      //the anchor must stay empty
+      if(_distances[_anchor] != 0 || (_anchor == idx))
+      {
+         do
+         {
+            _anchor = _next(_anchor);
+         } while(_distances[_anchor] != 0 || _anchor == idx);
+      }
+   }
+
+   void _erase_at(size_type idx) _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _slots[idx].~value_type();
+      _distances[idx] = 0;
+      --_size;
+      _close_gap(idx);
+   }
+
+   //backward-shift: moves the values after the empty slot idx back by one slot, up to
+   //the end of the cluster or to a value in its home slot
+   void _close_gap(size_type idx) _sstl_noexcept(std::is_nothrow_move_constructible<value_type>::value
+                                                 && std::is_nothrow_destructible<value_type>::value)
+   {
+      auto next = _next(idx);
+      while(_distances[next] > 1)
+      {
+         new(_slots + idx) value_type(std::move(_slots[next]));
+         _distances[idx] = _distances[next] - 1;
+         _slots[next].~value_type();
+         _distances[next] = 0;
+         idx = next;
+         next = _next(next);
+      }
+      //the cluster shrinks by one slot
+      _reset_occupied(idx);
+   }
+
+private:
+   _distance_type* _distances;
+   uint64_t* _occupied;
+   value_type* _slots;
+   size_type _capacity;
+   size_type _max_size;
+   size_type _size{ 0 };
+   size_type _anchor{ 0 };
+   hasher _hash;
+   key_equal _key_equal;
+};
+
+template<class TKey, class TValue, class TIteratorValue, class TKeyOfValue, class THash, class TKeyEqual>
+bool operator==(const _robin_hood_table<TKey, TValue, TIteratorValue, TKeyOfValue, THash, TKeyEqual>& lhs,
+                const _robin_hood_table<TKey, TValue, TIteratorValue, TKeyOfValue, THash, TKeyEqual>& rhs)
+{
+   if(lhs.size() != rhs.size())
+      return false;
+   //the values with equivalent keys must be permutations of each other
+   for(auto it = lhs.begin(); it != lhs.end();)
+   {
+      auto lhs_range = lhs.equal_range(TKeyOfValue::get(*it));
+      auto rhs_range = rhs.equal_range(TKeyOfValue::get(*it));
+      if(std::distance(lhs_range.first, lhs_range.second) != std::distance(rhs_range.first, rhs_range.second)
+         || !std::is_permutation(lhs_range.first, lhs_range.second, rhs_range.first))
+         return false;
+      it = lhs_range.second;
+   }
+   return true;
+}
+
+template<class TKey, class TValue, class TIteratorValue, class TKeyOfValue, class THash, class TKeyEqual>
+bool operator!=(const _robin_hood_table<TKey, TValue, TIteratorValue, TKeyOfValue, THash, TKeyEqual>& lhs,
+                const _robin_hood_table<TKey, TValue, TIteratorValue, TKeyOfValue, THash, TKeyEqual>& rhs)
+{
+   return !(lhs == rhs);
+}
+
+}
+
+#endif
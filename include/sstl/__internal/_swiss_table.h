@@ -0,0 +1,970 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_SWISS_TABLE__
+#define _SSTL_SWISS_TABLE__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+#include <initializer_list>
+#include <array>
+
+#include <sstl_assert.h>
+
+#include "_preprocessor.h"
+#include "_except.h"
+#include "_utility.h"
+#include "_iterator.h"
+#include "_bit_width.h"
+#include "_aligned_storage.h"
+#include "_hash_mix.h"
+
+#if !defined(_SSTL_DISABLE_SIMD) && (defined(__SSE2__) || (_is_msvc() && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))))
+   #define _sstl_swiss_table_has_sse2() 1
+   #include <emmintrin.h>
+#else
+   #define _sstl_swiss_table_has_sse2() 0
+#endif
+
+namespace sstl
+{
+
+// Open addressing hash table with one metadata byte per slot ("Swiss table", as in abseil's
+// flat_hash_map). The control byte of a slot is either empty, deleted (tombstone) or, if
+// the slot is full, the 7 lowest bits of the hash of its value (h2). The rest of the hash (h1)
+// selects the group of control bytes where the probing starts; a lookup compares the h2 of the
+// key against a whole group at once (16 bytes with SSE2, 8 bytes with the portable SWAR
+// fallback) and compares keys only for the matching slots.
+// The number of slots is a power of two minus one: the control byte after the last slot is a
+// sentinel that stops the iterators and the first group-width-1 control bytes are cloned after
+// the sentinel, so that a group can be loaded at any slot without wrapping around.
+// The table does not grow: the derived containers size their arrays at compile time for the
+// requested number of values with a maximum load factor of 7/8. Once the tombstones have eaten
+// up the spare empty slots, they are dropped by rehashing in place.
+
+using _ctrl_t = signed char;
+
+enum _ctrl_value : _ctrl_t
+{
+   _ctrl_empty = -128,
+   _ctrl_deleted = -2,
+   _ctrl_sentinel = -1
+};
+
+// mask of the control bytes of a group that matched, SHIFT is log2 of the number of bits per byte
+template<class T, size_t SIGNIFICANT_BITS, size_t SHIFT>
+class _ctrl_bitmask
+{
+public:
+   explicit _ctrl_bitmask(T mask) _sstl_noexcept_
+      : _mask(mask)
+   {}
+
+   explicit operator bool() const _sstl_noexcept_
+   {
+      return _mask != 0;
+   }
+
+   //position of the first matching byte (also the number of non-matching bytes at the beginning)
+   size_t lowest() const _sstl_noexcept_
+   {
+      return _countr_zero(_mask) >> SHIFT;
+   }
+
+   void clear_lowest() _sstl_noexcept_
+   {
+      _mask &= _mask - 1;
+   }
+
+   //number of non-matching bytes at the end
+   size_t leading_zeros() const _sstl_noexcept_
+   {
+      return (SIGNIFICANT_BITS - _bit_width(_mask)) >> SHIFT;
+   }
+
+private:
+   T _mask;
+};
+
+#if _sstl_swiss_table_has_sse2()
+class _ctrl_group
+{
+public:
+   static const size_t width = 16;
+   using bitmask = _ctrl_bitmask<uint32_t, 16, 0>;
+
+public:
+   explicit _ctrl_group(const _ctrl_t* pos) _sstl_noexcept_
+      : _ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos)))
+   {}
+
+   bitmask match(_ctrl_t h2) const _sstl_noexcept_
+   {
+      return bitmask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl))));
+   }
+
+   bitmask match_empty() const _sstl_noexcept_
+   {
+      return match(_ctrl_empty);
+   }
+
+   bitmask match_empty_or_deleted() const _sstl_noexcept_
+   {
+      //empty and deleted are the only values smaller than the sentinel
+      return bitmask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(_ctrl_sentinel), _ctrl))));
+   }
+
+   size_t count_leading_empty_or_deleted() const _sstl_noexcept_
+   {
+      auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(_ctrl_sentinel), _ctrl)));
+      return _countr_zero(mask + 1);
+   }
+
+private:
+   __m128i _ctrl;
+};
+#else
+//SWAR ("SIMD within a register") version: the match of a byte is reported in its most significant bit
+class _ctrl_group
+{
+public:
+   static const size_t width = 8;
+   using bitmask = _ctrl_bitmask<uint64_t, 64, 3>;
+
+public:
+   explicit _ctrl_group(const _ctrl_t* pos) _sstl_noexcept_
+   {
+      //little-endian load regardless of the platform's endianness (compiled to a single load on little-endian CPUs)
+      _ctrl = 0;
+      for(size_t i=0; i<width; ++i)
+      {
+         _ctrl |= static_cast<uint64_t>(static_cast<uint8_t>(pos[i])) << (8*i);
+      }
+   }
+
+   //may report false positives after a true match, they are filtered out by the key comparison
+   bitmask match(_ctrl_t h2) const _sstl_noexcept_
+   {
+      auto x = _ctrl ^ (_lsbs * static_cast<uint8_t>(h2));
+      return bitmask((x - _lsbs) & ~x & _msbs);
+   }
+
+   bitmask match_empty() const _sstl_noexcept_
+   {
+      //only empty has the most significant bit set and the second least significant bit clear
+      return bitmask(_ctrl & (~_ctrl << 6) & _msbs);
+   }
+
+   bitmask match_empty_or_deleted() const _sstl_noexcept_
+   {
+      //only empty and deleted have the most significant bit set and the least significant bit clear
+      return bitmask(_ctrl & (~_ctrl << 7) & _msbs);
+   }
+
+   size_t count_leading_empty_or_deleted() const _sstl_noexcept_
+   {
+      auto others = ~(_ctrl & (~_ctrl << 7)) & _msbs;
+      return others != 0 ? _countr_zero(others) >> 3 : width;
+   }
+
+private:
+   static const uint64_t _lsbs = 0x0101010101010101ull;
+   static const uint64_t _msbs = 0x8080808080808080ull;
+   uint64_t _ctrl;
+};
+#endif
+
+// triangular probing over groups: visits every group once, because the number of slots plus one
+// is a power of two multiple of the group width
+class _probe_sequence
+{
+public:
+   _probe_sequence(size_t h1, size_t mask) _sstl_noexcept_
+      : _mask(mask)
+      , _offset(h1 & mask)
+   {}
+
+   size_t offset() const _sstl_noexcept_
+   {
+      return _offset;
+   }
+
+   size_t offset(size_t i) const _sstl_noexcept_
+   {
+      return (_offset + i) & _mask;
+   }
+
+   void next() _sstl_noexcept_
+   {
+      _index += _ctrl_group::width;
+      _offset = (_offset + _index) & _mask;
+   }
+
+   size_t index() const _sstl_noexcept_
+   {
+      return _index;
+   }
+
+private:
+   size_t _mask;
+   size_t _offset;
+   size_t _index{ 0 };
+};
+
+// number of slots of a table that holds up to MAX_SIZE values:
+// the smallest power of two minus one (and at least a group) with enough room at 7/8 load
+template<size_t MAX_SIZE>
+struct _swiss_table_capacity
+{
+   static constexpr size_t growth(size_t capacity)
+   {
+      //a table of 7 slots must keep an empty slot as well
+      return capacity == 7 ? 6 : capacity - capacity / 8;
+   }
+
+   static constexpr size_t compute(size_t capacity)
+   {
+      return growth(capacity) >= MAX_SIZE ? capacity : compute(capacity * 2 + 1);
+   }
+
+   static const size_t value = compute(_ctrl_group::width - 1);
+   static const size_t number_of_ctrl_bytes = value + _ctrl_group::width;
+};
+
+// the arrays of a table that holds up to MAX_SIZE values, a base class of the derived containers
+// (listed before the table, so that the arrays are constructed when the table initializes them)
+template<class TValue, size_t MAX_SIZE>
+struct _swiss_table_storage
+{
+   using _table_capacity = _swiss_table_capacity<MAX_SIZE>;
+
+   std::array<_ctrl_t, _table_capacity::number_of_ctrl_bytes> _ctrl_;
+   std::array<typename _aligned_storage<sizeof(TValue), std::alignment_of<TValue>::value>::type, _table_capacity::value> _slots_;
+};
+
+template<class T>
+class _swiss_table_iterator
+{
+   template<class, class, class, class, class, class>
+   friend class _swiss_table;
+
+   template<class>
+   friend class _swiss_table_iterator;
+
+public:
+   using iterator_category = std::forward_iterator_tag;
+   using value_type = typename std::remove_const<T>::type;
+   using difference_type = ptrdiff_t;
+   using pointer = T*;
+   using reference = T&;
+
+public:
+   _swiss_table_iterator() _sstl_noexcept_ = default;
+
+   //conversion from iterator to const_iterator
+   template<class U, class = typename std::enable_if<std::is_same<const U, T>::value && !std::is_same<U, T>::value>::type>
+   _swiss_table_iterator(const _swiss_table_iterator<U>& rhs) _sstl_noexcept_
+      : _ctrl(rhs._ctrl)
+      , _slot(rhs._slot)
+   {}
+
+   reference operator*() const _sstl_noexcept_
+   {
+      sstl_assert(_ctrl != nullptr && *_ctrl >= 0);
+      return *_slot;
+   }
+
+   pointer operator->() const _sstl_noexcept_
+   {
+      sstl_assert(_ctrl != nullptr && *_ctrl >= 0);
+      return _slot;
+   }
+
+   _swiss_table_iterator& operator++() _sstl_noexcept_
+   {
+      sstl_assert(_ctrl != nullptr && *_ctrl != _ctrl_sentinel);
+      ++_ctrl;
+      ++_slot;
+      _skip_empty_or_deleted();
+      return *this;
+   }
+
+   _swiss_table_iterator operator++(int) _sstl_noexcept_
+   {
+      auto tmp = *this;
+      ++(*this);
+      return tmp;
+   }
+
+   friend bool operator==(const _swiss_table_iterator& lhs, const _swiss_table_iterator& rhs) _sstl_noexcept_
+   {
+      return lhs._ctrl == rhs._ctrl;
+   }
+
+   friend bool operator!=(const _swiss_table_iterator& lhs, const _swiss_table_iterator& rhs) _sstl_noexcept_
+   {
+      return lhs._ctrl != rhs._ctrl;
+   }
+
+private:
+   _swiss_table_iterator(const _ctrl_t* ctrl, T* slot) _sstl_noexcept_
+      : _ctrl(ctrl)
+      , _slot(slot)
+   {}
+
+   void _skip_empty_or_deleted() _sstl_noexcept_
+   {
+      while(*_ctrl < _ctrl_sentinel)
+      {
+         auto count = _ctrl_group(_ctrl).count_leading_empty_or_deleted();
+         _ctrl += count;
+         _slot += count;
+      }
+   }
+
+private:
+   const _ctrl_t* _ctrl{ nullptr };
+   T* _slot{ nullptr };
+};
+
+// the implementation shared by unordered_map and unordered_set: TKeyOfValue::get extracts the
+// key of a value and TIteratorValue is the value type seen through a non-const iterator
+// (const for sets). The derived containers provide the arrays of control bytes and slots.
+template<class TKey, class TValue, class TIteratorValue, class TKeyOfValue, class THash, class TKeyEqual>
+class _swiss_table
+{
+   template<class, class, class, class, class, class>
+   friend class _swiss_table;
+
+public:
+   using key_type = TKey;
+   using value_type = TValue;
+   using size_type = size_t;
+   using difference_type = ptrdiff_t;
+   using hasher = THash;
+   using key_equal = TKeyEqual;
+   using reference = value_type&;
+   using const_reference = const value_type&;
+   using pointer = value_type*;
+   using const_pointer = const value_type*;
+   using iterator = _swiss_table_iterator<TIteratorValue>;
+   using const_iterator = _swiss_table_iterator<const value_type>;
+
+private:
+   using _slot_type = value_type;
+
+   //heterogeneous lookup is enabled only if both the hasher and the key equality are transparent
+   template<class K>
+   using _enable_if_transparent = typename std::enable_if<_is_transparent<hasher>::value
+                                                          && _is_transparent<key_equal>::value, K>::type;
+
+public:
+   iterator begin() _sstl_noexcept_
+   {
+      auto it = iterator(_ctrl, _slots);
+      it._skip_empty_or_deleted();
+      return it;
+   }
+
+   const_iterator begin() const _sstl_noexcept_
+   {
+      return const_cast<_swiss_table&>(*this).begin();
+   }
+
+   const_iterator cbegin() const _sstl_noexcept_
+   {
+      return begin();
+   }
+
+   iterator end() _sstl_noexcept_
+   {
+      return iterator(_ctrl + _capacity, _slots + _capacity);
+   }
+
+   const_iterator end() const _sstl_noexcept_
+   {
+      return const_cast<_swiss_table&>(*this).end();
+   }
+
+   const_iterator cend() const _sstl_noexcept_
+   {
+      return end();
+   }
+
+   bool empty() const _sstl_noexcept_
+   {
+      return _size == 0;
+   }
+
+   bool full() const _sstl_noexcept_
+   {
+      return _size == _max_size;
+   }
+
+   size_type size() const _sstl_noexcept_
+   {
+      return _size;
+   }
+
+   size_type max_size() const _sstl_noexcept_
+   {
+      return _max_size;
+   }
+
+   size_type capacity() const _sstl_noexcept_
+   {
+      return _max_size;
+   }
+
+   //number of slots of the table
+   size_type bucket_count() const _sstl_noexcept_
+   {
+      return _capacity;
+   }
+
+   float load_factor() const _sstl_noexcept_
+   {
+      return static_cast<float>(_size) / static_cast<float>(_capacity);
+   }
+
+   hasher hash_function() const
+   {
+      return _hash;
+   }
+
+   key_equal key_eq() const
+   {
+      return _key_equal;
+   }
+
+   void clear() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _destroy_values();
+      _reset_ctrl();
+      _size = 0;
+   }
+
+   std::pair<iterator, bool> insert(const_reference value)
+   {
+      return _insert(value);
+   }
+
+   std::pair<iterator, bool> insert(value_type&& value)
+   {
+      return _insert(std::move(value));
+   }
+
+   iterator insert(const_iterator, const_reference value)
+   {
+      return insert(value).first;
+   }
+
+   iterator insert(const_iterator, value_type&& value)
+   {
+      return insert(std::move(value)).first;
+   }
+
+   template<class TIterator, class = typename std::enable_if<_is_input_iterator<TIterator>::value>::type>
+   void insert(TIterator range_begin, TIterator range_end)
+   {
+      while(range_begin != range_end)
+      {
+         insert(*range_begin);
+         ++range_begin;
+      }
+   }
+
+   void insert(std::initializer_list<value_type> init)
+   {
+      insert(init.begin(), init.end());
+   }
+
+   //the value is constructed before the lookup (as required for maps by the standard),
+   //use try_emplace to construct the mapped value only if the key is not present
+   template<class... Args>
+   std::pair<iterator, bool> emplace(Args&&... args)
+   {
+      return _insert(value_type(std::forward<Args>(args)...));
+   }
+
+   template<class... Args>
+   iterator emplace_hint(const_iterator, Args&&... args)
+   {
+      return emplace(std::forward<Args>(args)...).first;
+   }
+
+   iterator erase(const_iterator pos) _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      sstl_assert(pos._ctrl != nullptr && *pos._ctrl >= 0);
+      auto idx = static_cast<size_type>(pos._ctrl - _ctrl);
+      _erase_at(idx);
+      auto it = iterator(_ctrl + idx, _slots + idx);
+      it._skip_empty_or_deleted();
+      return it;
+   }
+
+   iterator erase(const_iterator range_begin, const_iterator range_end)
+      _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      while(range_begin != range_end)
+      {
+         range_begin = erase(range_begin);
+      }
+      return iterator(const_cast<_ctrl_t*>(range_end._ctrl), const_cast<TIteratorValue*>(range_end._slot));
+   }
+
+   size_type erase(const key_type& key)
+   {
+      auto idx = _find(key);
+      if(idx == _capacity)
+         return 0;
+      _erase_at(idx);
+      return 1;
+   }
+
+   iterator find(const key_type& key)
+   {
+      return _iterator_at(_find(key));
+   }
+
+   const_iterator find(const key_type& key) const
+   {
+      return const_cast<_swiss_table&>(*this).find(key);
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   iterator find(const K& key)
+   {
+      return _iterator_at(_find(key));
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   const_iterator find(const K& key) const
+   {
+      return const_cast<_swiss_table&>(*this).find(key);
+   }
+
+   size_type count(const key_type& key) const
+   {
+      return contains(key) ? 1 : 0;
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   size_type count(const K& key) const
+   {
+      return contains(key) ? 1 : 0;
+   }
+
+   bool contains(const key_type& key) const
+   {
+      return const_cast<_swiss_table&>(*this)._find(key) != _capacity;
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   bool contains(const K& key) const
+   {
+      return const_cast<_swiss_table&>(*this)._find(key) != _capacity;
+   }
+
+   std::pair<iterator, iterator> equal_range(const key_type& key)
+   {
+      return _equal_range(find(key));
+   }
+
+   std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+   {
+      return const_cast<_swiss_table&>(*this).equal_range(key);
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   std::pair<iterator, iterator> equal_range(const K& key)
+   {
+      return _equal_range(find(key));
+   }
+
+   template<class K, class = _enable_if_transparent<K>>
+   std::pair<const_iterator, const_iterator> equal_range(const K& key) const
+   {
+      return const_cast<_swiss_table&>(*this).equal_range(key);
+   }
+
+protected:
+   _swiss_table(_ctrl_t* ctrl, void* slots, size_type capacity, size_type max_size,
+                const hasher& hash, const key_equal& equal)
+      : _ctrl(ctrl)
+      , _slots(static_cast<_slot_type*>(slots))
+      , _capacity(capacity)
+      , _max_size(max_size)
+      , _hash(hash)
+      , _key_equal(equal)
+   {
+      _reset_ctrl();
+   }
+
+   _swiss_table(const _swiss_table&) = delete;
+   _swiss_table(_swiss_table&&) = delete;
+
+   ~_swiss_table() = default;
+
+   _swiss_table& operator=(const _swiss_table& rhs)
+   {
+      if(this != &rhs)
+      {
+         clear();
+         _hash = rhs._hash;
+         _key_equal = rhs._key_equal;
+         _assign_from(rhs);
+      }
+      return *this;
+   }
+
+   _swiss_table& operator=(_swiss_table&& rhs)
+   {
+      if(this != &rhs)
+      {
+         clear();
+         _hash = rhs._hash;
+         _key_equal = rhs._key_equal;
+         _assign_from(std::move(rhs));
+         rhs.clear();
+      }
+      return *this;
+   }
+
+   void _destructor() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _destroy_values();
+   }
+
+   //copies (or moves) the values of rhs, this must be empty
+   template<class TTable>
+   void _assign_from(TTable&& rhs)
+   {
+      using rhs_value_reference = typename std::conditional<std::is_lvalue_reference<TTable>::value,
+                                                            const value_type&,
+                                                            value_type&&>::type;
+      sstl_assert(empty());
+      sstl_assert(rhs.size() <= _max_size);
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         if(rhs._capacity == _capacity)
+         {
+            //same layout: the values keep their slots, no hashing required
+            for(size_type idx=0; idx<_capacity; ++idx)
+            {
+               if(rhs._ctrl[idx] >= 0)
+               {
+                  new(_slots + idx) value_type(static_cast<rhs_value_reference>(rhs._slots[idx]));
+                  _set_ctrl(idx, rhs._ctrl[idx]);
+                  ++_size;
+               }
+            }
+            _growth_left = _growth() - _size;
+         }
+         else
+         {
+            for(size_type idx=0; idx<rhs._capacity; ++idx)
+            {
+               if(rhs._ctrl[idx] >= 0)
+               {
+                  _insert(static_cast<rhs_value_reference>(rhs._slots[idx]));
+               }
+            }
+         }
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         clear();
+         throw;
+      }
+      #endif
+   }
+
+   template<class K>
+   size_type _hash_of(const K& key) const
+   {
+      return _hash_finalize<hasher>(static_cast<size_type>(_hash(key)));
+   }
+
+   //looks up the key and, if it is not present, returns the slot where it must be inserted
+   //(the control byte is set by _commit_insert, after the value has been constructed)
+   template<class K>
+   std::pair<size_type, bool> _find_or_prepare_insert(const K& key, size_type hash)
+   {
+      auto idx = _find(key, hash);
+      if(idx != _capacity)
+         return std::make_pair(idx, true);
+      return std::make_pair(_prepare_insert(hash), false);
+   }
+
+   void _commit_insert(size_type idx, size_type hash) _sstl_noexcept_
+   {
+      _growth_left -= _ctrl[idx] == _ctrl_empty ? 1 : 0;
+      _set_ctrl(idx, _h2(hash));
+      ++_size;
+   }
+
+   iterator _iterator_at(size_type idx) _sstl_noexcept_
+   {
+      return iterator(_ctrl + idx, _slots + idx);
+   }
+
+   reference _value_at(size_type idx) _sstl_noexcept_
+   {
+      return _slots[idx];
+   }
+
+   template<class K>
+   size_type _find(const K& key)
+   {
+      return _find(key, _hash_of(key));
+   }
+
+   template<class K>
+   size_type _find(const K& key, size_type hash)
+   {
+      auto sequence = _probe_sequence(_h1(hash), _capacity);
+      while(true)
+      {
+         auto group = _ctrl_group(_ctrl + sequence.offset());
+         for(auto match = group.match(_h2(hash)); match; match.clear_lowest())
+         {
+            auto idx = sequence.offset(match.lowest());
+            if(_key_equal(key, TKeyOfValue::get(_slots[idx])))
+               return idx;
+         }
+         if(group.match_empty())
+            return _capacity;
+         sequence.next();
+         sstl_assert(sequence.index() <= _capacity);
+      }
+   }
+
+private:
+   static size_type _h1(size_type hash) _sstl_noexcept_
+   {
+      return hash >> 7;
+   }
+
+   static _ctrl_t _h2(size_type hash) _sstl_noexcept_
+   {
+      return static_cast<_ctrl_t>(hash & 0x7f);
+   }
+
+   size_type _growth() const _sstl_noexcept_
+   {
+      return _swiss_table_capacity<1>::growth(_capacity);
+   }
+
+   //sets the control byte and its clone
+   void _set_ctrl(size_type idx, _ctrl_t value) _sstl_noexcept_
+   {
+      const auto cloned = _ctrl_group::width - 1;
+      _ctrl[idx] = value;
+      _ctrl[((idx - cloned) & _capacity) + cloned] = value;
+   }
+
+   void _reset_ctrl() _sstl_noexcept_
+   {
+      std::memset(_ctrl, static_cast<uint8_t>(_ctrl_empty), _capacity + _ctrl_group::width);
+      _ctrl[_capacity] = _ctrl_sentinel;
+      _growth_left = _growth();
+   }
+
+   void _destroy_values() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      if(std::is_trivially_destructible<value_type>::value)
+         return;
+      for(size_type idx=0; idx<_capacity; ++idx)
+      {
+         if(_ctrl[idx] >= 0)
+         {
+            _slots[idx].~value_type();
+         }
+      }
+   }
+
+   template<class TValueReference>
+   std::pair<iterator, bool> _insert(TValueReference&& value)
+   {
+      auto& key = TKeyOfValue::get(value);
+      auto hash = _hash_of(key);
+      auto result = _find_or_prepare_insert(key, hash);
+      if(!result.second)
+      {
+         new(_slots + result.first) value_type(std::forward<TValueReference>(value));
+         _commit_insert(result.first, hash);
+      }
+      return std::make_pair(_iterator_at(result.first), !result.second);
+   }
+
+   size_type _find_first_non_full(size_type hash) const _sstl_noexcept_
+   {
+      auto sequence = _probe_sequence(_h1(hash), _capacity);
+      while(true)
+      {
+         auto match = _ctrl_group(_ctrl + sequence.offset()).match_empty_or_deleted();
+         if(match)
+            return sequence.offset(match.lowest());
+         sequence.next();
+         sstl_assert(sequence.index() <= _capacity);
+      }
+   }
+
+   size_type _prepare_insert(size_type hash)
+   {
+      sstl_assert(!full());
+      auto idx = _find_first_non_full(hash);
+      if(_growth_left == 0 && _ctrl[idx] == _ctrl_empty)
+      {
+         //the remaining empty slots are needed to stop the probing: reclaim the tombstones
+         _drop_deleted();
+         idx = _find_first_non_full(hash);
+      }
+      return idx;
+   }
+
+   void _erase_at(size_type idx) _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _slots[idx].~value_type();
+      --_size;
+      //if no group that contains the slot has ever been full, no probing went past the slot
+      //and it can be marked as empty instead of deleted
+      auto before = (idx - _ctrl_group::width) & _capacity;
+      auto empty_after = _ctrl_group(_ctrl + idx).match_empty();
+      auto empty_before = _ctrl_group(_ctrl + before).match_empty();
+      auto was_never_full = empty_before && empty_after
+                            && empty_after.lowest() + empty_before.leading_zeros() < _ctrl_group::width;
+      _set_ctrl(idx, was_never_full ? _ctrl_empty : _ctrl_deleted);
+      _growth_left += was_never_full ? 1 : 0;
+   }
+
+   //rehashes in place: the full slots are marked deleted and the deleted slots empty, then
+   //each value marked deleted is moved to its first non-full slot (or stays if that is in the
+   //same group), swapping places with a value still to be rehashed if necessary
+   void _drop_deleted()
+   {
+      for(size_type idx=0; idx<_capacity; ++idx)
+      {
+         _ctrl[idx] = _ctrl[idx] >= 0 ? _ctrl_deleted : _ctrl_empty;
+      }
+      std::memcpy(_ctrl + _capacity + 1, _ctrl, _ctrl_group::width - 1);
+      _ctrl[_capacity] = _ctrl_sentinel;
+
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         for(size_type idx=0; idx<_capacity; ++idx)
+         {
+            if(_ctrl[idx] != _ctrl_deleted)
+               continue;
+            auto hash = _hash_of(TKeyOfValue::get(_slots[idx]));
+            auto new_idx = _find_first_non_full(hash);
+            auto probe_offset = _probe_sequence(_h1(hash), _capacity).offset();
+            auto group_of = [this, probe_offset](size_type i)
+            {
+               return ((i - probe_offset) & _capacity) / _ctrl_group::width;
+            };
+            if(group_of(new_idx) == group_of(idx))
+            {
+               _set_ctrl(idx, _h2(hash));
+            }
+            else if(_ctrl[new_idx] == _ctrl_empty)
+            {
+               new(_slots + new_idx) value_type(std::move(_slots[idx]));
+               _set_ctrl(new_idx, _h2(hash));
+               _slots[idx].~value_type();
+               _set_ctrl(idx, _ctrl_empty);
+            }
+            else
+            {
+               //the target holds a value still to be rehashed: swap and process idx again
+               value_type tmp(std::move(_slots[idx]));
+               _set_ctrl(idx, _ctrl_empty);
+               _slots[idx].~value_type();
+               new(_slots + idx) value_type(std::move(_slots[new_idx]));
+               _set_ctrl(idx, _ctrl_deleted);
+               _set_ctrl(new_idx, _ctrl_empty);
+               _slots[new_idx].~value_type();
+               new(_slots + new_idx) value_type(std::move(tmp));
+               _set_ctrl(new_idx, _h2(hash));
+               --idx;
+            }
+         }
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         //the values are in an inconsistent state: destroy the live ones (full or marked deleted)
+         for(size_type idx=0; idx<_capacity; ++idx)
+         {
+            if(_ctrl[idx] >= 0 || _ctrl[idx] == _ctrl_deleted)
+            {
+               _slots[idx].~value_type();
+            }
+         }
+         _reset_ctrl();
+         _size = 0;
+         throw;
+      }
+      #endif
+      _growth_left = _growth() - _size;
+   }
+
+   template<class TIterator>
+   static std::pair<TIterator, TIterator> _equal_range(TIterator it)
+   {
+      auto last = it;
+      if(it._ctrl != nullptr && *it._ctrl != _ctrl_sentinel)
+         ++last;
+      return std::make_pair(it, last);
+   }
+
+private:
+   _ctrl_t* _ctrl;
+   _slot_type* _slots;
+   size_type _capacity;
+   size_type _max_size;
+   size_type _size{ 0 };
+   size_type _growth_left;
+   hasher _hash;
+   key_equal _key_equal;
+};
+
+template<class TKey, class TValue, class TIteratorValue, class TKeyOfValue, class THash, class TKeyEqual>
+bool operator==(const _swiss_table<TKey, TValue, TIteratorValue, TKeyOfValue, THash, TKeyEqual>& lhs,
+                const _swiss_table<TKey, TValue, TIteratorValue, TKeyOfValue, THash, TKeyEqual>& rhs)
+{
+   if(lhs.size() != rhs.size())
+      return false;
+   for(const auto& value : lhs)
+   {
+      auto it = rhs.find(TKeyOfValue::get(value));
+      if(it == rhs.end() || !(*it == value))
+         return false;
+   }
+   return true;
+}
+
+template<class TKey, class TValue, class TIteratorValue, class TKeyOfValue, class THash, class TKeyEqual>
+bool operator!=(const _swiss_table<TKey, TValue, TIteratorValue, TKeyOfValue, THash, TKeyEqual>& lhs,
+                const _swiss_table<TKey, TValue, TIteratorValue, TKeyOfValue, THash, TKeyEqual>& rhs)
+{
+   return !(lhs == rhs);
+}
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_TREE_AUGMENTATION__
+#define _SSTL_TREE_AUGMENTATION__
+
+#include <cstddef>
+#include <type_traits>
+
+namespace sstl
+{
+
+// augmentation policies of the AVL trees of sstl::set and sstl::multiset (their last template parameter)
+
+// the nodes hold nothing but the value and the links of the tree
+struct tree_no_augmentation
+{};
+
+// every node also counts the nodes of its subtree: rank, nth and count_range take O(log n)
+// instead of walking the elements, at the cost of one size_t per node. The counts are kept
+// along the path of each insertion and erasure, and recomputed for the nodes moved by the rotations.
+struct tree_order_statistics
+{};
+
+template<class TAugmentation>
+struct _tree_node_augmentation
+{};
+
+template<>
+struct _tree_node_augmentation<tree_order_statistics>
+{
+   size_t subtree_size{ 1 };
+};
+
+template<class TAugmentation>
+using _has_order_statistics = std::is_same<TAugmentation, tree_order_statistics>;
+
+}
+
+#endif
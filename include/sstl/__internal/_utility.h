@@ -10,6 +10,8 @@ as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
 
 #include <type_traits>
 
+#include "_except.h"
+
 namespace sstl
 {
 
@@ -27,6 +29,40 @@ struct _type_tag
    using type = T;
 };
 
+//key extractors of the hash tables
+struct _key_of_pair
+{
+   template<class TPair>
+   static const typename TPair::first_type& get(const TPair& value) _sstl_noexcept_
+   {
+      return value.first;
+   }
+};
+
+struct _key_of_value
+{
+   template<class TKey>
+   static const TKey& get(const TKey& value) _sstl_noexcept_
+   {
+      return value;
+   }
+};
+
+template<class...>
+struct _void_type
+{
+   using type = void;
+};
+
+//true if T declares the member type "is_transparent" (heterogeneous lookup)
+template<class T, class = void>
+struct _is_transparent : std::false_type
+{};
+
+template<class T>
+struct _is_transparent<T, typename _void_type<typename T::is_transparent>::type> : std::true_type
+{};
+
 }
 
 #endif
@@ -42,6 +42,8 @@ public:
       sstl_assert(!bitmap.all());
       auto free_block_idx = get_next_free_block_idx();
       bitmap.set(free_block_idx);
+      //the next search starts after this block: consecutive allocations don't rescan the bitmap
+      _derived()._last_allocated_block_idx = free_block_idx;
       return &_derived()._pool[free_block_idx];
    }
 
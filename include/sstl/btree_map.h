@@ -0,0 +1,353 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_BTREE_MAP__
+#define _SSTL_BTREE_MAP__
+
+#include <cstddef>
+#include <utility>
+#include <tuple>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+#include <stdexcept>
+
+#include <sstl_assert.h>
+
+#include "__internal/_except.h"
+#include "__internal/_iterator.h"
+#include "__internal/_debug.h"
+#include "__internal/_btree.h"
+
+namespace sstl
+{
+
+// btree_map<Key, T, CAPACITY> holds up to CAPACITY values sorted by key in a B-tree whose
+// nodes span a few cache lines (see _btree.h). btree_map<Key, T> is the capacity-agnostic base,
+// e.g. a function taking a sstl::btree_map<int, int>& accepts maps of any capacity.
+// Unlike sstl::map, insertions and erasures invalidate all the iterators.
+// Heterogeneous lookup (find, count, contains, lower_bound, upper_bound, equal_range)
+// is enabled if Compare defines the member type is_transparent.
+template<class Key,
+         class T,
+         size_t CAPACITY=static_cast<size_t>(-1),
+         class Compare=std::less<Key>>
+class btree_map;
+
+template<class Key, class T, class Compare>
+class btree_map<Key, T, static_cast<size_t>(-1), Compare>
+   : public _btree<Key, std::pair<const Key, T>, std::pair<const Key, T>, _key_of_pair, Compare>
+{
+private:
+   using _base = _btree<Key, std::pair<const Key, T>, std::pair<const Key, T>, _key_of_pair, Compare>;
+
+public:
+   using key_type = typename _base::key_type;
+   using mapped_type = T;
+   using value_type = typename _base::value_type;
+   using size_type = typename _base::size_type;
+   using difference_type = typename _base::difference_type;
+   using key_compare = typename _base::key_compare;
+   using reference = typename _base::reference;
+   using const_reference = typename _base::const_reference;
+   using pointer = typename _base::pointer;
+   using const_pointer = typename _base::const_pointer;
+   using iterator = typename _base::iterator;
+   using const_iterator = typename _base::const_iterator;
+   using reverse_iterator = typename _base::reverse_iterator;
+   using const_reverse_iterator = typename _base::const_reverse_iterator;
+
+   class value_compare
+   {
+      friend class btree_map;
+
+   public:
+      bool operator()(const value_type& lhs, const value_type& rhs) const
+      {
+         return _compare(lhs.first, rhs.first);
+      }
+
+   private:
+      explicit value_compare(const key_compare& compare)
+         : _compare(compare)
+      {}
+
+   private:
+      key_compare _compare;
+   };
+
+public:
+   btree_map& operator=(const btree_map& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   btree_map& operator=(btree_map&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   btree_map& operator=(std::initializer_list<value_type> init)
+   {
+      _base::clear();
+      _base::insert(init);
+      return *this;
+   }
+
+   value_compare value_comp() const
+   {
+      return value_compare(_base::key_comp());
+   }
+
+   mapped_type& at(const key_type& key) _sstl_noexcept(!_sstl_has_exceptions())
+   {
+      auto it = _base::find(key);
+      #if _sstl_has_exceptions()
+      if(it == _base::end())
+      {
+         throw std::out_of_range(_sstl_debug_message("btree_map key not found"));
+      }
+      #endif
+      sstl_assert(it != _base::end());
+      return it->second;
+   }
+
+   const mapped_type& at(const key_type& key) const
+      _sstl_noexcept(noexcept(std::declval<btree_map>().at(std::declval<const key_type&>())))
+   {
+      return const_cast<btree_map&>(*this).at(key);
+   }
+
+   mapped_type& operator[](const key_type& key)
+   {
+      return try_emplace(key).first->second;
+   }
+
+   mapped_type& operator[](key_type&& key)
+   {
+      return try_emplace(std::move(key)).first->second;
+   }
+
+   //constructs the value only if the key is not present (the arguments are not moved from otherwise)
+   template<class... Args>
+   std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+   {
+      return _try_emplace(key, std::forward<Args>(args)...);
+   }
+
+   template<class... Args>
+   std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args)
+   {
+      return _try_emplace(std::move(key), std::forward<Args>(args)...);
+   }
+
+   template<class... Args>
+   iterator try_emplace(const_iterator, const key_type& key, Args&&... args)
+   {
+      return _try_emplace(key, std::forward<Args>(args)...).first;
+   }
+
+   template<class... Args>
+   iterator try_emplace(const_iterator, key_type&& key, Args&&... args)
+   {
+      return _try_emplace(std::move(key), std::forward<Args>(args)...).first;
+   }
+
+   template<class M>
+   std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& mapped)
+   {
+      return _insert_or_assign(key, std::forward<M>(mapped));
+   }
+
+   template<class M>
+   std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& mapped)
+   {
+      return _insert_or_assign(std::move(key), std::forward<M>(mapped));
+   }
+
+   template<class M>
+   iterator insert_or_assign(const_iterator, const key_type& key, M&& mapped)
+   {
+      return _insert_or_assign(key, std::forward<M>(mapped)).first;
+   }
+
+   template<class M>
+   iterator insert_or_assign(const_iterator, key_type&& key, M&& mapped)
+   {
+      return _insert_or_assign(std::move(key), std::forward<M>(mapped)).first;
+   }
+
+protected:
+   btree_map(void* leaves, size_type number_of_leaves,
+             void* internal_nodes, size_type number_of_internal_nodes,
+             size_type max_size, const key_compare& compare)
+      : _base(leaves, number_of_leaves, internal_nodes, number_of_internal_nodes, max_size, compare)
+   {}
+
+   btree_map(const btree_map&) = delete;
+   btree_map(btree_map&&) = delete;
+
+   ~btree_map() = default;
+
+private:
+   template<class K, class... Args>
+   std::pair<iterator, bool> _try_emplace(K&& key, Args&&... args)
+   {
+      auto result = _base::_find_insert_position(key);
+      if(result.second)
+         return std::make_pair(result.first, false);
+      auto it = _base::_emplace_at(result.first,
+                                   std::piecewise_construct,
+                                   std::forward_as_tuple(std::forward<K>(key)),
+                                   std::forward_as_tuple(std::forward<Args>(args)...));
+      return std::make_pair(it, true);
+   }
+
+   template<class K, class M>
+   std::pair<iterator, bool> _insert_or_assign(K&& key, M&& mapped)
+   {
+      auto result = _base::_find_insert_position(key);
+      if(result.second)
+      {
+         result.first->second = std::forward<M>(mapped);
+         return std::make_pair(result.first, false);
+      }
+      return std::make_pair(_base::_emplace_at(result.first, std::forward<K>(key), std::forward<M>(mapped)), true);
+   }
+};
+
+template<class Key, class T, size_t CAPACITY, class Compare>
+class btree_map : private _btree_storage<Key, std::pair<const Key, T>, Compare, CAPACITY>
+                , public btree_map<Key, T, static_cast<size_t>(-1), Compare>
+{
+   static_assert(CAPACITY >= 1, "capacity must be at least one");
+
+private:
+   using _base = btree_map<Key, T, static_cast<size_t>(-1), Compare>;
+   using _storage = _btree_storage<Key, std::pair<const Key, T>, Compare, CAPACITY>;
+
+public:
+   using key_type = typename _base::key_type;
+   using mapped_type = typename _base::mapped_type;
+   using value_type = typename _base::value_type;
+   using size_type = typename _base::size_type;
+   using difference_type = typename _base::difference_type;
+   using key_compare = typename _base::key_compare;
+   using value_compare = typename _base::value_compare;
+   using reference = typename _base::reference;
+   using const_reference = typename _base::const_reference;
+   using pointer = typename _base::pointer;
+   using const_pointer = typename _base::const_pointer;
+   using iterator = typename _base::iterator;
+   using const_iterator = typename _base::const_iterator;
+   using reverse_iterator = typename _base::reverse_iterator;
+   using const_reverse_iterator = typename _base::const_reverse_iterator;
+
+public:
+   btree_map()
+      : btree_map(key_compare())
+   {}
+
+   explicit btree_map(const key_compare& compare)
+      : _base(_storage::_leaves_.data(), _storage::_tree_capacity::leaves,
+              _storage::_internal_nodes_.data(), _storage::_tree_capacity::internal_nodes,
+              CAPACITY, compare)
+   {}
+
+   template<class TIterator, class = typename std::enable_if<_is_input_iterator<TIterator>::value>::type>
+   btree_map(TIterator range_begin, TIterator range_end, const key_compare& compare=key_compare())
+      : btree_map(compare)
+   {
+      _base::insert(range_begin, range_end);
+   }
+
+   btree_map(std::initializer_list<value_type> init, const key_compare& compare=key_compare())
+      : btree_map(compare)
+   {
+      _base::insert(init);
+   }
+
+   //copy construction from any btree_map with same types (capacity doesn't matter)
+   btree_map(const _base& rhs)
+      : btree_map(rhs.key_comp())
+   {
+      _base::_assign_from(rhs);
+   }
+
+   btree_map(const btree_map& rhs)
+      : btree_map(static_cast<const _base&>(rhs))
+   {}
+
+   //move construction from any btree_map with same types (capacity doesn't matter)
+   btree_map(_base&& rhs)
+      : btree_map(rhs.key_comp())
+   {
+      _base::_assign_from(std::move(rhs));
+      rhs.clear();
+   }
+
+   btree_map(btree_map&& rhs)
+      : btree_map(static_cast<_base&&>(rhs))
+   {}
+
+   ~btree_map() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _base::_destructor();
+   }
+
+   btree_map& operator=(const _base& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   btree_map& operator=(const btree_map& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   //move assignment from any btree_map with same types (capacity doesn't matter)
+   btree_map& operator=(_base&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   btree_map& operator=(btree_map&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   btree_map& operator=(std::initializer_list<value_type> init)
+   {
+      _base::operator=(init);
+      return *this;
+   }
+
+   void swap(btree_map& rhs)
+   {
+      if(this == &rhs)
+         return;
+      btree_map tmp(std::move(rhs));
+      rhs = std::move(*this);
+      *this = std::move(tmp);
+   }
+};
+
+template<class Key, class T, size_t CAPACITY, class Compare>
+void swap(btree_map<Key, T, CAPACITY, Compare>& lhs, btree_map<Key, T, CAPACITY, Compare>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+}
+
+#endif
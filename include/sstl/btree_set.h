@@ -0,0 +1,225 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_BTREE_SET__
+#define _SSTL_BTREE_SET__
+
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+
+#include <sstl_assert.h>
+
+#include "__internal/_except.h"
+#include "__internal/_iterator.h"
+#include "__internal/_btree.h"
+
+namespace sstl
+{
+
+// btree_set<Key, CAPACITY> holds up to CAPACITY sorted keys in a B-tree whose nodes span
+// a few cache lines (see _btree.h). btree_set<Key> is the capacity-agnostic base,
+// e.g. a function taking a sstl::btree_set<int>& accepts sets of any capacity.
+// Unlike sstl::set, insertions and erasures invalidate all the iterators.
+// Heterogeneous lookup (find, count, contains, lower_bound, upper_bound, equal_range)
+// is enabled if Compare defines the member type is_transparent.
+template<class Key,
+         size_t CAPACITY=static_cast<size_t>(-1),
+         class Compare=std::less<Key>>
+class btree_set;
+
+template<class Key, class Compare>
+class btree_set<Key, static_cast<size_t>(-1), Compare>
+   : public _btree<Key, Key, const Key, _key_of_value, Compare>
+{
+private:
+   using _base = _btree<Key, Key, const Key, _key_of_value, Compare>;
+
+public:
+   using key_type = typename _base::key_type;
+   using value_type = typename _base::value_type;
+   using size_type = typename _base::size_type;
+   using difference_type = typename _base::difference_type;
+   using key_compare = typename _base::key_compare;
+   using value_compare = typename _base::key_compare;
+   using reference = typename _base::reference;
+   using const_reference = typename _base::const_reference;
+   using pointer = typename _base::pointer;
+   using const_pointer = typename _base::const_pointer;
+   using iterator = typename _base::iterator;
+   using const_iterator = typename _base::const_iterator;
+   using reverse_iterator = typename _base::reverse_iterator;
+   using const_reverse_iterator = typename _base::const_reverse_iterator;
+
+public:
+   btree_set& operator=(const btree_set& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   btree_set& operator=(btree_set&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   btree_set& operator=(std::initializer_list<value_type> init)
+   {
+      _base::clear();
+      _base::insert(init);
+      return *this;
+   }
+
+   value_compare value_comp() const
+   {
+      return _base::key_comp();
+   }
+
+protected:
+   btree_set(void* leaves, size_type number_of_leaves,
+             void* internal_nodes, size_type number_of_internal_nodes,
+             size_type max_size, const key_compare& compare)
+      : _base(leaves, number_of_leaves, internal_nodes, number_of_internal_nodes, max_size, compare)
+   {}
+
+   btree_set(const btree_set&) = delete;
+   btree_set(btree_set&&) = delete;
+
+   ~btree_set() = default;
+};
+
+template<class Key, size_t CAPACITY, class Compare>
+class btree_set : private _btree_storage<Key, Key, Compare, CAPACITY>
+                , public btree_set<Key, static_cast<size_t>(-1), Compare>
+{
+   static_assert(CAPACITY >= 1, "capacity must be at least one");
+
+private:
+   using _base = btree_set<Key, static_cast<size_t>(-1), Compare>;
+   using _storage = _btree_storage<Key, Key, Compare, CAPACITY>;
+
+public:
+   using key_type = typename _base::key_type;
+   using value_type = typename _base::value_type;
+   using size_type = typename _base::size_type;
+   using difference_type = typename _base::difference_type;
+   using key_compare = typename _base::key_compare;
+   using value_compare = typename _base::value_compare;
+   using reference = typename _base::reference;
+   using const_reference = typename _base::const_reference;
+   using pointer = typename _base::pointer;
+   using const_pointer = typename _base::const_pointer;
+   using iterator = typename _base::iterator;
+   using const_iterator = typename _base::const_iterator;
+   using reverse_iterator = typename _base::reverse_iterator;
+   using const_reverse_iterator = typename _base::const_reverse_iterator;
+
+public:
+   btree_set()
+      : btree_set(key_compare())
+   {}
+
+   explicit btree_set(const key_compare& compare)
+      : _base(_storage::_leaves_.data(), _storage::_tree_capacity::leaves,
+              _storage::_internal_nodes_.data(), _storage::_tree_capacity::internal_nodes,
+              CAPACITY, compare)
+   {}
+
+   template<class TIterator, class = typename std::enable_if<_is_input_iterator<TIterator>::value>::type>
+   btree_set(TIterator range_begin, TIterator range_end, const key_compare& compare=key_compare())
+      : btree_set(compare)
+   {
+      _base::insert(range_begin, range_end);
+   }
+
+   btree_set(std::initializer_list<value_type> init, const key_compare& compare=key_compare())
+      : btree_set(compare)
+   {
+      _base::insert(init);
+   }
+
+   //copy construction from any btree_set with same types (capacity doesn't matter)
+   btree_set(const _base& rhs)
+      : btree_set(rhs.key_comp())
+   {
+      _base::_assign_from(rhs);
+   }
+
+   btree_set(const btree_set& rhs)
+      : btree_set(static_cast<const _base&>(rhs))
+   {}
+
+   //move construction from any btree_set with same types (capacity doesn't matter)
+   btree_set(_base&& rhs)
+      : btree_set(rhs.key_comp())
+   {
+      _base::_assign_from(std::move(rhs));
+      rhs.clear();
+   }
+
+   btree_set(btree_set&& rhs)
+      : btree_set(static_cast<_base&&>(rhs))
+   {}
+
+   ~btree_set() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _base::_destructor();
+   }
+
+   btree_set& operator=(const _base& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   btree_set& operator=(const btree_set& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   //move assignment from any btree_set with same types (capacity doesn't matter)
+   btree_set& operator=(_base&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   btree_set& operator=(btree_set&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   btree_set& operator=(std::initializer_list<value_type> init)
+   {
+      _base::operator=(init);
+      return *this;
+   }
+
+   void swap(btree_set& rhs)
+   {
+      if(this == &rhs)
+         return;
+      btree_set tmp(std::move(rhs));
+      rhs = std::move(*this);
+      *this = std::move(tmp);
+   }
+};
+
+template<class Key, size_t CAPACITY, class Compare>
+void swap(btree_set<Key, CAPACITY, Compare>& lhs, btree_set<Key, CAPACITY, Compare>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+}
+
+#endif
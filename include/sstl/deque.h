@@ -15,6 +15,7 @@ as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
 #include <iterator>
 #include <initializer_list>
 #include <array>
+#include <cstring>
 
 #include <sstl_assert.h>
 
@@ -51,6 +52,8 @@ public:
    using reverse_iterator = std::reverse_iterator<iterator>;
    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
    using difference_type = typename iterator::difference_type;
+   using array_range = std::pair<pointer, size_type>;
+   using const_array_range = std::pair<const_pointer, size_type>;
 
 public:
    deque& operator=(const deque& rhs)
@@ -798,6 +801,97 @@ public:
       --_derived()._size;
    }
 
+   //bulk version of push_back: the values are copied into the free storage as (at most)
+   //two contiguous chunks (with memcpy if the value type is trivially copyable and the
+   //source is a pointer) and the size is updated once per call
+   template<class TIterator>
+   TIterator push_back_n(TIterator range_begin, size_type count)
+      _sstl_noexcept(std::is_nothrow_copy_constructible<value_type>::value)
+   {
+      sstl_assert(size()+count <= capacity());
+      auto dst = _inc_pointer(_derived()._last_pointer);
+      auto first_chunk_size = std::min(count, static_cast<size_type>(_derived()._end_storage - dst));
+      size_type constructions_done = 0;
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         range_begin = _copy_construct_n(range_begin, first_chunk_size, dst, constructions_done);
+         range_begin = _copy_construct_n(range_begin, count-first_chunk_size, _derived()._begin_storage(), constructions_done);
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         _derived()._last_pointer = _add_offset_to_pointer(_derived()._last_pointer, constructions_done);
+         _derived()._size += constructions_done;
+         throw;
+      }
+      #endif
+      _derived()._last_pointer = _add_offset_to_pointer(_derived()._last_pointer, count);
+      _derived()._size += count;
+      return range_begin;
+   }
+
+   template<class TIterator>
+   void append_range(TIterator range_begin, TIterator range_end,
+                     typename std::enable_if<_is_forward_iterator<TIterator>::value>::type* = nullptr)
+      _sstl_noexcept(noexcept(std::declval<deque>().push_back_n(std::declval<TIterator>(), std::declval<size_type>())))
+   {
+      push_back_n(range_begin, static_cast<size_type>(std::distance(range_begin, range_end)));
+   }
+
+   template<class TIterator>
+   void append_range(TIterator range_begin, TIterator range_end,
+                     typename std::enable_if<_is_input_iterator<TIterator>::value
+                                          && !_is_forward_iterator<TIterator>::value>::type* = nullptr)
+      _sstl_noexcept(std::is_nothrow_copy_constructible<value_type>::value)
+   {
+      while(range_begin != range_end)
+      {
+         emplace_back(*range_begin);
+         ++range_begin;
+      }
+   }
+
+   //bulk version of pop_front: destroys the first 'count' elements
+   void pop_front_n(size_type count)
+      _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      sstl_assert(count <= size());
+      auto first_chunk_size = std::min(count, static_cast<size_type>(_derived()._end_storage - _derived()._first_pointer));
+      _destroy_n(_derived()._first_pointer, first_chunk_size);
+      _destroy_n(_derived()._begin_storage(), count-first_chunk_size);
+      _derived()._first_pointer = _add_offset_to_pointer(_derived()._first_pointer, count);
+      _derived()._size -= count;
+   }
+
+   //bulk version of pop_front: moves the first 'count' elements into
+   //the specified output range (in at most two chunks) and destroys them
+   template<class TOutputIterator>
+   TOutputIterator pop_front_n(size_type count, TOutputIterator range_begin)
+      _sstl_noexcept(std::is_nothrow_move_assignable<value_type>::value)
+   {
+      sstl_assert(count <= size());
+      auto first_chunk_size = std::min(count, static_cast<size_type>(_derived()._end_storage - _derived()._first_pointer));
+      size_type moves_done = 0;
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         range_begin = _move_n(_derived()._first_pointer, first_chunk_size, range_begin, moves_done);
+         range_begin = _move_n(_derived()._begin_storage(), count-first_chunk_size, range_begin, moves_done);
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         pop_front_n(moves_done);
+         throw;
+      }
+      #endif
+      pop_front_n(count);
+      return range_begin;
+   }
+
    void swap(deque& rhs)
       _sstl_noexcept(std::is_nothrow_move_constructible<value_type>::value
                   && std::is_nothrow_move_assignable<value_type>::value)
@@ -816,6 +910,79 @@ public:
       }
    }
 
+   //the elements are always stored in at most two contiguous arrays:
+   //array_one() is the first (front) part, array_two() the second (back) part
+   //(the latter is empty when the elements don't wrap around the end of the storage)
+   array_range array_one() _sstl_noexcept_
+   {
+      auto first_pointer = _derived()._first_pointer;
+      auto elements_until_end_storage = static_cast<size_type>(_derived()._end_storage - first_pointer);
+      return array_range{ first_pointer, std::min(size(), elements_until_end_storage) };
+   }
+
+   const_array_range array_one() const _sstl_noexcept_
+   {
+      auto range = const_cast<deque&>(*this).array_one();
+      return const_array_range{ range.first, range.second };
+   }
+
+   array_range array_two() _sstl_noexcept_
+   {
+      auto elements_until_end_storage = static_cast<size_type>(_derived()._end_storage - _derived()._first_pointer);
+      auto wrapped_elements = size() > elements_until_end_storage ? size() - elements_until_end_storage : 0;
+      return array_range{ _derived()._begin_storage(), wrapped_elements };
+   }
+
+   const_array_range array_two() const _sstl_noexcept_
+   {
+      auto range = const_cast<deque&>(*this).array_two();
+      return const_array_range{ range.first, range.second };
+   }
+
+   bool is_linearized() const _sstl_noexcept_
+   {
+      return array_two().second == 0;
+   }
+
+   //rearranges the elements so that they are stored in one contiguous array
+   //(i.e. array_two() becomes empty) and returns a pointer to the first element.
+   //The smaller of the two arrays is relocated and then the contiguous range is rotated in place
+   pointer linearize()
+      _sstl_noexcept(std::is_nothrow_move_constructible<value_type>::value
+                  && std::is_nothrow_move_assignable<value_type>::value)
+   {
+      auto wrapped_elements = array_two().second;
+      if(wrapped_elements == 0)
+         return _derived()._first_pointer;
+
+      auto unwrapped_elements = size() - wrapped_elements;
+      if(wrapped_elements < unwrapped_elements)
+      {
+         //relocate the second array in front of the first one
+         for(size_type i=0; i<wrapped_elements; ++i)
+         {
+            value_type value(std::move(back()));
+            pop_back();
+            emplace_front(std::move(value));
+         }
+         auto first_pointer = _derived()._first_pointer;
+         std::rotate(first_pointer, first_pointer+wrapped_elements, first_pointer+size());
+      }
+      else
+      {
+         //relocate the first array behind the second one
+         for(size_type i=0; i<unwrapped_elements; ++i)
+         {
+            value_type value(std::move(front()));
+            pop_front();
+            emplace_back(std::move(value));
+         }
+         auto first_pointer = _derived()._first_pointer;
+         std::rotate(first_pointer, first_pointer+(size()-unwrapped_elements), first_pointer+size());
+      }
+      return _derived()._first_pointer;
+   }
+
 protected:
    using _type_for_derived_class_access = deque<T, 11>;
 
@@ -1152,6 +1319,124 @@ protected:
       return _subtract_offset_to_pointer(_derived()._last_pointer, distance_to_end);
    }
 
+   //when the deque is full the oldest element (front) is overwritten through assignment
+   //and becomes the new back element, i.e. the ring is rotated by one position in O(1)
+   template<class TValue>
+   void _push_back_overwriting(TValue&& value)
+      _sstl_noexcept(std::is_nothrow_constructible<value_type, TValue&&>::value
+                  && std::is_nothrow_assignable<value_type&, TValue&&>::value)
+   {
+      if(!full())
+      {
+         emplace_back(std::forward<TValue>(value));
+         return;
+      }
+      auto new_last_pointer = _derived()._first_pointer;
+      *new_last_pointer = std::forward<TValue>(value);
+      _derived()._first_pointer = _inc_pointer(new_last_pointer);
+      _derived()._last_pointer = new_last_pointer;
+   }
+
+   //when the deque is full the oldest element (front) is destroyed and the
+   //new element is constructed in place of it
+   template<class... Args>
+   void _emplace_back_overwriting(Args&&... args)
+      _sstl_noexcept(std::is_nothrow_constructible<value_type, typename std::add_rvalue_reference<Args>::type...>::value)
+   {
+      if(full())
+      {
+         pop_front();
+      }
+      emplace_back(std::forward<Args>(args)...);
+   }
+
+   template<class TIterator>
+   struct _is_memcpy_source : std::integral_constant<bool,
+         std::is_trivially_copyable<value_type>::value
+      && (std::is_same<TIterator, pointer>::value || std::is_same<TIterator, const_pointer>::value)>
+   {};
+
+   template<class TIterator>
+   struct _is_memcpy_destination : std::integral_constant<bool,
+         std::is_trivially_copyable<value_type>::value
+      && std::is_same<TIterator, pointer>::value>
+   {};
+
+   template<class TIterator>
+   static TIterator _copy_construct_n(TIterator src, size_type count, pointer dst, size_type& constructions_done)
+      _sstl_noexcept(std::is_nothrow_copy_constructible<value_type>::value)
+   {
+      return _copy_construct_n(src, count, dst, constructions_done, _is_memcpy_source<TIterator>{});
+   }
+
+   template<class TIterator>
+   static TIterator _copy_construct_n(TIterator src, size_type count, pointer dst, size_type& constructions_done, std::true_type)
+      _sstl_noexcept_
+   {
+      std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), count*sizeof(value_type));
+      constructions_done += count;
+      return src+count;
+   }
+
+   template<class TIterator>
+   static TIterator _copy_construct_n(TIterator src, size_type count, pointer dst, size_type& constructions_done, std::false_type)
+      _sstl_noexcept(std::is_nothrow_copy_constructible<value_type>::value)
+   {
+      auto dst_end = dst + count;
+      while(dst != dst_end)
+      {
+         new(dst) value_type(*src);
+         ++src;
+         ++dst;
+         ++constructions_done;
+      }
+      return src;
+   }
+
+   template<class TOutputIterator>
+   static TOutputIterator _move_n(pointer src, size_type count, TOutputIterator dst, size_type& moves_done)
+      _sstl_noexcept(std::is_nothrow_move_assignable<value_type>::value)
+   {
+      return _move_n(src, count, dst, moves_done, _is_memcpy_destination<TOutputIterator>{});
+   }
+
+   template<class TOutputIterator>
+   static TOutputIterator _move_n(pointer src, size_type count, TOutputIterator dst, size_type& moves_done, std::true_type)
+      _sstl_noexcept_
+   {
+      std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), count*sizeof(value_type));
+      moves_done += count;
+      return dst+count;
+   }
+
+   template<class TOutputIterator>
+   static TOutputIterator _move_n(pointer src, size_type count, TOutputIterator dst, size_type& moves_done, std::false_type)
+      _sstl_noexcept(std::is_nothrow_move_assignable<value_type>::value)
+   {
+      auto src_end = src + count;
+      while(src != src_end)
+      {
+         *dst = std::move(*src);
+         ++src;
+         ++dst;
+         ++moves_done;
+      }
+      return dst;
+   }
+
+   static void _destroy_n(pointer ptr, size_type count)
+      _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      if(std::is_trivially_destructible<value_type>::value)
+         return;
+      auto end = ptr + count;
+      while(ptr != end)
+      {
+         ptr->~value_type();
+         ++ptr;
+      }
+   }
+
    _type_for_derived_class_access& _derived() _sstl_noexcept_;
    const _type_for_derived_class_access& _derived() const _sstl_noexcept_;
 
@@ -1228,13 +1513,6 @@ protected:
    {
       return _apply_offset_to_pointer(const_cast<pointer>(ptr), offset);
    }
-
-   bool _is_pointer_one_past_last_pointer(const_pointer ptr) const _sstl_noexcept_
-   {
-      auto one_past_last_pointer = _derived()._last_pointer;
-      one_past_last_pointer = _inc_pointer(one_past_last_pointer);
-      return ptr == one_past_last_pointer;
-   }
 };
 
 template<class T, size_t CAPACITY>
@@ -1262,6 +1540,8 @@ public:
    using const_iterator = typename _base::const_iterator;
    using reverse_iterator = typename _base::reverse_iterator;
    using const_reverse_iterator = typename _base::const_reverse_iterator;
+   using array_range = typename _base::array_range;
+   using const_array_range = typename _base::const_array_range;
 
 public:
    deque() _sstl_noexcept_
@@ -1361,7 +1641,73 @@ public:
       return reinterpret_cast<deque&>(_base::operator=(ilist));
    }
 
+   //the following member functions hide the ones of the base class: they are the
+   //hot paths of the FIFO use case and here the capacity is known at compile time,
+   //hence the wrap-around of the positions is a bitwise 'and' when the capacity is
+   //a power of two (no comparison against the end of the storage)
+   reference operator[](size_type idx) _sstl_noexcept_
+   {
+      return *_pointer_at_index(_index_of_pointer(_first_pointer) + idx);
+   }
+
+   const_reference operator[](size_type idx) const _sstl_noexcept_
+   {
+      return const_cast<deque&>(*this)[idx];
+   }
+
+   void push_back(const_reference value)
+      _sstl_noexcept(noexcept(std::declval<deque>().emplace_back(std::declval<const_reference>())))
+   {
+      emplace_back(value);
+   }
+
+   void push_back(value_type&& value)
+      _sstl_noexcept(noexcept(std::declval<deque>().emplace_back(std::declval<value_type&&>())))
+   {
+      emplace_back(std::move(value));
+   }
+
+   template<class... Args>
+   void emplace_back(Args&&... args)
+      _sstl_noexcept(std::is_nothrow_constructible<value_type, typename std::add_rvalue_reference<Args>::type...>::value)
+   {
+      sstl_assert(!_base::full());
+      auto new_last_pointer = _pointer_at_index(_index_of_pointer(_last_pointer) + 1);
+      new(new_last_pointer) value_type(std::forward<Args>(args)...);
+      _last_pointer = new_last_pointer;
+      ++_size;
+   }
+
+   void pop_front()
+      _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      sstl_assert(!_base::empty());
+      _first_pointer->~value_type();
+      _first_pointer = _pointer_at_index(_index_of_pointer(_first_pointer) + 1);
+      --_size;
+   }
+
 private:
+   static const bool _is_capacity_power_of_two = CAPACITY != 0 && (CAPACITY & (CAPACITY-1)) == 0;
+
+   //wraps an index that is less than 2*CAPACITY
+   static size_type _wrap_index(size_type idx) _sstl_noexcept_
+   {
+      return _is_capacity_power_of_two
+         ? idx & (CAPACITY-1)
+         : (idx < CAPACITY ? idx : idx-CAPACITY);
+   }
+
+   size_type _index_of_pointer(const_pointer ptr) const _sstl_noexcept_
+   {
+      return static_cast<size_type>(ptr - _begin_storage());
+   }
+
+   pointer _pointer_at_index(size_type unwrapped_idx) _sstl_noexcept_
+   {
+      return _begin_storage() + _wrap_index(unwrapped_idx);
+   }
+
    pointer _begin_storage() _sstl_noexcept_
    {
       auto begin_storage = reinterpret_cast<_type_for_derived_class_access&>(*this)._buffer.data();
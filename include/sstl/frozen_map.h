@@ -0,0 +1,244 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_FROZEN_MAP__
+#define _SSTL_FROZEN_MAP__
+
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+#include <stdexcept>
+
+#include <sstl_assert.h>
+
+#include "__internal/_except.h"
+#include "__internal/_iterator.h"
+#include "__internal/_debug.h"
+#include "__internal/_eytzinger.h"
+
+namespace sstl
+{
+
+// frozen_map<Key, T, CAPACITY> is a read-only map of up to CAPACITY values, built once from a range
+// sorted by key without equivalent keys (e.g. a sorted sstl::vector of pairs), and stored in Eytzinger
+// layout for branch-free lookups (see _eytzinger.h). frozen_map<Key, T> is the capacity-agnostic base,
+// e.g. a function taking a const sstl::frozen_map<int, int>& accepts maps of any capacity.
+// The values can only be replaced as a whole by assignment. The iteration is in sorted order
+// but doesn't visit the values in memory order.
+// Heterogeneous lookup (find, count, contains, lower_bound, upper_bound, equal_range)
+// is enabled if Compare defines the member type is_transparent.
+template<class Key,
+         class T,
+         size_t CAPACITY=static_cast<size_t>(-1),
+         class Compare=std::less<Key>>
+class frozen_map;
+
+template<class Key, class T, class Compare>
+class frozen_map<Key, T, static_cast<size_t>(-1), Compare>
+   : public _eytzinger<Key, std::pair<const Key, T>, _key_of_pair, Compare>
+{
+private:
+   using _base = _eytzinger<Key, std::pair<const Key, T>, _key_of_pair, Compare>;
+
+public:
+   using key_type = typename _base::key_type;
+   using mapped_type = T;
+   using value_type = typename _base::value_type;
+   using size_type = typename _base::size_type;
+   using difference_type = typename _base::difference_type;
+   using key_compare = typename _base::key_compare;
+   using reference = typename _base::reference;
+   using const_reference = typename _base::const_reference;
+   using pointer = typename _base::pointer;
+   using const_pointer = typename _base::const_pointer;
+   using iterator = typename _base::iterator;
+   using const_iterator = typename _base::const_iterator;
+   using reverse_iterator = typename _base::reverse_iterator;
+   using const_reverse_iterator = typename _base::const_reverse_iterator;
+
+   class value_compare
+   {
+      friend class frozen_map;
+
+   public:
+      bool operator()(const value_type& lhs, const value_type& rhs) const
+      {
+         return _compare(lhs.first, rhs.first);
+      }
+
+   private:
+      explicit value_compare(const key_compare& compare)
+         : _compare(compare)
+      {}
+
+   private:
+      key_compare _compare;
+   };
+
+public:
+   frozen_map& operator=(const frozen_map& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   frozen_map& operator=(frozen_map&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   value_compare value_comp() const
+   {
+      return value_compare(_base::key_comp());
+   }
+
+   const mapped_type& at(const key_type& key) const _sstl_noexcept(!_sstl_has_exceptions())
+   {
+      auto it = _base::find(key);
+      #if _sstl_has_exceptions()
+      if(it == _base::end())
+      {
+         throw std::out_of_range(_sstl_debug_message("frozen_map key not found"));
+      }
+      #endif
+      sstl_assert(it != _base::end());
+      return it->second;
+   }
+
+protected:
+   frozen_map(void* values, size_type max_size, const key_compare& compare)
+      : _base(values, max_size, compare)
+   {}
+
+   frozen_map(const frozen_map&) = delete;
+   frozen_map(frozen_map&&) = delete;
+
+   ~frozen_map() = default;
+};
+
+template<class Key, class T, size_t CAPACITY, class Compare>
+class frozen_map : private _eytzinger_storage<std::pair<const Key, T>, CAPACITY>
+                 , public frozen_map<Key, T, static_cast<size_t>(-1), Compare>
+{
+   static_assert(CAPACITY >= 1, "capacity must be at least one");
+
+private:
+   using _base = frozen_map<Key, T, static_cast<size_t>(-1), Compare>;
+   using _storage = _eytzinger_storage<std::pair<const Key, T>, CAPACITY>;
+
+public:
+   using key_type = typename _base::key_type;
+   using mapped_type = typename _base::mapped_type;
+   using value_type = typename _base::value_type;
+   using size_type = typename _base::size_type;
+   using difference_type = typename _base::difference_type;
+   using key_compare = typename _base::key_compare;
+   using value_compare = typename _base::value_compare;
+   using reference = typename _base::reference;
+   using const_reference = typename _base::const_reference;
+   using pointer = typename _base::pointer;
+   using const_pointer = typename _base::const_pointer;
+   using iterator = typename _base::iterator;
+   using const_iterator = typename _base::const_iterator;
+   using reverse_iterator = typename _base::reverse_iterator;
+   using const_reverse_iterator = typename _base::const_reverse_iterator;
+
+public:
+   frozen_map()
+      : frozen_map(key_compare())
+   {}
+
+   explicit frozen_map(const key_compare& compare)
+      : _base(_storage::_values_.data(), CAPACITY, compare)
+   {}
+
+   //the range must be sorted by key, without equivalent keys
+   template<class TIterator, class = typename std::enable_if<_is_forward_iterator<TIterator>::value>::type>
+   frozen_map(TIterator range_begin, TIterator range_end, const key_compare& compare=key_compare())
+      : frozen_map(compare)
+   {
+      _base::_assign_sorted(range_begin, range_end);
+   }
+
+   frozen_map(std::initializer_list<value_type> init, const key_compare& compare=key_compare())
+      : frozen_map(init.begin(), init.end(), compare)
+   {}
+
+   //copy construction from any frozen_map with same types (capacity doesn't matter)
+   frozen_map(const _base& rhs)
+      : frozen_map(rhs.key_comp())
+   {
+      _base::_assign_from(rhs);
+   }
+
+   frozen_map(const frozen_map& rhs)
+      : frozen_map(static_cast<const _base&>(rhs))
+   {}
+
+   //move construction from any frozen_map with same types (capacity doesn't matter)
+   frozen_map(_base&& rhs)
+      : frozen_map(rhs.key_comp())
+   {
+      _base::operator=(std::move(rhs));
+   }
+
+   frozen_map(frozen_map&& rhs)
+      : frozen_map(static_cast<_base&&>(rhs))
+   {}
+
+   ~frozen_map() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _base::_destructor();
+   }
+
+   frozen_map& operator=(const _base& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   frozen_map& operator=(const frozen_map& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   //move assignment from any frozen_map with same types (capacity doesn't matter)
+   frozen_map& operator=(_base&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   frozen_map& operator=(frozen_map&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   void swap(frozen_map& rhs)
+   {
+      if(this == &rhs)
+         return;
+      frozen_map tmp(std::move(rhs));
+      rhs = std::move(*this);
+      *this = std::move(tmp);
+   }
+};
+
+template<class Key, class T, size_t CAPACITY, class Compare>
+void swap(frozen_map<Key, T, CAPACITY, Compare>& lhs, frozen_map<Key, T, CAPACITY, Compare>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+}
+
+#endif
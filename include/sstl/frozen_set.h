@@ -0,0 +1,208 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_FROZEN_SET__
+#define _SSTL_FROZEN_SET__
+
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+
+#include <sstl_assert.h>
+
+#include "__internal/_except.h"
+#include "__internal/_iterator.h"
+#include "__internal/_eytzinger.h"
+
+namespace sstl
+{
+
+// frozen_set<Key, CAPACITY> is a read-only set of up to CAPACITY keys, built once from a range
+// sorted by Compare without equivalent keys (e.g. a sorted sstl::vector), and stored in Eytzinger
+// layout for branch-free lookups (see _eytzinger.h). frozen_set<Key> is the capacity-agnostic base,
+// e.g. a function taking a const sstl::frozen_set<int>& accepts sets of any capacity.
+// The keys can only be replaced as a whole by assignment. The iteration is in sorted order
+// but doesn't visit the keys in memory order.
+// Heterogeneous lookup (find, count, contains, lower_bound, upper_bound, equal_range)
+// is enabled if Compare defines the member type is_transparent.
+template<class Key,
+         size_t CAPACITY=static_cast<size_t>(-1),
+         class Compare=std::less<Key>>
+class frozen_set;
+
+template<class Key, class Compare>
+class frozen_set<Key, static_cast<size_t>(-1), Compare>
+   : public _eytzinger<Key, Key, _key_of_value, Compare>
+{
+private:
+   using _base = _eytzinger<Key, Key, _key_of_value, Compare>;
+
+public:
+   using key_type = typename _base::key_type;
+   using value_type = typename _base::value_type;
+   using size_type = typename _base::size_type;
+   using difference_type = typename _base::difference_type;
+   using key_compare = typename _base::key_compare;
+   using value_compare = typename _base::key_compare;
+   using reference = typename _base::reference;
+   using const_reference = typename _base::const_reference;
+   using pointer = typename _base::pointer;
+   using const_pointer = typename _base::const_pointer;
+   using iterator = typename _base::iterator;
+   using const_iterator = typename _base::const_iterator;
+   using reverse_iterator = typename _base::reverse_iterator;
+   using const_reverse_iterator = typename _base::const_reverse_iterator;
+
+public:
+   frozen_set& operator=(const frozen_set& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   frozen_set& operator=(frozen_set&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   value_compare value_comp() const
+   {
+      return _base::key_comp();
+   }
+
+protected:
+   frozen_set(void* values, size_type max_size, const key_compare& compare)
+      : _base(values, max_size, compare)
+   {}
+
+   frozen_set(const frozen_set&) = delete;
+   frozen_set(frozen_set&&) = delete;
+
+   ~frozen_set() = default;
+};
+
+template<class Key, size_t CAPACITY, class Compare>
+class frozen_set : private _eytzinger_storage<Key, CAPACITY>
+                , public frozen_set<Key, static_cast<size_t>(-1), Compare>
+{
+   static_assert(CAPACITY >= 1, "capacity must be at least one");
+
+private:
+   using _base = frozen_set<Key, static_cast<size_t>(-1), Compare>;
+   using _storage = _eytzinger_storage<Key, CAPACITY>;
+
+public:
+   using key_type = typename _base::key_type;
+   using value_type = typename _base::value_type;
+   using size_type = typename _base::size_type;
+   using difference_type = typename _base::difference_type;
+   using key_compare = typename _base::key_compare;
+   using value_compare = typename _base::value_compare;
+   using reference = typename _base::reference;
+   using const_reference = typename _base::const_reference;
+   using pointer = typename _base::pointer;
+   using const_pointer = typename _base::const_pointer;
+   using iterator = typename _base::iterator;
+   using const_iterator = typename _base::const_iterator;
+   using reverse_iterator = typename _base::reverse_iterator;
+   using const_reverse_iterator = typename _base::const_reverse_iterator;
+
+public:
+   frozen_set()
+      : frozen_set(key_compare())
+   {}
+
+   explicit frozen_set(const key_compare& compare)
+      : _base(_storage::_values_.data(), CAPACITY, compare)
+   {}
+
+   //the range must be sorted by compare, without equivalent keys
+   template<class TIterator, class = typename std::enable_if<_is_forward_iterator<TIterator>::value>::type>
+   frozen_set(TIterator range_begin, TIterator range_end, const key_compare& compare=key_compare())
+      : frozen_set(compare)
+   {
+      _base::_assign_sorted(range_begin, range_end);
+   }
+
+   frozen_set(std::initializer_list<value_type> init, const key_compare& compare=key_compare())
+      : frozen_set(init.begin(), init.end(), compare)
+   {}
+
+   //copy construction from any frozen_set with same types (capacity doesn't matter)
+   frozen_set(const _base& rhs)
+      : frozen_set(rhs.key_comp())
+   {
+      _base::_assign_from(rhs);
+   }
+
+   frozen_set(const frozen_set& rhs)
+      : frozen_set(static_cast<const _base&>(rhs))
+   {}
+
+   //move construction from any frozen_set with same types (capacity doesn't matter)
+   frozen_set(_base&& rhs)
+      : frozen_set(rhs.key_comp())
+   {
+      _base::operator=(std::move(rhs));
+   }
+
+   frozen_set(frozen_set&& rhs)
+      : frozen_set(static_cast<_base&&>(rhs))
+   {}
+
+   ~frozen_set() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _base::_destructor();
+   }
+
+   frozen_set& operator=(const _base& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   frozen_set& operator=(const frozen_set& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   //move assignment from any frozen_set with same types (capacity doesn't matter)
+   frozen_set& operator=(_base&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   frozen_set& operator=(frozen_set&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   void swap(frozen_set& rhs)
+   {
+      if(this == &rhs)
+         return;
+      frozen_set tmp(std::move(rhs));
+      rhs = std::move(*this);
+      *this = std::move(tmp);
+   }
+};
+
+template<class Key, size_t CAPACITY, class Compare>
+void swap(frozen_set<Key, CAPACITY, Compare>& lhs, frozen_set<Key, CAPACITY, Compare>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+}
+
+#endif
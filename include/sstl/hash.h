@@ -0,0 +1,228 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_HASH__
+#define _SSTL_HASH__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+#include "__internal/_except.h"
+#include "__internal/_hash_mix.h"
+
+namespace sstl
+{
+
+inline uint64_t _read_64(const unsigned char* bytes) _sstl_noexcept_
+{
+   uint64_t value;
+   std::memcpy(&value, bytes, sizeof(value));
+   return value;
+}
+
+inline uint64_t _read_32(const unsigned char* bytes) _sstl_noexcept_
+{
+   uint32_t value;
+   std::memcpy(&value, bytes, sizeof(value));
+   return value;
+}
+
+//one to three bytes: the first, the middle and the last one
+inline uint64_t _read_1_to_3(const unsigned char* bytes, size_t size) _sstl_noexcept_
+{
+   return (static_cast<uint64_t>(bytes[0]) << 16) | (static_cast<uint64_t>(bytes[size >> 1]) << 8) | bytes[size - 1];
+}
+
+//odd constants with balanced bits
+const uint64_t _hash_secret0 = 0x2d358dccaa6c78a5ull;
+const uint64_t _hash_secret1 = 0x8bb84b93962eacc9ull;
+const uint64_t _hash_secret2 = 0x4b33a62ed433d4a3ull;
+const uint64_t _hash_secret3 = 0x4d5a2da51de1aa47ull;
+
+// 64 bits hash of a range of bytes in the style of wyhash: the input is consumed 16 bytes
+// at a time (48 bytes, in three independent lanes, for the long inputs), each block is
+// combined with the state by a folded 64x64->128 bits multiplication. The inputs of up to
+// 16 bytes are read with two (possibly overlapping) loads, without loops.
+// The result depends on the endianness of the platform.
+//the seed must already be mixed (see _mix_seed)
+inline uint64_t _hash_bytes_64(const void* data, size_t size, uint64_t seed) _sstl_noexcept_
+{
+   auto bytes = static_cast<const unsigned char*>(data);
+   uint64_t a, b;
+   if(size <= 16)
+   {
+      if(size >= 4)
+      {
+         auto offset = (size >> 3) << 2;
+         a = (_read_32(bytes) << 32) | _read_32(bytes + offset);
+         b = (_read_32(bytes + size - 4) << 32) | _read_32(bytes + size - 4 - offset);
+      }
+      else if(size > 0)
+      {
+         a = _read_1_to_3(bytes, size);
+         b = 0;
+      }
+      else
+      {
+         a = b = 0;
+      }
+   }
+   else
+   {
+      auto remaining = size;
+      if(remaining > 48)
+      {
+         auto lane1 = seed, lane2 = seed;
+         do
+         {
+            seed = _folded_multiply(_read_64(bytes) ^ _hash_secret1, _read_64(bytes + 8) ^ seed);
+            lane1 = _folded_multiply(_read_64(bytes + 16) ^ _hash_secret2, _read_64(bytes + 24) ^ lane1);
+            lane2 = _folded_multiply(_read_64(bytes + 32) ^ _hash_secret3, _read_64(bytes + 40) ^ lane2);
+            bytes += 48;
+            remaining -= 48;
+         } while(remaining > 48);
+         seed ^= lane1 ^ lane2;
+      }
+      while(remaining > 16)
+      {
+         seed = _folded_multiply(_read_64(bytes) ^ _hash_secret1, _read_64(bytes + 8) ^ seed);
+         bytes += 16;
+         remaining -= 16;
+      }
+      //the last 16 bytes, possibly overlapping the previous block
+      a = _read_64(bytes + remaining - 16);
+      b = _read_64(bytes + remaining - 8);
+   }
+   _multiply_128(a ^ _hash_secret1, b ^ seed, a, b);
+   return _folded_multiply(a ^ _hash_secret0 ^ size, b ^ _hash_secret1);
+}
+
+//computed at compile time for a constant seed
+inline uint64_t _mix_seed(uint64_t seed) _sstl_noexcept_
+{
+   return seed ^ _folded_multiply(seed ^ _hash_secret0, _hash_secret1);
+}
+
+// hash of a range of bytes, for the user's specializations of sstl::hash
+inline size_t hash_bytes(const void* data, size_t size, uint64_t seed = 0) _sstl_noexcept_
+{
+   auto hash = _hash_bytes_64(data, size, _mix_seed(seed));
+   #if SIZE_MAX > 0xffffffffu
+   return static_cast<size_t>(hash);
+   #else
+   return static_cast<size_t>(hash ^ (hash >> 32));
+   #endif
+}
+
+inline size_t _hash_integer(uint64_t value) _sstl_noexcept_
+{
+   return static_cast<size_t>(_folded_multiply(value, 0x9E3779B97F4A7C15ull));
+}
+
+template<class T>
+struct hash;
+
+// the implementation of sstl::hash is selected at compile time by the category of the key type.
+// The selected hash functions are avalanching, so the hash tables don't mix their results again.
+// Any other type: std::hash, followed by a fibonacci mixer
+template<class T, class = void>
+struct _hash_impl
+{
+   using is_avalanching = void;
+
+   size_t operator()(const T& value) const
+   {
+      return _hash_mix(std::hash<T>()(value));
+   }
+};
+
+// integral and enum types: multiply-shift by the golden ratio, folding the high half of the
+// 128 bits product into the low one (a plain multiplication would leave the low bits of the
+// result depending only on the low bits of the key)
+template<class T>
+struct _hash_impl<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+{
+   using is_avalanching = void;
+
+   size_t operator()(T value) const _sstl_noexcept_
+   {
+      return _hash_integer(static_cast<uint64_t>(value));
+   }
+};
+
+template<class T>
+struct _hash_impl<T*, void>
+{
+   using is_avalanching = void;
+
+   size_t operator()(T* value) const _sstl_noexcept_
+   {
+      return _hash_integer(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)));
+   }
+};
+
+// float and double: the bits of the value (+0 and -0 compare equal, hence they have the same hash)
+template<class T>
+struct _hash_impl<T, typename std::enable_if<std::is_floating_point<T>::value
+                                             && sizeof(T) <= sizeof(uint64_t)>::type>
+{
+   using is_avalanching = void;
+
+   size_t operator()(T value) const _sstl_noexcept_
+   {
+      if(value == 0)
+         value = 0;
+      uint64_t bits = 0;
+      std::memcpy(&bits, &value, sizeof(value));
+      return _hash_integer(bits);
+   }
+};
+
+template<class TChar, class TTraits, class TAllocator>
+struct _hash_impl<std::basic_string<TChar, TTraits, TAllocator>, void>
+{
+   using is_avalanching = void;
+
+   size_t operator()(const std::basic_string<TChar, TTraits, TAllocator>& value) const _sstl_noexcept_
+   {
+      return hash_bytes(value.data(), value.size() * sizeof(TChar));
+   }
+};
+
+// composite keys: the hashes of the members are combined by a folded multiplication
+template<class T1, class T2>
+struct _hash_impl<std::pair<T1, T2>, void>
+{
+   using is_avalanching = void;
+
+   size_t operator()(const std::pair<T1, T2>& value) const
+   {
+      auto first = static_cast<uint64_t>(hash<T1>()(value.first));
+      auto second = static_cast<uint64_t>(hash<T2>()(value.second));
+      return static_cast<size_t>(_folded_multiply(first ^ _hash_secret0, second ^ _hash_secret1));
+   }
+};
+
+// drop-in replacement of std::hash for the keys of the hash tables: fast hashes of good quality
+// for the integral types (std::hash is usually the identity function) and for the strings
+// (see _hash_bytes_64). A key type can be supported by specializing sstl::hash, otherwise
+// std::hash is used. The hash functions declare the member type "is_avalanching",
+// telling the hash tables that their results don't need further mixing.
+// The hashes of the pointers are the hashes of the addresses (as in std::hash): the strings
+// must be hashed as std::string or with hash_bytes.
+template<class T>
+struct hash : _hash_impl<T>
+{};
+
+}
+
+#endif
@@ -34,6 +34,9 @@ SOFTWARE.
 #include <iterator>
 #include <algorithm>
 #include <functional>
+#include <utility>
+#include <tuple>
+#include <type_traits>
 #include <cstddef>
 #include <cstdint>
 
@@ -42,6 +45,8 @@ SOFTWARE.
 #include "map_base.h"
 #include "bitmap_allocator.h"
 #include "__internal/parameter_type.h"
+#include "__internal/_except.h"
+#include "__internal/_utility.h"
 
 #if WIN32
 #undef min
@@ -95,6 +100,10 @@ namespace sstl
     static const uint8_t kRight = 1;
     static const uint8_t kNeither = 2;
 
+    /// The maximum height of the tree: an AVL tree of n nodes is less than
+    /// 1.45 * log2(n + 2) high.
+    static const size_t kMaxHeight = sizeof(size_t) * 8 * 3 / 2;
+
     //*************************************************************************
     /// The node element in the map.
     //*************************************************************************
@@ -116,10 +125,12 @@ namespace sstl
       {
         weight = kNeither;
         dir = kNeither;
+        parent = nullptr;
         children[0] = nullptr;
         children[1] = nullptr;
       }
 
+      Node* parent;
       Node* children[2];
       uint8_t weight;
       uint8_t dir;
@@ -130,8 +141,9 @@ namespace sstl
     //*************************************************************************
     struct Data_Node : public Node
     {
-      explicit Data_Node(value_type value)
-        : value(value)
+      template <typename... TArgs>
+      explicit Data_Node(TArgs&&... args)
+        : value(std::forward<TArgs>(args)...)
       {
       }
 
@@ -141,6 +153,11 @@ namespace sstl
     /// Defines the key value parameter type
     typedef typename parameter_type<TKey>::type key_value_parameter_t;
 
+    /// Enables the lookups by a key of another type (see find), only if the
+    /// comparator is transparent.
+    template <typename K>
+    using _enable_if_transparent = typename std::enable_if<_is_transparent<key_compare>::value, K>::type;
+
     //*************************************************************************
     /// How to compare node elements.
     //*************************************************************************
@@ -148,11 +165,13 @@ namespace sstl
     {
       return key_compare()(node1.value.first, node2.value.first);
     }
-    bool node_comp(const Data_Node& node, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    bool node_comp(const Data_Node& node, const TLookupKey& key) const
     {
       return key_compare()(node.value.first, key);
     }
-    bool node_comp(const key_value_parameter_t& key, const Data_Node& node) const
+    template <typename TLookupKey>
+    bool node_comp(const TLookupKey& key, const Data_Node& node) const
     {
       return key_compare()(key, node.value.first);
     }
@@ -165,6 +184,10 @@ namespace sstl
     /// The node that acts as the map root.
     Node* root_node;
 
+    /// The node of the last element (nullptr if empty), where the
+    /// increasing keys are appended.
+    Node* rightmost_node;
+
     //*************************************************************************
     /// Downcast a Node* to a Data_Node*
     //*************************************************************************
@@ -433,6 +456,122 @@ namespace sstl
     typedef std::reverse_iterator<iterator>       reverse_iterator;
     typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
+    //*************************************************************************
+    /// A node extracted from the map, owning its element. The node keeps its
+    /// block in the pool of the map it was extracted from, until it is
+    /// inserted back or the handle is destroyed: the handle must not outlive
+    /// that map, which meanwhile can hold one element less.
+    //*************************************************************************
+    class node_type
+    {
+    public:
+
+      friend class imap;
+
+      typedef TKey    key_type;
+      typedef TMapped mapped_type;
+
+      node_type()
+        : p_container(nullptr)
+        , p_node(nullptr)
+      {
+      }
+
+      node_type(node_type&& other)
+        : p_container(other.p_container)
+        , p_node(other.p_node)
+      {
+        other.p_container = nullptr;
+        other.p_node = nullptr;
+      }
+
+      ~node_type()
+      {
+        reset();
+      }
+
+      node_type& operator =(node_type&& other)
+      {
+        if (this != &other)
+        {
+          reset();
+          p_container = other.p_container;
+          p_node = other.p_node;
+          other.p_container = nullptr;
+          other.p_node = nullptr;
+        }
+
+        return *this;
+      }
+
+      bool empty() const
+      {
+        return p_node == nullptr;
+      }
+
+      explicit operator bool() const
+      {
+        return p_node != nullptr;
+      }
+
+      //***********************************************************************
+      /// The key of the element, it can be modified before inserting the node.
+      //***********************************************************************
+      key_type& key() const
+      {
+        sstl_assert(p_node);
+        return const_cast<key_type&>(p_node->value.first);
+      }
+
+      //***********************************************************************
+      /// The mapped value of the element.
+      //***********************************************************************
+      mapped_type& mapped() const
+      {
+        sstl_assert(p_node);
+        return p_node->value.second;
+      }
+
+    private:
+
+      node_type(imap& container, Node* node)
+        : p_container(&container)
+        , p_node(imap::data_cast(node))
+      {
+      }
+
+      node_type(const node_type&) = delete;
+      node_type& operator =(const node_type&) = delete;
+
+      //***********************************************************************
+      /// Destroys the element and gives its block back to the pool.
+      //***********************************************************************
+      void reset()
+      {
+        if (p_node)
+        {
+          p_container->destroy_extracted_node(*p_node);
+          p_container = nullptr;
+          p_node = nullptr;
+        }
+      }
+
+      // Pointer to the map the node was extracted from
+      imap* p_container;
+
+      // Pointer to the extracted node
+      Data_Node* p_node;
+    };
+
+    //*************************************************************************
+    /// The result of the insertion of a node.
+    //*************************************************************************
+    struct insert_return_type
+    {
+      iterator  position;
+      bool      inserted;
+      node_type node;
+    };
 
     //*************************************************************************
     /// Gets the beginning of the map.
@@ -537,15 +676,19 @@ namespace sstl
     //*********************************************************************
     mapped_type& operator [](const key_value_parameter_t& key)
     {
-      iterator i_element = find(key);
-
-      if (!i_element.p_node)
-      {
-        // Doesn't exist, so create a new one.
-        i_element = insert(std::make_pair(key, mapped_type())).first;
-      }
+      // Value-initializes the mapped value if the key doesn't exist
+      return try_emplace(key).first->second;
+    }
 
-      return i_element->second;
+    //*********************************************************************
+    /// Returns a reference to the value at index 'key', moving the key into
+    /// a new element if it doesn't exist.
+    ///\param key The index.
+    ///\return A reference to the value at index 'key'
+    //*********************************************************************
+    mapped_type& operator [](key_type&& key)
+    {
+      return try_emplace(std::move(key)).first->second;
     }
 
     //*********************************************************************
@@ -584,6 +727,65 @@ namespace sstl
       insert(first, last);
     }
 
+    //*********************************************************************
+    /// Assigns the values of a sorted range to the map, building a
+    /// perfectly balanced tree in O(n) instead of inserting the values one
+    /// at a time. The range must be sorted by key_compare, without equivalent keys (checked
+    /// by an assertion).
+    ///\param first The forward iterator to the first element.
+    ///\param last  The forward iterator to the last element + 1.
+    //*********************************************************************
+    template <typename TIterator>
+    void assign_sorted(TIterator first, TIterator last)
+    {
+      clear();
+      size_type count = static_cast<size_type>(std::distance(first, last));
+      sstl_assert(count <= available());
+
+      // The nodes are created in order and chained through their right
+      // children, then linked into the tree all at once
+      Node* list = nullptr;
+      Node** tail = &list;
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+        const Data_Node* previous = nullptr;
+        for (; first != last; ++first)
+        {
+          Data_Node& data_node = allocate_data_node(*first);
+          sstl_assert(!previous || node_comp(*previous, data_node));
+          *tail = &data_node;
+          tail = &data_node.children[kRight];
+          previous = &data_node;
+        }
+        *tail = nullptr;
+        (void) previous;
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+        *tail = nullptr;
+        while (list)
+        {
+          Node* next = list->children[kRight];
+          destroy_data_node(imap::data_cast(*list));
+          list = next;
+        }
+        throw;
+      }
+      #endif
+
+      size_t height;
+      root_node = link_balanced_tree(list, count, height);
+      if (root_node)
+      {
+        root_node->parent = nullptr;
+      }
+      rightmost_node = find_limit_node(root_node, kRight);
+      current_size = count;
+    }
+
     //*************************************************************************
     /// Clears the map.
     //*************************************************************************
@@ -595,6 +797,7 @@ namespace sstl
         }
         current_size = 0;
         root_node = nullptr;
+        rightmost_node = nullptr;
     }
 
     //*********************************************************************
@@ -643,9 +846,10 @@ namespace sstl
     //*************************************************************************
     iterator erase(const_iterator position)
     {
-      // Find the parent node to be removed
-      Node*& reference_node = find_node(root_node, position.p_node);
-      iterator next(*this, reference_node);
+      // Cast const away from node to be removed. This is necessary because the
+      // STL definition of this method requires we provide the next node in the
+      // sequence as an iterator.
+      iterator next(*this, const_cast<Node*>(position.p_node));
       ++next;
 
       remove_node(root_node, (*position).first);
@@ -716,57 +920,288 @@ namespace sstl
     //*********************************************************************
     std::pair<iterator, bool> insert(const value_type& value)
     {
-      sstl_assert(!full());
-
-      // Default to no inserted node
-      Node* inserted_node = nullptr;
-      bool inserted = false;
-
-      // Get next available free node
-      Data_Node& node = allocate_data_node(value);
+      // The value is copied into a new node only if its key isn't in the map yet
+      std::pair<Node*, bool> result = insert_node(root_node, value.first,
+        [this, &value]() -> Data_Node& { return allocate_data_node(value); });
+      return std::make_pair(iterator(*this, result.first), result.second);
+    }
 
-      // Obtain the inserted node (might be nullptr if node was a duplicate)
-      inserted_node = insert_node(root_node, node);
-      inserted = inserted_node == &node;
+    //*********************************************************************
+    /// Inserts a value to the map, moving it into the new node.
+    ///\param value    The value to insert (not moved if its key is already in the map).
+    //*********************************************************************
+    std::pair<iterator, bool> insert(value_type&& value)
+    {
+      std::pair<Node*, bool> result = insert_node(root_node, value.first,
+        [this, &value]() -> Data_Node& { return allocate_data_node(std::move(value)); });
+      return std::make_pair(iterator(*this, result.first), result.second);
+    }
 
-      // Insert node into tree and return iterator to new node location in tree
-      return std::make_pair(iterator(*this, inserted_node), inserted);
+    //*********************************************************************
+    /// Inserts a value constructed in place from the pair provided.
+    ///\param value    The pair to construct the value from.
+    //*********************************************************************
+    template <typename TPair,
+              typename = typename std::enable_if<std::is_constructible<value_type, TPair&&>::value &&
+                                                 !std::is_same<typename std::decay<TPair>::type, value_type>::value>::type>
+    std::pair<iterator, bool> insert(TPair&& value)
+    {
+      return emplace(std::forward<TPair>(value));
     }
 
     //*********************************************************************
-    /// Inserts a value to the map starting at the position recommended.
-    ///\param position The position that would precede the value to insert.
+    /// Inserts a value to the map next to the position recommended.
+    ///\param position The position of the element that would follow the value.
     ///\param value    The value to insert.
     //*********************************************************************
-    iterator insert(iterator, const value_type& value)
+    iterator insert(iterator position, const value_type& value)
     {
-      sstl_assert(!full());
-      // Default to no inserted node
-      Node* inserted_node = nullptr;
-      // Get next available free node
-      Data_Node& node = allocate_data_node(value);
-      // Obtain the inserted node (might be nullptr if node was a duplicate)
-      inserted_node = insert_node(root_node, node);
-      // Insert node into tree and return iterator to new node location in tree
-      return iterator(*this, inserted_node);
+      return insert(const_iterator(position), value);
     }
 
     //*********************************************************************
-    /// Inserts a value to the map starting at the position recommended.
-    ///\param position The position that would precede the value to insert.
+    /// Inserts a value to the map next to the position recommended: the
+    /// value is linked without a search from the root if it goes right
+    /// before (or right after) the element at the position, as when
+    /// appending increasing keys at end().
+    ///\param position The position of the element that would follow the value.
     ///\param value    The value to insert.
     //*********************************************************************
-    iterator insert(const_iterator, const value_type& value)
+    iterator insert(const_iterator position, const value_type& value)
+    {
+      return iterator(*this, insert_node_at_hint(const_cast<Node*>(position.p_node), value.first,
+        [this, &value]() -> Data_Node& { return allocate_data_node(value); }).first);
+    }
+
+    //*********************************************************************
+    /// Inserts a value to the map next to the position recommended.
+    ///\param position The position of the element that would follow the value.
+    ///\param value    The value to insert (not moved if not inserted).
+    //*********************************************************************
+    iterator insert(iterator position, value_type&& value)
     {
-      sstl_assert(!full());
-      // Default to no inserted node
-      Node* inserted_node = nullptr;
-      // Get next available free node
-      Data_Node& node = allocate_data_node(value);
-      // Obtain the inserted node (might be nullptr if node was a duplicate)
-      inserted_node = insert_node(root_node, node);
-      // Insert node into tree and return iterator to new node location in tree
-      return iterator(*this, inserted_node);
+      return insert(const_iterator(position), std::move(value));
+    }
+
+    //*********************************************************************
+    /// Inserts a value to the map next to the position recommended.
+    ///\param position The position of the element that would follow the value.
+    ///\param value    The value to insert (not moved if not inserted).
+    //*********************************************************************
+    iterator insert(const_iterator position, value_type&& value)
+    {
+      return iterator(*this, insert_node_at_hint(const_cast<Node*>(position.p_node), value.first,
+        [this, &value]() -> Data_Node& { return allocate_data_node(std::move(value)); }).first);
+    }
+
+    //*********************************************************************
+    /// Constructs a value in place in a new node and inserts it to the map.
+    /// The node is released if the key is already in the map.
+    ///\param args The arguments to construct the value with.
+    //*********************************************************************
+    template <typename... TArgs>
+    std::pair<iterator, bool> emplace(TArgs&&... args)
+    {
+      Data_Node& node = allocate_data_node(std::forward<TArgs>(args)...);
+      std::pair<Node*, bool> result = insert_node(root_node, node.value.first,
+        [&node]() -> Data_Node& { return node; });
+      if (!result.second)
+      {
+        destroy_data_node(node);
+      }
+      return std::make_pair(iterator(*this, result.first), result.second);
+    }
+
+    //*********************************************************************
+    /// Constructs a value in place and inserts it to the map next to the
+    /// position recommended (see insert). The node is released if the
+    /// key is already in the map.
+    ///\param position The position of the element that would follow the value.
+    ///\param args     The arguments to construct the value with.
+    //*********************************************************************
+    template <typename... TArgs>
+    iterator emplace_hint(const_iterator position, TArgs&&... args)
+    {
+      Data_Node& node = allocate_data_node(std::forward<TArgs>(args)...);
+      std::pair<Node*, bool> result = insert_node_at_hint(const_cast<Node*>(position.p_node), node.value.first,
+        [&node]() -> Data_Node& { return node; });
+      if (!result.second)
+      {
+        destroy_data_node(node);
+      }
+      return iterator(*this, result.first);
+    }
+
+    //*********************************************************************
+    /// Inserts the key provided with a mapped value constructed in place
+    /// from the arguments provided, if the key isn't in the map yet.
+    /// Otherwise nothing is constructed and the arguments are left untouched.
+    ///\param key  The key to insert.
+    ///\param args The arguments to construct the mapped value with.
+    //*********************************************************************
+    template <typename... TArgs>
+    std::pair<iterator, bool> try_emplace(const key_type& key, TArgs&&... args)
+    {
+      std::pair<Node*, bool> result = insert_node(root_node, key, [&]() -> Data_Node&
+      {
+        return allocate_data_node(std::piecewise_construct,
+                                  std::forward_as_tuple(key),
+                                  std::forward_as_tuple(std::forward<TArgs>(args)...));
+      });
+      return std::make_pair(iterator(*this, result.first), result.second);
+    }
+
+    //*********************************************************************
+    /// Inserts the key provided with a mapped value constructed in place
+    /// from the arguments provided, if the key isn't in the map yet.
+    /// Otherwise nothing is constructed and the key and the arguments are
+    /// left untouched.
+    ///\param key  The key to move into the map.
+    ///\param args The arguments to construct the mapped value with.
+    //*********************************************************************
+    template <typename... TArgs>
+    std::pair<iterator, bool> try_emplace(key_type&& key, TArgs&&... args)
+    {
+      std::pair<Node*, bool> result = insert_node(root_node, key, [&]() -> Data_Node&
+      {
+        return allocate_data_node(std::piecewise_construct,
+                                  std::forward_as_tuple(std::move(key)),
+                                  std::forward_as_tuple(std::forward<TArgs>(args)...));
+      });
+      return std::make_pair(iterator(*this, result.first), result.second);
+    }
+
+    //*********************************************************************
+    /// Inserts the key and the mapped value provided, or assigns the mapped
+    /// value to the element of the key if it is already in the map.
+    ///\param key   The key to insert.
+    ///\param value The mapped value to insert or assign.
+    //*********************************************************************
+    template <typename TValue>
+    std::pair<iterator, bool> insert_or_assign(const key_type& key, TValue&& value)
+    {
+      std::pair<iterator, bool> result = try_emplace(key, std::forward<TValue>(value));
+      if (!result.second)
+      {
+        result.first->second = std::forward<TValue>(value);
+      }
+      return result;
+    }
+
+    //*********************************************************************
+    /// Inserts the key and the mapped value provided, or assigns the mapped
+    /// value to the element of the key if it is already in the map.
+    ///\param key   The key to move into the map.
+    ///\param value The mapped value to insert or assign.
+    //*********************************************************************
+    template <typename TValue>
+    std::pair<iterator, bool> insert_or_assign(key_type&& key, TValue&& value)
+    {
+      std::pair<iterator, bool> result = try_emplace(std::move(key), std::forward<TValue>(value));
+      if (!result.second)
+      {
+        result.first->second = std::forward<TValue>(value);
+      }
+      return result;
+    }
+
+    //*********************************************************************
+    /// Extracts the element at the position provided from the map, without
+    /// destroying it.
+    ///\param position The position of the element to extract.
+    ///\return The node of the element.
+    //*********************************************************************
+    node_type extract(const_iterator position)
+    {
+      return extract((*position).first);
+    }
+
+    //*********************************************************************
+    /// Extracts the element with the key provided from the map, without
+    /// destroying it.
+    ///\param key The key of the element to extract.
+    ///\return The node of the element, empty if the key wasn't found.
+    //*********************************************************************
+    node_type extract(const key_value_parameter_t& key)
+    {
+      Node* node = unlink_node(root_node, key);
+      if (!node)
+      {
+        return node_type();
+      }
+
+      ++extracted_size;
+      return node_type(*this, node);
+    }
+
+    //*********************************************************************
+    /// Inserts the element of the node provided. A node extracted from this
+    /// map is linked back into the tree, without copying the element.
+    /// A node extracted from another map is moved into a block of the pool
+    /// of this map.
+    ///\param node The node to insert, left untouched if its key is in the map.
+    ///\return The position of the element with the key of the node, whether
+    /// the node was inserted and the node if it wasn't.
+    //*********************************************************************
+    insert_return_type insert(node_type&& node)
+    {
+      insert_return_type result;
+      result.inserted = false;
+
+      if (node.empty())
+      {
+        result.position = end();
+        return result;
+      }
+
+      Data_Node& data_node = *node.p_node;
+      std::pair<Node*, bool> inserted;
+      if (node.p_container == this)
+      {
+        // Link the node back into the tree
+        inserted = insert_node(root_node, data_node.value.first,
+          [&data_node]() -> Data_Node& { return data_node; });
+        if (inserted.second)
+        {
+          --extracted_size;
+          node.p_container = nullptr;
+          node.p_node = nullptr;
+        }
+      }
+      else
+      {
+        // Relocate the element from the pool of the other map
+        inserted = insert_node(root_node, data_node.value.first,
+          [this, &data_node]() -> Data_Node&
+          {
+            return allocate_data_node(std::move(const_cast<TKey&>(data_node.value.first)),
+                                      std::move(data_node.value.second));
+          });
+        if (inserted.second)
+        {
+          node.reset();
+        }
+      }
+
+      result.position = iterator(*this, inserted.first);
+      result.inserted = inserted.second;
+      if (!inserted.second)
+      {
+        result.node = std::move(node);
+      }
+
+      return result;
+    }
+
+    //*********************************************************************
+    /// Inserts the element of the node provided starting at the position
+    /// recommended.
+    ///\param position The position that would precede the node to insert.
+    ///\param node     The node to insert.
+    //*********************************************************************
+    iterator insert(const_iterator, node_type&& node)
+    {
+      return insert(std::move(node)).position;
     }
 
     //*********************************************************************
@@ -780,7 +1215,8 @@ namespace sstl
     {
       while (first != last)
       {
-        insert(*first++);
+        // Appended next to the last element if the range is sorted
+        insert(cend(), *first++);
       }
     }
 
@@ -828,6 +1264,134 @@ namespace sstl
       return const_iterator(*this, find_upper_node(root_node, key));
     }
 
+    //*********************************************************************
+    /// Finds an element by a key of another type, compared with the keys
+    /// of the elements as it is: looking up a std::string key by a
+    /// const char* doesn't construct a temporary std::string.
+    /// Available only if key_compare declares is_transparent (e.g.
+    /// std::less<>), as the following overloads of count, lower_bound,
+    /// upper_bound and equal_range.
+    //*********************************************************************
+    template <typename K, typename = _enable_if_transparent<K>>
+    iterator find(const K& key)
+    {
+      return iterator(*this, find_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    const_iterator find(const K& key) const
+    {
+      return const_iterator(*this, find_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    size_type count(const K& key) const
+    {
+      return find_node(root_node, key) ? 1 : 0;
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    iterator lower_bound(const K& key)
+    {
+      return iterator(*this, find_lower_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    const_iterator lower_bound(const K& key) const
+    {
+      return const_iterator(*this, find_lower_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    iterator upper_bound(const K& key)
+    {
+      return iterator(*this, find_upper_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    const_iterator upper_bound(const K& key) const
+    {
+      return const_iterator(*this, find_upper_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    std::pair<iterator, iterator> equal_range(const K& key)
+    {
+      return std::make_pair(iterator(*this, find_lower_node(root_node, key)),
+                            iterator(*this, find_upper_node(root_node, key)));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    std::pair<const_iterator, const_iterator> equal_range(const K& key) const
+    {
+      return std::make_pair(const_iterator(*this, find_lower_node(root_node, key)),
+                            const_iterator(*this, find_upper_node(root_node, key)));
+    }
+
+    //*********************************************************************
+    /// Calls the function provided for each element in order. The tree is
+    /// walked with an explicit stack, without climbing back through the
+    /// parent nodes as the iterators do.
+    ///\param function The function to call with each element.
+    ///\return The function provided.
+    //*********************************************************************
+    template <typename TFunction>
+    TFunction for_each(TFunction function)
+    {
+      Node* stack[kMaxHeight];
+      size_t top = 0;
+      Node* node = root_node;
+      while (node || top > 0)
+      {
+        // Descend to the leftmost node not visited yet
+        while (node)
+        {
+          stack[top++] = node;
+          node = node->children[kLeft];
+        }
+
+        node = stack[--top];
+        function(imap::data_cast(node)->value);
+
+        // Continue with the tree on the right
+        node = node->children[kRight];
+      }
+
+      return function;
+    }
+
+    //*********************************************************************
+    /// Calls the function provided for each element in order. The tree is
+    /// walked with an explicit stack, without climbing back through the
+    /// parent nodes as the iterators do.
+    ///\param function The function to call with each element.
+    ///\return The function provided.
+    //*********************************************************************
+    template <typename TFunction>
+    TFunction for_each(TFunction function) const
+    {
+      const Node* stack[kMaxHeight];
+      size_t top = 0;
+      const Node* node = root_node;
+      while (node || top > 0)
+      {
+        // Descend to the leftmost node not visited yet
+        while (node)
+        {
+          stack[top++] = node;
+          node = node->children[kLeft];
+        }
+
+        node = stack[--top];
+        function(imap::data_cast(node)->value);
+
+        // Continue with the tree on the right
+        node = node->children[kRight];
+      }
+
+      return function;
+    }
+
   protected:
 
     //*************************************************************************
@@ -837,6 +1401,7 @@ namespace sstl
       : map_base(max_size_)
       , p_node_pool(&node_pool)
       , root_node(nullptr)
+      , rightmost_node(nullptr)
     {
       clear();
     }
@@ -846,10 +1411,24 @@ namespace sstl
     //*************************************************************************
     /// Allocate a Data_Node.
     //*************************************************************************
-    Data_Node& allocate_data_node(value_type value) const
+    template <typename... TArgs>
+    Data_Node& allocate_data_node(TArgs&&... args) const
     {
+        sstl_assert(!full());
         auto p = p_node_pool->allocate();
-        new(p) Data_Node(value);
+        #if _sstl_has_exceptions()
+        try
+        {
+        #endif
+          new(p) Data_Node(std::forward<TArgs>(args)...);
+        #if _sstl_has_exceptions()
+        }
+        catch(...)
+        {
+          p_node_pool->deallocate(p);
+          throw;
+        }
+        #endif
         return *p;
     }
 
@@ -862,17 +1441,74 @@ namespace sstl
         p_node_pool->deallocate(&node);
     }
 
+    //*************************************************************************
+    /// Links the next count nodes of a list chained through their right
+    /// children into a perfectly balanced subtree, in order, and advances
+    /// the list past them. Returns the root of the subtree (its parent is
+    /// left to the caller) and its height.
+    //*************************************************************************
+    Node* link_balanced_tree(Node*& list, size_type count, size_t& height)
+    {
+      if (count == 0)
+      {
+        height = 0;
+        return nullptr;
+      }
+
+      // The right subtree gets the extra node, if any
+      size_type left_count = (count - 1) / 2;
+      size_t left_height;
+      size_t right_height;
+      Node* left = link_balanced_tree(list, left_count, left_height);
+      Node* node = list;
+      list = list->children[kRight];
+      Node* right = link_balanced_tree(list, count - 1 - left_count, right_height);
+
+      node->children[kLeft] = left;
+      node->children[kRight] = right;
+      if (left)
+      {
+        left->parent = node;
+      }
+      if (right)
+      {
+        right->parent = node;
+      }
+      node->weight = right_height > left_height ? uint8_t(kRight) : uint8_t(kNeither);
+      node->dir = kNeither;
+      height = right_height + 1;
+      return node;
+    }
+
+    //*************************************************************************
+    /// Destroy a Data_Node held by a node_type.
+    //*************************************************************************
+    void destroy_extracted_node(Data_Node& node)
+    {
+        --extracted_size;
+        destroy_data_node(node);
+    }
+
     //*************************************************************************
     /// Attach the provided node to the position provided
     //*************************************************************************
-    void attach_node(Node*& position, Data_Node& node)
+    void attach_node(Node* parent, Node*& position, Data_Node& node)
     {
       // Mark new node as leaf on attach to tree at position provided
       node.mark_as_leaf();
 
+      // Keep track of this node's parent
+      node.parent = parent;
+
       // Add the node here
       position = &node;
 
+      // A node attached to the right of the last node is the new last node
+      if (parent == rightmost_node && (!parent || &position == &parent->children[kRight]))
+      {
+        rightmost_node = &node;
+      }
+
       // One more.
       ++current_size;
     }
@@ -940,6 +1576,120 @@ namespace sstl
       }
     }
 
+    //*************************************************************************
+    /// Insert a node for the key provided next to the hint, if the key goes
+    /// right before the node at the hint (or right after it): the node is
+    /// attached to one of the neighbours without searching the tree from
+    /// the root. Otherwise the key is inserted as by insert_node.
+    //*************************************************************************
+    template <typename TCreateNode>
+    std::pair<Node*, bool> insert_node_at_hint(Node* hint, const key_value_parameter_t& key, TCreateNode create_node)
+    {
+      // Find the neighbours of the key next to the hint
+      Node* prev = hint;
+      Node* next = hint;
+      if (!hint || node_comp(key, imap::data_cast(*hint)))
+      {
+        // The key goes before the hint, does it go after the previous node?
+        prev_node(prev);
+        if (prev && !node_comp(imap::data_cast(*prev), key))
+        {
+          return insert_node(root_node, key, create_node);
+        }
+      }
+      else if (node_comp(imap::data_cast(*hint), key))
+      {
+        // The key goes after the hint, does it go before the next node?
+        if (hint == rightmost_node)
+        {
+          next = nullptr;
+        }
+        else
+        {
+          next_node(next);
+        }
+        if (next && !node_comp(key, imap::data_cast(*next)))
+        {
+          return insert_node(root_node, key, create_node);
+        }
+      }
+      else
+      {
+        // The key is in the tree already
+        return std::make_pair(hint, false);
+      }
+
+      return std::make_pair(attach_node_between(prev, next, create_node), true);
+    }
+
+    //*************************************************************************
+    /// Attach the node created by the function provided between the nodes
+    /// provided (next to each other in order, either one might be nullptr
+    /// at the ends), then balance the tree.
+    //*************************************************************************
+    template <typename TCreateNode>
+    Node* attach_node_between(Node* prev, Node* next, TCreateNode create_node)
+    {
+      Node* node;
+      if (!prev && !next)
+      {
+        attach_node(nullptr, root_node, create_node());
+        return root_node;
+      }
+      // Either the next node has no left child or the previous node (the
+      // maximum of that left child) has no right child
+      else if (next && !next->children[kLeft])
+      {
+        attach_node(next, next->children[kLeft], create_node());
+        node = next->children[kLeft];
+      }
+      else
+      {
+        attach_node(prev, prev->children[kRight], create_node());
+        node = prev->children[kRight];
+      }
+
+      balance_attached_node(node);
+      return node;
+    }
+
+    //*************************************************************************
+    /// Balance the tree after the node provided was attached as a leaf
+    /// without searching from the root: the directions from the critical
+    /// node down to the new node are marked going up the parents, as they
+    /// are by insert_node on its way down.
+    //*************************************************************************
+    void balance_attached_node(Node* node)
+    {
+      // The critical node is the nearest ancestor that isn't balanced (or
+      // the root)
+      Node* critical_node = node->parent;
+      while (true)
+      {
+        critical_node->dir = critical_node->children[kLeft] == node ? kLeft : kRight;
+        if (kNeither != critical_node->weight || !critical_node->parent)
+        {
+          break;
+        }
+        node = critical_node;
+        critical_node = critical_node->parent;
+      }
+
+      Node* critical_parent_node = critical_node->parent;
+      if (!critical_parent_node)
+      {
+        balance_node(root_node);
+      }
+      else if (critical_parent_node->children[kLeft] == critical_node)
+      {
+        balance_node(critical_parent_node->children[kLeft]);
+      }
+      else
+      {
+        balance_node(critical_parent_node->children[kRight]);
+      }
+    }
+
     //*************************************************************************
     /// Detach the node at the position provided
     //*************************************************************************
@@ -957,17 +1707,31 @@ namespace sstl
       // Update replacement node to point to child in opposite direction
       // otherwise we might lose the other child of the swap node
       replacement = swap->children[1 - swap->dir];
+      if (replacement)
+      {
+        replacement->parent = swap->parent;
+      }
 
-      // Point swap node to detached node's children and weight
+      // Point swap node to detached node's parent, children and weight
+      swap->parent = detached->parent;
       swap->children[kLeft] = detached->children[kLeft];
       swap->children[kRight] = detached->children[kRight];
+      if (swap->children[kLeft])
+      {
+        swap->children[kLeft]->parent = swap;
+      }
+      if (swap->children[kRight])
+      {
+        swap->children[kRight]->parent = swap;
+      }
       swap->weight = detached->weight;
     }
 
     //*************************************************************************
     /// Find the value matching the node provided
     //*************************************************************************
-    Node* find_node(Node* position, const key_value_parameter_t& key)
+    template <typename TLookupKey>
+    Node* find_node(Node* position, const TLookupKey& key)
     {
       Node* found = position;
       while (found)
@@ -1000,7 +1764,8 @@ namespace sstl
     //*************************************************************************
     /// Find the value matching the node provided
     //*************************************************************************
-    const Node* find_node(const Node* position, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    const Node* find_node(const Node* position, const TLookupKey& key) const
     {
       const Node* found = position;
       while (found)
@@ -1030,51 +1795,6 @@ namespace sstl
       return found;
     }
 
-    //*************************************************************************
-    /// Find the reference node matching the node provided
-    //*************************************************************************
-    Node*& find_node(Node*& position, const Node* node)
-    {
-      Node* found = position;
-      while (found)
-      {
-        if (found->children[kLeft] == node)
-        {
-          return found->children[kLeft];
-        }
-        else if (found->children[kRight] == node)
-        {
-          return found->children[kRight];
-        }
-        else
-        {
-          // Downcast found to Data_Node class for comparison and other operations
-          Data_Node& found_data_node = imap::data_cast(*found);
-          const Data_Node& data_node = imap::data_cast(*node);
-
-          // Compare the node value to the current position value
-          if (node_comp(data_node, found_data_node))
-          {
-            // Keep searching for the node on the left
-            found = found->children[kLeft];
-          }
-          else if (node_comp(found_data_node, data_node))
-          {
-            // Keep searching for the node on the right
-            found = found->children[kRight];
-          }
-          else
-          {
-            // Return position provided (it matches the node)
-            return position;
-          }
-        }
-      }
-
-      // Return root node if nothing was found
-      return root_node;
-    }
-
     //*************************************************************************
     /// Find the node whose key would go before all the other keys from the
     /// position provided
@@ -1109,133 +1829,32 @@ namespace sstl
       return limit_node;
     }
 
-    //*************************************************************************
-    /// Find the parent node that contains the node provided in its left or
-    /// right tree
-    //*************************************************************************
-    Node* find_parent_node(Node* position, const Node* node)
-    {
-      // Default to no parent node found
-      Node* found = nullptr;
-
-      // If the position provided is the same as the node then there is no parent
-      if (position && node && position != node)
-      {
-        while (position)
-        {
-          // Is this position not the parent of the node we are looking for?
-          if (position->children[kLeft] != node &&
-              position->children[kRight] != node)
-          {
-            // Downcast node and position to Data_Node references for key comparisons
-            const Data_Node& node_data_node = imap::data_cast(*node);
-            Data_Node& position_data_node = imap::data_cast(*position);
-            // Compare the node value to the current position value
-            if (node_comp(node_data_node, position_data_node))
-            {
-              // Keep looking for parent on the left
-              position = position->children[kLeft];
-            }
-            else if (node_comp(position_data_node, node_data_node))
-            {
-              // Keep looking for parent on the right
-              position = position->children[kRight];
-            }
-          }
-          else
-          {
-            // Return the current position as the parent node found
-            found = position;
-
-            // Parent node found, exit loop
-            break;
-          }
-        }
-      }
-
-      // Return the parent node found (might be nullptr)
-      return found;
-    }
-
-    //*************************************************************************
-    /// Find the parent node that contains the node provided in its left or
-    /// right tree
-    //*************************************************************************
-    const Node* find_parent_node(const Node* position, const Node* node) const
-    {
-      // Default to no parent node found
-      const Node* found = nullptr;
-
-      // If the position provided is the same as the node then there is no parent
-      if (position && node && position != node)
-      {
-        while (position)
-        {
-          // Is this position not the parent of the node we are looking for?
-          if (position->children[kLeft] != node &&
-              position->children[kRight] != node)
-          {
-            // Downcast node and position to Data_Node references for key comparisons
-            const Data_Node& node_data_node = imap::data_cast(*node);
-            const Data_Node& position_data_node = imap::data_cast(*position);
-            // Compare the node value to the current position value
-            if (node_comp(node_data_node, position_data_node))
-            {
-              // Keep looking for parent on the left
-              position = position->children[kLeft];
-            }
-            else if (node_comp(position_data_node, node_data_node))
-            {
-              // Keep looking for parent on the right
-              position = position->children[kRight];
-            }
-          }
-          else
-          {
-            // Return the current position as the parent node found
-            found = position;
-
-            // Parent node found, exit loop
-            break;
-          }
-        }
-      }
-
-      // Return the parent node found (might be nullptr)
-      return found;
-    }
-
     //*************************************************************************
     /// Find the node whose key is not considered to go before the key provided
     //*************************************************************************
-    Node* find_lower_node(Node* position, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    Node* find_lower_node(Node* position, const TLookupKey& key) const
     {
-      // Something at this position? keep going
-      Node* lower_node = position;
-      while (lower_node)
+      // Keep track of the last node whose key goes after the key provided
+      Node* lower_node = nullptr;
+      while (position)
       {
-        // Downcast lower node to Data_Node reference for key comparisons
-        Data_Node& data_node = imap::data_cast(*lower_node);
-        // Compare the key value to the current lower node key value
+        // Downcast position to Data_Node reference for key comparisons
+        Data_Node& data_node = imap::data_cast(*position);
+        // Compare the key value to the current position key value
         if (node_comp(key, data_node))
         {
-          if (lower_node->children[kLeft])
-          {
-            lower_node = lower_node->children[kLeft];
-          }
-          else
-          {
-            // Found lowest node
-            break;
-          }
+          lower_node = position;
+          position = position->children[kLeft];
         }
         else if (node_comp(data_node, key))
         {
-          lower_node = lower_node->children[kRight];
+          position = position->children[kRight];
         }
         else
         {
           // Found equal node
+          lower_node = position;
           break;
         }
       }
@@ -1247,7 +1866,8 @@ namespace sstl
     //*************************************************************************
     /// Find the node whose key is considered to go after the key provided
     //*************************************************************************
-    Node* find_upper_node(Node* position, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    Node* find_upper_node(Node* position, const TLookupKey& key) const
     {
       // Keep track of parent of last upper node
       Node* upper_node = nullptr;
@@ -1283,12 +1903,16 @@ namespace sstl
     }
 
     //*************************************************************************
-    /// Insert a node.
+    /// Insert a node for the key provided. The node is created by the
+    /// function provided only once the key is known not to be in the tree,
+    /// otherwise the node that holds the key already is returned.
     //*************************************************************************
-    Node* insert_node(Node*& position, Data_Node& node)
+    template <typename TCreateNode>
+    std::pair<Node*, bool> insert_node(Node*& position, const key_value_parameter_t& key, TCreateNode create_node)
     {
       // Find the location where the node belongs
       Node* found = position;
+      bool inserted = false;
 
       // Was position provided not empty? then find where the node belongs
       if (position)
@@ -1309,14 +1933,14 @@ namespace sstl
           // Downcast found to Data_Node class for comparison and other operations
           Data_Node& found_data_node = imap::data_cast(*found);
 
-          // Is the node provided to the left of the current position?
-          if (node_comp(node, found_data_node))
+          // Is the key provided to the left of the current position?
+          if (node_comp(key, found_data_node))
           {
             // Update direction taken to insert new node in parent node
             found->dir = kLeft;
           }
-          // Is the node provided to the right of the current position?
-          else if (node_comp(found_data_node, node))
+          // Is the key provided to the right of the current position?
+          else if (node_comp(found_data_node, key))
           {
             // Update direction taken to insert new node in parent node
             found->dir = kRight;
@@ -1329,10 +1953,7 @@ namespace sstl
             // Clear critical node value to skip weight step below
             critical_node = nullptr;
 
-            // Destroy the node provided (its a duplicate)
-            destroy_data_node(node);
-
-            // Exit loop, duplicate node found
+            // Exit loop, the key is already in the tree
             break;
           }
 
@@ -1351,11 +1972,12 @@ namespace sstl
           }
           else
           {
-            // Attatch node to right
-            attach_node(found->children[found->dir], node);
+            // Create the node and attach it as a child of the parent node found
+            attach_node(found, found->children[found->dir], create_node());
 
             // Return newly added node
             found = found->children[found->dir];
+            inserted = true;
 
             // Exit loop
             break;
@@ -1381,15 +2003,16 @@ namespace sstl
       }
       else
       {
-        // Attatch node to current position
-        attach_node(position, node);
+        // Attatch node to current position (which is assumed to be root)
+        attach_node(nullptr, position, create_node());
 
         // Return newly added node at current position
         found = position;
+        inserted = true;
       }
 
-      // Return the node found (might be nullptr)
-      return found;
+      // Return the node found and whether it was created
+      return std::make_pair(found, inserted);
     }
 
     //*************************************************************************
@@ -1414,7 +2037,7 @@ namespace sstl
             // Update current position as previous parent
             position = parent;
             // Find parent of current position
-            parent = find_parent_node(root_node, position);
+            parent = position->parent;
             // Repeat while previous position was on right side of parent tree
           } while (parent && parent->children[kRight] == position);
 
@@ -1446,7 +2069,7 @@ namespace sstl
             // Update current position as previous parent
             position = parent;
             // Find parent of current position
-            parent = find_parent_node(root_node, position);
+            parent = position->parent;
             // Repeat while previous position was on right side of parent tree
           } while (parent && parent->children[kRight] == position);
 
@@ -1465,7 +2088,7 @@ namespace sstl
       // from the root
       if (!position)
       {
-        position = find_limit_node(root_node, kRight);
+        position = rightmost_node;
       }
       else
       {
@@ -1484,7 +2107,7 @@ namespace sstl
             // Update current position as previous parent
             position = parent;
             // Find parent of current position
-            parent = find_parent_node(root_node, position);
+            parent = position->parent;
             // Repeat while previous position was on left side of parent tree
           } while (parent && parent->children[kLeft] == position);
 
@@ -1503,7 +2126,7 @@ namespace sstl
       // from the root
       if (!position)
       {
-        position = find_limit_node(root_node, kRight);
+        position = rightmost_node;
       }
       else
       {
@@ -1522,7 +2145,7 @@ namespace sstl
             // Update current position as previous parent
             position = parent;
             // Find parent of current position
-            parent = find_parent_node(root_node, position);
+            parent = position->parent;
             // Repeat while previous position was on left side of parent tree
           } while (parent && parent->children[kLeft] == position);
 
@@ -1533,10 +2156,25 @@ namespace sstl
     }
 
     //*************************************************************************
-    /// Remove the node specified from somewhere starting at the position
-    /// provided
+    /// Remove the node matching the key provided and destroy it
     //*************************************************************************
     Node* remove_node(Node*& position, const key_value_parameter_t& key)
+    {
+      Node* found = unlink_node(position, key);
+      if (found)
+      {
+        destroy_data_node(imap::data_cast(*found));
+      }
+
+      // Return node found (might be nullptr)
+      return found;
+    }
+
+    //*************************************************************************
+    /// Unlink the node matching the key provided from the tree starting at
+    /// the position provided, without destroying it
+    //*************************************************************************
+    Node* unlink_node(Node*& position, const key_value_parameter_t& key)
     {
       // Step 1: Find the target node that matches the key provided, the
       // replacement node (might be the same as target node), and the critical
@@ -1601,6 +2239,13 @@ namespace sstl
       // If target node was found, proceed with rebalancing and replacement
       if (found)
       {
+        // The last node is replaced by the previous one: its left child if
+        // any (a leaf, its right subtree being empty) or its parent
+        if (found == rightmost_node)
+        {
+          rightmost_node = found->children[kLeft] ? found->children[kLeft] : found->parent;
+        }
+
         // Step 2: Update weights from critical node to replacement parent node
         while (balance)
         {
@@ -1712,14 +2357,8 @@ namespace sstl
           }
         }
 
-        // Downcast found into data node
-        Data_Node& found_data_node = imap::data_cast(*found);
-
         // One less.
         --current_size;
-
-        // Destroy the node removed
-        destroy_data_node(found_data_node);
       } // if(found)
 
       // Return node found (might be nullptr)
@@ -1742,15 +2381,26 @@ namespace sstl
       // A (position) takes ownership of E as its left child
       // B (new position) takes ownership of A as its right child
 
-      // Capture new root
+      // Capture new root (either B or C depending on dir) and its parent
       Node* new_root = position->children[dir];
+
       // Replace position's previous child with new root's other child
       position->children[dir] = new_root->children[1 - dir];
-      // New root now becomes parent of current position
+      // Update new root's other child parent pointer
+      if (position->children[dir])
+      {
+        position->children[dir]->parent = position;
+      }
+
+      // New root's parent becomes current position's parent
+      new_root->parent = position->parent;
       new_root->children[1 - dir] = position;
+      new_root->dir = 1 - dir;
+
       // Clear weight factor from current position
       position->weight = kNeither;
-      // Newly detached right now becomes current position
+      // Position's parent becomes new_root
+      position->parent = new_root;
       position = new_root;
       // Clear weight factor from new root
       position->weight = kNeither;
@@ -1779,18 +2429,34 @@ namespace sstl
       position->children[dir]->weight = third != kNeither && third != dir ? dir : kNeither;
 
       // Detach new root from its tree (replace with new roots child)
-      position->children[dir]->children[1 - dir] =
-        new_root->children[dir];
-      // Attach current left tree to new root
+      position->children[dir]->children[1 - dir] = new_root->children[dir];
+      // Update new roots child parent pointer
+      if (new_root->children[dir])
+      {
+        new_root->children[dir]->parent = position->children[dir];
+      }
+
+      // Attach current left tree to new root and update its parent
       new_root->children[dir] = position->children[dir];
+      position->children[dir]->parent = new_root;
+
       // Set weight factor for A based on F or G
       position->weight = third != kNeither && third == dir ? 1 - dir : kNeither;
 
       // Move new root's right tree to current roots left tree
       position->children[dir] = new_root->children[1 - dir];
-      // Attach current root to new roots right tree
+      if (new_root->children[1 - dir])
+      {
+        new_root->children[1 - dir]->parent = position;
+      }
+
+      // Attach current root to new roots right tree and assume its parent
+      new_root->parent = position->parent;
       new_root->children[1 - dir] = position;
-      // Replace current position with new root
+      new_root->dir = 1 - dir;
+
+      // Update current position's parent and replace with new root
+      position->parent = new_root;
       position = new_root;
       // Clear weight factor for new current position
       position->weight = kNeither;
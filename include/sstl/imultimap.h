@@ -36,12 +36,16 @@ SOFTWARE.
 #include <iterator>
 #include <algorithm>
 #include <functional>
+#include <utility>
+#include <type_traits>
 
 #include <sstl_assert.h>
 
 #include "map_base.h"
 #include "bitmap_allocator.h"
 #include "__internal/parameter_type.h"
+#include "__internal/_except.h"
+#include "__internal/_utility.h"
 
 #if WIN32
 #undef min
@@ -95,6 +99,10 @@ namespace sstl
     static const uint8_t kRight = 1;
     static const uint8_t kNeither = 2;
 
+    /// The maximum height of the tree: an AVL tree of n nodes is less than
+    /// 1.45 * log2(n + 2) high.
+    static const size_t kMaxHeight = sizeof(size_t) * 8 * 3 / 2;
+
     //*************************************************************************
     /// The node element in the multimap.
     //*************************************************************************
@@ -132,8 +140,9 @@ namespace sstl
     //*************************************************************************
     struct Data_Node : public Node
     {
-      explicit Data_Node(value_type value)
-        : value(value)
+      template <typename... TArgs>
+      explicit Data_Node(TArgs&&... args)
+        : value(std::forward<TArgs>(args)...)
       {
       }
 
@@ -143,6 +152,11 @@ namespace sstl
     /// Defines the key value parameter type
     typedef typename parameter_type<TKey>::type key_value_parameter_t;
 
+    /// Enables the lookups by a key of another type (see find), only if the
+    /// comparator is transparent.
+    template <typename K>
+    using _enable_if_transparent = typename std::enable_if<_is_transparent<key_compare>::value, K>::type;
+
     //*************************************************************************
     /// How to compare node elements.
     //*************************************************************************
@@ -150,11 +164,13 @@ namespace sstl
     {
       return key_compare()(node1.value.first, node2.value.first);
     }
-    bool node_comp(const Data_Node& node, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    bool node_comp(const Data_Node& node, const TLookupKey& key) const
     {
       return key_compare()(node.value.first, key);
     }
-    bool node_comp(const key_value_parameter_t& key, const Data_Node& node) const
+    template <typename TLookupKey>
+    bool node_comp(const TLookupKey& key, const Data_Node& node) const
     {
       return key_compare()(key, node.value.first);
     }
@@ -167,6 +183,10 @@ namespace sstl
     /// The node that acts as the multimap root.
     Node* root_node;
 
+    /// The node of the last element (nullptr if empty), where the
+    /// increasing keys are appended.
+    Node* rightmost_node;
+
     //*************************************************************************
     /// Downcast a Node* to a Data_Node*
     //*************************************************************************
@@ -435,6 +455,112 @@ namespace sstl
     typedef std::reverse_iterator<iterator>       reverse_iterator;
     typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
+    //*************************************************************************
+    /// A node extracted from the multimap, owning its element. The node keeps its
+    /// block in the pool of the multimap it was extracted from, until it is
+    /// inserted back or the handle is destroyed: the handle must not outlive
+    /// that multimap, which meanwhile can hold one element less.
+    //*************************************************************************
+    class node_type
+    {
+    public:
+
+      friend class imultimap;
+
+      typedef TKey    key_type;
+      typedef TMapped mapped_type;
+
+      node_type()
+        : p_container(nullptr)
+        , p_node(nullptr)
+      {
+      }
+
+      node_type(node_type&& other)
+        : p_container(other.p_container)
+        , p_node(other.p_node)
+      {
+        other.p_container = nullptr;
+        other.p_node = nullptr;
+      }
+
+      ~node_type()
+      {
+        reset();
+      }
+
+      node_type& operator =(node_type&& other)
+      {
+        if (this != &other)
+        {
+          reset();
+          p_container = other.p_container;
+          p_node = other.p_node;
+          other.p_container = nullptr;
+          other.p_node = nullptr;
+        }
+
+        return *this;
+      }
+
+      bool empty() const
+      {
+        return p_node == nullptr;
+      }
+
+      explicit operator bool() const
+      {
+        return p_node != nullptr;
+      }
+
+      //***********************************************************************
+      /// The key of the element, it can be modified before inserting the node.
+      //***********************************************************************
+      key_type& key() const
+      {
+        sstl_assert(p_node);
+        return const_cast<key_type&>(p_node->value.first);
+      }
+
+      //***********************************************************************
+      /// The mapped value of the element.
+      //***********************************************************************
+      mapped_type& mapped() const
+      {
+        sstl_assert(p_node);
+        return p_node->value.second;
+      }
+
+    private:
+
+      node_type(imultimap& container, Node* node)
+        : p_container(&container)
+        , p_node(imultimap::data_cast(node))
+      {
+      }
+
+      node_type(const node_type&) = delete;
+      node_type& operator =(const node_type&) = delete;
+
+      //***********************************************************************
+      /// Destroys the element and gives its block back to the pool.
+      //***********************************************************************
+      void reset()
+      {
+        if (p_node)
+        {
+          p_container->destroy_extracted_node(*p_node);
+          p_container = nullptr;
+          p_node = nullptr;
+        }
+      }
+
+      // Pointer to the multimap the node was extracted from
+      imultimap* p_container;
+
+      // Pointer to the extracted node
+      Data_Node* p_node;
+    };
 
     //*************************************************************************
     /// Gets the beginning of the multimap.
@@ -544,6 +670,65 @@ namespace sstl
       insert(first, last);
     }
 
+    //*********************************************************************
+    /// Assigns the values of a sorted range to the multimap, building a
+    /// perfectly balanced tree in O(n) instead of inserting the values one
+    /// at a time. The range must be sorted by key_compare (checked by an assertion), the
+    /// equivalent keys being kept in the order of the range.
+    ///\param first The forward iterator to the first element.
+    ///\param last  The forward iterator to the last element + 1.
+    //*********************************************************************
+    template <typename TIterator>
+    void assign_sorted(TIterator first, TIterator last)
+    {
+      clear();
+      size_type count = static_cast<size_type>(std::distance(first, last));
+      sstl_assert(count <= available());
+
+      // The nodes are created in order and chained through their right
+      // children, then linked into the tree all at once
+      Node* list = nullptr;
+      Node** tail = &list;
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+        const Data_Node* previous = nullptr;
+        for (; first != last; ++first)
+        {
+          Data_Node& data_node = allocate_data_node(*first);
+          sstl_assert(!previous || !node_comp(data_node, *previous));
+          *tail = &data_node;
+          tail = &data_node.children[kRight];
+          previous = &data_node;
+        }
+        *tail = nullptr;
+        (void) previous;
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+        *tail = nullptr;
+        while (list)
+        {
+          Node* next = list->children[kRight];
+          destroy_data_node(imultimap::data_cast(*list));
+          list = next;
+        }
+        throw;
+      }
+      #endif
+
+      size_t height;
+      root_node = link_balanced_tree(list, count, height);
+      if (root_node)
+      {
+        root_node->parent = nullptr;
+      }
+      rightmost_node = find_limit_node(root_node, kRight);
+      current_size = count;
+    }
+
     //*************************************************************************
     /// Clears the multimap.
     //*************************************************************************
@@ -555,6 +740,7 @@ namespace sstl
         }
         current_size = 0;
         root_node = nullptr;
+        rightmost_node = nullptr;
     }
 
     //*********************************************************************
@@ -703,25 +889,166 @@ namespace sstl
     }
 
     //*********************************************************************
-    /// Inserts a value to the multimap starting at the position recommended.
-    ///\param position The position that would precede the value to insert.
+    /// Inserts a value to the multimap next to the position recommended.
+    ///\param position The position of the element that would follow the value.
     ///\param value    The value to insert.
     //*********************************************************************
     iterator insert(iterator position, const value_type& value)
     {
-      // Ignore position provided and just do a normal insert
-      return insert(value);
+      return insert(const_iterator(position), value);
     }
 
     //*********************************************************************
-    /// Inserts a value to the multimap starting at the position recommended.
-    ///\param position The position that would precede the value to insert.
+    /// Inserts a value to the multimap next to the position recommended: the
+    /// value is linked without a search from the root if it goes right
+    /// before (or right after) the element at the position, as when
+    /// appending increasing keys at end().
+    ///\param position The position of the element that would follow the value.
     ///\param value    The value to insert.
     //*********************************************************************
     iterator insert(const_iterator position, const value_type& value)
     {
-      // Ignore position provided and just do a normal insert
-      return insert(value);
+      return emplace_hint(position, value);
+    }
+
+    //*********************************************************************
+    /// Inserts a value to the multimap, moving it into the new node.
+    ///\param value    The value to insert.
+    //*********************************************************************
+    iterator insert(value_type&& value)
+    {
+      return emplace(std::move(value));
+    }
+
+    //*********************************************************************
+    /// Inserts a value constructed in place from the pair provided.
+    ///\param value    The pair to construct the value from.
+    //*********************************************************************
+    template <typename TPair,
+              typename = typename std::enable_if<std::is_constructible<value_type, TPair&&>::value &&
+                                                 !std::is_same<typename std::decay<TPair>::type, value_type>::value>::type>
+    iterator insert(TPair&& value)
+    {
+      return emplace(std::forward<TPair>(value));
+    }
+
+    //*********************************************************************
+    /// Inserts a value to the multimap next to the position recommended.
+    ///\param position The position of the element that would follow the value.
+    ///\param value    The value to insert.
+    //*********************************************************************
+    iterator insert(iterator position, value_type&& value)
+    {
+      return emplace_hint(const_iterator(position), std::move(value));
+    }
+
+    //*********************************************************************
+    /// Inserts a value to the multimap next to the position recommended.
+    ///\param position The position of the element that would follow the value.
+    ///\param value    The value to insert.
+    //*********************************************************************
+    iterator insert(const_iterator position, value_type&& value)
+    {
+      return emplace_hint(position, std::move(value));
+    }
+
+    //*********************************************************************
+    /// Constructs a value in place in a new node and inserts it to the multimap.
+    ///\param args The arguments to construct the value with.
+    //*********************************************************************
+    template <typename... TArgs>
+    iterator emplace(TArgs&&... args)
+    {
+      Data_Node& node = allocate_data_node(std::forward<TArgs>(args)...);
+      return iterator(*this, insert_node(root_node, node));
+    }
+
+    //*********************************************************************
+    /// Constructs a value in place and inserts it to the multimap next to the
+    /// position recommended (see insert).
+    ///\param position The position of the element that would follow the value.
+    ///\param args     The arguments to construct the value with.
+    //*********************************************************************
+    template <typename... TArgs>
+    iterator emplace_hint(const_iterator position, TArgs&&... args)
+    {
+      Data_Node& node = allocate_data_node(std::forward<TArgs>(args)...);
+      return iterator(*this, insert_node_at_hint(const_cast<Node*>(position.p_node), node));
+    }
+
+    //*********************************************************************
+    /// Extracts the element at the position provided from the multimap, without
+    /// destroying it.
+    ///\param position The position of the element to extract.
+    ///\return The node of the element.
+    //*********************************************************************
+    node_type extract(const_iterator position)
+    {
+      Node* node = const_cast<Node*>(position.p_node);
+      unlink_node(node);
+
+      ++extracted_size;
+      return node_type(*this, node);
+    }
+
+    //*********************************************************************
+    /// Extracts the first element with the key provided from the multimap,
+    /// without destroying it.
+    ///\param key The key of the element to extract.
+    ///\return The node of the element, empty if the key wasn't found.
+    //*********************************************************************
+    node_type extract(const key_value_parameter_t& key)
+    {
+      const_iterator position = lower_bound(key);
+      if (position == cend() || node_comp(key, imultimap::data_cast(*position.p_node)))
+      {
+        return node_type();
+      }
+
+      return extract(position);
+    }
+
+    //*********************************************************************
+    /// Inserts the element of the node provided. A node extracted from this
+    /// multimap is linked back into the tree, without copying the element.
+    /// A node extracted from another multimap is moved into a block of the pool
+    /// of this multimap.
+    ///\param node The node to insert.
+    ///\return The position of the element inserted, end() if the node is empty.
+    //*********************************************************************
+    iterator insert(node_type&& node)
+    {
+      if (node.empty())
+      {
+        return end();
+      }
+
+      Data_Node& data_node = *node.p_node;
+      if (node.p_container == this)
+      {
+        // Link the node back into the tree
+        --extracted_size;
+        node.p_container = nullptr;
+        node.p_node = nullptr;
+        return iterator(*this, insert_node(root_node, data_node));
+      }
+
+      // Relocate the element from the pool of the other multimap
+      iterator position = emplace(std::move(const_cast<TKey&>(data_node.value.first)),
+                                  std::move(data_node.value.second));
+      node.reset();
+      return position;
+    }
+
+    //*********************************************************************
+    /// Inserts the element of the node provided starting at the position
+    /// recommended.
+    ///\param position The position that would precede the node to insert.
+    ///\param node     The node to insert.
+    //*********************************************************************
+    iterator insert(const_iterator, node_type&& node)
+    {
+      return insert(std::move(node));
     }
 
     //*********************************************************************
@@ -735,7 +1062,8 @@ namespace sstl
     {
       while (first != last)
       {
-        insert(*first++);
+        // Appended next to the last element if the range is sorted
+        insert(cend(), *first++);
       }
     }
 
@@ -788,6 +1116,134 @@ namespace sstl
       return const_iterator(*this, find_upper_node(root_node, key));
     }
 
+    //*********************************************************************
+    /// Finds an element by a key of another type, compared with the keys
+    /// of the elements as it is: looking up a std::string key by a
+    /// const char* doesn't construct a temporary std::string.
+    /// Available only if key_compare declares is_transparent (e.g.
+    /// std::less<>), as the following overloads of count, lower_bound,
+    /// upper_bound and equal_range.
+    //*********************************************************************
+    template <typename K, typename = _enable_if_transparent<K>>
+    iterator find(const K& key)
+    {
+      return iterator(*this, find_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    const_iterator find(const K& key) const
+    {
+      return const_iterator(*this, find_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    size_type count(const K& key) const
+    {
+      return count_nodes(key);
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    iterator lower_bound(const K& key)
+    {
+      return iterator(*this, find_lower_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    const_iterator lower_bound(const K& key) const
+    {
+      return const_iterator(*this, find_lower_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    iterator upper_bound(const K& key)
+    {
+      return iterator(*this, find_upper_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    const_iterator upper_bound(const K& key) const
+    {
+      return const_iterator(*this, find_upper_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    std::pair<iterator, iterator> equal_range(const K& key)
+    {
+      return std::make_pair(iterator(*this, find_lower_node(root_node, key)),
+                            iterator(*this, find_upper_node(root_node, key)));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    std::pair<const_iterator, const_iterator> equal_range(const K& key) const
+    {
+      return std::make_pair(const_iterator(*this, find_lower_node(root_node, key)),
+                            const_iterator(*this, find_upper_node(root_node, key)));
+    }
+
+    //*********************************************************************
+    /// Calls the function provided for each element in order. The tree is
+    /// walked with an explicit stack, without climbing back through the
+    /// parent nodes as the iterators do.
+    ///\param function The function to call with each element.
+    ///\return The function provided.
+    //*********************************************************************
+    template <typename TFunction>
+    TFunction for_each(TFunction function)
+    {
+      Node* stack[kMaxHeight];
+      size_t top = 0;
+      Node* node = root_node;
+      while (node || top > 0)
+      {
+        // Descend to the leftmost node not visited yet
+        while (node)
+        {
+          stack[top++] = node;
+          node = node->children[kLeft];
+        }
+
+        node = stack[--top];
+        function(imultimap::data_cast(node)->value);
+
+        // Continue with the tree on the right
+        node = node->children[kRight];
+      }
+
+      return function;
+    }
+
+    //*********************************************************************
+    /// Calls the function provided for each element in order. The tree is
+    /// walked with an explicit stack, without climbing back through the
+    /// parent nodes as the iterators do.
+    ///\param function The function to call with each element.
+    ///\return The function provided.
+    //*********************************************************************
+    template <typename TFunction>
+    TFunction for_each(TFunction function) const
+    {
+      const Node* stack[kMaxHeight];
+      size_t top = 0;
+      const Node* node = root_node;
+      while (node || top > 0)
+      {
+        // Descend to the leftmost node not visited yet
+        while (node)
+        {
+          stack[top++] = node;
+          node = node->children[kLeft];
+        }
+
+        node = stack[--top];
+        function(imultimap::data_cast(node)->value);
+
+        // Continue with the tree on the right
+        node = node->children[kRight];
+      }
+
+      return function;
+    }
+
   protected:
 
     //*************************************************************************
@@ -797,6 +1253,7 @@ namespace sstl
       : map_base(max_size_)
       , p_node_pool(&node_pool)
       , root_node(nullptr)
+      , rightmost_node(nullptr)
     {
       clear();
     }
@@ -806,10 +1263,24 @@ namespace sstl
     //*************************************************************************
     /// Allocate a Data_Node.
     //*************************************************************************
-    Data_Node& allocate_data_node(value_type value) const
+    template <typename... TArgs>
+    Data_Node& allocate_data_node(TArgs&&... args) const
     {
+        sstl_assert(!full());
         auto p = p_node_pool->allocate();
-        new(p) Data_Node(value);
+        #if _sstl_has_exceptions()
+        try
+        {
+        #endif
+          new(p) Data_Node(std::forward<TArgs>(args)...);
+        #if _sstl_has_exceptions()
+        }
+        catch(...)
+        {
+          p_node_pool->deallocate(p);
+          throw;
+        }
+        #endif
         return *p;
     }
 
@@ -822,6 +1293,54 @@ namespace sstl
         p_node_pool->deallocate(&node);
     }
 
+    //*************************************************************************
+    /// Links the next count nodes of a list chained through their right
+    /// children into a perfectly balanced subtree, in order, and advances
+    /// the list past them. Returns the root of the subtree (its parent is
+    /// left to the caller) and its height.
+    //*************************************************************************
+    Node* link_balanced_tree(Node*& list, size_type count, size_t& height)
+    {
+      if (count == 0)
+      {
+        height = 0;
+        return nullptr;
+      }
+
+      // The right subtree gets the extra node, if any
+      size_type left_count = (count - 1) / 2;
+      size_t left_height;
+      size_t right_height;
+      Node* left = link_balanced_tree(list, left_count, left_height);
+      Node* node = list;
+      list = list->children[kRight];
+      Node* right = link_balanced_tree(list, count - 1 - left_count, right_height);
+
+      node->children[kLeft] = left;
+      node->children[kRight] = right;
+      if (left)
+      {
+        left->parent = node;
+      }
+      if (right)
+      {
+        right->parent = node;
+      }
+      node->weight = right_height > left_height ? uint8_t(kRight) : uint8_t(kNeither);
+      node->dir = kNeither;
+      height = right_height + 1;
+      return node;
+    }
+
+    //*************************************************************************
+    /// Destroy a Data_Node held by a node_type.
+    //*************************************************************************
+    void destroy_extracted_node(Data_Node& node)
+    {
+        --extracted_size;
+        destroy_data_node(node);
+    }
+
     //*************************************************************************
     /// Attach the provided node to the position provided
     //*************************************************************************
@@ -836,6 +1355,12 @@ namespace sstl
       // Add the node here
       position = &node;
 
+      // A node attached to the right of the last node is the new last node
+      if (parent == rightmost_node && (!parent || &position == &parent->children[kRight]))
+      {
+        rightmost_node = &node;
+      }
+
       // One more.
       ++current_size;
     }
@@ -906,7 +1431,8 @@ namespace sstl
     //*************************************************************************
     /// Count the nodes that match the key provided
     //*************************************************************************
-    size_type count_nodes(const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    size_type count_nodes(const TLookupKey& key) const
     {
       // Number of nodes that match the key provided result
       size_type result = 0;
@@ -935,6 +1461,114 @@ namespace sstl
       return result;
     }
 
+    //*************************************************************************
+    /// Insert the node provided next to the hint, if its key goes right
+    /// before the node at the hint (or right after it): the node is attached
+    /// to one of the neighbours without searching the tree from the root.
+    /// Otherwise the node is inserted as by insert_node.
+    //*************************************************************************
+    Node* insert_node_at_hint(Node* hint, Data_Node& node)
+    {
+      // Find the neighbours of the key next to the hint
+      Node* prev = hint;
+      Node* next = hint;
+      if (!hint || !node_comp(imultimap::data_cast(*hint), node))
+      {
+        // The key goes before the hint, does it go after the previous node?
+        prev_node(prev);
+        if (prev && node_comp(node, imultimap::data_cast(*prev)))
+        {
+          return insert_node(root_node, node);
+        }
+      }
+      else
+      {
+        // The key goes after the hint, does it go before the next node?
+        if (hint == rightmost_node)
+        {
+          next = nullptr;
+        }
+        else
+        {
+          next_node(next);
+        }
+        if (next && node_comp(imultimap::data_cast(*next), node))
+        {
+          return insert_node(root_node, node);
+        }
+      }
+
+      return attach_node_between(prev, next, [&node]() -> Data_Node& { return node; });
+    }
+
+    //*************************************************************************
+    /// Attach the node created by the function provided between the nodes
+    /// provided (next to each other in order, either one might be nullptr
+    /// at the ends), then balance the tree.
+    //*************************************************************************
+    template <typename TCreateNode>
+    Node* attach_node_between(Node* prev, Node* next, TCreateNode create_node)
+    {
+      Node* node;
+      if (!prev && !next)
+      {
+        attach_node(nullptr, root_node, create_node());
+        return root_node;
+      }
+      // Either the next node has no left child or the previous node (the
+      // maximum of that left child) has no right child
+      else if (next && !next->children[kLeft])
+      {
+        attach_node(next, next->children[kLeft], create_node());
+        node = next->children[kLeft];
+      }
+      else
+      {
+        attach_node(prev, prev->children[kRight], create_node());
+        node = prev->children[kRight];
+      }
+
+      balance_attached_node(node);
+      return node;
+    }
+
+    //*************************************************************************
+    /// Balance the tree after the node provided was attached as a leaf
+    /// without searching from the root: the directions from the critical
+    /// node down to the new node are marked going up the parents, as they
+    /// are by insert_node on its way down.
+    //*************************************************************************
+    void balance_attached_node(Node* node)
+    {
+      // The critical node is the nearest ancestor that isn't balanced (or
+      // the root)
+      Node* critical_node = node->parent;
+      while (true)
+      {
+        critical_node->dir = critical_node->children[kLeft] == node ? kLeft : kRight;
+        if (kNeither != critical_node->weight || !critical_node->parent)
+        {
+          break;
+        }
+        node = critical_node;
+        critical_node = critical_node->parent;
+      }
+
+      Node* critical_parent_node = critical_node->parent;
+      if (!critical_parent_node)
+      {
+        balance_node(root_node);
+      }
+      else if (critical_parent_node->children[kLeft] == critical_node)
+      {
+        balance_node(critical_parent_node->children[kLeft]);
+      }
+      else
+      {
+        balance_node(critical_parent_node->children[kRight]);
+      }
+    }
+
     //*************************************************************************
     /// Detach the node at the position provided
     //*************************************************************************
@@ -952,6 +1586,10 @@ namespace sstl
       // Update replacement node to point to child in opposite direction
       // otherwise we might lose the other child of the swap node
       replacement = swap->children[1 - swap->dir];
+      if (replacement)
+      {
+        replacement->parent = swap->parent;
+      }
 
       // Point swap node to detached node's parent, children and weight
       swap->parent = detached->parent;
@@ -971,7 +1609,8 @@ namespace sstl
     //*************************************************************************
     /// Find the value matching the node provided
     //*************************************************************************
-    Node* find_node(Node* position, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    Node* find_node(Node* position, const TLookupKey& key) const
     {
       Node* found = nullptr;
       while (position)
@@ -1004,7 +1643,8 @@ namespace sstl
     //*************************************************************************
     /// Find the value matching the node provided
     //*************************************************************************
-    const Node* find_node(const Node* position, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    const Node* find_node(const Node* position, const TLookupKey& key) const
     {
       const Node* found = nullptr;
       while (position)
@@ -1054,7 +1694,8 @@ namespace sstl
     //*************************************************************************
     /// Find the node whose key is not considered to go before the key provided
     //*************************************************************************
-    Node* find_lower_node(Node* position, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    Node* find_lower_node(Node* position, const TLookupKey& key) const
     {
       // Something at this position? keep going
       Node* lower_node = nullptr;
@@ -1095,7 +1736,8 @@ namespace sstl
     //*************************************************************************
     /// Find the node whose key is considered to go after the key provided
     //*************************************************************************
-    Node* find_upper_node(Node* position, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    Node* find_upper_node(Node* position, const TLookupKey& key) const
     {
       // Keep track of parent of last upper node
       Node* upper_node = nullptr;
@@ -1310,7 +1952,7 @@ namespace sstl
       // from the root
       if (!position)
       {
-        position = find_limit_node(root_node, kRight);
+        position = rightmost_node;
       }
       else
       {
@@ -1348,7 +1990,7 @@ namespace sstl
       // from the root
       if (!position)
       {
-        position = find_limit_node(root_node, kRight);
+        position = rightmost_node;
       }
       else
       {
@@ -1378,16 +2020,31 @@ namespace sstl
     }
 
     //*************************************************************************
-    /// Remove the node specified from somewhere starting at the position
-    /// provided
+    /// Remove the node specified and destroy it
     //*************************************************************************
     void remove_node(Node* node)
+    {
+      if (node)
+      {
+        unlink_node(node);
+        destroy_data_node(imultimap::data_cast(*node));
+      }
+    }
+
+    //*************************************************************************
+    /// Unlink the node specified from the tree, without destroying it
+    //*************************************************************************
+    void unlink_node(Node* node)
     {
       // If valid found node was provided then proceed with steps 1 through 5
       if (node)
       {
-        // Downcast found node provided to Data_Node class
-        Data_Node& data_node = imultimap::data_cast(*node);
+        // The last node is replaced by the previous one: its left child if
+        // any (a leaf, its right subtree being empty) or its parent
+        if (node == rightmost_node)
+        {
+          rightmost_node = node->children[kLeft] ? node->children[kLeft] : node->parent;
+        }
 
         // Keep track of node as found node
         Node* found = node;
@@ -1479,25 +2136,10 @@ namespace sstl
           // Keep searching for replacement node in the direction specified above
           node = node->children[node->dir];
 
-          // Downcast node to Data_Node class for comparison operations
-          Data_Node& replace_data_node = imultimap::data_cast(*node);
-
-          // Compare the key provided to the replace data node key
-          if (node_comp(data_node, replace_data_node))
-          {
-            // Update the direction to the replace node
-            node->dir = kLeft;
-          }
-          else if (node_comp(replace_data_node, data_node))
-          {
-            // Update the direction to the replace node
-            node->dir = kRight;
-          }
-          else
-          {
-            // Update the direction to the replace node
-            node->dir = node->children[kLeft] ? kLeft : kRight;
-          }
+          // The replacement is the in-order neighbour of found: the nodes
+          // equivalent to found may be on either side, so the keys can't
+          // tell the way
+          node->dir = 1 - found->dir;
         } // while(node)
 
         // Step 4: Update weights from balance to parent of node determined
@@ -1606,9 +2248,6 @@ namespace sstl
 
         // One less.
         --current_size;
-
-        // Destroy the node detached above
-        destroy_data_node(data_node);
       } // if(found)
     }
 
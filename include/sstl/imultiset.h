@@ -36,12 +36,17 @@ SOFTWARE.
 #include <iterator>
 #include <algorithm>
 #include <functional>
+#include <utility>
+#include <type_traits>
 
 #include <sstl_assert.h>
 
 #include "set_base.h"
 #include "bitmap_allocator.h"
 #include "__internal/parameter_type.h"
+#include "__internal/_except.h"
+#include "__internal/_utility.h"
+#include "__internal/_tree_augmentation.h"
 
 #if WIN32
 #undef min
@@ -51,9 +56,11 @@ namespace sstl
 {
   //***************************************************************************
   /// A templated base for all sstl::multiset types.
+  /// With the tree_order_statistics augmentation, the nodes also count the
+  /// nodes of their subtrees (see rank, nth and count_range).
   ///\ingroup set
   //***************************************************************************
-  template <typename T, typename TCompare>
+  template <typename T, typename TCompare, typename TAugmentation = tree_no_augmentation>
   class imultiset : public set_base
   {
   public:
@@ -93,10 +100,20 @@ namespace sstl
     static const uint8_t kRight = 1;
     static const uint8_t kNeither = 2;
 
+    /// The maximum height of the tree: an AVL tree of n nodes is less than
+    /// 1.45 * log2(n + 2) high.
+    static const size_t kMaxHeight = sizeof(size_t) * 8 * 3 / 2;
+
+    /// The parts of two multisets kept by a set operation: the elements only
+    /// in the first multiset, in both multisets and only in the second one.
+    static const uint8_t kFirstOnly = 1;
+    static const uint8_t kBoth = 2;
+    static const uint8_t kSecondOnly = 4;
+
     //*************************************************************************
     /// The node element in the multiset.
     //*************************************************************************
-    struct Node
+    struct Node : public _tree_node_augmentation<TAugmentation>
     {
       //***********************************************************************
       /// Constructor
@@ -130,8 +147,9 @@ namespace sstl
     //*************************************************************************
     struct Data_Node : public Node
     {
-      explicit Data_Node(value_type value)
-        : value(value)
+      template <typename... TArgs>
+      explicit Data_Node(TArgs&&... args)
+        : value(std::forward<TArgs>(args)...)
       {
       }
 
@@ -141,6 +159,11 @@ namespace sstl
     /// Defines the key value parameter type
     typedef typename parameter_type<T>::type key_value_parameter_t;
 
+    /// Enables the lookups by a key of another type (see find), only if the
+    /// comparator is transparent.
+    template <typename K>
+    using _enable_if_transparent = typename std::enable_if<_is_transparent<key_compare>::value, K>::type;
+
     //*************************************************************************
     /// How to compare node elements.
     //*************************************************************************
@@ -148,11 +171,13 @@ namespace sstl
     {
       return key_compare()(node1.value, node2.value);
     }
-    bool node_comp(const Data_Node& node, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    bool node_comp(const Data_Node& node, const TLookupKey& key) const
     {
       return key_compare()(node.value, key);
     }
-    bool node_comp(const key_value_parameter_t& key, const Data_Node& node) const
+    template <typename TLookupKey>
+    bool node_comp(const TLookupKey& key, const Data_Node& node) const
     {
       return key_compare()(key, node.value);
     }
@@ -165,6 +190,10 @@ namespace sstl
     /// The node that acts as the multiset root.
     Node* root_node;
 
+    /// The node of the last element (nullptr if empty), where the
+    /// increasing keys are appended.
+    Node* rightmost_node;
+
     //*************************************************************************
     /// Downcast a Node* to a Data_Node*
     //*************************************************************************
@@ -418,6 +447,102 @@ namespace sstl
     typedef std::reverse_iterator<iterator>       reverse_iterator;
     typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
+    //*************************************************************************
+    /// A node extracted from the multiset, owning its element. The node keeps its
+    /// block in the pool of the multiset it was extracted from, until it is
+    /// inserted back or the handle is destroyed: the handle must not outlive
+    /// that multiset, which meanwhile can hold one element less.
+    //*************************************************************************
+    class node_type
+    {
+    public:
+
+      friend class imultiset;
+
+      typedef T value_type;
+
+      node_type()
+        : p_container(nullptr)
+        , p_node(nullptr)
+      {
+      }
+
+      node_type(node_type&& other)
+        : p_container(other.p_container)
+        , p_node(other.p_node)
+      {
+        other.p_container = nullptr;
+        other.p_node = nullptr;
+      }
+
+      ~node_type()
+      {
+        reset();
+      }
+
+      node_type& operator =(node_type&& other)
+      {
+        if (this != &other)
+        {
+          reset();
+          p_container = other.p_container;
+          p_node = other.p_node;
+          other.p_container = nullptr;
+          other.p_node = nullptr;
+        }
+
+        return *this;
+      }
+
+      bool empty() const
+      {
+        return p_node == nullptr;
+      }
+
+      explicit operator bool() const
+      {
+        return p_node != nullptr;
+      }
+
+      //***********************************************************************
+      /// The value of the element, it can be modified before inserting the node.
+      //***********************************************************************
+      value_type& value() const
+      {
+        sstl_assert(p_node);
+        return const_cast<value_type&>(p_node->value);
+      }
+
+    private:
+
+      node_type(imultiset& container, Node* node)
+        : p_container(&container)
+        , p_node(imultiset::data_cast(node))
+      {
+      }
+
+      node_type(const node_type&) = delete;
+      node_type& operator =(const node_type&) = delete;
+
+      //***********************************************************************
+      /// Destroys the element and gives its block back to the pool.
+      //***********************************************************************
+      void reset()
+      {
+        if (p_node)
+        {
+          p_container->destroy_extracted_node(*p_node);
+          p_container = nullptr;
+          p_node = nullptr;
+        }
+      }
+
+      // Pointer to the multiset the node was extracted from
+      imultiset* p_container;
+
+      // Pointer to the extracted node
+      Data_Node* p_node;
+    };
 
     //*************************************************************************
     /// Gets the beginning of the multiset.
@@ -527,6 +652,59 @@ namespace sstl
       insert(first, last);
     }
 
+    //*********************************************************************
+    /// Assigns the values of a sorted range to the multiset, building a
+    /// perfectly balanced tree in O(n) instead of inserting the values one
+    /// at a time. The range must be sorted by key_compare (checked by an assertion), the
+    /// equivalent keys being kept in the order of the range.
+    ///\param first The forward iterator to the first element.
+    ///\param last  The forward iterator to the last element + 1.
+    //*********************************************************************
+    template <typename TIterator>
+    void assign_sorted(TIterator first, TIterator last)
+    {
+      clear();
+      size_type count = static_cast<size_type>(std::distance(first, last));
+      sstl_assert(count <= available());
+
+      // The nodes are created in order and chained through their right
+      // children, then linked into the tree all at once
+      Node* list = nullptr;
+      Node** tail = &list;
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+        const Data_Node* previous = nullptr;
+        for (; first != last; ++first)
+        {
+          Data_Node& data_node = allocate_data_node(*first);
+          sstl_assert(!previous || !node_comp(data_node, *previous));
+          *tail = &data_node;
+          tail = &data_node.children[kRight];
+          previous = &data_node;
+        }
+        *tail = nullptr;
+        (void) previous;
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+        *tail = nullptr;
+        while (list)
+        {
+          Node* next = list->children[kRight];
+          destroy_data_node(imultiset::data_cast(*list));
+          list = next;
+        }
+        throw;
+      }
+      #endif
+
+      current_size = count;
+      link_sorted_list(list);
+    }
+
     //*************************************************************************
     /// Clears the multiset.
     //*************************************************************************
@@ -538,6 +716,7 @@ namespace sstl
         }
         current_size = 0;
         root_node = nullptr;
+        rightmost_node = nullptr;
     }
 
     //*********************************************************************
@@ -686,25 +865,153 @@ namespace sstl
     }
 
     //*********************************************************************
-    /// Inserts a value to the multiset starting at the position recommended.
-    ///\param position The position that would precede the value to insert.
+    /// Inserts a value to the multiset next to the position recommended.
+    ///\param position The position of the element that would follow the value.
     ///\param value    The value to insert.
     //*********************************************************************
     iterator insert(iterator position, const value_type& value)
     {
-      // Ignore position provided and just do a normal insert
-      return insert(value);
+      return insert(const_iterator(position), value);
     }
 
     //*********************************************************************
-    /// Inserts a value to the multiset starting at the position recommended.
-    ///\param position The position that would precede the value to insert.
+    /// Inserts a value to the multiset next to the position recommended: the
+    /// value is linked without a search from the root if it goes right
+    /// before (or right after) the element at the position, as when
+    /// appending increasing keys at end().
+    ///\param position The position of the element that would follow the value.
     ///\param value    The value to insert.
     //*********************************************************************
     iterator insert(const_iterator position, const value_type& value)
     {
-      // Ignore position provided and just do a normal insert
-      return insert(value);
+      return emplace_hint(position, value);
+    }
+
+    //*********************************************************************
+    /// Inserts a value to the multiset, moving it into the new node.
+    ///\param value    The value to insert.
+    //*********************************************************************
+    iterator insert(T&& value)
+    {
+      return emplace(std::move(value));
+    }
+
+    //*********************************************************************
+    /// Inserts a value to the multiset next to the position recommended.
+    ///\param position The position of the element that would follow the value.
+    ///\param value    The value to insert.
+    //*********************************************************************
+    iterator insert(iterator position, T&& value)
+    {
+      return emplace_hint(const_iterator(position), std::move(value));
+    }
+
+    //*********************************************************************
+    /// Inserts a value to the multiset next to the position recommended.
+    ///\param position The position of the element that would follow the value.
+    ///\param value    The value to insert.
+    //*********************************************************************
+    iterator insert(const_iterator position, T&& value)
+    {
+      return emplace_hint(position, std::move(value));
+    }
+
+    //*********************************************************************
+    /// Constructs a value in place in a new node and inserts it to the multiset.
+    ///\param args The arguments to construct the value with.
+    //*********************************************************************
+    template <typename... TArgs>
+    iterator emplace(TArgs&&... args)
+    {
+      Data_Node& node = allocate_data_node(std::forward<TArgs>(args)...);
+      return iterator(*this, insert_node(root_node, node));
+    }
+
+    //*********************************************************************
+    /// Constructs a value in place and inserts it to the multiset next to the
+    /// position recommended (see insert).
+    ///\param position The position of the element that would follow the value.
+    ///\param args     The arguments to construct the value with.
+    //*********************************************************************
+    template <typename... TArgs>
+    iterator emplace_hint(const_iterator position, TArgs&&... args)
+    {
+      Data_Node& node = allocate_data_node(std::forward<TArgs>(args)...);
+      return iterator(*this, insert_node_at_hint(const_cast<Node*>(position.p_node), node));
+    }
+
+    //*********************************************************************
+    /// Extracts the element at the position provided from the multiset, without
+    /// destroying it.
+    ///\param position The position of the element to extract.
+    ///\return The node of the element.
+    //*********************************************************************
+    node_type extract(const_iterator position)
+    {
+      Node* node = const_cast<Node*>(position.p_node);
+      unlink_node(node);
+
+      ++extracted_size;
+      return node_type(*this, node);
+    }
+
+    //*********************************************************************
+    /// Extracts the first element with the key provided from the multiset,
+    /// without destroying it.
+    ///\param key The key of the element to extract.
+    ///\return The node of the element, empty if the key wasn't found.
+    //*********************************************************************
+    node_type extract(const key_value_parameter_t& key)
+    {
+      const_iterator position = lower_bound(key);
+      if (position == cend() || node_comp(key, imultiset::data_cast(*position.p_node)))
+      {
+        return node_type();
+      }
+
+      return extract(position);
+    }
+
+    //*********************************************************************
+    /// Inserts the element of the node provided. A node extracted from this
+    /// multiset is linked back into the tree, without copying the element.
+    /// A node extracted from another multiset is moved into a block of the pool
+    /// of this multiset.
+    ///\param node The node to insert.
+    ///\return The position of the element inserted, end() if the node is empty.
+    //*********************************************************************
+    iterator insert(node_type&& node)
+    {
+      if (node.empty())
+      {
+        return end();
+      }
+
+      Data_Node& data_node = *node.p_node;
+      if (node.p_container == this)
+      {
+        // Link the node back into the tree
+        --extracted_size;
+        node.p_container = nullptr;
+        node.p_node = nullptr;
+        return iterator(*this, insert_node(root_node, data_node));
+      }
+
+      // Relocate the element from the pool of the other multiset
+      iterator position = emplace(std::move(const_cast<T&>(data_node.value)));
+      node.reset();
+      return position;
+    }
+
+    //*********************************************************************
+    /// Inserts the element of the node provided starting at the position
+    /// recommended.
+    ///\param position The position that would precede the node to insert.
+    ///\param node     The node to insert.
+    //*********************************************************************
+    iterator insert(const_iterator, node_type&& node)
+    {
+      return insert(std::move(node));
     }
 
     //*********************************************************************
@@ -718,8 +1025,126 @@ namespace sstl
     {
       while (first != last)
       {
-        insert(*first++);
+        // Appended next to the last element if the range is sorted
+        insert(cend(), *first++);
+      }
+    }
+
+    //*********************************************************************
+    /// Moves the elements of the other multiset, as std::multiset::merge
+    /// does: each one goes after the equivalent elements of this multiset.
+    /// The elements are relocated into the pool of this multiset. Both trees
+    /// are flattened into sorted lists, merged in one pass and relinked
+    /// balanced, in O(n + m) instead of one insertion per element. The
+    /// elements that don't fit once the multiset is full are left in the
+    /// other multiset.
+    ///\param other The multiset to take the elements from.
+    //*********************************************************************
+    void merge(imultiset& other)
+    {
+      if (&other == this || other.empty())
+      {
+        return;
+      }
+
+      Node* mine = flatten_tree(root_node);
+      Node* theirs = flatten_tree(other.root_node);
+      Node* merged = nullptr;
+      Node** merged_tail = &merged;
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+        while (theirs)
+        {
+          if (mine && !node_comp(imultiset::data_cast(*theirs), imultiset::data_cast(*mine)))
+          {
+            *merged_tail = mine;
+            merged_tail = &mine->children[kRight];
+            mine = mine->children[kRight];
+          }
+          else
+          {
+            if (full())
+            {
+              break;
+            }
+            Data_Node& data_node = imultiset::data_cast(*theirs);
+            Data_Node& moved_node = allocate_data_node(std::move(const_cast<T&>(data_node.value)));
+            ++current_size;
+            *merged_tail = &moved_node;
+            merged_tail = &moved_node.children[kRight];
+            theirs = theirs->children[kRight];
+            other.destroy_data_node(data_node);
+            --other.current_size;
+          }
+        }
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+        *merged_tail = mine;
+        link_sorted_list(merged);
+        other.link_sorted_list(theirs);
+        throw;
       }
+      #endif
+
+      *merged_tail = mine;
+      link_sorted_list(merged);
+      other.link_sorted_list(theirs);
+    }
+
+    //*********************************************************************
+    /// Moves the elements of the other multiset.
+    ///\param other The multiset to take the elements from.
+    //*********************************************************************
+    void merge(imultiset&& other)
+    {
+      merge(other);
+    }
+
+    //*********************************************************************
+    /// Assigns the union of two multisets to the destination multiset, as
+    /// std::set_union does: an element equivalent to k elements of one
+    /// multiset and j of the other is kept max(k, j) times. The sorted
+    /// sequences of the two multisets are merged in one pass and the
+    /// destination is built balanced, in O(n + m) instead of one insertion
+    /// per element. The destination must be another multiset, with room for
+    /// the result (checked by an assertion).
+    //*********************************************************************
+    friend void set_union(const imultiset& first, const imultiset& second, imultiset& destination)
+    {
+      destination.assign_set_operation(first, second, kFirstOnly | kBoth | kSecondOnly);
+    }
+
+    //*********************************************************************
+    /// Assigns the intersection of two multisets to the destination
+    /// multiset (min(k, j) equivalent elements), in O(n + m) (see set_union).
+    //*********************************************************************
+    friend void set_intersection(const imultiset& first, const imultiset& second, imultiset& destination)
+    {
+      destination.assign_set_operation(first, second, kBoth);
+    }
+
+    //*********************************************************************
+    /// Assigns the elements of the first multiset that aren't matched by an
+    /// element of the second one to the destination multiset (max(k - j, 0)
+    /// equivalent elements), in O(n + m) (see set_union).
+    //*********************************************************************
+    friend void set_difference(const imultiset& first, const imultiset& second, imultiset& destination)
+    {
+      destination.assign_set_operation(first, second, kFirstOnly);
+    }
+
+    //*********************************************************************
+    /// Assigns the elements of either multiset that aren't matched by an
+    /// element of the other one to the destination multiset (|k - j|
+    /// equivalent elements), in O(n + m) (see set_union).
+    //*********************************************************************
+    friend void set_symmetric_difference(const imultiset& first, const imultiset& second, imultiset& destination)
+    {
+      destination.assign_set_operation(first, second, kFirstOnly | kSecondOnly);
     }
 
     void print() const
@@ -771,6 +1196,166 @@ namespace sstl
       return const_iterator(*this, find_upper_node(root_node, key));
     }
 
+    //*********************************************************************
+    /// Finds an element by a key of another type, compared with the keys
+    /// of the elements as it is: looking up a std::string key by a
+    /// const char* doesn't construct a temporary std::string.
+    /// Available only if key_compare declares is_transparent (e.g.
+    /// std::less<>), as the following overloads of count, lower_bound,
+    /// upper_bound and equal_range.
+    //*********************************************************************
+    template <typename K, typename = _enable_if_transparent<K>>
+    iterator find(const K& key)
+    {
+      return iterator(*this, find_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    const_iterator find(const K& key) const
+    {
+      return const_iterator(*this, find_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    size_type count(const K& key) const
+    {
+      return count_nodes(key);
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    iterator lower_bound(const K& key)
+    {
+      return iterator(*this, find_lower_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    const_iterator lower_bound(const K& key) const
+    {
+      return const_iterator(*this, find_lower_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    iterator upper_bound(const K& key)
+    {
+      return iterator(*this, find_upper_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    const_iterator upper_bound(const K& key) const
+    {
+      return const_iterator(*this, find_upper_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    std::pair<iterator, iterator> equal_range(const K& key)
+    {
+      return std::make_pair(iterator(*this, find_lower_node(root_node, key)),
+                            iterator(*this, find_upper_node(root_node, key)));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    std::pair<const_iterator, const_iterator> equal_range(const K& key) const
+    {
+      return std::make_pair(const_iterator(*this, find_lower_node(root_node, key)),
+                            const_iterator(*this, find_upper_node(root_node, key)));
+    }
+
+    //*********************************************************************
+    /// Returns the number of elements whose key goes before the key
+    /// provided, i.e. the position of lower_bound(key) in order (the
+    /// position of the first element with the key, if any).
+    /// Available only with the tree_order_statistics augmentation, as nth
+    /// and count_range: O(log n) instead of walking the elements.
+    ///\param key The key to rank.
+    ///\return The number of elements before the key.
+    //*********************************************************************
+    size_type rank(const key_value_parameter_t& key) const
+    {
+      return rank_of_key(key);
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    size_type rank(const K& key) const
+    {
+      return rank_of_key(key);
+    }
+
+    //*********************************************************************
+    /// Returns an iterator pointing to the element at the position
+    /// provided in order (starting from zero), or end() if the position
+    /// is not less than size().
+    ///\param position The position of the element.
+    ///\return An iterator pointing to the element or end().
+    //*********************************************************************
+    iterator nth(size_type position)
+    {
+      return iterator(*this, find_nth_node(position));
+    }
+
+    //*********************************************************************
+    /// Returns a const_iterator pointing to the element at the position
+    /// provided in order (starting from zero), or end() if the position
+    /// is not less than size().
+    ///\param position The position of the element.
+    ///\return A const_iterator pointing to the element or end().
+    //*********************************************************************
+    const_iterator nth(size_type position) const
+    {
+      return const_iterator(*this, find_nth_node(position));
+    }
+
+    //*********************************************************************
+    /// Returns the number of elements whose key doesn't go before first
+    /// and goes before last, i.e. the length of the range from
+    /// lower_bound(first) to lower_bound(last).
+    ///\param first The first key of the range.
+    ///\param last  The key past the range.
+    ///\return The number of elements in the range (zero if last goes
+    /// before first).
+    //*********************************************************************
+    size_type count_range(const key_value_parameter_t& first, const key_value_parameter_t& last) const
+    {
+      return count_keys_between(first, last);
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    size_type count_range(const K& first, const K& last) const
+    {
+      return count_keys_between(first, last);
+    }
+
+    //*********************************************************************
+    /// Calls the function provided for each element in order. The tree is
+    /// walked with an explicit stack, without climbing back through the
+    /// parent nodes as the iterators do.
+    ///\param function The function to call with each element.
+    ///\return The function provided.
+    //*********************************************************************
+    template <typename TFunction>
+    TFunction for_each(TFunction function) const
+    {
+      const Node* stack[kMaxHeight];
+      size_t top = 0;
+      const Node* node = root_node;
+      while (node || top > 0)
+      {
+        // Descend to the leftmost node not visited yet
+        while (node)
+        {
+          stack[top++] = node;
+          node = node->children[kLeft];
+        }
+
+        node = stack[--top];
+        function(imultiset::data_cast(node)->value);
+
+        // Continue with the tree on the right
+        node = node->children[kRight];
+      }
+
+      return function;
+    }
+
   protected:
 
     //*************************************************************************
@@ -780,6 +1365,7 @@ namespace sstl
       : set_base(max_size_)
       , p_node_pool(&node_pool)
       , root_node(nullptr)
+      , rightmost_node(nullptr)
     {
       clear();
     }
@@ -789,10 +1375,24 @@ namespace sstl
     //*************************************************************************
     /// Allocate a Data_Node.
     //*************************************************************************
-    Data_Node& allocate_data_node(value_type value) const
+    template <typename... TArgs>
+    Data_Node& allocate_data_node(TArgs&&... args) const
     {
+        sstl_assert(!full());
         auto p = p_node_pool->allocate();
-        new(p) Data_Node(value);
+        #if _sstl_has_exceptions()
+        try
+        {
+        #endif
+          new(p) Data_Node(std::forward<TArgs>(args)...);
+        #if _sstl_has_exceptions()
+        }
+        catch(...)
+        {
+          p_node_pool->deallocate(p);
+          throw;
+        }
+        #endif
         return *p;
     }
 
@@ -805,6 +1405,366 @@ namespace sstl
         p_node_pool->deallocate(&node);
     }
 
+    //*************************************************************************
+    /// The number of nodes of the subtree at the node provided (zero for an
+    /// empty subtree), counted with the tree_order_statistics augmentation.
+    //*************************************************************************
+    static size_type subtree_size(const Node* node)
+    {
+      return node ? node->subtree_size : 0;
+    }
+
+    //*************************************************************************
+    /// Recount the nodes of the subtree at the node provided from its
+    /// children (after linking or rotating them).
+    //*************************************************************************
+    static void update_subtree_size(Node* node)
+    {
+      update_subtree_size(node, _has_order_statistics<TAugmentation>());
+    }
+
+    static void update_subtree_size(Node*, std::false_type)
+    {
+    }
+
+    static void update_subtree_size(Node* node, std::true_type)
+    {
+      node->subtree_size = subtree_size(node->children[kLeft]) + subtree_size(node->children[kRight]) + 1;
+    }
+
+    //*************************************************************************
+    /// Add one node to (or remove one from) the subtrees of the node
+    /// provided and of its ancestors, up to the root.
+    //*************************************************************************
+    static void adjust_subtree_sizes(Node* node, bool grow)
+    {
+      adjust_subtree_sizes(node, grow, _has_order_statistics<TAugmentation>());
+    }
+
+    static void adjust_subtree_sizes(Node*, bool, std::false_type)
+    {
+    }
+
+    static void adjust_subtree_sizes(Node* node, bool grow, std::true_type)
+    {
+      for (; node; node = node->parent)
+      {
+        if (grow)
+        {
+          ++node->subtree_size;
+        }
+        else
+        {
+          --node->subtree_size;
+        }
+      }
+    }
+
+    //*************************************************************************
+    /// The replacement node of an erasure takes the place of the node
+    /// removed, with the subtree of that node.
+    //*************************************************************************
+    static void copy_subtree_size(Node* destination, const Node* source)
+    {
+      copy_subtree_size(destination, source, _has_order_statistics<TAugmentation>());
+    }
+
+    static void copy_subtree_size(Node*, const Node*, std::false_type)
+    {
+    }
+
+    static void copy_subtree_size(Node* destination, const Node* source, std::true_type)
+    {
+      destination->subtree_size = source->subtree_size;
+    }
+
+    //*************************************************************************
+    /// The number of elements whose key goes before the key provided: the
+    /// sizes of the left subtrees skipped on the way down, plus the nodes.
+    //*************************************************************************
+    template <typename TLookupKey>
+    size_type rank_of_key(const TLookupKey& key) const
+    {
+      static_assert(_has_order_statistics<TAugmentation>::value, "rank requires the tree_order_statistics augmentation");
+
+      size_type rank = 0;
+      const Node* node = root_node;
+      while (node)
+      {
+        if (node_comp(imultiset::data_cast(*node), key))
+        {
+          rank += subtree_size(node->children[kLeft]) + 1;
+          node = node->children[kRight];
+        }
+        else
+        {
+          node = node->children[kLeft];
+        }
+      }
+
+      return rank;
+    }
+
+    //*************************************************************************
+    /// The number of elements between the keys provided (see count_range).
+    //*************************************************************************
+    template <typename TLookupKey>
+    size_type count_keys_between(const TLookupKey& first, const TLookupKey& last) const
+    {
+      size_type first_rank = rank_of_key(first);
+      size_type last_rank = rank_of_key(last);
+      return last_rank > first_rank ? last_rank - first_rank : 0;
+    }
+
+    //*************************************************************************
+    /// Find the node at the position provided in order (nullptr if the
+    /// position is not less than the size).
+    //*************************************************************************
+    Node* find_nth_node(size_type position) const
+    {
+      static_assert(_has_order_statistics<TAugmentation>::value, "nth requires the tree_order_statistics augmentation");
+
+      Node* node = root_node;
+      while (node)
+      {
+        size_type left_size = subtree_size(node->children[kLeft]);
+        if (position < left_size)
+        {
+          node = node->children[kLeft];
+        }
+        else if (position == left_size)
+        {
+          break;
+        }
+        else
+        {
+          position -= left_size + 1;
+          node = node->children[kRight];
+        }
+      }
+
+      return node;
+    }
+
+    //*************************************************************************
+    /// Links the next count nodes of a list chained through their right
+    /// children into a perfectly balanced subtree, in order, and advances
+    /// the list past them. Returns the root of the subtree (its parent is
+    /// left to the caller) and its height.
+    //*************************************************************************
+    Node* link_balanced_tree(Node*& list, size_type count, size_t& height)
+    {
+      if (count == 0)
+      {
+        height = 0;
+        return nullptr;
+      }
+
+      // The right subtree gets the extra node, if any
+      size_type left_count = (count - 1) / 2;
+      size_t left_height;
+      size_t right_height;
+      Node* left = link_balanced_tree(list, left_count, left_height);
+      Node* node = list;
+      list = list->children[kRight];
+      Node* right = link_balanced_tree(list, count - 1 - left_count, right_height);
+
+      node->children[kLeft] = left;
+      node->children[kRight] = right;
+      if (left)
+      {
+        left->parent = node;
+      }
+      if (right)
+      {
+        right->parent = node;
+      }
+      node->weight = right_height > left_height ? uint8_t(kRight) : uint8_t(kNeither);
+      update_subtree_size(node);
+      node->dir = kNeither;
+      height = right_height + 1;
+      return node;
+    }
+
+    //*************************************************************************
+    /// Links a list of current_size nodes, chained in order through their
+    /// right children, into the tree of the multiset.
+    //*************************************************************************
+    void link_sorted_list(Node* list)
+    {
+      size_t height;
+      root_node = link_balanced_tree(list, current_size, height);
+      if (root_node)
+      {
+        root_node->parent = nullptr;
+      }
+      rightmost_node = find_limit_node(root_node, kRight);
+    }
+
+    //*************************************************************************
+    /// Walks a tree in order with an explicit stack, as for_each does,
+    /// without climbing back through the parent nodes as the iterators do.
+    //*************************************************************************
+    class in_order_cursor
+    {
+    public:
+
+      explicit in_order_cursor(const Node* root)
+        : top(0)
+      {
+        descend(root);
+      }
+
+      /// The current node, nullptr past the last node.
+      const Node* node() const
+      {
+        return top > 0 ? stack[top - 1] : nullptr;
+      }
+
+      void next()
+      {
+        const Node* current = stack[--top];
+        descend(current->children[kRight]);
+      }
+
+    private:
+
+      void descend(const Node* node)
+      {
+        while (node)
+        {
+          stack[top++] = node;
+          node = node->children[kLeft];
+        }
+      }
+
+      const Node* stack[kMaxHeight];
+      size_t top;
+    };
+
+    //*************************************************************************
+    /// Chains the nodes of the tree provided in order through their right
+    /// children, and returns the first one. The right child of each node is
+    /// read before it gets overwritten by the link to the next node.
+    //*************************************************************************
+    static Node* flatten_tree(Node* root)
+    {
+      Node* stack[kMaxHeight];
+      size_t top = 0;
+      Node* list = nullptr;
+      Node** tail = &list;
+      Node* node = root;
+      while (node || top > 0)
+      {
+        while (node)
+        {
+          stack[top++] = node;
+          node = node->children[kLeft];
+        }
+
+        node = stack[--top];
+        *tail = node;
+        tail = &node->children[kRight];
+        node = node->children[kRight];
+      }
+      *tail = nullptr;
+
+      return list;
+    }
+
+    //*************************************************************************
+    /// Assigns the parts of two multisets selected by a set operation (kFirstOnly,
+    /// kBoth, kSecondOnly) in one merge of their sorted sequences, creating
+    /// the nodes in order and linking them into a balanced tree.
+    //*************************************************************************
+    void assign_set_operation(const imultiset& first, const imultiset& second, uint8_t parts)
+    {
+      sstl_assert(this != &first && this != &second);
+      clear();
+
+      Node* list = nullptr;
+      Node** tail = &list;
+      auto append = [this, &tail](const value_type& value)
+      {
+        sstl_assert(!full());
+        Data_Node& data_node = allocate_data_node(value);
+        ++current_size;
+        *tail = &data_node;
+        tail = &data_node.children[kRight];
+      };
+
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+        in_order_cursor first_cursor(first.root_node);
+        in_order_cursor second_cursor(second.root_node);
+        while (first_cursor.node() && second_cursor.node())
+        {
+          const Data_Node& first_node = imultiset::data_cast(*first_cursor.node());
+          const Data_Node& second_node = imultiset::data_cast(*second_cursor.node());
+          if (node_comp(first_node, second_node))
+          {
+            if (parts & kFirstOnly)
+            {
+              append(first_node.value);
+            }
+            first_cursor.next();
+          }
+          else if (node_comp(second_node, first_node))
+          {
+            if (parts & kSecondOnly)
+            {
+              append(second_node.value);
+            }
+            second_cursor.next();
+          }
+          else
+          {
+            if (parts & kBoth)
+            {
+              append(first_node.value);
+            }
+            first_cursor.next();
+            second_cursor.next();
+          }
+        }
+        for (; (parts & kFirstOnly) && first_cursor.node(); first_cursor.next())
+        {
+          append(imultiset::data_cast(first_cursor.node())->value);
+        }
+        for (; (parts & kSecondOnly) && second_cursor.node(); second_cursor.next())
+        {
+          append(imultiset::data_cast(second_cursor.node())->value);
+        }
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+        *tail = nullptr;
+        while (list)
+        {
+          Node* next = list->children[kRight];
+          destroy_data_node(imultiset::data_cast(*list));
+          list = next;
+        }
+        current_size = 0;
+        throw;
+      }
+      #endif
+
+      link_sorted_list(list);
+    }
+
+    //*************************************************************************
+    /// Destroy a Data_Node held by a node_type.
+    //*************************************************************************
+    void destroy_extracted_node(Data_Node& node)
+    {
+        --extracted_size;
+        destroy_data_node(node);
+    }
+
     //*************************************************************************
     /// Attach the provided node to the position provided
     //*************************************************************************
@@ -819,6 +1779,16 @@ namespace sstl
       // Add the node here
       position = &node;
 
+      // One more node in the subtrees of the ancestors
+      update_subtree_size(&node);
+      adjust_subtree_sizes(parent, true);
+
+      // A node attached to the right of the last node is the new last node
+      if (parent == rightmost_node && (!parent || &position == &parent->children[kRight]))
+      {
+        rightmost_node = &node;
+      }
+
       // One more.
       ++current_size;
     }
@@ -889,7 +1859,8 @@ namespace sstl
     //*************************************************************************
     /// Count the nodes that match the key provided
     //*************************************************************************
-    size_type count_nodes(const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    size_type count_nodes(const TLookupKey& key) const
     {
       // Number of nodes that match the key provided result
       size_type result = 0;
@@ -918,6 +1889,114 @@ namespace sstl
       return result;
     }
 
+    //*************************************************************************
+    /// Insert the node provided next to the hint, if its key goes right
+    /// before the node at the hint (or right after it): the node is attached
+    /// to one of the neighbours without searching the tree from the root.
+    /// Otherwise the node is inserted as by insert_node.
+    //*************************************************************************
+    Node* insert_node_at_hint(Node* hint, Data_Node& node)
+    {
+      // Find the neighbours of the key next to the hint
+      Node* prev = hint;
+      Node* next = hint;
+      if (!hint || !node_comp(imultiset::data_cast(*hint), node))
+      {
+        // The key goes before the hint, does it go after the previous node?
+        prev_node(prev);
+        if (prev && node_comp(node, imultiset::data_cast(*prev)))
+        {
+          return insert_node(root_node, node);
+        }
+      }
+      else
+      {
+        // The key goes after the hint, does it go before the next node?
+        if (hint == rightmost_node)
+        {
+          next = nullptr;
+        }
+        else
+        {
+          next_node(next);
+        }
+        if (next && node_comp(imultiset::data_cast(*next), node))
+        {
+          return insert_node(root_node, node);
+        }
+      }
+
+      return attach_node_between(prev, next, [&node]() -> Data_Node& { return node; });
+    }
+
+    //*************************************************************************
+    /// Attach the node created by the function provided between the nodes
+    /// provided (next to each other in order, either one might be nullptr
+    /// at the ends), then balance the tree.
+    //*************************************************************************
+    template <typename TCreateNode>
+    Node* attach_node_between(Node* prev, Node* next, TCreateNode create_node)
+    {
+      Node* node;
+      if (!prev && !next)
+      {
+        attach_node(nullptr, root_node, create_node());
+        return root_node;
+      }
+      // Either the next node has no left child or the previous node (the
+      // maximum of that left child) has no right child
+      else if (next && !next->children[kLeft])
+      {
+        attach_node(next, next->children[kLeft], create_node());
+        node = next->children[kLeft];
+      }
+      else
+      {
+        attach_node(prev, prev->children[kRight], create_node());
+        node = prev->children[kRight];
+      }
+
+      balance_attached_node(node);
+      return node;
+    }
+
+    //*************************************************************************
+    /// Balance the tree after the node provided was attached as a leaf
+    /// without searching from the root: the directions from the critical
+    /// node down to the new node are marked going up the parents, as they
+    /// are by insert_node on its way down.
+    //*************************************************************************
+    void balance_attached_node(Node* node)
+    {
+      // The critical node is the nearest ancestor that isn't balanced (or
+      // the root)
+      Node* critical_node = node->parent;
+      while (true)
+      {
+        critical_node->dir = critical_node->children[kLeft] == node ? kLeft : kRight;
+        if (kNeither != critical_node->weight || !critical_node->parent)
+        {
+          break;
+        }
+        node = critical_node;
+        critical_node = critical_node->parent;
+      }
+
+      Node* critical_parent_node = critical_node->parent;
+      if (!critical_parent_node)
+      {
+        balance_node(root_node);
+      }
+      else if (critical_parent_node->children[kLeft] == critical_node)
+      {
+        balance_node(critical_parent_node->children[kLeft]);
+      }
+      else
+      {
+        balance_node(critical_parent_node->children[kRight]);
+      }
+    }
+
     //*************************************************************************
     /// Detach the node at the position provided
     //*************************************************************************
@@ -935,6 +2014,10 @@ namespace sstl
       // Update replacement node to point to child in opposite direction
       // otherwise we might lose the other child of the swap node
       replacement = swap->children[1 - swap->dir];
+      if (replacement)
+      {
+        replacement->parent = swap->parent;
+      }
 
       // Point swap node to detached node's parent, children and weight
       swap->parent = detached->parent;
@@ -949,12 +2032,14 @@ namespace sstl
         swap->children[kRight]->parent = swap;
       }
       swap->weight = detached->weight;
+      copy_subtree_size(swap, detached);
     }
 
     //*************************************************************************
     /// Find the value matching the node provided
     //*************************************************************************
-    Node* find_node(Node* position, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    Node* find_node(Node* position, const TLookupKey& key) const
     {
       Node* found = nullptr;
       while (position)
@@ -987,7 +2072,8 @@ namespace sstl
     //*************************************************************************
     /// Find the value matching the node provided
     //*************************************************************************
-    const Node* find_node(const Node* position, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    const Node* find_node(const Node* position, const TLookupKey& key) const
     {
       const Node* found = nullptr;
       while (position)
@@ -1037,7 +2123,8 @@ namespace sstl
     //*************************************************************************
     /// Find the node whose key is not considered to go before the key provided
     //*************************************************************************
-    Node* find_lower_node(Node* position, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    Node* find_lower_node(Node* position, const TLookupKey& key) const
     {
       // Something at this position? keep going
       Node* lower_node = nullptr;
@@ -1078,7 +2165,8 @@ namespace sstl
     //*************************************************************************
     /// Find the node whose key is considered to go after the key provided
     //*************************************************************************
-    Node* find_upper_node(Node* position, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    Node* find_upper_node(Node* position, const TLookupKey& key) const
     {
       // Keep track of parent of last upper node
       Node* upper_node = nullptr;
@@ -1293,7 +2381,7 @@ namespace sstl
       // from the root
       if (!position)
       {
-        position = find_limit_node(root_node, kRight);
+        position = rightmost_node;
       }
       else
       {
@@ -1331,7 +2419,7 @@ namespace sstl
       // from the root
       if (!position)
       {
-        position = find_limit_node(root_node, kRight);
+        position = rightmost_node;
       }
       else
       {
@@ -1361,16 +2449,31 @@ namespace sstl
     }
 
     //*************************************************************************
-    /// Remove the node specified from somewhere starting at the position
-    /// provided
+    /// Remove the node specified and destroy it
     //*************************************************************************
     void remove_node(Node* node)
+    {
+      if (node)
+      {
+        unlink_node(node);
+        destroy_data_node(imultiset::data_cast(*node));
+      }
+    }
+
+    //*************************************************************************
+    /// Unlink the node specified from the tree, without destroying it
+    //*************************************************************************
+    void unlink_node(Node* node)
     {
       // If valid found node was provided then proceed with steps 1 through 5
       if (node)
       {
-        // Downcast found node provided to Data_Node class
-        Data_Node& data_node = imultiset::data_cast(*node);
+        // The last node is replaced by the previous one: its left child if
+        // any (a leaf, its right subtree being empty) or its parent
+        if (node == rightmost_node)
+        {
+          rightmost_node = node->children[kLeft] ? node->children[kLeft] : node->parent;
+        }
 
         // Keep track of node as found node
         Node* found = node;
@@ -1462,25 +2565,10 @@ namespace sstl
           // Keep searching for replacement node in the direction specified above
           node = node->children[node->dir];
 
-          // Downcast node to Data_Node class for comparison operations
-          Data_Node& replace_data_node = imultiset::data_cast(*node);
-
-          // Compare the key provided to the replace data node key
-          if (node_comp(data_node, replace_data_node))
-          {
-            // Update the direction to the replace node
-            node->dir = kLeft;
-          }
-          else if (node_comp(replace_data_node, data_node))
-          {
-            // Update the direction to the replace node
-            node->dir = kRight;
-          }
-          else
-          {
-            // Update the direction to the replace node
-            node->dir = node->children[kLeft] ? kLeft : kRight;
-          }
+          // The replacement is the in-order neighbour of found: the nodes
+          // equivalent to found may be on either side, so the keys can't
+          // tell the way
+          node->dir = 1 - found->dir;
         } // while(node)
 
         // Step 4: Update weights from balance to parent of node determined
@@ -1565,6 +2653,10 @@ namespace sstl
           balance = balance->children[balance->dir];
         } // while(balance)
 
+        // The replacement node leaves its position: one node less in the
+        // subtrees of its ancestors (found included, unless it is found)
+        adjust_subtree_sizes(node->parent, false);
+
         // Step 5: Swap found with node (replacement)
         if (found->parent)
         {
@@ -1589,9 +2681,6 @@ namespace sstl
 
         // One less.
         --current_size;
-
-        // Destroy the node detached above
-        destroy_data_node(data_node);
       } // if(found)
     }
 
@@ -1631,6 +2720,9 @@ namespace sstl
       position->weight = kNeither;
       // Position's parent becomes new_root
       position->parent = new_root;
+      // Position lost the subtree of new root, which now holds both
+      update_subtree_size(position);
+      update_subtree_size(new_root);
       position = new_root;
       // Clear weight factor from new root
       position->weight = kNeither;
@@ -1687,6 +2779,10 @@ namespace sstl
 
       // Update current position's parent and replace with new root
       position->parent = new_root;
+      // Recount the subtrees of the three nodes moved, bottom up
+      update_subtree_size(new_root->children[dir]);
+      update_subtree_size(position);
+      update_subtree_size(new_root);
       position = new_root;
       // Clear weight factor for new current position
       position->weight = kNeither;
@@ -1700,8 +2796,8 @@ namespace sstl
    ///\return <b>true</b> if the arrays are equal, otherwise <b>false</b>
    ///\ingroup lookup
    //***************************************************************************
-   template <typename T, typename TCompare>
-   bool operator ==(const sstl::imultiset<T, TCompare>& lhs, const sstl::imultiset<T, TCompare>& rhs)
+   template <typename T, typename TCompare, typename TAugmentation>
+   bool operator ==(const sstl::imultiset<T, TCompare, TAugmentation>& lhs, const sstl::imultiset<T, TCompare, TAugmentation>& rhs)
    {
      return (lhs.size() == rhs.size()) && std::equal(lhs.begin(), lhs.end(), rhs.begin());
    }
@@ -1713,8 +2809,8 @@ namespace sstl
    ///\return <b>true</b> if the arrays are not equal, otherwise <b>false</b>
    ///\ingroup lookup
    //***************************************************************************
-   template <typename T, typename TCompare>
-   bool operator !=(const sstl::imultiset<T, TCompare>& lhs, const sstl::imultiset<T, TCompare>& rhs)
+   template <typename T, typename TCompare, typename TAugmentation>
+   bool operator !=(const sstl::imultiset<T, TCompare, TAugmentation>& lhs, const sstl::imultiset<T, TCompare, TAugmentation>& rhs)
    {
      return !(lhs == rhs);
    }
@@ -1726,8 +2822,8 @@ namespace sstl
    ///\return <b>true</b> if the first list is lexicographically less than the
    /// second, otherwise <b>false</b>.
    //*************************************************************************
-   template <typename T, typename TCompare>
-   bool operator <(const sstl::imultiset<T, TCompare>& lhs, const sstl::imultiset<T, TCompare>& rhs)
+   template <typename T, typename TCompare, typename TAugmentation>
+   bool operator <(const sstl::imultiset<T, TCompare, TAugmentation>& lhs, const sstl::imultiset<T, TCompare, TAugmentation>& rhs)
    {
      return std::lexicographical_compare(lhs.begin(),
                                          lhs.end(),
@@ -1742,8 +2838,8 @@ namespace sstl
    ///\return <b>true</b> if the first list is lexicographically greater than the
    /// second, otherwise <b>false</b>.
    //*************************************************************************
-   template <typename T, typename TCompare>
-   bool operator >(const sstl::imultiset<T, TCompare>& lhs, const sstl::imultiset<T, TCompare>& rhs)
+   template <typename T, typename TCompare, typename TAugmentation>
+   bool operator >(const sstl::imultiset<T, TCompare, TAugmentation>& lhs, const sstl::imultiset<T, TCompare, TAugmentation>& rhs)
    {
      return std::lexicographical_compare(lhs.begin(),
                                          lhs.end(),
@@ -1759,8 +2855,8 @@ namespace sstl
    ///\return <b>true</b> if the first list is lexicographically less than or equal
    /// to the second, otherwise <b>false</b>.
    //*************************************************************************
-   template <typename T, typename TCompare>
-   bool operator <=(const sstl::imultiset<T, TCompare>& lhs, const sstl::imultiset<T, TCompare>& rhs)
+   template <typename T, typename TCompare, typename TAugmentation>
+   bool operator <=(const sstl::imultiset<T, TCompare, TAugmentation>& lhs, const sstl::imultiset<T, TCompare, TAugmentation>& rhs)
    {
      return !operator >(lhs, rhs);
    }
@@ -1772,8 +2868,8 @@ namespace sstl
    ///\return <b>true</b> if the first list is lexicographically greater than or
    /// equal to the second, otherwise <b>false</b>.
    //*************************************************************************
-   template <typename T, typename TCompare>
-   bool operator >=(const sstl::imultiset<T, TCompare>& lhs, const sstl::imultiset<T, TCompare>& rhs)
+   template <typename T, typename TCompare, typename TAugmentation>
+   bool operator >=(const sstl::imultiset<T, TCompare, TAugmentation>& lhs, const sstl::imultiset<T, TCompare, TAugmentation>& rhs)
    {
      return !operator <(lhs, rhs);
    }
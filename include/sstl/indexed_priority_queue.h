@@ -0,0 +1,339 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_INDEXED_PRIORITY_QUEUE__
+#define _SSTL_INDEXED_PRIORITY_QUEUE__
+
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+#include <functional>
+#include <array>
+
+#include <sstl_assert.h>
+
+#include "__internal/_except.h"
+#include "__internal/_aligned_storage.h"
+
+namespace sstl
+{
+
+// d-ary heap (4-ary by default) whose values can be reprioritized or removed
+// through the handle returned on insertion.
+// The values never move: every handle owns a fixed slot of the value storage and
+// the heap only orders handles, while a position table maps every handle to its
+// index in the heap. The handles that are not in use are kept in the unused part
+// of the heap array, thus a released handle is reused by the next insertion.
+template<class T,
+         size_t CAPACITY,
+         class Compare=std::less<T>,
+         size_t ARITY=4>
+class indexed_priority_queue
+{
+   static_assert(CAPACITY >= 1, "capacity must be at least one");
+   static_assert(ARITY >= 2, "arity must be at least two");
+
+public:
+   using value_type = T;
+   using size_type = size_t;
+   using reference = value_type&;
+   using const_reference = const value_type&;
+   using value_compare = Compare;
+   using handle = size_type;
+
+public:
+   indexed_priority_queue() : indexed_priority_queue(Compare{})
+   {}
+
+   explicit indexed_priority_queue(const Compare& compare)
+      : _compare(compare)
+   {
+      for(size_type i=0; i<CAPACITY; ++i)
+      {
+         _heap[i] = i;
+         _positions[i] = i;
+      }
+   }
+
+   indexed_priority_queue(const indexed_priority_queue& rhs)
+      : _compare(rhs._compare)
+   {
+      _construct_from(rhs);
+   }
+
+   indexed_priority_queue(indexed_priority_queue&& rhs)
+      : _compare(std::move(rhs._compare))
+   {
+      _construct_from(std::move(rhs));
+      rhs.clear();
+   }
+
+   ~indexed_priority_queue()
+   {
+      clear();
+   }
+
+   indexed_priority_queue& operator=(const indexed_priority_queue& rhs)
+   {
+      if(this != &rhs)
+      {
+         clear();
+         _compare = rhs._compare;
+         _construct_from(rhs);
+      }
+      return *this;
+   }
+
+   indexed_priority_queue& operator=(indexed_priority_queue&& rhs)
+   {
+      if(this != &rhs)
+      {
+         clear();
+         _compare = std::move(rhs._compare);
+         _construct_from(std::move(rhs));
+         rhs.clear();
+      }
+      return *this;
+   }
+
+   const_reference top() const _sstl_noexcept_
+   {
+      sstl_assert(!empty());
+      return *_value(_heap[0]);
+   }
+
+   handle top_handle() const _sstl_noexcept_
+   {
+      sstl_assert(!empty());
+      return _heap[0];
+   }
+
+   //the heap property must be restored with update(handle) after the value was modified
+   reference operator[](handle h) _sstl_noexcept_
+   {
+      sstl_assert(contains(h));
+      return *_value(h);
+   }
+
+   const_reference operator[](handle h) const _sstl_noexcept_
+   {
+      sstl_assert(contains(h));
+      return *_value(h);
+   }
+
+   //returns true if the handle refers to a value in the queue
+   bool contains(handle h) const _sstl_noexcept_
+   {
+      return h < CAPACITY && _positions[h] < _size;
+   }
+
+   bool empty() const _sstl_noexcept_
+   {
+      return _size == 0;
+   }
+
+   bool full() const _sstl_noexcept_
+   {
+      return _size == CAPACITY;
+   }
+
+   size_type size() const _sstl_noexcept_
+   {
+      return _size;
+   }
+
+   size_type capacity() const _sstl_noexcept_
+   {
+      return CAPACITY;
+   }
+
+   handle push(const_reference value)
+   {
+      return emplace(value);
+   }
+
+   handle push(value_type&& value)
+   {
+      return emplace(std::move(value));
+   }
+
+   template<class... Args>
+   handle emplace(Args&&... args)
+   {
+      sstl_assert(!full());
+      auto h = _heap[_size];
+      new(_value(h)) value_type(std::forward<Args>(args)...);
+      ++_size;
+      _sift_up(_size-1);
+      return h;
+   }
+
+   void pop()
+   {
+      erase(top_handle());
+   }
+
+   //removes the top value and returns it (also works with move-only values)
+   value_type pop_top()
+   {
+      sstl_assert(!empty());
+      value_type value(std::move(*_value(_heap[0])));
+      pop();
+      return value;
+   }
+
+   //assigns the specified value to the handle and moves the handle up or down the heap
+   template<class TValue>
+   void update(handle h, TValue&& value)
+   {
+      sstl_assert(contains(h));
+      *_value(h) = std::forward<TValue>(value);
+      update(h);
+   }
+
+   //restores the heap property after the value of the handle was modified through operator[]
+   void update(handle h)
+   {
+      sstl_assert(contains(h));
+      auto pos = _positions[h];
+      if(pos > 0 && _compare(*_value(_heap[(pos-1) / ARITY]), *_value(h)))
+         _sift_up(pos);
+      else
+         _sift_down(pos);
+   }
+
+   //removes the value of the handle, the handle becomes invalid
+   void erase(handle h)
+   {
+      sstl_assert(contains(h));
+      auto pos = _positions[h];
+      _value(h)->~value_type();
+      --_size;
+      if(pos != _size)
+      {
+         auto last = _heap[_size];
+         _place(pos, last);
+         _place(_size, h);
+         update(last);
+      }
+   }
+
+   void clear() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      for(size_type i=0; i<_size; ++i)
+      {
+         _value(_heap[i])->~value_type();
+      }
+      _size = 0;
+   }
+
+   void swap(indexed_priority_queue& rhs)
+   {
+      auto tmp = std::move(rhs);
+      rhs = std::move(*this);
+      *this = std::move(tmp);
+   }
+
+private:
+   value_type* _value(handle h) _sstl_noexcept_
+   {
+      return static_cast<value_type*>(static_cast<void*>(&_values[h]));
+   }
+
+   const value_type* _value(handle h) const _sstl_noexcept_
+   {
+      return static_cast<const value_type*>(static_cast<const void*>(&_values[h]));
+   }
+
+   void _place(size_type pos, handle h) _sstl_noexcept_
+   {
+      _heap[pos] = h;
+      _positions[h] = pos;
+   }
+
+   void _sift_up(size_type pos)
+   {
+      auto h = _heap[pos];
+      while(pos > 0)
+      {
+         auto parent = (pos-1) / ARITY;
+         if(!_compare(*_value(_heap[parent]), *_value(h)))
+            break;
+         _place(pos, _heap[parent]);
+         pos = parent;
+      }
+      _place(pos, h);
+   }
+
+   void _sift_down(size_type pos)
+   {
+      auto h = _heap[pos];
+      auto first_child = pos*ARITY + 1;
+      while(first_child < _size)
+      {
+         auto last_child = first_child + ARITY < _size ? first_child + ARITY : _size;
+         auto best_child = first_child;
+         for(auto child = first_child+1; child < last_child; ++child)
+         {
+            best_child = _compare(*_value(_heap[best_child]), *_value(_heap[child])) ? child : best_child;
+         }
+         if(!_compare(*_value(h), *_value(_heap[best_child])))
+            break;
+         _place(pos, _heap[best_child]);
+         pos = best_child;
+         first_child = pos*ARITY + 1;
+      }
+      _place(pos, h);
+   }
+
+   //copies (or moves) the values of rhs into the same handles, this must be empty
+   template<class TIndexedPriorityQueue>
+   void _construct_from(TIndexedPriorityQueue&& rhs)
+   {
+      using rhs_value_reference = typename std::conditional<std::is_lvalue_reference<TIndexedPriorityQueue>::value,
+                                                            const value_type&,
+                                                            value_type&&>::type;
+      _heap = rhs._heap;
+      _positions = rhs._positions;
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         while(_size < rhs._size)
+         {
+            auto h = _heap[_size];
+            new(_value(h)) value_type(static_cast<rhs_value_reference>(*rhs._value(h)));
+            ++_size;
+         }
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         clear();
+         throw;
+      }
+      #endif
+   }
+
+private:
+   std::array<typename _aligned_storage<sizeof(value_type), std::alignment_of<value_type>::value>::type, CAPACITY> _values;
+   std::array<handle, CAPACITY> _heap;
+   std::array<size_type, CAPACITY> _positions;
+   size_type _size{ 0 };
+   Compare _compare;
+};
+
+template<class T, size_t CAPACITY, class Compare, size_t ARITY>
+void swap(indexed_priority_queue<T, CAPACITY, Compare, ARITY>& lhs,
+          indexed_priority_queue<T, CAPACITY, Compare, ARITY>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+}
+
+#endif
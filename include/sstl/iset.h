@@ -36,12 +36,17 @@ SOFTWARE.
 #include <iterator>
 #include <algorithm>
 #include <functional>
+#include <utility>
+#include <type_traits>
 
 #include <sstl_assert.h>
 
 #include "set_base.h"
 #include "bitmap_allocator.h"
 #include "__internal/parameter_type.h"
+#include "__internal/_except.h"
+#include "__internal/_utility.h"
+#include "__internal/_tree_augmentation.h"
 
 #if WIN32
 #undef min
@@ -51,9 +56,11 @@ namespace sstl
 {
   //***************************************************************************
   /// A templated base for all sstl::set types.
+  /// With the tree_order_statistics augmentation, the nodes also count the
+  /// nodes of their subtrees (see rank, nth and count_range).
   ///\ingroup set
   //***************************************************************************
-  template <typename T, typename TCompare>
+  template <typename T, typename TCompare, typename TAugmentation = tree_no_augmentation>
   class iset : public set_base
   {
   public:
@@ -93,10 +100,20 @@ namespace sstl
     static const uint8_t kRight = 1;
     static const uint8_t kNeither = 2;
 
+    /// The maximum height of the tree: an AVL tree of n nodes is less than
+    /// 1.45 * log2(n + 2) high.
+    static const size_t kMaxHeight = sizeof(size_t) * 8 * 3 / 2;
+
+    /// The parts of two sets kept by a set operation: the elements only in
+    /// the first set, in both sets and only in the second set.
+    static const uint8_t kFirstOnly = 1;
+    static const uint8_t kBoth = 2;
+    static const uint8_t kSecondOnly = 4;
+
     //*************************************************************************
     /// The node element in the set.
     //*************************************************************************
-    struct Node
+    struct Node : public _tree_node_augmentation<TAugmentation>
     {
       //***********************************************************************
       /// Constructor
@@ -114,10 +131,12 @@ namespace sstl
       {
         weight = kNeither;
         dir = kNeither;
+        parent = nullptr;
         children[0] = nullptr;
         children[1] = nullptr;
       }
 
+      Node* parent;
       Node* children[2];
       uint8_t weight;
       uint8_t dir;
@@ -128,8 +147,9 @@ namespace sstl
     //*************************************************************************
     struct Data_Node : public Node
     {
-      explicit Data_Node(value_type value)
-        : value(value)
+      template <typename... TArgs>
+      explicit Data_Node(TArgs&&... args)
+        : value(std::forward<TArgs>(args)...)
       {
       }
 
@@ -139,6 +159,11 @@ namespace sstl
     /// Defines the key value parameter type
     typedef typename parameter_type<T>::type key_value_parameter_t;
 
+    /// Enables the lookups by a key of another type (see find), only if the
+    /// comparator is transparent.
+    template <typename K>
+    using _enable_if_transparent = typename std::enable_if<_is_transparent<key_compare>::value, K>::type;
+
     //*************************************************************************
     /// How to compare node elements.
     //*************************************************************************
@@ -146,11 +171,13 @@ namespace sstl
     {
       return key_compare()(node1.value, node2.value);
     }
-    bool node_comp(const Data_Node& node, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    bool node_comp(const Data_Node& node, const TLookupKey& key) const
     {
       return key_compare()(node.value, key);
     }
-    bool node_comp(const key_value_parameter_t& key, const Data_Node& node) const
+    template <typename TLookupKey>
+    bool node_comp(const TLookupKey& key, const Data_Node& node) const
     {
       return key_compare()(key, node.value);
     }
@@ -163,6 +190,10 @@ namespace sstl
     /// The node that acts as the set root.
     Node* root_node;
 
+    /// The node of the last element (nullptr if empty), where the
+    /// increasing keys are appended.
+    Node* rightmost_node;
+
     //*************************************************************************
     /// Downcast a Node* to a Data_Node*
     //*************************************************************************
@@ -416,6 +447,112 @@ namespace sstl
     typedef std::reverse_iterator<iterator>       reverse_iterator;
     typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
+    //*************************************************************************
+    /// A node extracted from the set, owning its element. The node keeps its
+    /// block in the pool of the set it was extracted from, until it is
+    /// inserted back or the handle is destroyed: the handle must not outlive
+    /// that set, which meanwhile can hold one element less.
+    //*************************************************************************
+    class node_type
+    {
+    public:
+
+      friend class iset;
+
+      typedef T value_type;
+
+      node_type()
+        : p_container(nullptr)
+        , p_node(nullptr)
+      {
+      }
+
+      node_type(node_type&& other)
+        : p_container(other.p_container)
+        , p_node(other.p_node)
+      {
+        other.p_container = nullptr;
+        other.p_node = nullptr;
+      }
+
+      ~node_type()
+      {
+        reset();
+      }
+
+      node_type& operator =(node_type&& other)
+      {
+        if (this != &other)
+        {
+          reset();
+          p_container = other.p_container;
+          p_node = other.p_node;
+          other.p_container = nullptr;
+          other.p_node = nullptr;
+        }
+
+        return *this;
+      }
+
+      bool empty() const
+      {
+        return p_node == nullptr;
+      }
+
+      explicit operator bool() const
+      {
+        return p_node != nullptr;
+      }
+
+      //***********************************************************************
+      /// The value of the element, it can be modified before inserting the node.
+      //***********************************************************************
+      value_type& value() const
+      {
+        sstl_assert(p_node);
+        return const_cast<value_type&>(p_node->value);
+      }
+
+    private:
+
+      node_type(iset& container, Node* node)
+        : p_container(&container)
+        , p_node(iset::data_cast(node))
+      {
+      }
+
+      node_type(const node_type&) = delete;
+      node_type& operator =(const node_type&) = delete;
+
+      //***********************************************************************
+      /// Destroys the element and gives its block back to the pool.
+      //***********************************************************************
+      void reset()
+      {
+        if (p_node)
+        {
+          p_container->destroy_extracted_node(*p_node);
+          p_container = nullptr;
+          p_node = nullptr;
+        }
+      }
+
+      // Pointer to the set the node was extracted from
+      iset* p_container;
+
+      // Pointer to the extracted node
+      Data_Node* p_node;
+    };
+
+    //*************************************************************************
+    /// The result of the insertion of a node.
+    //*************************************************************************
+    struct insert_return_type
+    {
+      iterator  position;
+      bool      inserted;
+      node_type node;
+    };
 
     //*************************************************************************
     /// Assignment operator.
@@ -535,6 +672,59 @@ namespace sstl
       insert(first, last);
     }
 
+    //*********************************************************************
+    /// Assigns the values of a sorted range to the set, building a
+    /// perfectly balanced tree in O(n) instead of inserting the values one
+    /// at a time. The range must be sorted by key_compare, without equivalent keys (checked
+    /// by an assertion).
+    ///\param first The forward iterator to the first element.
+    ///\param last  The forward iterator to the last element + 1.
+    //*********************************************************************
+    template <typename TIterator>
+    void assign_sorted(TIterator first, TIterator last)
+    {
+      clear();
+      size_type count = static_cast<size_type>(std::distance(first, last));
+      sstl_assert(count <= available());
+
+      // The nodes are created in order and chained through their right
+      // children, then linked into the tree all at once
+      Node* list = nullptr;
+      Node** tail = &list;
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+        const Data_Node* previous = nullptr;
+        for (; first != last; ++first)
+        {
+          Data_Node& data_node = allocate_data_node(*first);
+          sstl_assert(!previous || node_comp(*previous, data_node));
+          *tail = &data_node;
+          tail = &data_node.children[kRight];
+          previous = &data_node;
+        }
+        *tail = nullptr;
+        (void) previous;
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+        *tail = nullptr;
+        while (list)
+        {
+          Node* next = list->children[kRight];
+          destroy_data_node(iset::data_cast(*list));
+          list = next;
+        }
+        throw;
+      }
+      #endif
+
+      current_size = count;
+      link_sorted_list(list);
+    }
+
     //*************************************************************************
     /// Clears the set.
     //*************************************************************************
@@ -546,6 +736,7 @@ namespace sstl
         }
         current_size = 0;
         root_node = nullptr;
+        rightmost_node = nullptr;
     }
 
     //*********************************************************************
@@ -594,9 +785,10 @@ namespace sstl
     //*************************************************************************
     iterator erase(const_iterator position)
     {
-      // Find the parent node to be removed
-      Node*& reference_node = find_node(root_node, position.p_node);
-      iterator next(*this, reference_node);
+      // Cast const away from node to be removed. This is necessary because the
+      // STL definition of this method requires we provide the next node in the
+      // sequence as an iterator.
+      iterator next(*this, const_cast<Node*>(position.p_node));
       ++next;
 
       remove_node(root_node, (*position));
@@ -667,53 +859,199 @@ namespace sstl
     //*********************************************************************
     std::pair<iterator, bool> insert(value_type& value)
     {
-      sstl_assert(!full());
-      // Default to no inserted node
-      Node* inserted_node = nullptr;
-      bool inserted = false;
-      // Get next available free node
-      Data_Node& node = allocate_data_node(value);
-      // Obtain the inserted node (might be nullptr if node was a duplicate)
-      inserted_node = insert_node(root_node, node);
-      inserted = inserted_node == &node;
-      // Insert node into tree and return iterator to new node location in tree
-      return std::make_pair(iterator(*this, inserted_node), inserted);
+      // The value is copied into a new node only if it isn't in the set yet
+      std::pair<Node*, bool> result = insert_node(root_node, value,
+        [this, &value]() -> Data_Node& { return allocate_data_node(value); });
+      return std::make_pair(iterator(*this, result.first), result.second);
     }
 
     //*********************************************************************
-    /// Inserts a value to the set starting at the position recommended.
-    ///\param position The position that would precede the value to insert.
+    /// Inserts a value to the set, moving it into the new node.
+    ///\param value    The value to insert (not moved if already in the set).
+    //*********************************************************************
+    std::pair<iterator, bool> insert(T&& value)
+    {
+      std::pair<Node*, bool> result = insert_node(root_node, value,
+        [this, &value]() -> Data_Node& { return allocate_data_node(std::move(value)); });
+      return std::make_pair(iterator(*this, result.first), result.second);
+    }
+
+    //*********************************************************************
+    /// Inserts a value to the set next to the position recommended.
+    ///\param position The position of the element that would follow the value.
     ///\param value    The value to insert.
     //*********************************************************************
-    iterator insert(iterator, value_type& value)
+    iterator insert(iterator position, value_type& value)
     {
-      sstl_assert(!full());
-      // Default to no inserted node
-      Node* inserted_node = nullptr;
-      // Get next available free node
-      Data_Node& node = allocate_data_node(value);
-      // Obtain the inserted node (might be nullptr if node was a duplicate)
-      inserted_node = insert_node(root_node, node);
-      // Insert node into tree and return iterator to new node location in tree
-      return iterator(*this, inserted_node);
+      return insert(const_iterator(position), value);
     }
 
     //*********************************************************************
-    /// Inserts a value to the set starting at the position recommended.
-    ///\param position The position that would precede the value to insert.
+    /// Inserts a value to the set next to the position recommended: the
+    /// value is linked without a search from the root if it goes right
+    /// before (or right after) the element at the position, as when
+    /// appending increasing keys at end().
+    ///\param position The position of the element that would follow the value.
     ///\param value    The value to insert.
     //*********************************************************************
-    iterator insert(const_iterator, value_type& value)
+    iterator insert(const_iterator position, value_type& value)
     {
-      sstl_assert(!full());
-      // Default to no inserted node
-      Node* inserted_node = nullptr;
-      // Get next available free node
-      Data_Node& node = allocate_data_node(value);
-      // Obtain the inserted node (might be nullptr if node was a duplicate)
-      inserted_node = insert_node(root_node, node);
-      // Insert node into tree and return iterator to new node location in tree
-      return iterator(*this, inserted_node);
+      return iterator(*this, insert_node_at_hint(const_cast<Node*>(position.p_node), value,
+        [this, &value]() -> Data_Node& { return allocate_data_node(value); }).first);
+    }
+
+    //*********************************************************************
+    /// Inserts a value to the set next to the position recommended.
+    ///\param position The position of the element that would follow the value.
+    ///\param value    The value to insert (not moved if not inserted).
+    //*********************************************************************
+    iterator insert(iterator position, T&& value)
+    {
+      return insert(const_iterator(position), std::move(value));
+    }
+
+    //*********************************************************************
+    /// Inserts a value to the set next to the position recommended.
+    ///\param position The position of the element that would follow the value.
+    ///\param value    The value to insert (not moved if not inserted).
+    //*********************************************************************
+    iterator insert(const_iterator position, T&& value)
+    {
+      return iterator(*this, insert_node_at_hint(const_cast<Node*>(position.p_node), value,
+        [this, &value]() -> Data_Node& { return allocate_data_node(std::move(value)); }).first);
+    }
+
+    //*********************************************************************
+    /// Constructs a value in place in a new node and inserts it to the set.
+    /// The node is released if the value is already in the set.
+    ///\param args The arguments to construct the value with.
+    //*********************************************************************
+    template <typename... TArgs>
+    std::pair<iterator, bool> emplace(TArgs&&... args)
+    {
+      Data_Node& node = allocate_data_node(std::forward<TArgs>(args)...);
+      std::pair<Node*, bool> result = insert_node(root_node, node.value,
+        [&node]() -> Data_Node& { return node; });
+      if (!result.second)
+      {
+        destroy_data_node(node);
+      }
+      return std::make_pair(iterator(*this, result.first), result.second);
+    }
+
+    //*********************************************************************
+    /// Constructs a value in place and inserts it to the set next to the
+    /// position recommended (see insert). The node is released if the
+    /// value is already in the set.
+    ///\param position The position of the element that would follow the value.
+    ///\param args     The arguments to construct the value with.
+    //*********************************************************************
+    template <typename... TArgs>
+    iterator emplace_hint(const_iterator position, TArgs&&... args)
+    {
+      Data_Node& node = allocate_data_node(std::forward<TArgs>(args)...);
+      std::pair<Node*, bool> result = insert_node_at_hint(const_cast<Node*>(position.p_node), node.value,
+        [&node]() -> Data_Node& { return node; });
+      if (!result.second)
+      {
+        destroy_data_node(node);
+      }
+      return iterator(*this, result.first);
+    }
+
+    //*********************************************************************
+    /// Extracts the element at the position provided from the set, without
+    /// destroying it.
+    ///\param position The position of the element to extract.
+    ///\return The node of the element.
+    //*********************************************************************
+    node_type extract(const_iterator position)
+    {
+      return extract(*position);
+    }
+
+    //*********************************************************************
+    /// Extracts the element with the key provided from the set, without
+    /// destroying it.
+    ///\param key The key of the element to extract.
+    ///\return The node of the element, empty if the key wasn't found.
+    //*********************************************************************
+    node_type extract(const key_value_parameter_t& key)
+    {
+      Node* node = unlink_node(root_node, key);
+      if (!node)
+      {
+        return node_type();
+      }
+
+      ++extracted_size;
+      return node_type(*this, node);
+    }
+
+    //*********************************************************************
+    /// Inserts the element of the node provided. A node extracted from this
+    /// set is linked back into the tree, without copying the element.
+    /// A node extracted from another set is moved into a block of the pool
+    /// of this set.
+    ///\param node The node to insert, left untouched if its key is in the set.
+    ///\return The position of the element with the key of the node, whether
+    /// the node was inserted and the node if it wasn't.
+    //*********************************************************************
+    insert_return_type insert(node_type&& node)
+    {
+      insert_return_type result;
+      result.inserted = false;
+
+      if (node.empty())
+      {
+        result.position = end();
+        return result;
+      }
+
+      Data_Node& data_node = *node.p_node;
+      std::pair<Node*, bool> inserted;
+      if (node.p_container == this)
+      {
+        // Link the node back into the tree
+        inserted = insert_node(root_node, data_node.value,
+          [&data_node]() -> Data_Node& { return data_node; });
+        if (inserted.second)
+        {
+          --extracted_size;
+          node.p_container = nullptr;
+          node.p_node = nullptr;
+        }
+      }
+      else
+      {
+        // Relocate the element from the pool of the other set
+        inserted = insert_node(root_node, data_node.value,
+          [this, &data_node]() -> Data_Node& { return allocate_data_node(std::move(const_cast<T&>(data_node.value))); });
+        if (inserted.second)
+        {
+          node.reset();
+        }
+      }
+
+      result.position = iterator(*this, inserted.first);
+      result.inserted = inserted.second;
+      if (!inserted.second)
+      {
+        result.node = std::move(node);
+      }
+
+      return result;
+    }
+
+    //*********************************************************************
+    /// Inserts the element of the node provided starting at the position
+    /// recommended.
+    ///\param position The position that would precede the node to insert.
+    ///\param node     The node to insert.
+    //*********************************************************************
+    iterator insert(const_iterator, node_type&& node)
+    {
+      return insert(std::move(node)).position;
     }
 
     //*********************************************************************
@@ -727,8 +1065,132 @@ namespace sstl
     {
       while (first != last)
       {
-        insert(*first++);
+        // Appended next to the last element if the range is sorted
+        insert(cend(), *first++);
+      }
+    }
+
+    //*********************************************************************
+    /// Moves the elements of the other set whose keys aren't in this set,
+    /// as std::set::merge does. The elements are relocated into the pool of
+    /// this set. Both trees are flattened into sorted lists, merged in one
+    /// pass and relinked balanced, in O(n + m) instead of one insertion
+    /// per element. The elements whose key is already in the set, and
+    /// those that don't fit once the set is full, are left in the other set.
+    ///\param other The set to take the elements from.
+    //*********************************************************************
+    void merge(iset& other)
+    {
+      if (&other == this || other.empty())
+      {
+        return;
       }
+
+      Node* mine = flatten_tree(root_node);
+      Node* theirs = flatten_tree(other.root_node);
+      Node* merged = nullptr;
+      Node** merged_tail = &merged;
+      Node* kept = nullptr;
+      Node** kept_tail = &kept;
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+        while (theirs)
+        {
+          if (mine && node_comp(iset::data_cast(*mine), iset::data_cast(*theirs)))
+          {
+            *merged_tail = mine;
+            merged_tail = &mine->children[kRight];
+            mine = mine->children[kRight];
+          }
+          else if (!mine || node_comp(iset::data_cast(*theirs), iset::data_cast(*mine)))
+          {
+            if (full())
+            {
+              break;
+            }
+            Data_Node& data_node = iset::data_cast(*theirs);
+            Data_Node& moved_node = allocate_data_node(std::move(const_cast<T&>(data_node.value)));
+            ++current_size;
+            *merged_tail = &moved_node;
+            merged_tail = &moved_node.children[kRight];
+            theirs = theirs->children[kRight];
+            other.destroy_data_node(data_node);
+            --other.current_size;
+          }
+          else
+          {
+            // The key is in both sets
+            *kept_tail = theirs;
+            kept_tail = &theirs->children[kRight];
+            theirs = theirs->children[kRight];
+          }
+        }
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+        *merged_tail = mine;
+        *kept_tail = theirs;
+        link_sorted_list(merged);
+        other.link_sorted_list(kept);
+        throw;
+      }
+      #endif
+
+      *merged_tail = mine;
+      *kept_tail = theirs;
+      link_sorted_list(merged);
+      other.link_sorted_list(kept);
+    }
+
+    //*********************************************************************
+    /// Moves the elements of the other set whose keys aren't in this set.
+    ///\param other The set to take the elements from.
+    //*********************************************************************
+    void merge(iset&& other)
+    {
+      merge(other);
+    }
+
+    //*********************************************************************
+    /// Assigns the union of two sets to the destination set. The sorted
+    /// sequences of the two sets are merged in one pass and the destination
+    /// is built balanced, in O(n + m) instead of one insertion per element.
+    /// The destination must be another set, with room for the result
+    /// (checked by an assertion).
+    //*********************************************************************
+    friend void set_union(const iset& first, const iset& second, iset& destination)
+    {
+      destination.assign_set_operation(first, second, kFirstOnly | kBoth | kSecondOnly);
+    }
+
+    //*********************************************************************
+    /// Assigns the intersection of two sets to the destination set, in
+    /// O(n + m) (see set_union).
+    //*********************************************************************
+    friend void set_intersection(const iset& first, const iset& second, iset& destination)
+    {
+      destination.assign_set_operation(first, second, kBoth);
+    }
+
+    //*********************************************************************
+    /// Assigns the elements of the first set that aren't in the second set
+    /// to the destination set, in O(n + m) (see set_union).
+    //*********************************************************************
+    friend void set_difference(const iset& first, const iset& second, iset& destination)
+    {
+      destination.assign_set_operation(first, second, kFirstOnly);
+    }
+
+    //*********************************************************************
+    /// Assigns the elements that are in exactly one of the two sets to the
+    /// destination set, in O(n + m) (see set_union).
+    //*********************************************************************
+    friend void set_symmetric_difference(const iset& first, const iset& second, iset& destination)
+    {
+      destination.assign_set_operation(first, second, kFirstOnly | kSecondOnly);
     }
 
     //*********************************************************************
@@ -775,51 +1237,599 @@ namespace sstl
       return const_iterator(*this, find_upper_node(root_node, key));
     }
 
-  protected:
+    //*********************************************************************
+    /// Finds an element by a key of another type, compared with the keys
+    /// of the elements as it is: looking up a std::string key by a
+    /// const char* doesn't construct a temporary std::string.
+    /// Available only if key_compare declares is_transparent (e.g.
+    /// std::less<>), as the following overloads of count, lower_bound,
+    /// upper_bound and equal_range.
+    //*********************************************************************
+    template <typename K, typename = _enable_if_transparent<K>>
+    iterator find(const K& key)
+    {
+      return iterator(*this, find_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    const_iterator find(const K& key) const
+    {
+      return const_iterator(*this, find_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    size_type count(const K& key) const
+    {
+      return find_node(root_node, key) ? 1 : 0;
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    iterator lower_bound(const K& key)
+    {
+      return iterator(*this, find_lower_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    const_iterator lower_bound(const K& key) const
+    {
+      return const_iterator(*this, find_lower_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    iterator upper_bound(const K& key)
+    {
+      return iterator(*this, find_upper_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    const_iterator upper_bound(const K& key) const
+    {
+      return const_iterator(*this, find_upper_node(root_node, key));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    std::pair<iterator, iterator> equal_range(const K& key)
+    {
+      return std::make_pair(iterator(*this, find_lower_node(root_node, key)),
+                            iterator(*this, find_upper_node(root_node, key)));
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    std::pair<const_iterator, const_iterator> equal_range(const K& key) const
+    {
+      return std::make_pair(const_iterator(*this, find_lower_node(root_node, key)),
+                            const_iterator(*this, find_upper_node(root_node, key)));
+    }
+
+    //*********************************************************************
+    /// Returns the number of elements whose key goes before the key
+    /// provided, i.e. the position of lower_bound(key) in order (the
+    /// position of the element with the key, if any).
+    /// Available only with the tree_order_statistics augmentation, as nth
+    /// and count_range: O(log n) instead of walking the elements.
+    ///\param key The key to rank.
+    ///\return The number of elements before the key.
+    //*********************************************************************
+    size_type rank(const key_value_parameter_t& key) const
+    {
+      return rank_of_key(key);
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    size_type rank(const K& key) const
+    {
+      return rank_of_key(key);
+    }
+
+    //*********************************************************************
+    /// Returns an iterator pointing to the element at the position
+    /// provided in order (starting from zero), or end() if the position
+    /// is not less than size().
+    ///\param position The position of the element.
+    ///\return An iterator pointing to the element or end().
+    //*********************************************************************
+    iterator nth(size_type position)
+    {
+      return iterator(*this, find_nth_node(position));
+    }
+
+    //*********************************************************************
+    /// Returns a const_iterator pointing to the element at the position
+    /// provided in order (starting from zero), or end() if the position
+    /// is not less than size().
+    ///\param position The position of the element.
+    ///\return A const_iterator pointing to the element or end().
+    //*********************************************************************
+    const_iterator nth(size_type position) const
+    {
+      return const_iterator(*this, find_nth_node(position));
+    }
+
+    //*********************************************************************
+    /// Returns the number of elements whose key doesn't go before first
+    /// and goes before last, i.e. the length of the range from
+    /// lower_bound(first) to lower_bound(last).
+    ///\param first The first key of the range.
+    ///\param last  The key past the range.
+    ///\return The number of elements in the range (zero if last goes
+    /// before first).
+    //*********************************************************************
+    size_type count_range(const key_value_parameter_t& first, const key_value_parameter_t& last) const
+    {
+      return count_keys_between(first, last);
+    }
+
+    template <typename K, typename = _enable_if_transparent<K>>
+    size_type count_range(const K& first, const K& last) const
+    {
+      return count_keys_between(first, last);
+    }
+
+    //*********************************************************************
+    /// Calls the function provided for each element in order. The tree is
+    /// walked with an explicit stack, without climbing back through the
+    /// parent nodes as the iterators do.
+    ///\param function The function to call with each element.
+    ///\return The function provided.
+    //*********************************************************************
+    template <typename TFunction>
+    TFunction for_each(TFunction function) const
+    {
+      const Node* stack[kMaxHeight];
+      size_t top = 0;
+      const Node* node = root_node;
+      while (node || top > 0)
+      {
+        // Descend to the leftmost node not visited yet
+        while (node)
+        {
+          stack[top++] = node;
+          node = node->children[kLeft];
+        }
+
+        node = stack[--top];
+        function(iset::data_cast(node)->value);
+
+        // Continue with the tree on the right
+        node = node->children[kRight];
+      }
+
+      return function;
+    }
+
+  protected:
+
+    //*************************************************************************
+    /// Constructor.
+    //*************************************************************************
+    iset(bitmap_allocator<Data_Node>& node_pool, size_t max_size_)
+      : set_base(max_size_)
+      , p_node_pool(&node_pool)
+      , root_node(nullptr)
+      , rightmost_node(nullptr)
+    {
+      clear();
+    }
+
+  private:
+
+    //*************************************************************************
+    /// Allocate a Data_Node.
+    //*************************************************************************
+    template <typename... TArgs>
+    Data_Node& allocate_data_node(TArgs&&... args) const
+    {
+        sstl_assert(!full());
+        auto p = p_node_pool->allocate();
+        #if _sstl_has_exceptions()
+        try
+        {
+        #endif
+          new(p) Data_Node(std::forward<TArgs>(args)...);
+        #if _sstl_has_exceptions()
+        }
+        catch(...)
+        {
+          p_node_pool->deallocate(p);
+          throw;
+        }
+        #endif
+        return *p;
+    }
+
+    //*************************************************************************
+    /// Destroy a Data_Node.
+    //*************************************************************************
+    void destroy_data_node(Data_Node& node) const
+    {
+        node.~Data_Node();
+        p_node_pool->deallocate(&node);
+    }
+
+    //*************************************************************************
+    /// The number of nodes of the subtree at the node provided (zero for an
+    /// empty subtree), counted with the tree_order_statistics augmentation.
+    //*************************************************************************
+    static size_type subtree_size(const Node* node)
+    {
+      return node ? node->subtree_size : 0;
+    }
+
+    //*************************************************************************
+    /// Recount the nodes of the subtree at the node provided from its
+    /// children (after linking or rotating them).
+    //*************************************************************************
+    static void update_subtree_size(Node* node)
+    {
+      update_subtree_size(node, _has_order_statistics<TAugmentation>());
+    }
+
+    static void update_subtree_size(Node*, std::false_type)
+    {
+    }
+
+    static void update_subtree_size(Node* node, std::true_type)
+    {
+      node->subtree_size = subtree_size(node->children[kLeft]) + subtree_size(node->children[kRight]) + 1;
+    }
+
+    //*************************************************************************
+    /// Add one node to (or remove one from) the subtrees of the node
+    /// provided and of its ancestors, up to the root.
+    //*************************************************************************
+    static void adjust_subtree_sizes(Node* node, bool grow)
+    {
+      adjust_subtree_sizes(node, grow, _has_order_statistics<TAugmentation>());
+    }
+
+    static void adjust_subtree_sizes(Node*, bool, std::false_type)
+    {
+    }
+
+    static void adjust_subtree_sizes(Node* node, bool grow, std::true_type)
+    {
+      for (; node; node = node->parent)
+      {
+        if (grow)
+        {
+          ++node->subtree_size;
+        }
+        else
+        {
+          --node->subtree_size;
+        }
+      }
+    }
+
+    //*************************************************************************
+    /// The replacement node of an erasure takes the place of the node
+    /// removed, with the subtree of that node.
+    //*************************************************************************
+    static void copy_subtree_size(Node* destination, const Node* source)
+    {
+      copy_subtree_size(destination, source, _has_order_statistics<TAugmentation>());
+    }
+
+    static void copy_subtree_size(Node*, const Node*, std::false_type)
+    {
+    }
+
+    static void copy_subtree_size(Node* destination, const Node* source, std::true_type)
+    {
+      destination->subtree_size = source->subtree_size;
+    }
+
+    //*************************************************************************
+    /// The number of elements whose key goes before the key provided: the
+    /// sizes of the left subtrees skipped on the way down, plus the nodes.
+    //*************************************************************************
+    template <typename TLookupKey>
+    size_type rank_of_key(const TLookupKey& key) const
+    {
+      static_assert(_has_order_statistics<TAugmentation>::value, "rank requires the tree_order_statistics augmentation");
+
+      size_type rank = 0;
+      const Node* node = root_node;
+      while (node)
+      {
+        if (node_comp(iset::data_cast(*node), key))
+        {
+          rank += subtree_size(node->children[kLeft]) + 1;
+          node = node->children[kRight];
+        }
+        else
+        {
+          node = node->children[kLeft];
+        }
+      }
+
+      return rank;
+    }
+
+    //*************************************************************************
+    /// The number of elements between the keys provided (see count_range).
+    //*************************************************************************
+    template <typename TLookupKey>
+    size_type count_keys_between(const TLookupKey& first, const TLookupKey& last) const
+    {
+      size_type first_rank = rank_of_key(first);
+      size_type last_rank = rank_of_key(last);
+      return last_rank > first_rank ? last_rank - first_rank : 0;
+    }
+
+    //*************************************************************************
+    /// Find the node at the position provided in order (nullptr if the
+    /// position is not less than the size).
+    //*************************************************************************
+    Node* find_nth_node(size_type position) const
+    {
+      static_assert(_has_order_statistics<TAugmentation>::value, "nth requires the tree_order_statistics augmentation");
+
+      Node* node = root_node;
+      while (node)
+      {
+        size_type left_size = subtree_size(node->children[kLeft]);
+        if (position < left_size)
+        {
+          node = node->children[kLeft];
+        }
+        else if (position == left_size)
+        {
+          break;
+        }
+        else
+        {
+          position -= left_size + 1;
+          node = node->children[kRight];
+        }
+      }
+
+      return node;
+    }
+
+    //*************************************************************************
+    /// Links the next count nodes of a list chained through their right
+    /// children into a perfectly balanced subtree, in order, and advances
+    /// the list past them. Returns the root of the subtree (its parent is
+    /// left to the caller) and its height.
+    //*************************************************************************
+    Node* link_balanced_tree(Node*& list, size_type count, size_t& height)
+    {
+      if (count == 0)
+      {
+        height = 0;
+        return nullptr;
+      }
+
+      // The right subtree gets the extra node, if any
+      size_type left_count = (count - 1) / 2;
+      size_t left_height;
+      size_t right_height;
+      Node* left = link_balanced_tree(list, left_count, left_height);
+      Node* node = list;
+      list = list->children[kRight];
+      Node* right = link_balanced_tree(list, count - 1 - left_count, right_height);
+
+      node->children[kLeft] = left;
+      node->children[kRight] = right;
+      if (left)
+      {
+        left->parent = node;
+      }
+      if (right)
+      {
+        right->parent = node;
+      }
+      node->weight = right_height > left_height ? uint8_t(kRight) : uint8_t(kNeither);
+      update_subtree_size(node);
+      node->dir = kNeither;
+      height = right_height + 1;
+      return node;
+    }
+
+    //*************************************************************************
+    /// Links a list of current_size nodes, chained in order through their
+    /// right children, into the tree of the set.
+    //*************************************************************************
+    void link_sorted_list(Node* list)
+    {
+      size_t height;
+      root_node = link_balanced_tree(list, current_size, height);
+      if (root_node)
+      {
+        root_node->parent = nullptr;
+      }
+      rightmost_node = find_limit_node(root_node, kRight);
+    }
+
+    //*************************************************************************
+    /// Walks a tree in order with an explicit stack, as for_each does,
+    /// without climbing back through the parent nodes as the iterators do.
+    //*************************************************************************
+    class in_order_cursor
+    {
+    public:
+
+      explicit in_order_cursor(const Node* root)
+        : top(0)
+      {
+        descend(root);
+      }
+
+      /// The current node, nullptr past the last node.
+      const Node* node() const
+      {
+        return top > 0 ? stack[top - 1] : nullptr;
+      }
+
+      void next()
+      {
+        const Node* current = stack[--top];
+        descend(current->children[kRight]);
+      }
+
+    private:
+
+      void descend(const Node* node)
+      {
+        while (node)
+        {
+          stack[top++] = node;
+          node = node->children[kLeft];
+        }
+      }
+
+      const Node* stack[kMaxHeight];
+      size_t top;
+    };
 
     //*************************************************************************
-    /// Constructor.
+    /// Chains the nodes of the tree provided in order through their right
+    /// children, and returns the first one. The right child of each node is
+    /// read before it gets overwritten by the link to the next node.
     //*************************************************************************
-    iset(bitmap_allocator<Data_Node>& node_pool, size_t max_size_)
-      : set_base(max_size_)
-      , p_node_pool(&node_pool)
-      , root_node(nullptr)
+    static Node* flatten_tree(Node* root)
     {
-      clear();
-    }
+      Node* stack[kMaxHeight];
+      size_t top = 0;
+      Node* list = nullptr;
+      Node** tail = &list;
+      Node* node = root;
+      while (node || top > 0)
+      {
+        while (node)
+        {
+          stack[top++] = node;
+          node = node->children[kLeft];
+        }
 
-  private:
+        node = stack[--top];
+        *tail = node;
+        tail = &node->children[kRight];
+        node = node->children[kRight];
+      }
+      *tail = nullptr;
+
+      return list;
+    }
 
     //*************************************************************************
-    /// Allocate a Data_Node.
+    /// Assigns the parts of two sets selected by a set operation (kFirstOnly,
+    /// kBoth, kSecondOnly) in one merge of their sorted sequences, creating
+    /// the nodes in order and linking them into a balanced tree.
     //*************************************************************************
-    Data_Node& allocate_data_node(value_type value) const
+    void assign_set_operation(const iset& first, const iset& second, uint8_t parts)
     {
-        auto p = p_node_pool->allocate();
-        new(p) Data_Node(value);
-        return *p;
+      sstl_assert(this != &first && this != &second);
+      clear();
+
+      Node* list = nullptr;
+      Node** tail = &list;
+      auto append = [this, &tail](const value_type& value)
+      {
+        sstl_assert(!full());
+        Data_Node& data_node = allocate_data_node(value);
+        ++current_size;
+        *tail = &data_node;
+        tail = &data_node.children[kRight];
+      };
+
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+        in_order_cursor first_cursor(first.root_node);
+        in_order_cursor second_cursor(second.root_node);
+        while (first_cursor.node() && second_cursor.node())
+        {
+          const Data_Node& first_node = iset::data_cast(*first_cursor.node());
+          const Data_Node& second_node = iset::data_cast(*second_cursor.node());
+          if (node_comp(first_node, second_node))
+          {
+            if (parts & kFirstOnly)
+            {
+              append(first_node.value);
+            }
+            first_cursor.next();
+          }
+          else if (node_comp(second_node, first_node))
+          {
+            if (parts & kSecondOnly)
+            {
+              append(second_node.value);
+            }
+            second_cursor.next();
+          }
+          else
+          {
+            if (parts & kBoth)
+            {
+              append(first_node.value);
+            }
+            first_cursor.next();
+            second_cursor.next();
+          }
+        }
+        for (; (parts & kFirstOnly) && first_cursor.node(); first_cursor.next())
+        {
+          append(iset::data_cast(first_cursor.node())->value);
+        }
+        for (; (parts & kSecondOnly) && second_cursor.node(); second_cursor.next())
+        {
+          append(iset::data_cast(second_cursor.node())->value);
+        }
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+        *tail = nullptr;
+        while (list)
+        {
+          Node* next = list->children[kRight];
+          destroy_data_node(iset::data_cast(*list));
+          list = next;
+        }
+        current_size = 0;
+        throw;
+      }
+      #endif
+
+      link_sorted_list(list);
     }
 
     //*************************************************************************
-    /// Destroy a Data_Node.
+    /// Destroy a Data_Node held by a node_type.
     //*************************************************************************
-    void destroy_data_node(Data_Node& node) const
+    void destroy_extracted_node(Data_Node& node)
     {
-        node.~Data_Node();
-        p_node_pool->deallocate(&node);
+        --extracted_size;
+        destroy_data_node(node);
     }
 
     //*************************************************************************
     /// Attach the provided node to the position provided
     //*************************************************************************
-    void attach_node(Node*& position, Data_Node& node)
+    void attach_node(Node* parent, Node*& position, Data_Node& node)
     {
       // Mark new node as leaf on attach to tree at position provided
       node.mark_as_leaf();
 
+      // Keep track of this node's parent
+      node.parent = parent;
+
       // Add the node here
       position = &node;
 
+      // One more node in the subtrees of the ancestors
+      update_subtree_size(&node);
+      adjust_subtree_sizes(parent, true);
+
+      // A node attached to the right of the last node is the new last node
+      if (parent == rightmost_node && (!parent || &position == &parent->children[kRight]))
+      {
+        rightmost_node = &node;
+      }
+
       // One more.
       ++current_size;
     }
@@ -887,6 +1897,120 @@ namespace sstl
       }
     }
 
+    //*************************************************************************
+    /// Insert a node for the key provided next to the hint, if the key goes
+    /// right before the node at the hint (or right after it): the node is
+    /// attached to one of the neighbours without searching the tree from
+    /// the root. Otherwise the key is inserted as by insert_node.
+    //*************************************************************************
+    template <typename TCreateNode>
+    std::pair<Node*, bool> insert_node_at_hint(Node* hint, const key_value_parameter_t& key, TCreateNode create_node)
+    {
+      // Find the neighbours of the key next to the hint
+      Node* prev = hint;
+      Node* next = hint;
+      if (!hint || node_comp(key, iset::data_cast(*hint)))
+      {
+        // The key goes before the hint, does it go after the previous node?
+        prev_node(prev);
+        if (prev && !node_comp(iset::data_cast(*prev), key))
+        {
+          return insert_node(root_node, key, create_node);
+        }
+      }
+      else if (node_comp(iset::data_cast(*hint), key))
+      {
+        // The key goes after the hint, does it go before the next node?
+        if (hint == rightmost_node)
+        {
+          next = nullptr;
+        }
+        else
+        {
+          next_node(next);
+        }
+        if (next && !node_comp(key, iset::data_cast(*next)))
+        {
+          return insert_node(root_node, key, create_node);
+        }
+      }
+      else
+      {
+        // The key is in the tree already
+        return std::make_pair(hint, false);
+      }
+
+      return std::make_pair(attach_node_between(prev, next, create_node), true);
+    }
+
+    //*************************************************************************
+    /// Attach the node created by the function provided between the nodes
+    /// provided (next to each other in order, either one might be nullptr
+    /// at the ends), then balance the tree.
+    //*************************************************************************
+    template <typename TCreateNode>
+    Node* attach_node_between(Node* prev, Node* next, TCreateNode create_node)
+    {
+      Node* node;
+      if (!prev && !next)
+      {
+        attach_node(nullptr, root_node, create_node());
+        return root_node;
+      }
+      // Either the next node has no left child or the previous node (the
+      // maximum of that left child) has no right child
+      else if (next && !next->children[kLeft])
+      {
+        attach_node(next, next->children[kLeft], create_node());
+        node = next->children[kLeft];
+      }
+      else
+      {
+        attach_node(prev, prev->children[kRight], create_node());
+        node = prev->children[kRight];
+      }
+
+      balance_attached_node(node);
+      return node;
+    }
+
+    //*************************************************************************
+    /// Balance the tree after the node provided was attached as a leaf
+    /// without searching from the root: the directions from the critical
+    /// node down to the new node are marked going up the parents, as they
+    /// are by insert_node on its way down.
+    //*************************************************************************
+    void balance_attached_node(Node* node)
+    {
+      // The critical node is the nearest ancestor that isn't balanced (or
+      // the root)
+      Node* critical_node = node->parent;
+      while (true)
+      {
+        critical_node->dir = critical_node->children[kLeft] == node ? kLeft : kRight;
+        if (kNeither != critical_node->weight || !critical_node->parent)
+        {
+          break;
+        }
+        node = critical_node;
+        critical_node = critical_node->parent;
+      }
+
+      Node* critical_parent_node = critical_node->parent;
+      if (!critical_parent_node)
+      {
+        balance_node(root_node);
+      }
+      else if (critical_parent_node->children[kLeft] == critical_node)
+      {
+        balance_node(critical_parent_node->children[kLeft]);
+      }
+      else
+      {
+        balance_node(critical_parent_node->children[kRight]);
+      }
+    }
+
     //*************************************************************************
     /// Detach the node at the position provided
     //*************************************************************************
@@ -904,17 +2028,32 @@ namespace sstl
       // Update replacement node to point to child in opposite direction
       // otherwise we might lose the other child of the swap node
       replacement = swap->children[1 - swap->dir];
+      if (replacement)
+      {
+        replacement->parent = swap->parent;
+      }
 
-      // Point swap node to detached node's children and weight
+      // Point swap node to detached node's parent, children and weight
+      swap->parent = detached->parent;
       swap->children[kLeft] = detached->children[kLeft];
       swap->children[kRight] = detached->children[kRight];
+      if (swap->children[kLeft])
+      {
+        swap->children[kLeft]->parent = swap;
+      }
+      if (swap->children[kRight])
+      {
+        swap->children[kRight]->parent = swap;
+      }
       swap->weight = detached->weight;
+      copy_subtree_size(swap, detached);
     }
 
     //*************************************************************************
     /// Find the value matching the node provided
     //*************************************************************************
-    Node* find_node(Node* position, const key_value_parameter_t& key)
+    template <typename TLookupKey>
+    Node* find_node(Node* position, const TLookupKey& key)
     {
       Node* found = position;
       while (found)
@@ -947,7 +2086,8 @@ namespace sstl
     //*************************************************************************
     /// Find the value matching the node provided
     //*************************************************************************
-    const Node* find_node(const Node* position, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    const Node* find_node(const Node* position, const TLookupKey& key) const
     {
       const Node* found = position;
       while (found)
@@ -977,51 +2117,6 @@ namespace sstl
       return found;
     }
 
-    //*************************************************************************
-    /// Find the reference node matching the node provided
-    //*************************************************************************
-    Node*& find_node(Node*& position, const Node* node)
-    {
-      Node* found = position;
-      while (found)
-      {
-        if (found->children[kLeft] == node)
-        {
-          return found->children[kLeft];
-        }
-        else if (found->children[kRight] == node)
-        {
-          return found->children[kRight];
-        }
-        else
-        {
-          // Downcast found to Data_Node class for comparison and other operations
-          Data_Node& found_data_node = iset::data_cast(*found);
-          const Data_Node& data_node = iset::data_cast(*node);
-
-          // Compare the node value to the current position value
-          if (node_comp(data_node, found_data_node))
-          {
-            // Keep searching for the node on the left
-            found = found->children[kLeft];
-          }
-          else if (node_comp(found_data_node, data_node))
-          {
-            // Keep searching for the node on the right
-            found = found->children[kRight];
-          }
-          else
-          {
-            // Return position provided (it matches the node)
-            return position;
-          }
-        }
-      }
-
-      // Return root node if nothing was found
-      return root_node;
-    }
-
     //*************************************************************************
     /// Find the node whose key would go before all the other keys from the
     /// position provided
@@ -1056,133 +2151,32 @@ namespace sstl
       return limit_node;
     }
 
-    //*************************************************************************
-    /// Find the parent node that contains the node provided in its left or
-    /// right tree
-    //*************************************************************************
-    Node* find_parent_node(Node* position, const Node* node)
-    {
-      // Default to no parent node found
-      Node* found = nullptr;
-
-      // If the position provided is the same as the node then there is no parent
-      if (position && node && position != node)
-      {
-        while (position)
-        {
-          // Is this position not the parent of the node we are looking for?
-          if (position->children[kLeft] != node &&
-              position->children[kRight] != node)
-          {
-            // Downcast node and position to Data_Node references for key comparisons
-            const Data_Node& node_data_node = iset::data_cast(*node);
-            Data_Node& position_data_node = iset::data_cast(*position);
-            // Compare the node value to the current position value
-            if (node_comp(node_data_node, position_data_node))
-            {
-              // Keep looking for parent on the left
-              position = position->children[kLeft];
-            }
-            else if (node_comp(position_data_node, node_data_node))
-            {
-              // Keep looking for parent on the right
-              position = position->children[kRight];
-            }
-          }
-          else
-          {
-            // Return the current position as the parent node found
-            found = position;
-
-            // Parent node found, exit loop
-            break;
-          }
-        }
-      }
-
-      // Return the parent node found (might be nullptr)
-      return found;
-    }
-
-    //*************************************************************************
-    /// Find the parent node that contains the node provided in its left or
-    /// right tree
-    //*************************************************************************
-    const Node* find_parent_node(const Node* position, const Node* node) const
-    {
-      // Default to no parent node found
-      const Node* found = nullptr;
-
-      // If the position provided is the same as the node then there is no parent
-      if (position && node && position != node)
-      {
-        while (position)
-        {
-          // Is this position not the parent of the node we are looking for?
-          if (position->children[kLeft] != node &&
-              position->children[kRight] != node)
-          {
-            // Downcast node and position to Data_Node references for key comparisons
-            const Data_Node& node_data_node = iset::data_cast(*node);
-            const Data_Node& position_data_node = iset::data_cast(*position);
-            // Compare the node value to the current position value
-            if (node_comp(node_data_node, position_data_node))
-            {
-              // Keep looking for parent on the left
-              position = position->children[kLeft];
-            }
-            else if (node_comp(position_data_node, node_data_node))
-            {
-              // Keep looking for parent on the right
-              position = position->children[kRight];
-            }
-          }
-          else
-          {
-            // Return the current position as the parent node found
-            found = position;
-
-            // Parent node found, exit loop
-            break;
-          }
-        }
-      }
-
-      // Return the parent node found (might be nullptr)
-      return found;
-    }
-
     //*************************************************************************
     /// Find the node whose key is not considered to go before the key provided
     //*************************************************************************
-    Node* find_lower_node(Node* position, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    Node* find_lower_node(Node* position, const TLookupKey& key) const
     {
-      // Something at this position? keep going
-      Node* lower_node = position;
-      while (lower_node)
+      // Keep track of the last node whose key goes after the key provided
+      Node* lower_node = nullptr;
+      while (position)
       {
-        // Downcast lower node to Data_Node reference for key comparisons
-        Data_Node& data_node = iset::data_cast(*lower_node);
-        // Compare the key value to the current lower node key value
+        // Downcast position to Data_Node reference for key comparisons
+        Data_Node& data_node = iset::data_cast(*position);
+        // Compare the key value to the current position key value
         if (node_comp(key, data_node))
         {
-          if (lower_node->children[kLeft])
-          {
-            lower_node = lower_node->children[kLeft];
-          }
-          else
-          {
-            // Found lowest node
-            break;
-          }
+          lower_node = position;
+          position = position->children[kLeft];
         }
         else if (node_comp(data_node, key))
         {
-          lower_node = lower_node->children[kRight];
+          position = position->children[kRight];
         }
         else
         {
           // Found equal node
+          lower_node = position;
           break;
         }
       }
@@ -1194,7 +2188,8 @@ namespace sstl
     //*************************************************************************
     /// Find the node whose key is considered to go after the key provided
     //*************************************************************************
-    Node* find_upper_node(Node* position, const key_value_parameter_t& key) const
+    template <typename TLookupKey>
+    Node* find_upper_node(Node* position, const TLookupKey& key) const
     {
       // Keep track of parent of last upper node
       Node* upper_node = nullptr;
@@ -1230,12 +2225,16 @@ namespace sstl
     }
 
     //*************************************************************************
-    /// Insert a node.
+    /// Insert a node for the key provided. The node is created by the
+    /// function provided only once the key is known not to be in the tree,
+    /// otherwise the node that holds the key already is returned.
     //*************************************************************************
-    Node* insert_node(Node*& position, Data_Node& node)
+    template <typename TCreateNode>
+    std::pair<Node*, bool> insert_node(Node*& position, const key_value_parameter_t& key, TCreateNode create_node)
     {
       // Find the location where the node belongs
       Node* found = position;
+      bool inserted = false;
 
       // Was position provided not empty? then find where the node belongs
       if (position)
@@ -1256,14 +2255,14 @@ namespace sstl
           // Downcast found to Data_Node class for comparison and other operations
           Data_Node& found_data_node = iset::data_cast(*found);
 
-          // Is the node provided to the left of the current position?
-          if (node_comp(node, found_data_node))
+          // Is the key provided to the left of the current position?
+          if (node_comp(key, found_data_node))
           {
             // Update direction taken to insert new node in parent node
             found->dir = kLeft;
           }
-          // Is the node provided to the right of the current position?
-          else if (node_comp(found_data_node, node))
+          // Is the key provided to the right of the current position?
+          else if (node_comp(found_data_node, key))
           {
             // Update direction taken to insert new node in parent node
             found->dir = kRight;
@@ -1276,10 +2275,7 @@ namespace sstl
             // Clear critical node value to skip weight step below
             critical_node = nullptr;
 
-            // Destroy the node provided (its a duplicate)
-            destroy_data_node(node);
-
-            // Exit loop, duplicate node found
+            // Exit loop, the key is already in the tree
             break;
           }
 
@@ -1298,11 +2294,12 @@ namespace sstl
           }
           else
           {
-            // Attatch node to right
-            attach_node(found->children[found->dir], node);
+            // Create the node and attach it as a child of the parent node found
+            attach_node(found, found->children[found->dir], create_node());
 
             // Return newly added node
             found = found->children[found->dir];
+            inserted = true;
 
             // Exit loop
             break;
@@ -1328,15 +2325,16 @@ namespace sstl
       }
       else
       {
-        // Attatch node to current position
-        attach_node(position, node);
+        // Attatch node to current position (which is assumed to be root)
+        attach_node(nullptr, position, create_node());
 
         // Return newly added node at current position
         found = position;
+        inserted = true;
       }
 
-      // Return the node found (might be nullptr)
-      return found;
+      // Return the node found and whether it was created
+      return std::make_pair(found, inserted);
     }
 
     //*************************************************************************
@@ -1361,7 +2359,7 @@ namespace sstl
             // Update current position as previous parent
             position = parent;
             // Find parent of current position
-            parent = find_parent_node(root_node, position);
+            parent = position->parent;
             // Repeat while previous position was on right side of parent tree
           } while (parent && parent->children[kRight] == position);
 
@@ -1393,7 +2391,7 @@ namespace sstl
             // Update current position as previous parent
             position = parent;
             // Find parent of current position
-            parent = find_parent_node(root_node, position);
+            parent = position->parent;
             // Repeat while previous position was on right side of parent tree
           } while (parent && parent->children[kRight] == position);
 
@@ -1412,7 +2410,7 @@ namespace sstl
       // from the root
       if (!position)
       {
-        position = find_limit_node(root_node, kRight);
+        position = rightmost_node;
       }
       else
       {
@@ -1431,7 +2429,7 @@ namespace sstl
             // Update current position as previous parent
             position = parent;
             // Find parent of current position
-            parent = find_parent_node(root_node, position);
+            parent = position->parent;
             // Repeat while previous position was on left side of parent tree
           } while (parent && parent->children[kLeft] == position);
 
@@ -1450,7 +2448,7 @@ namespace sstl
       // from the root
       if (!position)
       {
-        position = find_limit_node(root_node, kRight);
+        position = rightmost_node;
       }
       else
       {
@@ -1469,7 +2467,7 @@ namespace sstl
             // Update current position as previous parent
             position = parent;
             // Find parent of current position
-            parent = find_parent_node(root_node, position);
+            parent = position->parent;
             // Repeat while previous position was on left side of parent tree
           } while (parent && parent->children[kLeft] == position);
 
@@ -1480,10 +2478,25 @@ namespace sstl
     }
 
     //*************************************************************************
-    /// Remove the node specified from somewhere starting at the position
-    /// provided
+    /// Remove the node matching the key provided and destroy it
     //*************************************************************************
     Node* remove_node(Node*& position, const key_value_parameter_t& key)
+    {
+      Node* found = unlink_node(position, key);
+      if (found)
+      {
+        destroy_data_node(iset::data_cast(*found));
+      }
+
+      // Return node found (might be nullptr)
+      return found;
+    }
+
+    //*************************************************************************
+    /// Unlink the node matching the key provided from the tree starting at
+    /// the position provided, without destroying it
+    //*************************************************************************
+    Node* unlink_node(Node*& position, const key_value_parameter_t& key)
     {
       // Step 1: Find the target node that matches the key provided, the
       // replacement node (might be the same as target node), and the critical
@@ -1548,6 +2561,13 @@ namespace sstl
       // If target node was found, proceed with rebalancing and replacement
       if (found)
       {
+        // The last node is replaced by the previous one: its left child if
+        // any (a leaf, its right subtree being empty) or its parent
+        if (found == rightmost_node)
+        {
+          rightmost_node = found->children[kLeft] ? found->children[kLeft] : found->parent;
+        }
+
         // Step 2: Update weights from critical node to replacement parent node
         while (balance)
         {
@@ -1637,6 +2657,10 @@ namespace sstl
           balance = balance->children[balance->dir];
         } // while(balance)
 
+        // The replacement node leaves its position: one node less in the
+        // subtrees of its ancestors (found included, unless it is found)
+        adjust_subtree_sizes(replace->parent, false);
+
         // Step 3: Swap found node with replacement node
         if (found_parent)
         {
@@ -1659,14 +2683,8 @@ namespace sstl
           }
         }
 
-        // Downcast found into data node
-        Data_Node& found_data_node = iset::data_cast(*found);
-
         // One less.
         --current_size;
-
-        // Destroy the node removed
-        destroy_data_node(found_data_node);
       } // if(found)
 
       // Return node found (might be nullptr)
@@ -1689,15 +2707,29 @@ namespace sstl
       // A (position) takes ownership of E as its left child
       // B (new position) takes ownership of A as its right child
 
-      // Capture new root
+      // Capture new root (either B or C depending on dir) and its parent
       Node* new_root = position->children[dir];
+
       // Replace position's previous child with new root's other child
       position->children[dir] = new_root->children[1 - dir];
-      // New root now becomes parent of current position
+      // Update new root's other child parent pointer
+      if (position->children[dir])
+      {
+        position->children[dir]->parent = position;
+      }
+
+      // New root's parent becomes current position's parent
+      new_root->parent = position->parent;
       new_root->children[1 - dir] = position;
+      new_root->dir = 1 - dir;
+
       // Clear weight factor from current position
       position->weight = kNeither;
-      // Newly detached right now becomes current position
+      // Position's parent becomes new_root
+      position->parent = new_root;
+      // Position lost the subtree of new root, which now holds both
+      update_subtree_size(position);
+      update_subtree_size(new_root);
       position = new_root;
       // Clear weight factor from new root
       position->weight = kNeither;
@@ -1726,18 +2758,38 @@ namespace sstl
       position->children[dir]->weight = third != kNeither && third != dir ? dir : kNeither;
 
       // Detach new root from its tree (replace with new roots child)
-      position->children[dir]->children[1 - dir] =
-        new_root->children[dir];
-      // Attach current left tree to new root
+      position->children[dir]->children[1 - dir] = new_root->children[dir];
+      // Update new roots child parent pointer
+      if (new_root->children[dir])
+      {
+        new_root->children[dir]->parent = position->children[dir];
+      }
+
+      // Attach current left tree to new root and update its parent
       new_root->children[dir] = position->children[dir];
+      position->children[dir]->parent = new_root;
+
       // Set weight factor for A based on F or G
       position->weight = third != kNeither && third == dir ? 1 - dir : kNeither;
 
       // Move new root's right tree to current roots left tree
       position->children[dir] = new_root->children[1 - dir];
-      // Attach current root to new roots right tree
+      if (new_root->children[1 - dir])
+      {
+        new_root->children[1 - dir]->parent = position;
+      }
+
+      // Attach current root to new roots right tree and assume its parent
+      new_root->parent = position->parent;
       new_root->children[1 - dir] = position;
-      // Replace current position with new root
+      new_root->dir = 1 - dir;
+
+      // Update current position's parent and replace with new root
+      position->parent = new_root;
+      // Recount the subtrees of the three nodes moved, bottom up
+      update_subtree_size(new_root->children[dir]);
+      update_subtree_size(position);
+      update_subtree_size(new_root);
       position = new_root;
       // Clear weight factor for new current position
       position->weight = kNeither;
@@ -1751,8 +2803,8 @@ namespace sstl
    ///\return <b>true</b> if the arrays are equal, otherwise <b>false</b>
    ///\ingroup lookup
    //***************************************************************************
-   template <typename T, typename TCompare>
-   bool operator ==(const sstl::iset<T, TCompare>& lhs, const sstl::iset<T, TCompare>& rhs)
+   template <typename T, typename TCompare, typename TAugmentation>
+   bool operator ==(const sstl::iset<T, TCompare, TAugmentation>& lhs, const sstl::iset<T, TCompare, TAugmentation>& rhs)
    {
      return (lhs.size() == rhs.size()) && std::equal(lhs.begin(), lhs.end(), rhs.begin());
    }
@@ -1764,8 +2816,8 @@ namespace sstl
    ///\return <b>true</b> if the arrays are not equal, otherwise <b>false</b>
    ///\ingroup lookup
    //***************************************************************************
-   template <typename T, typename TCompare>
-   bool operator !=(const sstl::iset<T, TCompare>& lhs, const sstl::iset<T, TCompare>& rhs)
+   template <typename T, typename TCompare, typename TAugmentation>
+   bool operator !=(const sstl::iset<T, TCompare, TAugmentation>& lhs, const sstl::iset<T, TCompare, TAugmentation>& rhs)
    {
      return !(lhs == rhs);
    }
@@ -1777,8 +2829,8 @@ namespace sstl
    ///\return <b>true</b> if the first list is lexicographically less than the
    /// second, otherwise <b>false</b>.
    //*************************************************************************
-   template <typename T, typename TCompare>
-   bool operator <(const sstl::iset<T, TCompare>& lhs, const sstl::iset<T, TCompare>& rhs)
+   template <typename T, typename TCompare, typename TAugmentation>
+   bool operator <(const sstl::iset<T, TCompare, TAugmentation>& lhs, const sstl::iset<T, TCompare, TAugmentation>& rhs)
    {
      return std::lexicographical_compare(lhs.begin(),
                                          lhs.end(),
@@ -1793,8 +2845,8 @@ namespace sstl
    ///\return <b>true</b> if the first list is lexicographically greater than the
    /// second, otherwise <b>false</b>.
    //*************************************************************************
-   template <typename T, typename TCompare>
-   bool operator >(const sstl::iset<T, TCompare>& lhs, const sstl::iset<T, TCompare>& rhs)
+   template <typename T, typename TCompare, typename TAugmentation>
+   bool operator >(const sstl::iset<T, TCompare, TAugmentation>& lhs, const sstl::iset<T, TCompare, TAugmentation>& rhs)
    {
      return std::lexicographical_compare(lhs.begin(),
                                          lhs.end(),
@@ -1810,8 +2862,8 @@ namespace sstl
    ///\return <b>true</b> if the first list is lexicographically less than or equal
    /// to the second, otherwise <b>false</b>.
    //*************************************************************************
-   template <typename T, typename TCompare>
-   bool operator <=(const sstl::iset<T, TCompare>& lhs, const sstl::iset<T, TCompare>& rhs)
+   template <typename T, typename TCompare, typename TAugmentation>
+   bool operator <=(const sstl::iset<T, TCompare, TAugmentation>& lhs, const sstl::iset<T, TCompare, TAugmentation>& rhs)
    {
      return !operator >(lhs, rhs);
    }
@@ -1823,8 +2875,8 @@ namespace sstl
    ///\return <b>true</b> if the first list is lexicographically greater than or
    /// equal to the second, otherwise <b>false</b>.
    //*************************************************************************
-   template <typename T, typename TCompare>
-   bool operator >=(const sstl::iset<T, TCompare>& lhs, const sstl::iset<T, TCompare>& rhs)
+   template <typename T, typename TCompare, typename TAugmentation>
+   bool operator >=(const sstl::iset<T, TCompare, TAugmentation>& lhs, const sstl::iset<T, TCompare, TAugmentation>& rhs)
    {
      return !operator <(lhs, rhs);
    }
@@ -85,6 +85,14 @@ namespace sstl
       imap<TKey, TValue, TCompare>::insert(first, last);
     }
 
+    //*************************************************************************
+    /// Destructor.
+    //*************************************************************************
+    ~map()
+    {
+      imap<TKey, TValue, TCompare>::clear();
+    }
+
     //*************************************************************************
     /// Assignment operator.
     //*************************************************************************
@@ -77,7 +77,7 @@ namespace sstl
     //*************************************************************************
     bool full() const
     {
-      return current_size == MAX_SIZE;
+      return current_size + extracted_size == MAX_SIZE;
     }
 
     //*************************************************************************
@@ -95,7 +95,7 @@ namespace sstl
     //*************************************************************************
     size_t available() const
     {
-      return max_size() - size();
+      return max_size() - size() - extracted_size;
     }
 
   protected:
@@ -105,12 +105,14 @@ namespace sstl
     //*************************************************************************
     map_base(size_type max_size)
       : current_size(0)
+      , extracted_size(0)
       , MAX_SIZE(max_size)
 
     {
     }
 
     size_type current_size;   ///< The number of the used nodes.
+    size_type extracted_size; ///< The number of the nodes held by node handles.
     const size_type MAX_SIZE; ///< The maximum size of the map.
   };
 }
@@ -0,0 +1,307 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_MINMAX_HEAP__
+#define _SSTL_MINMAX_HEAP__
+
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+#include <functional>
+
+#include <sstl_assert.h>
+
+#include "__internal/_except.h"
+#include "__internal/_iterator.h"
+#include "__internal/_bit_width.h"
+#include "vector.h"
+
+namespace sstl
+{
+
+// double-ended priority queue (Atkinson et al., "Min-max heaps and generalized priority queues").
+// The levels of the binary heap alternate between min levels (the root's level) and max levels:
+// a value on a min level is not greater than any of its descendants and a value on a max level
+// is not smaller. The smallest value is the root and the largest value is one of its children.
+// push_keep_largest/push_keep_smallest implement a bounded "top K" mode (K == CAPACITY):
+// once the heap is full an insertion evicts the smallest/largest value, if the new value is better.
+template<class T, size_t CAPACITY, class Compare=std::less<T>>
+class minmax_heap
+{
+public:
+   using container_type = sstl::vector<T, CAPACITY>;
+   using value_compare = Compare;
+   using value_type = T;
+   using size_type = size_t;
+   using reference = value_type&;
+   using const_reference = const value_type&;
+
+public:
+   minmax_heap() : minmax_heap(Compare{})
+   {}
+
+   explicit minmax_heap(const Compare& compare)
+      : _values()
+      , _compare(compare)
+   {}
+
+   template<class TIterator, class = typename std::enable_if<_is_input_iterator<TIterator>::value>::type>
+   minmax_heap(TIterator range_begin, TIterator range_end, const Compare& compare=Compare{})
+      : _values(range_begin, range_end)
+      , _compare(compare)
+   {
+      for(auto idx = _values.size() / 2; idx > 0; --idx)
+      {
+         _trickle_down(idx-1);
+      }
+   }
+
+   const_reference min() const _sstl_noexcept_
+   {
+      sstl_assert(!empty());
+      return _values[0];
+   }
+
+   const_reference max() const _sstl_noexcept_
+   {
+      sstl_assert(!empty());
+      return _values[_max_index()];
+   }
+
+   bool empty() const _sstl_noexcept_
+   {
+      return _values.empty();
+   }
+
+   bool full() const _sstl_noexcept_
+   {
+      return _values.size() == CAPACITY;
+   }
+
+   size_type size() const _sstl_noexcept_
+   {
+      return _values.size();
+   }
+
+   size_type capacity() const _sstl_noexcept_
+   {
+      return CAPACITY;
+   }
+
+   void push(const_reference value)
+   {
+      _values.push_back(value);
+      _bubble_up(_values.size()-1);
+   }
+
+   void push(value_type&& value)
+   {
+      _values.push_back(std::move(value));
+      _bubble_up(_values.size()-1);
+   }
+
+   template<class... Args>
+   void emplace(Args&&... args)
+   {
+      _values.emplace_back(std::forward<Args>(args)...);
+      _bubble_up(_values.size()-1);
+   }
+
+   void pop_min()
+   {
+      sstl_assert(!empty());
+      _erase(0);
+   }
+
+   void pop_max()
+   {
+      sstl_assert(!empty());
+      _erase(_max_index());
+   }
+
+   //pop_min() + push() with a single trickle-down
+   template<class TValue>
+   void replace_min(TValue&& value)
+   {
+      sstl_assert(!empty());
+      _values[0] = std::forward<TValue>(value);
+      _trickle_down(0);
+   }
+
+   //pop_max() + push() with a single trickle-down
+   template<class TValue>
+   void replace_max(TValue&& value)
+   {
+      sstl_assert(!empty());
+      auto idx = _max_index();
+      _values[idx] = std::forward<TValue>(value);
+      if(idx > 0 && _compare(_values[idx], _values[0]))
+      {
+         //the new value is smaller than the minimum
+         using std::swap;
+         swap(_values[idx], _values[0]);
+      }
+      _trickle_down(idx);
+   }
+
+   //keeps the CAPACITY largest values: if the heap is full the value replaces the
+   //smallest value, unless it is not greater. Returns false if the value was rejected
+   template<class TValue>
+   bool push_keep_largest(TValue&& value)
+   {
+      if(!full())
+      {
+         push(std::forward<TValue>(value));
+         return true;
+      }
+      if(!_compare(_values[0], value))
+         return false;
+      replace_min(std::forward<TValue>(value));
+      return true;
+   }
+
+   //keeps the CAPACITY smallest values: if the heap is full the value replaces the
+   //largest value, unless it is not smaller. Returns false if the value was rejected
+   template<class TValue>
+   bool push_keep_smallest(TValue&& value)
+   {
+      if(!full())
+      {
+         push(std::forward<TValue>(value));
+         return true;
+      }
+      if(!_compare(value, _values[_max_index()]))
+         return false;
+      replace_max(std::forward<TValue>(value));
+      return true;
+   }
+
+   void clear() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _values.clear();
+   }
+
+   void swap(minmax_heap& rhs)
+   {
+      using std::swap;
+      swap(_values, rhs._values);
+      swap(_compare, rhs._compare);
+   }
+
+private:
+   static bool _is_min_level(size_type idx) _sstl_noexcept_
+   {
+      return _bit_width_of(idx+1) % 2 == 1;
+   }
+
+   size_type _max_index() const _sstl_noexcept_
+   {
+      auto size = _values.size();
+      if(size <= 2)
+         return size-1;
+      return _compare(_values[1], _values[2]) ? 2 : 1;
+   }
+
+   //"is better than" on min levels means "is smaller than", on max levels "is greater than"
+   bool _is_better(const_reference lhs, const_reference rhs, bool is_min_level) const
+   {
+      return is_min_level ? _compare(lhs, rhs) : _compare(rhs, lhs);
+   }
+
+   void _erase(size_type idx)
+   {
+      auto last = _values.size()-1;
+      if(idx != last)
+         _values[idx] = std::move(_values[last]);
+      _values.pop_back();
+      if(idx < last)
+         _trickle_down(idx);
+   }
+
+   void _bubble_up(size_type idx)
+   {
+      if(idx == 0)
+         return;
+      auto is_min_level = _is_min_level(idx);
+      auto parent = (idx-1) / 2;
+      if(_is_better(_values[parent], _values[idx], is_min_level))
+      {
+         //the value belongs to the levels of the other kind
+         using std::swap;
+         swap(_values[idx], _values[parent]);
+         _bubble_up_grandparents(parent, !is_min_level);
+      }
+      else
+      {
+         _bubble_up_grandparents(idx, is_min_level);
+      }
+   }
+
+   void _bubble_up_grandparents(size_type idx, bool is_min_level)
+   {
+      if(idx < 3)
+         return;
+      value_type value(std::move(_values[idx]));
+      while(idx >= 3)
+      {
+         auto grandparent = ((idx-1) / 2 - 1) / 2;
+         if(!_is_better(value, _values[grandparent], is_min_level))
+            break;
+         _values[idx] = std::move(_values[grandparent]);
+         idx = grandparent;
+      }
+      _values[idx] = std::move(value);
+   }
+
+   void _trickle_down(size_type idx)
+   {
+      using std::swap;
+      auto size = _values.size();
+      auto is_min_level = _is_min_level(idx);
+      while(true)
+      {
+         //the best value among the children and the grandchildren
+         auto first_child = 2*idx + 1;
+         if(first_child >= size)
+            return;
+         auto best = first_child;
+         if(first_child+1 < size && _is_better(_values[first_child+1], _values[best], is_min_level))
+            best = first_child+1;
+         auto first_grandchild = 2*first_child + 1;
+         auto last_grandchild = first_grandchild+4 < size ? first_grandchild+4 : size;
+         for(auto grandchild = first_grandchild; grandchild < last_grandchild; ++grandchild)
+         {
+            if(_is_better(_values[grandchild], _values[best], is_min_level))
+               best = grandchild;
+         }
+
+         if(!_is_better(_values[best], _values[idx], is_min_level))
+            return;
+         swap(_values[best], _values[idx]);
+         if(best < first_grandchild)
+            return;
+         auto parent = (best-1) / 2;
+         if(_is_better(_values[parent], _values[best], is_min_level))
+            swap(_values[parent], _values[best]);
+         idx = best;
+      }
+   }
+
+private:
+   container_type _values;
+   Compare _compare;
+};
+
+template<class T, size_t CAPACITY, class Compare>
+void swap(minmax_heap<T, CAPACITY, Compare>& lhs, minmax_heap<T, CAPACITY, Compare>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+}
+
+#endif
@@ -0,0 +1,230 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_MPMC_QUEUE__
+#define _SSTL_MPMC_QUEUE__
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <atomic>
+#include <array>
+
+#include "__internal/_except.h"
+#include "__internal/_aligned_storage.h"
+#include "__internal/_cache_line.h"
+#include "__internal/_backoff.h"
+
+namespace sstl
+{
+
+// lock-free bounded queue for any number of producer and consumer threads
+// (D. Vyukov's design). Every cell has a sequence number telling whether the cell
+// is ready to be written (sequence == position) or read (sequence == position+1)
+// for the current lap, thus producers and consumers only contend on the enqueue or
+// dequeue position respectively (one CAS each) and never on the same cell.
+// The value type must be nothrow move constructible and nothrow move assignable,
+// because once a cell is claimed the operation cannot be rolled back.
+template<class T, size_t CAPACITY>
+class mpmc_queue
+{
+   static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY-1)) == 0, "capacity must be a power of two (greater than one)");
+   static_assert(std::is_nothrow_move_constructible<T>::value, "value type must be nothrow move constructible");
+   static_assert(std::is_nothrow_move_assignable<T>::value, "value type must be nothrow move assignable");
+
+public:
+   using value_type = T;
+   using size_type = size_t;
+   using reference = value_type&;
+   using const_reference = const value_type&;
+
+public:
+   mpmc_queue() _sstl_noexcept_
+   {
+      for(size_type i=0; i<CAPACITY; ++i)
+      {
+         _cells[i]._sequence.store(i, std::memory_order_relaxed);
+      }
+   }
+
+   mpmc_queue(const mpmc_queue&) = delete;
+   mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+   ~mpmc_queue()
+   {
+      auto end = _enqueue_pos.load(std::memory_order_relaxed);
+      for(auto pos = _dequeue_pos.load(std::memory_order_relaxed); pos != end; ++pos)
+      {
+         _cells[pos & _mask]._value()->~value_type();
+      }
+   }
+
+   bool try_push(const_reference value)
+      _sstl_noexcept(std::is_nothrow_copy_constructible<value_type>::value)
+   {
+      value_type copy(value);
+      return _try_push_value(copy);
+   }
+
+   bool try_push(value_type&& value) _sstl_noexcept_
+   {
+      return _try_push_value(value);
+   }
+
+   template<class... Args>
+   bool try_emplace(Args&&... args)
+      _sstl_noexcept(std::is_nothrow_constructible<value_type, typename std::add_rvalue_reference<Args>::type...>::value)
+   {
+      value_type value(std::forward<Args>(args)...);
+      return _try_push_value(value);
+   }
+
+   bool try_pop(reference value) _sstl_noexcept_
+   {
+      auto pos = _dequeue_pos.load(std::memory_order_relaxed);
+      _cell* cell;
+      while(true)
+      {
+         cell = &_cells[pos & _mask];
+         auto sequence = cell->_sequence.load(std::memory_order_acquire);
+         auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos+1);
+         if(difference == 0)
+         {
+            if(_dequeue_pos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed))
+               break;
+         }
+         else if(difference < 0)
+         {
+            return false; //empty
+         }
+         else
+         {
+            pos = _dequeue_pos.load(std::memory_order_relaxed);
+         }
+      }
+      value = std::move(*cell->_value());
+      cell->_value()->~value_type();
+      cell->_sequence.store(pos+CAPACITY, std::memory_order_release);
+      return true;
+   }
+
+   //blocking variants: spin (and then yield) until the operation succeeds
+   void push(const_reference value)
+      _sstl_noexcept(std::is_nothrow_copy_constructible<value_type>::value)
+   {
+      value_type copy(value);
+      _push_value(copy);
+   }
+
+   void push(value_type&& value) _sstl_noexcept_
+   {
+      _push_value(value);
+   }
+
+   template<class... Args>
+   void emplace(Args&&... args)
+      _sstl_noexcept(std::is_nothrow_constructible<value_type, typename std::add_rvalue_reference<Args>::type...>::value)
+   {
+      value_type value(std::forward<Args>(args)...);
+      _push_value(value);
+   }
+
+   void pop(reference value) _sstl_noexcept_
+   {
+      _backoff backoff;
+      while(!try_pop(value))
+      {
+         backoff();
+      }
+   }
+
+   //the result might be outdated when it gets returned
+   size_type size() const _sstl_noexcept_
+   {
+      auto dequeue_pos = _dequeue_pos.load(std::memory_order_acquire);
+      auto enqueue_pos = _enqueue_pos.load(std::memory_order_acquire);
+      auto difference = static_cast<intptr_t>(enqueue_pos) - static_cast<intptr_t>(dequeue_pos);
+      return difference < 0 ? 0 : std::min(static_cast<size_type>(difference), CAPACITY);
+   }
+
+   //the result might be outdated when it gets returned
+   bool empty() const _sstl_noexcept_
+   {
+      return size() == 0;
+   }
+
+   size_type capacity() const _sstl_noexcept_
+   {
+      return CAPACITY;
+   }
+
+private:
+   //the value is moved into the queue only if a cell could be claimed
+   bool _try_push_value(value_type& value) _sstl_noexcept_
+   {
+      auto pos = _enqueue_pos.load(std::memory_order_relaxed);
+      _cell* cell;
+      while(true)
+      {
+         cell = &_cells[pos & _mask];
+         auto sequence = cell->_sequence.load(std::memory_order_acquire);
+         auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+         if(difference == 0)
+         {
+            if(_enqueue_pos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed))
+               break;
+         }
+         else if(difference < 0)
+         {
+            return false; //full
+         }
+         else
+         {
+            pos = _enqueue_pos.load(std::memory_order_relaxed);
+         }
+      }
+      new(cell->_value()) value_type(std::move(value));
+      cell->_sequence.store(pos+1, std::memory_order_release);
+      return true;
+   }
+
+   void _push_value(value_type& value) _sstl_noexcept_
+   {
+      _backoff backoff;
+      while(!_try_push_value(value))
+      {
+         backoff();
+      }
+   }
+
+private:
+   struct _cell
+   {
+      value_type* _value() _sstl_noexcept_
+      {
+         return static_cast<value_type*>(static_cast<void*>(&_storage));
+      }
+
+      std::atomic<size_type> _sequence;
+      typename _aligned_storage<sizeof(value_type), std::alignment_of<value_type>::value>::type _storage;
+   };
+
+   static const size_type _mask = CAPACITY-1;
+
+   _cache_line_padding<> _padding0;
+   std::atomic<size_type> _enqueue_pos{ 0 };
+   _cache_line_padding<sizeof(std::atomic<size_type>)> _padding1;
+   std::atomic<size_type> _dequeue_pos{ 0 };
+   _cache_line_padding<sizeof(std::atomic<size_type>)> _padding2;
+   std::array<_cell, CAPACITY> _cells;
+};
+
+}
+
+#endif
@@ -84,6 +84,14 @@ namespace sstl
       imultimap<TKey, TValue, TCompare>::insert(first, last);
     }
 
+    //*************************************************************************
+    /// Destructor.
+    //*************************************************************************
+    ~multimap()
+    {
+      imultimap<TKey, TValue, TCompare>::clear();
+    }
+
     //*************************************************************************
     /// Assignment operator.
     //*************************************************************************
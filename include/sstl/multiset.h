@@ -46,9 +46,11 @@ namespace sstl
 {
   //*************************************************************************
   /// A templated multiset implementation that uses a fixed size buffer.
+  /// With TAugmentation = tree_order_statistics, rank, nth and count_range
+  /// take O(log n) (see imultiset).
   //*************************************************************************
-  template <typename T, const size_t MAX_SIZE_, typename TCompare = std::less<T>>
-  class multiset : public imultiset<T, TCompare>
+  template <typename T, const size_t MAX_SIZE_, typename TCompare = std::less<T>, typename TAugmentation = tree_no_augmentation>
+  class multiset : public imultiset<T, TCompare, TAugmentation>
   {
   public:
 
@@ -58,7 +60,7 @@ namespace sstl
     /// Default constructor.
     //*************************************************************************
     multiset()
-      : imultiset<T, TCompare>(node_pool, MAX_SIZE)
+      : imultiset<T, TCompare, TAugmentation>(node_pool, MAX_SIZE)
     {
     }
 
@@ -66,9 +68,9 @@ namespace sstl
     /// Copy constructor.
     //*************************************************************************
     explicit multiset(const multiset& other)
-      : imultiset<T, TCompare>(node_pool, MAX_SIZE)
+      : imultiset<T, TCompare, TAugmentation>(node_pool, MAX_SIZE)
     {
-			imultiset<T, TCompare>::assign(other.cbegin(), other.cend());
+			imultiset<T, TCompare, TAugmentation>::assign(other.cbegin(), other.cend());
     }
 
     //*************************************************************************
@@ -79,9 +81,17 @@ namespace sstl
     //*************************************************************************
     template <typename TIterator>
     multiset(TIterator first, TIterator last)
-      : imultiset<T, TCompare>(node_pool, MAX_SIZE)
+      : imultiset<T, TCompare, TAugmentation>(node_pool, MAX_SIZE)
     {
-      imultiset<T, TCompare>::insert(first, last);
+      imultiset<T, TCompare, TAugmentation>::insert(first, last);
+    }
+
+    //*************************************************************************
+    /// Destructor.
+    //*************************************************************************
+    ~multiset()
+    {
+      imultiset<T, TCompare, TAugmentation>::clear();
     }
 
     //*************************************************************************
@@ -92,7 +102,7 @@ namespace sstl
       // Skip if doing self assignment
       if (this != &rhs)
       {
-        imultiset<T, TCompare>::assign(rhs.cbegin(), rhs.cend());
+        imultiset<T, TCompare, TAugmentation>::assign(rhs.cbegin(), rhs.cend());
       }
 
       return *this;
@@ -101,7 +111,7 @@ namespace sstl
   private:
 
     /// The pool of data nodes used for the multiset.
-    bitmap_allocator<typename imultiset<T, TCompare>::Data_Node, MAX_SIZE> node_pool;
+    bitmap_allocator<typename imultiset<T, TCompare, TAugmentation>::Data_Node, MAX_SIZE> node_pool;
   };
 
 }
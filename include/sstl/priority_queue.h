@@ -8,19 +8,305 @@ as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
 #ifndef _SSTL_PRIORITY_QUEUE__
 #define _SSTL_PRIORITY_QUEUE__
 
-#include <queue>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+#include <iterator>
 #include <functional>
+
+#include <sstl_assert.h>
+
+#include "__internal/_except.h"
+#include "__internal/_iterator.h"
 #include "vector.h"
 
 namespace sstl
 {
-   // alias template to provide an sstl::priority_queue type that has consistent
-   // interface with the rest of the library's containers
-   template<class T,
-            size_t CAPACITY,
-            class Container=sstl::vector<T, CAPACITY>,
-            class Compare=std::less<typename  Container::value_type>>
-   using priority_queue = std::priority_queue<T, Container, Compare>;
+
+// container adaptor with the interface of std::priority_queue, implemented as
+// a d-ary heap (4-ary by default): a node's children are adjacent in memory, thus
+// the sift-down of pop() visits half as many levels as a binary heap and the
+// children of a node typically share a cache line.
+// Moreover it provides bulk insertion (Floyd's heap construction), replacement
+// of the top value without a separate pop + push and extraction of move-only values.
+template<class T,
+         size_t CAPACITY,
+         class Container=sstl::vector<T, CAPACITY>,
+         class Compare=std::less<typename Container::value_type>,
+         size_t ARITY=4>
+class priority_queue
+{
+   static_assert(ARITY >= 2, "arity must be at least two");
+
+public:
+   using container_type = Container;
+   using value_compare = Compare;
+   using value_type = typename Container::value_type;
+   using size_type = typename Container::size_type;
+   using reference = typename Container::reference;
+   using const_reference = typename Container::const_reference;
+
+public:
+   priority_queue() : priority_queue(Compare{})
+   {}
+
+   explicit priority_queue(const Compare& compare)
+      : c()
+      , comp(compare)
+   {}
+
+   priority_queue(const Compare& compare, const Container& container)
+      : c(container)
+      , comp(compare)
+   {
+      _make_heap();
+   }
+
+   priority_queue(const Compare& compare, Container&& container)
+      : c(std::move(container))
+      , comp(compare)
+   {
+      _make_heap();
+   }
+
+   template<class TIterator, class = typename std::enable_if<_is_input_iterator<TIterator>::value>::type>
+   priority_queue(TIterator range_begin, TIterator range_end, const Compare& compare=Compare{})
+      : c()
+      , comp(compare)
+   {
+      push_range(range_begin, range_end);
+   }
+
+   priority_queue(const priority_queue&) = default;
+   priority_queue& operator=(const priority_queue&) = default;
+
+   priority_queue(priority_queue&& rhs)
+      _sstl_noexcept(std::is_nothrow_move_constructible<Container>::value
+                     && std::is_nothrow_move_constructible<Compare>::value)
+      : c(std::move(rhs.c))
+      , comp(std::move(rhs.comp))
+   {}
+
+   priority_queue& operator=(priority_queue&& rhs)
+      _sstl_noexcept(std::is_nothrow_move_assignable<Container>::value
+                     && std::is_nothrow_move_assignable<Compare>::value)
+   {
+      c = std::move(rhs.c);
+      comp = std::move(rhs.comp);
+      return *this;
+   }
+
+   const_reference top() const _sstl_noexcept_
+   {
+      sstl_assert(!empty());
+      return c[0];
+   }
+
+   bool empty() const _sstl_noexcept_
+   {
+      return c.empty();
+   }
+
+   size_type size() const _sstl_noexcept_
+   {
+      return c.size();
+   }
+
+   void push(const value_type& value)
+   {
+      c.push_back(value);
+      _sift_up(c.size()-1);
+   }
+
+   void push(value_type&& value)
+   {
+      c.push_back(std::move(value));
+      _sift_up(c.size()-1);
+   }
+
+   template<class... Args>
+   void emplace(Args&&... args)
+   {
+      c.emplace_back(std::forward<Args>(args)...);
+      _sift_up(c.size()-1);
+   }
+
+   //inserts the values of the range. When the range is large compared to the
+   //current size the heap is rebuilt in O(n) (Floyd), instead of sifting up every value
+   template<class TIterator, class = typename std::enable_if<_is_input_iterator<TIterator>::value>::type>
+   void push_range(TIterator range_begin, TIterator range_end)
+   {
+      auto old_size = c.size();
+      while(range_begin != range_end)
+      {
+         c.push_back(*range_begin);
+         ++range_begin;
+      }
+      auto count = c.size() - old_size;
+      if(count >= old_size)
+      {
+         _make_heap();
+      }
+      else
+      {
+         for(auto idx = old_size; idx < c.size(); ++idx)
+         {
+            _sift_up(idx);
+         }
+      }
+   }
+
+   void pop()
+   {
+      sstl_assert(!empty());
+      if(c.size() > 1)
+      {
+         value_type value(std::move(c.back()));
+         c.pop_back();
+         _sift_hole_down_and_up(0, value);
+      }
+      else
+      {
+         c.pop_back();
+      }
+   }
+
+   //removes the top value and returns it (also works with move-only values)
+   value_type pop_top()
+   {
+      sstl_assert(!empty());
+      value_type value(std::move(c[0]));
+      pop();
+      return value;
+   }
+
+   //replaces the top value with a value constructed from the arguments,
+   //i.e. pop() + emplace() with a single sift-down
+   template<class... Args>
+   void replace_top(Args&&... args)
+   {
+      sstl_assert(!empty());
+      c[0] = value_type(std::forward<Args>(args)...);
+      _sift_down(0);
+   }
+
+   //removes and returns the top value and inserts the specified value,
+   //i.e. pop_top() + push() with a single sift-down
+   value_type pop_push(value_type value)
+   {
+      sstl_assert(!empty());
+      using std::swap;
+      swap(c[0], value);
+      _sift_down(0);
+      return value;
+   }
+
+   void swap(priority_queue& rhs)
+   {
+      using std::swap;
+      swap(c, rhs.c);
+      swap(comp, rhs.comp);
+   }
+
+protected:
+   Container c;
+   Compare comp;
+
+private:
+   void _make_heap()
+   {
+      if(c.size() < 2)
+         return;
+      for(auto idx = (c.size()-2) / ARITY + 1; idx > 0; --idx)
+      {
+         _sift_down(idx-1);
+      }
+   }
+
+   //moves the value at the specified index towards the root (the "hole" is moved
+   //down instead of swapping the values at every level)
+   void _sift_up(size_type idx)
+   {
+      if(idx == 0)
+         return;
+      auto first = c.begin();
+      value_type value(std::move(first[idx]));
+      _sift_hole_up(idx, value);
+   }
+
+   void _sift_hole_up(size_type hole, value_type& value)
+   {
+      auto first = c.begin();
+      while(hole > 0)
+      {
+         auto parent = (hole-1) / ARITY;
+         if(!comp(first[parent], value))
+            break;
+         first[hole] = std::move(first[parent]);
+         hole = parent;
+      }
+      first[hole] = std::move(value);
+   }
+
+   //returns the index of the highest priority child
+   size_type _best_child(size_type first_child, size_type size)
+   {
+      auto first = c.begin();
+      auto last_child = first_child + ARITY < size ? first_child + ARITY : size;
+      auto best_child = first_child;
+      for(auto child = first_child+1; child < last_child; ++child)
+      {
+         best_child = comp(first[best_child], first[child]) ? child : best_child;
+      }
+      return best_child;
+   }
+
+   void _sift_down(size_type idx)
+   {
+      auto size = c.size();
+      auto first_child = idx*ARITY + 1;
+      if(first_child >= size)
+         return;
+      auto first = c.begin();
+      value_type value(std::move(first[idx]));
+      while(first_child < size)
+      {
+         auto best_child = _best_child(first_child, size);
+         if(!comp(value, first[best_child]))
+            break;
+         first[idx] = std::move(first[best_child]);
+         idx = best_child;
+         first_child = idx*ARITY + 1;
+      }
+      first[idx] = std::move(value);
+   }
+
+   //moves the hole down to a leaf along the path of the highest priority children
+   //and then sifts the value up from there. Since the value that replaces the top
+   //typically comes from the bottom of the heap, this saves one comparison per level
+   void _sift_hole_down_and_up(size_type hole, value_type& value)
+   {
+      auto size = c.size();
+      auto first = c.begin();
+      auto first_child = hole*ARITY + 1;
+      while(first_child < size)
+      {
+         auto best_child = _best_child(first_child, size);
+         first[hole] = std::move(first[best_child]);
+         hole = best_child;
+         first_child = hole*ARITY + 1;
+      }
+      _sift_hole_up(hole, value);
+   }
+};
+
+template<class T, size_t CAPACITY, class Container, class Compare, size_t ARITY>
+void swap(priority_queue<T, CAPACITY, Container, Compare, ARITY>& lhs,
+          priority_queue<T, CAPACITY, Container, Compare, ARITY>& rhs)
+{
+   lhs.swap(rhs);
+}
+
 }
 
 #endif
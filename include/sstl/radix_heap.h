@@ -0,0 +1,302 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_RADIX_HEAP__
+#define _SSTL_RADIX_HEAP__
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+#include <limits>
+#include <array>
+
+#include <sstl_assert.h>
+
+#include "__internal/_except.h"
+#include "__internal/_aligned_storage.h"
+#include "__internal/_bit_width.h"
+
+namespace sstl
+{
+
+// monotone min-priority queue for unsigned integer keys (32 or 64 bits): the key of
+// a pushed value must not be smaller than the key of the last popped value, as it
+// happens with timestamps.
+// An entry is put into the bucket given by the most significant bit in which its key
+// differs from the last popped key. When the bucket of the keys equal to the last
+// popped key is empty, the smallest non-empty bucket is redistributed into lower
+// buckets: every entry moves down at most once per bit, thus the operations take
+// amortized O(log C) time (C = range of the keys) and the keys are only compared
+// while looking for the minimum of the redistributed bucket.
+// The entries live in a fixed pool of CAPACITY nodes and the buckets are linked lists
+// of nodes, thus the values never move.
+template<class Key, class Value, size_t CAPACITY>
+class radix_heap
+{
+   static_assert(std::is_unsigned<Key>::value && (sizeof(Key) == 4 || sizeof(Key) == 8),
+                 "key must be a 32 or 64 bit unsigned integral type");
+   static_assert(CAPACITY >= 1, "capacity must be at least one");
+
+public:
+   using key_type = Key;
+   using value_type = Value;
+   using size_type = size_t;
+   using reference = value_type&;
+   using const_reference = const value_type&;
+
+public:
+   radix_heap() _sstl_noexcept_
+   {
+      _initialize();
+   }
+
+   radix_heap(const radix_heap& rhs)
+   {
+      _initialize();
+      _push_all(rhs);
+   }
+
+   radix_heap(radix_heap&& rhs)
+   {
+      _initialize();
+      _push_all(std::move(rhs));
+      rhs.clear();
+   }
+
+   ~radix_heap()
+   {
+      clear();
+   }
+
+   radix_heap& operator=(const radix_heap& rhs)
+   {
+      if(this != &rhs)
+      {
+         clear();
+         _push_all(rhs);
+      }
+      return *this;
+   }
+
+   radix_heap& operator=(radix_heap&& rhs)
+   {
+      if(this != &rhs)
+      {
+         clear();
+         _push_all(std::move(rhs));
+         rhs.clear();
+      }
+      return *this;
+   }
+
+   //the top functions are not const because they may redistribute the smallest bucket
+   key_type top_key() _sstl_noexcept_
+   {
+      sstl_assert(!empty());
+      _pull();
+      return _keys[_buckets[0]];
+   }
+
+   reference top_value() _sstl_noexcept_
+   {
+      sstl_assert(!empty());
+      _pull();
+      return *_value(_buckets[0]);
+   }
+
+   bool empty() const _sstl_noexcept_
+   {
+      return _size == 0;
+   }
+
+   bool full() const _sstl_noexcept_
+   {
+      return _size == CAPACITY;
+   }
+
+   size_type size() const _sstl_noexcept_
+   {
+      return _size;
+   }
+
+   size_type capacity() const _sstl_noexcept_
+   {
+      return CAPACITY;
+   }
+
+   //the key of the last popped value, pushed keys must not be smaller
+   key_type last_key() const _sstl_noexcept_
+   {
+      return _last;
+   }
+
+   void push(key_type key, const_reference value)
+   {
+      emplace(key, value);
+   }
+
+   void push(key_type key, value_type&& value)
+   {
+      emplace(key, std::move(value));
+   }
+
+   template<class... Args>
+   void emplace(key_type key, Args&&... args)
+   {
+      sstl_assert(!full());
+      sstl_assert(key >= _last);
+      auto idx = _free;
+      new(_value(idx)) value_type(std::forward<Args>(args)...);
+      _free = _next[idx];
+      _keys[idx] = key;
+      _link(idx, _bucket_index(key));
+      ++_size;
+   }
+
+   void pop() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      sstl_assert(!empty());
+      _pull();
+      auto idx = _buckets[0];
+      _buckets[0] = _next[idx];
+      _last = _keys[idx];
+      _release(idx);
+   }
+
+   //removes the top value and returns it (also works with move-only values)
+   value_type pop_top()
+   {
+      value_type value(std::move(top_value()));
+      pop();
+      return value;
+   }
+
+   void clear() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      for(auto& bucket : _buckets)
+      {
+         while(bucket != _null)
+         {
+            auto idx = bucket;
+            bucket = _next[idx];
+            _release(idx);
+         }
+      }
+   }
+
+private:
+   static const size_type _null = CAPACITY;
+   static const size_type _number_of_buckets = std::numeric_limits<key_type>::digits + 1;
+
+   value_type* _value(size_type idx) _sstl_noexcept_
+   {
+      return static_cast<value_type*>(static_cast<void*>(&_values[idx]));
+   }
+
+   void _initialize() _sstl_noexcept_
+   {
+      for(auto& bucket : _buckets)
+      {
+         bucket = _null;
+      }
+      for(size_type i=0; i<CAPACITY; ++i)
+      {
+         _next[i] = i+1;
+      }
+      _free = 0;
+   }
+
+   size_type _bucket_index(key_type key) const _sstl_noexcept_
+   {
+      return _bit_width_of(static_cast<key_type>(key ^ _last));
+   }
+
+   void _link(size_type idx, size_type bucket) _sstl_noexcept_
+   {
+      _next[idx] = _buckets[bucket];
+      _buckets[bucket] = idx;
+   }
+
+   void _release(size_type idx) _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _value(idx)->~value_type();
+      _next[idx] = _free;
+      _free = idx;
+      --_size;
+   }
+
+   //makes sure that bucket zero contains the entries with the smallest key
+   void _pull() _sstl_noexcept_
+   {
+      if(_buckets[0] != _null)
+         return;
+      auto bucket = size_type{ 1 };
+      while(_buckets[bucket] == _null)
+      {
+         ++bucket;
+      }
+      auto minimum = _keys[_buckets[bucket]];
+      for(auto idx = _next[_buckets[bucket]]; idx != _null; idx = _next[idx])
+      {
+         minimum = _keys[idx] < minimum ? _keys[idx] : minimum;
+      }
+      _last = minimum;
+      auto idx = _buckets[bucket];
+      _buckets[bucket] = _null;
+      while(idx != _null)
+      {
+         auto next = _next[idx];
+         _link(idx, _bucket_index(_keys[idx]));
+         idx = next;
+      }
+   }
+
+   //copies (or moves) the entries of rhs, this must be empty
+   template<class TRadixHeap>
+   void _push_all(TRadixHeap&& rhs)
+   {
+      using rhs_value_reference = typename std::conditional<std::is_lvalue_reference<TRadixHeap>::value,
+                                                            const value_type&,
+                                                            value_type&&>::type;
+      _last = rhs._last;
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         for(auto bucket : rhs._buckets)
+         {
+            for(auto idx = bucket; idx != _null; idx = rhs._next[idx])
+            {
+               auto& value = *const_cast<radix_heap&>(rhs)._value(idx);
+               emplace(rhs._keys[idx], static_cast<rhs_value_reference>(value));
+            }
+         }
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         clear();
+         throw;
+      }
+      #endif
+   }
+
+private:
+   std::array<size_type, _number_of_buckets> _buckets;
+   //the keys and the links are kept apart from the values for a denser redistribution
+   std::array<key_type, CAPACITY> _keys;
+   std::array<size_type, CAPACITY> _next;
+   std::array<typename _aligned_storage<sizeof(value_type), std::alignment_of<value_type>::value>::type, CAPACITY> _values;
+   size_type _free;
+   size_type _size{ 0 };
+   key_type _last{ 0 };
+};
+
+}
+
+#endif
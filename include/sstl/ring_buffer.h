@@ -0,0 +1,178 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_RING_BUFFER__
+#define _SSTL_RING_BUFFER__
+
+#include <utility>
+#include <type_traits>
+#include <initializer_list>
+
+#include <sstl_assert.h>
+
+#include "deque.h"
+
+namespace sstl
+{
+
+// deque with an overwriting overflow policy: pushing back into a full instance
+// replaces the oldest element in O(1) instead of triggering an assertion.
+// An instance can still be passed around as a capacity-agnostic sstl::deque<T>&
+// (note that through such reference push_back has the usual deque semantics)
+template<class T, size_t CAPACITY>
+class ring_buffer : public deque<T, CAPACITY>
+{
+private:
+   using _base = deque<T, CAPACITY>;
+
+public:
+   using value_type = typename _base::value_type;
+   using size_type = typename _base::size_type;
+   using difference_type = typename _base::difference_type;
+   using reference = typename _base::reference;
+   using const_reference = typename _base::const_reference;
+   using pointer = typename _base::pointer;
+   using const_pointer = typename _base::const_pointer;
+   using iterator = typename _base::iterator;
+   using const_iterator = typename _base::const_iterator;
+   using reverse_iterator = typename _base::reverse_iterator;
+   using const_reverse_iterator = typename _base::const_reverse_iterator;
+   using array_range = typename _base::array_range;
+   using const_array_range = typename _base::const_array_range;
+
+public:
+   ring_buffer() _sstl_noexcept_ = default;
+
+   explicit ring_buffer(size_type count, const_reference value = value_type())
+      _sstl_noexcept(noexcept(_base(std::declval<size_type>(), std::declval<const_reference>())))
+      : _base(count, value)
+   {}
+
+   template<class TIterator, class = typename std::enable_if<_is_input_iterator<TIterator>::value>::type>
+   ring_buffer(TIterator range_begin, TIterator range_end)
+      _sstl_noexcept(noexcept(_base(std::declval<TIterator>(), std::declval<TIterator>())))
+      : _base(range_begin, range_end)
+   {}
+
+   //copy construction from any instance with same value type (capacity doesn't matter)
+   ring_buffer(const deque<T>& rhs)
+      _sstl_noexcept(noexcept(_base(std::declval<const deque<T>&>())))
+      : _base(rhs)
+   {}
+
+   ring_buffer(const ring_buffer& rhs)
+      _sstl_noexcept(noexcept(_base(std::declval<const deque<T>&>())))
+      : _base(static_cast<const deque<T>&>(rhs))
+   {}
+
+   //move construction from any instance with same value type (capacity doesn't matter)
+   ring_buffer(deque<T>&& rhs)
+      _sstl_noexcept(noexcept(_base(std::declval<deque<T>&&>())))
+      : _base(std::move(rhs))
+   {}
+
+   ring_buffer(ring_buffer&& rhs)
+      _sstl_noexcept(noexcept(_base(std::declval<deque<T>&&>())))
+      : _base(static_cast<deque<T>&&>(rhs))
+   {}
+
+   ring_buffer(std::initializer_list<value_type> init)
+      _sstl_noexcept(noexcept(_base(std::declval<std::initializer_list<value_type>>())))
+      : _base(init)
+   {}
+
+   //copy assignment from any instance with same value type (capacity doesn't matter)
+   ring_buffer& operator=(const deque<T>& rhs)
+      _sstl_noexcept(noexcept(std::declval<_base&>().operator=(std::declval<const deque<T>&>())))
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   ring_buffer& operator=(const ring_buffer& rhs)
+      _sstl_noexcept(noexcept(std::declval<_base&>().operator=(std::declval<const deque<T>&>())))
+   {
+      _base::operator=(static_cast<const deque<T>&>(rhs));
+      return *this;
+   }
+
+   //move assignment from any instance with same value type (capacity doesn't matter)
+   ring_buffer& operator=(deque<T>&& rhs)
+      _sstl_noexcept(noexcept(std::declval<_base&>().operator=(std::declval<deque<T>&&>())))
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   ring_buffer& operator=(ring_buffer&& rhs)
+      _sstl_noexcept(noexcept(std::declval<_base&>().operator=(std::declval<deque<T>&&>())))
+   {
+      _base::operator=(static_cast<deque<T>&&>(rhs));
+      return *this;
+   }
+
+   ring_buffer& operator=(std::initializer_list<value_type> ilist)
+      _sstl_noexcept(noexcept(std::declval<_base&>().operator=(std::declval<std::initializer_list<value_type>>())))
+   {
+      _base::operator=(ilist);
+      return *this;
+   }
+
+   void push_back(const_reference value)
+      _sstl_noexcept(noexcept(std::declval<ring_buffer&>()._push_back_overwriting(std::declval<const_reference>())))
+   {
+      _base::_push_back_overwriting(value);
+   }
+
+   void push_back(value_type&& value)
+      _sstl_noexcept(noexcept(std::declval<ring_buffer&>()._push_back_overwriting(std::declval<value_type&&>())))
+   {
+      _base::_push_back_overwriting(std::move(value));
+   }
+
+   template<class... Args>
+   void emplace_back(Args&&... args)
+      _sstl_noexcept(noexcept(std::declval<ring_buffer&>()._emplace_back_overwriting(std::declval<Args>()...)))
+   {
+      _base::_emplace_back_overwriting(std::forward<Args>(args)...);
+   }
+
+   //returns the n-th most recently pushed element (n=0 is the back element)
+   reference recent(size_type n) _sstl_noexcept_
+   {
+      sstl_assert(n < _base::size());
+      return (*this)[_base::size()-1-n];
+   }
+
+   const_reference recent(size_type n) const _sstl_noexcept_
+   {
+      return const_cast<ring_buffer&>(*this).recent(n);
+   }
+
+   //returns an iterator to the first of the 'count' most recent elements,
+   //i.e. [recent_begin(count), end()) is the range of the 'count' most recent elements
+   iterator recent_begin(size_type count) _sstl_noexcept_
+   {
+      sstl_assert(count <= _base::size());
+      return _base::end() - static_cast<difference_type>(count);
+   }
+
+   const_iterator recent_begin(size_type count) const _sstl_noexcept_
+   {
+      return crecent_begin(count);
+   }
+
+   const_iterator crecent_begin(size_type count) const _sstl_noexcept_
+   {
+      sstl_assert(count <= _base::size());
+      return _base::cend() - static_cast<difference_type>(count);
+   }
+};
+
+}
+
+#endif
@@ -47,9 +47,11 @@ namespace sstl
 {
   //*************************************************************************
   /// A templated set implementation that uses a fixed size buffer.
+  /// With TAugmentation = tree_order_statistics, rank, nth and count_range
+  /// take O(log n) (see iset).
   //*************************************************************************
-  template <typename T, const size_t MAX_SIZE_, typename TCompare = std::less<T>>
-  class set : public iset<T, TCompare>
+  template <typename T, const size_t MAX_SIZE_, typename TCompare = std::less<T>, typename TAugmentation = tree_no_augmentation>
+  class set : public iset<T, TCompare, TAugmentation>
   {
   public:
 
@@ -59,7 +61,7 @@ namespace sstl
     /// Default constructor.
     //*************************************************************************
     set()
-      : iset<T, TCompare>(node_pool, MAX_SIZE)
+      : iset<T, TCompare, TAugmentation>(node_pool, MAX_SIZE)
     {
     }
 
@@ -67,9 +69,9 @@ namespace sstl
     /// Copy constructor.
     //*************************************************************************
     explicit set(const set& other)
-      : iset<T, TCompare>(node_pool, MAX_SIZE)
+      : iset<T, TCompare, TAugmentation>(node_pool, MAX_SIZE)
     {
-			iset<T, TCompare>::assign(other.cbegin(), other.cend());
+			iset<T, TCompare, TAugmentation>::assign(other.cbegin(), other.cend());
     }
 
     //*************************************************************************
@@ -80,9 +82,17 @@ namespace sstl
     //*************************************************************************
     template <typename TIterator>
     set(TIterator first, TIterator last)
-      : iset<T, TCompare>(node_pool, MAX_SIZE)
+      : iset<T, TCompare, TAugmentation>(node_pool, MAX_SIZE)
     {
-      iset<T, TCompare>::insert(first, last);
+      iset<T, TCompare, TAugmentation>::insert(first, last);
+    }
+
+    //*************************************************************************
+    /// Destructor.
+    //*************************************************************************
+    ~set()
+    {
+      iset<T, TCompare, TAugmentation>::clear();
     }
 
     //*************************************************************************
@@ -93,7 +103,7 @@ namespace sstl
       // Skip if doing self assignment
       if (this != &rhs)
       {
-        iset<T, TCompare>::assign(rhs.cbegin(), rhs.cend());
+        iset<T, TCompare, TAugmentation>::assign(rhs.cbegin(), rhs.cend());
       }
 
       return *this;
@@ -102,7 +112,7 @@ namespace sstl
   private:
 
     /// The pool of data nodes used for the set.
-    bitmap_allocator<typename iset<T, TCompare>::Data_Node, MAX_SIZE> node_pool;
+    bitmap_allocator<typename iset<T, TCompare, TAugmentation>::Data_Node, MAX_SIZE> node_pool;
   };
 
 }
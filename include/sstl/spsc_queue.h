@@ -0,0 +1,244 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_SPSC_QUEUE__
+#define _SSTL_SPSC_QUEUE__
+
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <atomic>
+#include <array>
+
+#include <sstl_assert.h>
+
+#include "__internal/_except.h"
+#include "__internal/_aligned_storage.h"
+#include "__internal/_cache_line.h"
+
+namespace sstl
+{
+
+// lock-free bounded queue for exactly one producer thread and one consumer thread.
+// The producer only writes the tail index and the consumer only writes the head index,
+// the two indices live on separate cache lines and each side keeps a cached copy of
+// the other side's index, so that the shared index is loaded only when the cached
+// copy says that the queue is full (producer) or empty (consumer).
+// Member functions are annotated with the side that is allowed to call them.
+template<class T, size_t CAPACITY>
+class spsc_queue
+{
+   static_assert(CAPACITY > 0, "capacity must be greater than zero");
+
+public:
+   using value_type = T;
+   using size_type = size_t;
+   using reference = value_type&;
+   using const_reference = const value_type&;
+   using pointer = value_type*;
+   using const_pointer = const value_type*;
+
+public:
+   spsc_queue() _sstl_noexcept_ = default;
+   spsc_queue(const spsc_queue&) = delete;
+   spsc_queue& operator=(const spsc_queue&) = delete;
+
+   ~spsc_queue()
+   {
+      while(front() != nullptr)
+         pop();
+   }
+
+   //producer
+   bool try_push(const_reference value)
+      _sstl_noexcept(std::is_nothrow_copy_constructible<value_type>::value)
+   {
+      return try_emplace(value);
+   }
+
+   //producer
+   bool try_push(value_type&& value)
+      _sstl_noexcept(std::is_nothrow_move_constructible<value_type>::value)
+   {
+      return try_emplace(std::move(value));
+   }
+
+   //producer
+   template<class... Args>
+   bool try_emplace(Args&&... args)
+      _sstl_noexcept(std::is_nothrow_constructible<value_type, typename std::add_rvalue_reference<Args>::type...>::value)
+   {
+      auto tail = _tail.load(std::memory_order_relaxed);
+      if(tail - _cached_head == CAPACITY)
+      {
+         _cached_head = _head.load(std::memory_order_acquire);
+         if(tail - _cached_head == CAPACITY)
+            return false;
+      }
+      new(_slot(tail)) value_type(std::forward<Args>(args)...);
+      _tail.store(tail+1, std::memory_order_release);
+      return true;
+   }
+
+   //producer
+   //pushes as many values of the range as possible (publishing them all at once)
+   //and returns an iterator to the first value that was not pushed
+   template<class TIterator>
+   TIterator try_push(TIterator range_begin, TIterator range_end)
+      _sstl_noexcept(std::is_nothrow_copy_constructible<value_type>::value)
+   {
+      auto tail = _tail.load(std::memory_order_relaxed);
+      auto new_tail = tail;
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         while(range_begin != range_end)
+         {
+            if(new_tail - _cached_head == CAPACITY)
+            {
+               _cached_head = _head.load(std::memory_order_acquire);
+               if(new_tail - _cached_head == CAPACITY)
+                  break;
+            }
+            new(_slot(new_tail)) value_type(*range_begin);
+            ++range_begin;
+            ++new_tail;
+         }
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         _tail.store(new_tail, std::memory_order_release);
+         throw;
+      }
+      #endif
+      _tail.store(new_tail, std::memory_order_release);
+      return range_begin;
+   }
+
+   //consumer
+   //returns a pointer to the front value or nullptr if the queue is empty.
+   //The value stays valid (and can be modified in place) until it gets popped
+   pointer front() _sstl_noexcept_
+   {
+      auto head = _head.load(std::memory_order_relaxed);
+      if(head == _cached_tail)
+      {
+         _cached_tail = _tail.load(std::memory_order_acquire);
+         if(head == _cached_tail)
+            return nullptr;
+      }
+      return _slot(head);
+   }
+
+   //consumer
+   //pops the front value, the queue must not be empty (see front())
+   void pop() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      auto head = _head.load(std::memory_order_relaxed);
+      sstl_assert(head != _cached_tail);
+      _slot(head)->~value_type();
+      _head.store(head+1, std::memory_order_release);
+   }
+
+   //consumer
+   bool try_pop(reference value)
+      _sstl_noexcept(std::is_nothrow_move_assignable<value_type>::value)
+   {
+      auto front_value = front();
+      if(front_value == nullptr)
+         return false;
+      value = std::move(*front_value);
+      pop();
+      return true;
+   }
+
+   //consumer
+   //pops up to 'max_count' values into the specified output range (releasing the
+   //slots all at once) and returns the number of popped values
+   template<class TOutputIterator>
+   size_type try_pop(TOutputIterator range_begin, size_type max_count)
+      _sstl_noexcept(std::is_nothrow_move_assignable<value_type>::value)
+   {
+      auto head = _head.load(std::memory_order_relaxed);
+      if(_cached_tail - head < max_count)
+      {
+         _cached_tail = _tail.load(std::memory_order_acquire);
+      }
+      auto count = std::min(max_count, _cached_tail - head);
+      auto new_head = head;
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         while(new_head - head < count)
+         {
+            auto slot = _slot(new_head);
+            *range_begin = std::move(*slot);
+            slot->~value_type();
+            ++range_begin;
+            ++new_head;
+         }
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         _head.store(new_head, std::memory_order_release);
+         throw;
+      }
+      #endif
+      _head.store(new_head, std::memory_order_release);
+      return count;
+   }
+
+   //any side (the result might be outdated when it gets returned)
+   size_type size() const _sstl_noexcept_
+   {
+      auto head = _head.load(std::memory_order_acquire);
+      auto tail = _tail.load(std::memory_order_acquire);
+      return std::min(tail - head, CAPACITY);
+   }
+
+   //any side (the result might be outdated when it gets returned)
+   bool empty() const _sstl_noexcept_
+   {
+      return size() == 0;
+   }
+
+   size_type capacity() const _sstl_noexcept_
+   {
+      return CAPACITY;
+   }
+
+private:
+   //the indices are free-running, the slot is obtained by wrapping
+   //(a bitwise 'and' if the capacity is a power of two)
+   pointer _slot(size_type idx) _sstl_noexcept_
+   {
+      return static_cast<pointer>(static_cast<void*>(_buffer.data() + idx % CAPACITY));
+   }
+
+private:
+   using _index_type = std::atomic<size_type>;
+
+   _cache_line_padding<> _padding0;
+   //producer's cache line
+   _index_type _tail{ 0 };
+   size_type _cached_head{ 0 };
+   _cache_line_padding<sizeof(_index_type) + sizeof(size_type)> _padding1;
+   //consumer's cache line
+   _index_type _head{ 0 };
+   size_type _cached_tail{ 0 };
+   _cache_line_padding<sizeof(_index_type) + sizeof(size_type)> _padding2;
+   std::array<typename _aligned_storage<sizeof(value_type), std::alignment_of<value_type>::value>::type, CAPACITY> _buffer;
+};
+
+}
+
+#endif
@@ -0,0 +1,351 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_TIMER_WHEEL__
+#define _SSTL_TIMER_WHEEL__
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+#include <array>
+
+#include <sstl_assert.h>
+
+#include "__internal/_except.h"
+#include "__internal/_aligned_storage.h"
+#include "function.h"
+
+namespace sstl
+{
+
+// hierarchical timing wheel (as in Varghese & Lauck, "Hashed and Hierarchical Timing Wheels").
+// Time is measured in abstract ticks. Four wheels of 64 slots each cover 2^24 ticks:
+// a timer is put into the slot of the lowest wheel whose range covers its expiry,
+// and when a wheel completes a revolution the timers of the next slot of the upper
+// wheel are cascaded down. Timers that expire farther away than the range are put
+// into the last slot of the highest wheel and re-inserted on cascade.
+// Scheduling and cancelling are O(1), no comparisons between timers are performed.
+// The timers (and their sstl::function callbacks) live in a fixed pool of N_TIMERS
+// nodes, the free nodes are linked in a freelist.
+template<size_t N_TIMERS, size_t CALLABLE_SIZE=4*sizeof(void*)>
+class timer_wheel
+{
+   static_assert(N_TIMERS >= 1, "at least one timer is required");
+
+public:
+   using size_type = size_t;
+   using time_point = uint64_t;
+   using duration = uint64_t;
+   using callback_type = sstl::function<void(), CALLABLE_SIZE>;
+
+   // identifies a scheduled timer, it becomes invalid once the timer fires or is cancelled
+   class handle
+   {
+      friend class timer_wheel;
+
+   public:
+      handle() = default;
+
+      bool operator==(const handle& rhs) const _sstl_noexcept_
+      {
+         return _index == rhs._index && _generation == rhs._generation;
+      }
+
+      bool operator!=(const handle& rhs) const _sstl_noexcept_
+      {
+         return !(*this == rhs);
+      }
+
+   private:
+      handle(size_type index, size_type generation) _sstl_noexcept_
+         : _index(index)
+         , _generation(generation)
+      {}
+
+      size_type _index{ N_TIMERS };
+      size_type _generation{ 0 };
+   };
+
+public:
+   explicit timer_wheel(time_point now = 0) _sstl_noexcept_
+      : _next_tick(now+1)
+   {
+      for(auto& wheel : _wheels)
+      {
+         for(auto& slot : wheel)
+         {
+            slot._prev = &slot;
+            slot._next = &slot;
+         }
+      }
+      for(size_type i=0; i<N_TIMERS-1; ++i)
+      {
+         _timers[i]._next = &_timers[i+1];
+      }
+      _timers[N_TIMERS-1]._next = nullptr;
+      _free = &_timers[0];
+   }
+
+   //the slots' sentinel nodes are referenced by the timers
+   timer_wheel(const timer_wheel&) = delete;
+   timer_wheel& operator=(const timer_wheel&) = delete;
+
+   ~timer_wheel()
+   {
+      for(auto& wheel : _wheels)
+      {
+         for(auto& slot : wheel)
+         {
+            while(slot._next != &slot)
+            {
+               auto timer = static_cast<_timer*>(slot._next);
+               _unlink(timer);
+               timer->_callback()->~callback_type();
+            }
+         }
+      }
+   }
+
+   //the callback is invoked by the first tick() whose time is greater than or equal to
+   //the expiry (if the expiry is not in the future the callback is invoked by the next tick)
+   template<class TCallback>
+   handle schedule_at(time_point expiry, TCallback&& callback)
+   {
+      sstl_assert(!full());
+      auto timer = _free;
+      new(timer->_callback()) callback_type(std::forward<TCallback>(callback));
+      _free = static_cast<_timer*>(timer->_next);
+      timer->_expiry = expiry;
+      _insert(timer);
+      ++_size;
+      return handle(static_cast<size_type>(timer - &_timers[0]), timer->_generation);
+   }
+
+   template<class TCallback>
+   handle schedule_after(duration delay, TCallback&& callback)
+   {
+      return schedule_at(now() + delay, std::forward<TCallback>(callback));
+   }
+
+   //returns false if the timer already fired or was cancelled
+   bool cancel(handle h) _sstl_noexcept_
+   {
+      if(!is_scheduled(h))
+         return false;
+      auto timer = &_timers[h._index];
+      _unlink(timer);
+      _release(timer);
+      return true;
+   }
+
+   bool is_scheduled(handle h) const _sstl_noexcept_
+   {
+      return h._index < N_TIMERS
+         && _timers[h._index]._generation == h._generation
+         && _timers[h._index]._is_linked;
+   }
+
+   //advances the time to the specified time point, invokes the callbacks of the
+   //expired timers (in expiry order, up to the granularity of one tick) and
+   //returns the number of invoked callbacks. Callbacks may schedule and cancel timers.
+   size_type tick(time_point now)
+   {
+      size_type fired = 0;
+      while(_next_tick <= now)
+      {
+         if(_size == 0)
+         {
+            _next_tick = now+1;
+            break;
+         }
+         auto idx = _slot_index(_next_tick, 0);
+         if(idx == 0)
+         {
+            for(size_type level=1; level<_levels && _cascade(level) == 0; ++level)
+               ;
+         }
+         //timers scheduled by the callbacks for the current time are fired on the next tick
+         _link expired;
+         _splice(_wheels[0][idx], expired);
+         ++_next_tick;
+         while(expired._next != &expired)
+         {
+            auto timer = static_cast<_timer*>(expired._next);
+            _unlink(timer);
+            _fire(timer, expired);
+            ++fired;
+         }
+      }
+      return fired;
+   }
+
+   time_point now() const _sstl_noexcept_
+   {
+      return _next_tick-1;
+   }
+
+   size_type size() const _sstl_noexcept_
+   {
+      return _size;
+   }
+
+   bool empty() const _sstl_noexcept_
+   {
+      return _size == 0;
+   }
+
+   bool full() const _sstl_noexcept_
+   {
+      return _size == N_TIMERS;
+   }
+
+   size_type capacity() const _sstl_noexcept_
+   {
+      return N_TIMERS;
+   }
+
+private:
+   struct _link
+   {
+      _link* _prev{ nullptr };
+      _link* _next{ nullptr };
+      bool _is_linked{ false };
+   };
+
+   struct _timer : _link
+   {
+      callback_type* _callback() _sstl_noexcept_
+      {
+         return static_cast<callback_type*>(static_cast<void*>(&_callback_storage));
+      }
+
+      time_point _expiry{ 0 };
+      size_type _generation{ 0 };
+      typename _aligned_storage<sizeof(callback_type), std::alignment_of<callback_type>::value>::type _callback_storage;
+   };
+
+   static const size_type _slot_bits = 6;
+   static const size_type _slots_per_wheel = size_type{ 1 } << _slot_bits;
+   static const size_type _levels = 4;
+
+   static size_type _slot_index(time_point time, size_type level) _sstl_noexcept_
+   {
+      return static_cast<size_type>(time >> (level*_slot_bits)) & (_slots_per_wheel-1);
+   }
+
+   void _insert(_timer* timer) _sstl_noexcept_
+   {
+      auto expiry = timer->_expiry < _next_tick ? _next_tick : timer->_expiry;
+      auto delta = expiry - _next_tick;
+      auto level = size_type{ 0 };
+      while(level < _levels-1 && delta >= (time_point{ 1 } << ((level+1)*_slot_bits)))
+      {
+         ++level;
+      }
+      if(delta >= (time_point{ 1 } << (_levels*_slot_bits)))
+      {
+         //out of range: re-inserted when the slot is cascaded
+         expiry = _next_tick + (time_point{ 1 } << (_levels*_slot_bits)) - 1;
+      }
+      auto& slot = _wheels[level][_slot_index(expiry, level)];
+      timer->_prev = slot._prev;
+      timer->_next = &slot;
+      slot._prev->_next = timer;
+      slot._prev = timer;
+      timer->_is_linked = true;
+   }
+
+   static void _unlink(_link* node) _sstl_noexcept_
+   {
+      node->_prev->_next = node->_next;
+      node->_next->_prev = node->_prev;
+      node->_is_linked = false;
+   }
+
+   //moves all the nodes of the source list into the (empty) destination list
+   static void _splice(_link& source, _link& destination) _sstl_noexcept_
+   {
+      if(source._next == &source)
+      {
+         destination._prev = &destination;
+         destination._next = &destination;
+      }
+      else
+      {
+         destination._next = source._next;
+         destination._prev = source._prev;
+         destination._next->_prev = &destination;
+         destination._prev->_next = &destination;
+         source._prev = &source;
+         source._next = &source;
+      }
+   }
+
+   //re-inserts the timers of the current slot of the specified wheel into the lower wheels,
+   //returns the index of the slot
+   size_type _cascade(size_type level) _sstl_noexcept_
+   {
+      auto idx = _slot_index(_next_tick, level);
+      _link timers;
+      _splice(_wheels[level][idx], timers);
+      while(timers._next != &timers)
+      {
+         auto timer = static_cast<_timer*>(timers._next);
+         _unlink(timer);
+         _insert(timer);
+      }
+      return idx;
+   }
+
+   //if the callback throws, the remaining expired timers are fired on the next tick
+   void _fire(_timer* timer, _link& expired)
+   {
+      #if _sstl_has_exceptions()
+      try
+      {
+      #endif
+         (*timer->_callback())();
+      #if _sstl_has_exceptions()
+      }
+      catch(...)
+      {
+         _release(timer);
+         while(expired._next != &expired)
+         {
+            auto remaining = static_cast<_timer*>(expired._next);
+            _unlink(remaining);
+            _insert(remaining);
+         }
+         throw;
+      }
+      #else
+      (void) expired;
+      #endif
+      _release(timer);
+   }
+
+   void _release(_timer* timer) _sstl_noexcept_
+   {
+      ++timer->_generation;
+      timer->_callback()->~callback_type();
+      timer->_next = _free;
+      _free = timer;
+      --_size;
+   }
+
+private:
+   std::array<std::array<_link, _slots_per_wheel>, _levels> _wheels;
+   std::array<_timer, N_TIMERS> _timers;
+   _timer* _free{ nullptr };
+   time_point _next_tick;
+   size_type _size{ 0 };
+};
+
+}
+
+#endif
@@ -0,0 +1,337 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_UNORDERED_MAP__
+#define _SSTL_UNORDERED_MAP__
+
+#include <cstddef>
+#include <utility>
+#include <tuple>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+#include <stdexcept>
+
+#include <sstl_assert.h>
+
+#include "__internal/_except.h"
+#include "__internal/_iterator.h"
+#include "__internal/_debug.h"
+#include "__internal/_swiss_table.h"
+#include "hash.h"
+
+namespace sstl
+{
+
+// unordered_map<Key, T, CAPACITY> holds up to CAPACITY values in an open addressing
+// hash table (see _swiss_table.h). unordered_map<Key, T> is the capacity-agnostic base,
+// e.g. a function taking a sstl::unordered_map<int, int>& accepts maps of any capacity.
+// Heterogeneous lookup (find, count, contains, equal_range) is enabled if both Hash and
+// KeyEqual define the member type is_transparent. The results of a Hash that is not
+// avalanching (see hash.h) are mixed again by the table.
+template<class Key,
+         class T,
+         size_t CAPACITY=static_cast<size_t>(-1),
+         class Hash=hash<Key>,
+         class KeyEqual=std::equal_to<Key>>
+class unordered_map;
+
+template<class Key, class T, class Hash, class KeyEqual>
+class unordered_map<Key, T, static_cast<size_t>(-1), Hash, KeyEqual>
+   : public _swiss_table<Key, std::pair<const Key, T>, std::pair<const Key, T>, _key_of_pair, Hash, KeyEqual>
+{
+private:
+   using _base = _swiss_table<Key, std::pair<const Key, T>, std::pair<const Key, T>, _key_of_pair, Hash, KeyEqual>;
+
+public:
+   using key_type = typename _base::key_type;
+   using mapped_type = T;
+   using value_type = typename _base::value_type;
+   using size_type = typename _base::size_type;
+   using difference_type = typename _base::difference_type;
+   using hasher = typename _base::hasher;
+   using key_equal = typename _base::key_equal;
+   using reference = typename _base::reference;
+   using const_reference = typename _base::const_reference;
+   using pointer = typename _base::pointer;
+   using const_pointer = typename _base::const_pointer;
+   using iterator = typename _base::iterator;
+   using const_iterator = typename _base::const_iterator;
+
+public:
+   unordered_map& operator=(const unordered_map& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   unordered_map& operator=(unordered_map&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   unordered_map& operator=(std::initializer_list<value_type> init)
+   {
+      _base::clear();
+      _base::insert(init);
+      return *this;
+   }
+
+   mapped_type& at(const key_type& key) _sstl_noexcept(!_sstl_has_exceptions())
+   {
+      auto it = _base::find(key);
+      #if _sstl_has_exceptions()
+      if(it == _base::end())
+      {
+         throw std::out_of_range(_sstl_debug_message("unordered_map key not found"));
+      }
+      #endif
+      sstl_assert(it != _base::end());
+      return it->second;
+   }
+
+   const mapped_type& at(const key_type& key) const
+      _sstl_noexcept(noexcept(std::declval<unordered_map>().at(std::declval<const key_type&>())))
+   {
+      return const_cast<unordered_map&>(*this).at(key);
+   }
+
+   mapped_type& operator[](const key_type& key)
+   {
+      return try_emplace(key).first->second;
+   }
+
+   mapped_type& operator[](key_type&& key)
+   {
+      return try_emplace(std::move(key)).first->second;
+   }
+
+   //constructs the value only if the key is not present (the arguments are not moved from otherwise)
+   template<class... Args>
+   std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+   {
+      return _try_emplace(key, std::forward<Args>(args)...);
+   }
+
+   template<class... Args>
+   std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args)
+   {
+      return _try_emplace(std::move(key), std::forward<Args>(args)...);
+   }
+
+   template<class... Args>
+   iterator try_emplace(const_iterator, const key_type& key, Args&&... args)
+   {
+      return _try_emplace(key, std::forward<Args>(args)...).first;
+   }
+
+   template<class... Args>
+   iterator try_emplace(const_iterator, key_type&& key, Args&&... args)
+   {
+      return _try_emplace(std::move(key), std::forward<Args>(args)...).first;
+   }
+
+   template<class M>
+   std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& mapped)
+   {
+      return _insert_or_assign(key, std::forward<M>(mapped));
+   }
+
+   template<class M>
+   std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& mapped)
+   {
+      return _insert_or_assign(std::move(key), std::forward<M>(mapped));
+   }
+
+   template<class M>
+   iterator insert_or_assign(const_iterator, const key_type& key, M&& mapped)
+   {
+      return _insert_or_assign(key, std::forward<M>(mapped)).first;
+   }
+
+   template<class M>
+   iterator insert_or_assign(const_iterator, key_type&& key, M&& mapped)
+   {
+      return _insert_or_assign(std::move(key), std::forward<M>(mapped)).first;
+   }
+
+protected:
+   unordered_map(_ctrl_t* ctrl, void* slots, size_type capacity, size_type max_size,
+                 const hasher& hash, const key_equal& equal)
+      : _base(ctrl, slots, capacity, max_size, hash, equal)
+   {}
+
+   unordered_map(const unordered_map&) = delete;
+   unordered_map(unordered_map&&) = delete;
+
+   ~unordered_map() = default;
+
+private:
+   template<class K, class... Args>
+   std::pair<iterator, bool> _try_emplace(K&& key, Args&&... args)
+   {
+      auto hash = _base::_hash_of(key);
+      auto result = _base::_find_or_prepare_insert(key, hash);
+      if(!result.second)
+      {
+         new(&_base::_value_at(result.first)) value_type(std::piecewise_construct,
+                                                         std::forward_as_tuple(std::forward<K>(key)),
+                                                         std::forward_as_tuple(std::forward<Args>(args)...));
+         _base::_commit_insert(result.first, hash);
+      }
+      return std::make_pair(_base::_iterator_at(result.first), !result.second);
+   }
+
+   template<class K, class M>
+   std::pair<iterator, bool> _insert_or_assign(K&& key, M&& mapped)
+   {
+      auto hash = _base::_hash_of(key);
+      auto result = _base::_find_or_prepare_insert(key, hash);
+      if(result.second)
+      {
+         _base::_value_at(result.first).second = std::forward<M>(mapped);
+      }
+      else
+      {
+         new(&_base::_value_at(result.first)) value_type(std::forward<K>(key), std::forward<M>(mapped));
+         _base::_commit_insert(result.first, hash);
+      }
+      return std::make_pair(_base::_iterator_at(result.first), !result.second);
+   }
+};
+
+template<class Key, class T, size_t CAPACITY, class Hash, class KeyEqual>
+class unordered_map : private _swiss_table_storage<std::pair<const Key, T>, CAPACITY>
+                    , public unordered_map<Key, T, static_cast<size_t>(-1), Hash, KeyEqual>
+{
+   static_assert(CAPACITY >= 1, "capacity must be at least one");
+
+private:
+   using _base = unordered_map<Key, T, static_cast<size_t>(-1), Hash, KeyEqual>;
+   using _storage = _swiss_table_storage<std::pair<const Key, T>, CAPACITY>;
+
+public:
+   using key_type = typename _base::key_type;
+   using mapped_type = typename _base::mapped_type;
+   using value_type = typename _base::value_type;
+   using size_type = typename _base::size_type;
+   using difference_type = typename _base::difference_type;
+   using hasher = typename _base::hasher;
+   using key_equal = typename _base::key_equal;
+   using reference = typename _base::reference;
+   using const_reference = typename _base::const_reference;
+   using pointer = typename _base::pointer;
+   using const_pointer = typename _base::const_pointer;
+   using iterator = typename _base::iterator;
+   using const_iterator = typename _base::const_iterator;
+
+public:
+   unordered_map()
+      : unordered_map(hasher())
+   {}
+
+   explicit unordered_map(const hasher& hash, const key_equal& equal=key_equal())
+      : _base(_storage::_ctrl_.data(), _storage::_slots_.data(), _storage::_table_capacity::value, CAPACITY, hash, equal)
+   {}
+
+   template<class TIterator, class = typename std::enable_if<_is_input_iterator<TIterator>::value>::type>
+   unordered_map(TIterator range_begin,
+                 TIterator range_end,
+                 const hasher& hash=hasher(),
+                 const key_equal& equal=key_equal())
+      : unordered_map(hash, equal)
+   {
+      _base::insert(range_begin, range_end);
+   }
+
+   unordered_map(std::initializer_list<value_type> init,
+                 const hasher& hash=hasher(),
+                 const key_equal& equal=key_equal())
+      : unordered_map(hash, equal)
+   {
+      _base::insert(init);
+   }
+
+   //copy construction from any unordered_map with same types (capacity doesn't matter)
+   unordered_map(const _base& rhs)
+      : unordered_map(rhs.hash_function(), rhs.key_eq())
+   {
+      _base::_assign_from(rhs);
+   }
+
+   unordered_map(const unordered_map& rhs)
+      : unordered_map(static_cast<const _base&>(rhs))
+   {}
+
+   //move construction from any unordered_map with same types (capacity doesn't matter)
+   unordered_map(_base&& rhs)
+      : unordered_map(rhs.hash_function(), rhs.key_eq())
+   {
+      _base::_assign_from(std::move(rhs));
+      rhs.clear();
+   }
+
+   unordered_map(unordered_map&& rhs)
+      : unordered_map(static_cast<_base&&>(rhs))
+   {}
+
+   ~unordered_map() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _base::_destructor();
+   }
+
+   unordered_map& operator=(const _base& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   unordered_map& operator=(const unordered_map& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   //move assignment from any unordered_map with same types (capacity doesn't matter)
+   unordered_map& operator=(_base&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   unordered_map& operator=(unordered_map&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   unordered_map& operator=(std::initializer_list<value_type> init)
+   {
+      _base::operator=(init);
+      return *this;
+   }
+
+   void swap(unordered_map& rhs)
+   {
+      if(this == &rhs)
+         return;
+      unordered_map tmp(std::move(rhs));
+      rhs = std::move(*this);
+      *this = std::move(tmp);
+   }
+};
+
+template<class Key, class T, size_t CAPACITY, class Hash, class KeyEqual>
+void swap(unordered_map<Key, T, CAPACITY, Hash, KeyEqual>& lhs, unordered_map<Key, T, CAPACITY, Hash, KeyEqual>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+}
+
+#endif
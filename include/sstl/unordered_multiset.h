@@ -0,0 +1,224 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_UNORDERED_MULTISET__
+#define _SSTL_UNORDERED_MULTISET__
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+
+#include <sstl_assert.h>
+
+#include "__internal/_except.h"
+#include "__internal/_iterator.h"
+#include "__internal/_robin_hood_table.h"
+#include "hash.h"
+
+namespace sstl
+{
+
+// unordered_multiset<Key, CAPACITY> holds up to CAPACITY keys, with equivalent keys allowed,
+// in a robin hood hash table (see _robin_hood_table.h): equivalent keys are contiguous,
+// thus equal_range and count are a short linear scan.
+// unordered_multiset<Key> is the capacity-agnostic base, e.g. a function taking a
+// sstl::unordered_multiset<int>& accepts sets of any capacity.
+// Heterogeneous lookup (find, count, contains, equal_range) is enabled if both Hash and
+// KeyEqual define the member type is_transparent. The results of a Hash that is not
+// avalanching (see hash.h) are mixed again by the table.
+template<class Key,
+         size_t CAPACITY=static_cast<size_t>(-1),
+         class Hash=hash<Key>,
+         class KeyEqual=std::equal_to<Key>>
+class unordered_multiset;
+
+template<class Key, class Hash, class KeyEqual>
+class unordered_multiset<Key, static_cast<size_t>(-1), Hash, KeyEqual>
+   : public _robin_hood_table<Key, Key, const Key, _key_of_value, Hash, KeyEqual>
+{
+private:
+   using _base = _robin_hood_table<Key, Key, const Key, _key_of_value, Hash, KeyEqual>;
+
+public:
+   using key_type = typename _base::key_type;
+   using value_type = typename _base::value_type;
+   using size_type = typename _base::size_type;
+   using difference_type = typename _base::difference_type;
+   using hasher = typename _base::hasher;
+   using key_equal = typename _base::key_equal;
+   using reference = typename _base::reference;
+   using const_reference = typename _base::const_reference;
+   using pointer = typename _base::pointer;
+   using const_pointer = typename _base::const_pointer;
+   using iterator = typename _base::iterator;
+   using const_iterator = typename _base::const_iterator;
+
+public:
+   unordered_multiset& operator=(const unordered_multiset& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   unordered_multiset& operator=(unordered_multiset&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   unordered_multiset& operator=(std::initializer_list<value_type> init)
+   {
+      _base::clear();
+      _base::insert(init);
+      return *this;
+   }
+
+protected:
+   unordered_multiset(_robin_hood_distance_t* distances, uint64_t* occupied, void* slots, size_type capacity,
+                      size_type max_size, const hasher& hash, const key_equal& equal)
+      : _base(distances, occupied, slots, capacity, max_size, hash, equal)
+   {}
+
+   unordered_multiset(const unordered_multiset&) = delete;
+   unordered_multiset(unordered_multiset&&) = delete;
+
+   ~unordered_multiset() = default;
+};
+
+template<class Key, size_t CAPACITY, class Hash, class KeyEqual>
+class unordered_multiset : private _robin_hood_table_storage<Key, CAPACITY>
+                    , public unordered_multiset<Key, static_cast<size_t>(-1), Hash, KeyEqual>
+{
+   static_assert(CAPACITY >= 1, "capacity must be at least one");
+
+private:
+   using _base = unordered_multiset<Key, static_cast<size_t>(-1), Hash, KeyEqual>;
+   using _storage = _robin_hood_table_storage<Key, CAPACITY>;
+
+public:
+   using key_type = typename _base::key_type;
+   using value_type = typename _base::value_type;
+   using size_type = typename _base::size_type;
+   using difference_type = typename _base::difference_type;
+   using hasher = typename _base::hasher;
+   using key_equal = typename _base::key_equal;
+   using reference = typename _base::reference;
+   using const_reference = typename _base::const_reference;
+   using pointer = typename _base::pointer;
+   using const_pointer = typename _base::const_pointer;
+   using iterator = typename _base::iterator;
+   using const_iterator = typename _base::const_iterator;
+
+public:
+   unordered_multiset()
+      : unordered_multiset(hasher())
+   {}
+
+   explicit unordered_multiset(const hasher& hash, const key_equal& equal=key_equal())
+      : _base(_storage::_distances_.data(), _storage::_occupied_.data(), _storage::_slots_.data(),
+              _storage::_table_capacity::value, CAPACITY, hash, equal)
+   {}
+
+   template<class TIterator, class = typename std::enable_if<_is_input_iterator<TIterator>::value>::type>
+   unordered_multiset(TIterator range_begin,
+                 TIterator range_end,
+                 const hasher& hash=hasher(),
+                 const key_equal& equal=key_equal())
+      : unordered_multiset(hash, equal)
+   {
+      _base::insert(range_begin, range_end);
+   }
+
+   unordered_multiset(std::initializer_list<value_type> init,
+                 const hasher& hash=hasher(),
+                 const key_equal& equal=key_equal())
+      : unordered_multiset(hash, equal)
+   {
+      _base::insert(init);
+   }
+
+   //copy construction from any unordered_multiset with same types (capacity doesn't matter)
+   unordered_multiset(const _base& rhs)
+      : unordered_multiset(rhs.hash_function(), rhs.key_eq())
+   {
+      _base::_assign_from(rhs);
+   }
+
+   unordered_multiset(const unordered_multiset& rhs)
+      : unordered_multiset(static_cast<const _base&>(rhs))
+   {}
+
+   //move construction from any unordered_multiset with same types (capacity doesn't matter)
+   unordered_multiset(_base&& rhs)
+      : unordered_multiset(rhs.hash_function(), rhs.key_eq())
+   {
+      _base::_assign_from(std::move(rhs));
+      rhs.clear();
+   }
+
+   unordered_multiset(unordered_multiset&& rhs)
+      : unordered_multiset(static_cast<_base&&>(rhs))
+   {}
+
+   ~unordered_multiset() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _base::_destructor();
+   }
+
+   unordered_multiset& operator=(const _base& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   unordered_multiset& operator=(const unordered_multiset& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   //move assignment from any unordered_multiset with same types (capacity doesn't matter)
+   unordered_multiset& operator=(_base&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   unordered_multiset& operator=(unordered_multiset&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   unordered_multiset& operator=(std::initializer_list<value_type> init)
+   {
+      _base::operator=(init);
+      return *this;
+   }
+
+   void swap(unordered_multiset& rhs)
+   {
+      if(this == &rhs)
+         return;
+      unordered_multiset tmp(std::move(rhs));
+      rhs = std::move(*this);
+      *this = std::move(tmp);
+   }
+};
+
+template<class Key, size_t CAPACITY, class Hash, class KeyEqual>
+void swap(unordered_multiset<Key, CAPACITY, Hash, KeyEqual>& lhs, unordered_multiset<Key, CAPACITY, Hash, KeyEqual>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+}
+
+#endif
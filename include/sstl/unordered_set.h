@@ -0,0 +1,220 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_UNORDERED_SET__
+#define _SSTL_UNORDERED_SET__
+
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+
+#include <sstl_assert.h>
+
+#include "__internal/_except.h"
+#include "__internal/_iterator.h"
+#include "__internal/_swiss_table.h"
+#include "hash.h"
+
+namespace sstl
+{
+
+// unordered_set<Key, CAPACITY> holds up to CAPACITY keys in an open addressing
+// hash table (see _swiss_table.h). unordered_set<Key> is the capacity-agnostic base,
+// e.g. a function taking a sstl::unordered_set<int>& accepts sets of any capacity.
+// Heterogeneous lookup (find, count, contains, equal_range) is enabled if both Hash and
+// KeyEqual define the member type is_transparent. The results of a Hash that is not
+// avalanching (see hash.h) are mixed again by the table.
+template<class Key,
+         size_t CAPACITY=static_cast<size_t>(-1),
+         class Hash=hash<Key>,
+         class KeyEqual=std::equal_to<Key>>
+class unordered_set;
+
+template<class Key, class Hash, class KeyEqual>
+class unordered_set<Key, static_cast<size_t>(-1), Hash, KeyEqual>
+   : public _swiss_table<Key, Key, const Key, _key_of_value, Hash, KeyEqual>
+{
+private:
+   using _base = _swiss_table<Key, Key, const Key, _key_of_value, Hash, KeyEqual>;
+
+public:
+   using key_type = typename _base::key_type;
+   using value_type = typename _base::value_type;
+   using size_type = typename _base::size_type;
+   using difference_type = typename _base::difference_type;
+   using hasher = typename _base::hasher;
+   using key_equal = typename _base::key_equal;
+   using reference = typename _base::reference;
+   using const_reference = typename _base::const_reference;
+   using pointer = typename _base::pointer;
+   using const_pointer = typename _base::const_pointer;
+   using iterator = typename _base::iterator;
+   using const_iterator = typename _base::const_iterator;
+
+public:
+   unordered_set& operator=(const unordered_set& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   unordered_set& operator=(unordered_set&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   unordered_set& operator=(std::initializer_list<value_type> init)
+   {
+      _base::clear();
+      _base::insert(init);
+      return *this;
+   }
+
+protected:
+   unordered_set(_ctrl_t* ctrl, void* slots, size_type capacity, size_type max_size,
+                 const hasher& hash, const key_equal& equal)
+      : _base(ctrl, slots, capacity, max_size, hash, equal)
+   {}
+
+   unordered_set(const unordered_set&) = delete;
+   unordered_set(unordered_set&&) = delete;
+
+   ~unordered_set() = default;
+};
+
+template<class Key, size_t CAPACITY, class Hash, class KeyEqual>
+class unordered_set : private _swiss_table_storage<Key, CAPACITY>
+                    , public unordered_set<Key, static_cast<size_t>(-1), Hash, KeyEqual>
+{
+   static_assert(CAPACITY >= 1, "capacity must be at least one");
+
+private:
+   using _base = unordered_set<Key, static_cast<size_t>(-1), Hash, KeyEqual>;
+   using _storage = _swiss_table_storage<Key, CAPACITY>;
+
+public:
+   using key_type = typename _base::key_type;
+   using value_type = typename _base::value_type;
+   using size_type = typename _base::size_type;
+   using difference_type = typename _base::difference_type;
+   using hasher = typename _base::hasher;
+   using key_equal = typename _base::key_equal;
+   using reference = typename _base::reference;
+   using const_reference = typename _base::const_reference;
+   using pointer = typename _base::pointer;
+   using const_pointer = typename _base::const_pointer;
+   using iterator = typename _base::iterator;
+   using const_iterator = typename _base::const_iterator;
+
+public:
+   unordered_set()
+      : unordered_set(hasher())
+   {}
+
+   explicit unordered_set(const hasher& hash, const key_equal& equal=key_equal())
+      : _base(_storage::_ctrl_.data(), _storage::_slots_.data(), _storage::_table_capacity::value, CAPACITY, hash, equal)
+   {}
+
+   template<class TIterator, class = typename std::enable_if<_is_input_iterator<TIterator>::value>::type>
+   unordered_set(TIterator range_begin,
+                 TIterator range_end,
+                 const hasher& hash=hasher(),
+                 const key_equal& equal=key_equal())
+      : unordered_set(hash, equal)
+   {
+      _base::insert(range_begin, range_end);
+   }
+
+   unordered_set(std::initializer_list<value_type> init,
+                 const hasher& hash=hasher(),
+                 const key_equal& equal=key_equal())
+      : unordered_set(hash, equal)
+   {
+      _base::insert(init);
+   }
+
+   //copy construction from any unordered_set with same types (capacity doesn't matter)
+   unordered_set(const _base& rhs)
+      : unordered_set(rhs.hash_function(), rhs.key_eq())
+   {
+      _base::_assign_from(rhs);
+   }
+
+   unordered_set(const unordered_set& rhs)
+      : unordered_set(static_cast<const _base&>(rhs))
+   {}
+
+   //move construction from any unordered_set with same types (capacity doesn't matter)
+   unordered_set(_base&& rhs)
+      : unordered_set(rhs.hash_function(), rhs.key_eq())
+   {
+      _base::_assign_from(std::move(rhs));
+      rhs.clear();
+   }
+
+   unordered_set(unordered_set&& rhs)
+      : unordered_set(static_cast<_base&&>(rhs))
+   {}
+
+   ~unordered_set() _sstl_noexcept(std::is_nothrow_destructible<value_type>::value)
+   {
+      _base::_destructor();
+   }
+
+   unordered_set& operator=(const _base& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   unordered_set& operator=(const unordered_set& rhs)
+   {
+      _base::operator=(rhs);
+      return *this;
+   }
+
+   //move assignment from any unordered_set with same types (capacity doesn't matter)
+   unordered_set& operator=(_base&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   unordered_set& operator=(unordered_set&& rhs)
+   {
+      _base::operator=(std::move(rhs));
+      return *this;
+   }
+
+   unordered_set& operator=(std::initializer_list<value_type> init)
+   {
+      _base::operator=(init);
+      return *this;
+   }
+
+   void swap(unordered_set& rhs)
+   {
+      if(this == &rhs)
+         return;
+      unordered_set tmp(std::move(rhs));
+      rhs = std::move(*this);
+      *this = std::move(tmp);
+   }
+};
+
+template<class Key, size_t CAPACITY, class Hash, class KeyEqual>
+void swap(unordered_set<Key, CAPACITY, Hash, KeyEqual>& lhs, unordered_set<Key, CAPACITY, Hash, KeyEqual>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+}
+
+#endif
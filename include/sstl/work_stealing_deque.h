@@ -0,0 +1,148 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#ifndef _SSTL_WORK_STEALING_DEQUE__
+#define _SSTL_WORK_STEALING_DEQUE__
+
+#include <cstddef>
+#include <type_traits>
+#include <atomic>
+#include <array>
+
+#include "__internal/_except.h"
+#include "__internal/_cache_line.h"
+
+namespace sstl
+{
+
+// fixed-capacity work-stealing deque (Chase-Lev, with the memory orderings of
+// Le, Pop, Cohen, Zappa Nardelli: "Correct and Efficient Work-Stealing for Weak Memory Models").
+// The owner thread pushes and pops at the bottom, any number of thief threads steal
+// from the top. The owner's fast path only needs plain (relaxed) accesses, synchronization
+// is required only when the owner pops the last element or when the deque looks full.
+// Since a thief reads a slot before knowing whether its CAS succeeds, the slots are
+// atomics and the value type must be trivially copyable (typically a pointer or handle to a task).
+template<class T, size_t CAPACITY>
+class work_stealing_deque
+{
+   static_assert(CAPACITY >= 1 && (CAPACITY & (CAPACITY-1)) == 0, "capacity must be a power of two");
+   static_assert(std::is_trivially_copyable<T>::value, "value type must be trivially copyable");
+
+public:
+   using value_type = T;
+   using size_type = size_t;
+
+public:
+   work_stealing_deque() _sstl_noexcept_ = default;
+   work_stealing_deque(const work_stealing_deque&) = delete;
+   work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+   //owner
+   //returns false if the deque is full
+   bool push(value_type value) _sstl_noexcept_
+   {
+      auto bottom = _bottom.load(std::memory_order_relaxed);
+      if(bottom - _cached_top >= static_cast<_index_type>(CAPACITY))
+      {
+         _cached_top = _top.load(std::memory_order_acquire);
+         if(bottom - _cached_top >= static_cast<_index_type>(CAPACITY))
+            return false;
+      }
+      _slot(bottom).store(value, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      _bottom.store(bottom+1, std::memory_order_relaxed);
+      return true;
+   }
+
+   //owner
+   //pops the most recently pushed value, returns false if the deque is empty
+   bool pop(value_type& value) _sstl_noexcept_
+   {
+      auto bottom = _bottom.load(std::memory_order_relaxed) - 1;
+      _bottom.store(bottom, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      auto top = _top.load(std::memory_order_relaxed);
+      _cached_top = top;
+
+      if(top > bottom)
+      {
+         //empty
+         _bottom.store(bottom+1, std::memory_order_relaxed);
+         return false;
+      }
+
+      value = _slot(bottom).load(std::memory_order_relaxed);
+      if(top == bottom)
+      {
+         //last value: race against the thieves
+         bool won = _top.compare_exchange_strong(top, top+1, std::memory_order_seq_cst, std::memory_order_relaxed);
+         _bottom.store(bottom+1, std::memory_order_relaxed);
+         return won;
+      }
+      return true;
+   }
+
+   //thief
+   //steals the least recently pushed value, returns false if the deque is
+   //empty or if the value was taken by a concurrent pop/steal
+   bool steal(value_type& value) _sstl_noexcept_
+   {
+      auto top = _top.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      auto bottom = _bottom.load(std::memory_order_acquire);
+      if(top >= bottom)
+         return false;
+
+      auto stolen = _slot(top).load(std::memory_order_relaxed);
+      if(!_top.compare_exchange_strong(top, top+1, std::memory_order_seq_cst, std::memory_order_relaxed))
+         return false;
+      value = stolen;
+      return true;
+   }
+
+   //any thread (the result might be outdated when it gets returned)
+   size_type size() const _sstl_noexcept_
+   {
+      auto bottom = _bottom.load(std::memory_order_relaxed);
+      auto top = _top.load(std::memory_order_relaxed);
+      return bottom > top ? static_cast<size_type>(bottom - top) : 0;
+   }
+
+   //any thread (the result might be outdated when it gets returned)
+   bool empty() const _sstl_noexcept_
+   {
+      return size() == 0;
+   }
+
+   size_type capacity() const _sstl_noexcept_
+   {
+      return CAPACITY;
+   }
+
+private:
+   using _index_type = std::ptrdiff_t;
+
+   std::atomic<value_type>& _slot(_index_type idx) _sstl_noexcept_
+   {
+      return _buffer[static_cast<size_type>(idx) & (CAPACITY-1)];
+   }
+
+private:
+   _cache_line_padding<> _padding0;
+   //thieves' cache line
+   std::atomic<_index_type> _top{ 0 };
+   _cache_line_padding<sizeof(std::atomic<_index_type>)> _padding1;
+   //owner's cache line
+   std::atomic<_index_type> _bottom{ 0 };
+   _index_type _cached_top{ 0 };
+   _cache_line_padding<sizeof(std::atomic<_index_type>) + sizeof(_index_type)> _padding2;
+   std::array<std::atomic<value_type>, CAPACITY> _buffer;
+};
+
+}
+
+#endif
@@ -0,0 +1,421 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <memory>
+#include <map>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+#include <sstl/__internal/_except.h>
+#include <sstl/btree_map.h>
+
+#include "counted_type.h"
+
+namespace sstl_test
+{
+using btree_map_int_base_t = sstl::btree_map<int, int>;
+using btree_map_counted_type_t = sstl::btree_map<int, counted_type, 100>;
+
+namespace
+{
+   //transparent comparator: lookup of std::string keys with C strings
+   struct string_less
+   {
+      using is_transparent = void;
+
+      bool operator()(const std::string& lhs, const std::string& rhs) const
+      {
+         return lhs < rhs;
+      }
+
+      bool operator()(const char* lhs, const std::string& rhs) const
+      {
+         return std::strcmp(lhs, rhs.c_str()) < 0;
+      }
+
+      bool operator()(const std::string& lhs, const char* rhs) const
+      {
+         return std::strcmp(lhs.c_str(), rhs) < 0;
+      }
+   };
+
+   size_t sum_of_values(const sstl::btree_map<int, int>& map)
+   {
+      size_t sum = 0;
+      for(const auto& value : map)
+      {
+         sum += value.second;
+      }
+      return sum;
+   }
+
+   template<class TMap, class TReference>
+   bool is_equal(const TMap& map, const TReference& reference)
+   {
+      return map.size() == reference.size()
+             && std::equal(map.cbegin(), map.cend(), reference.cbegin())
+             && std::equal(map.crbegin(), map.crend(), reference.crbegin());
+   }
+}
+
+TEST_CASE("btree_map")
+{
+   SECTION("user cannot directly construct the base class")
+   {
+      REQUIRE(!std::is_default_constructible<btree_map_int_base_t>::value);
+      REQUIRE(!std::is_copy_constructible<btree_map_int_base_t>::value);
+      REQUIRE(!std::is_move_constructible<btree_map_int_base_t>::value);
+   }
+
+   SECTION("nodes span a few cache lines")
+   {
+      REQUIRE(sstl::btree_map<int, int>::values_per_node > 8);
+      REQUIRE(sstl::btree_map<std::string, std::string>::values_per_node >= 3);
+   }
+
+   SECTION("default constructor")
+   {
+      sstl::btree_map<int, int, 10> m;
+      REQUIRE(m.empty());
+      REQUIRE(m.size() == 0);
+      REQUIRE(m.capacity() == 10);
+      REQUIRE(m.begin() == m.end());
+      REQUIRE(m.rbegin() == m.rend());
+   }
+
+   SECTION("insert + find + erase")
+   {
+      sstl::btree_map<int, int, 10> m;
+      auto result = m.insert(std::make_pair(1, 10));
+      REQUIRE(result.second);
+      REQUIRE(result.first->first == 1);
+      REQUIRE(result.first->second == 10);
+      result = m.insert(std::make_pair(1, 20));
+      REQUIRE(!result.second);
+      REQUIRE(result.first->second == 10);
+      m.emplace(2, 20);
+      m.insert({ { 3, 30 }, { 4, 40 } });
+      REQUIRE(m.size() == 4);
+      REQUIRE(m.find(3)->second == 30);
+      REQUIRE(m.find(5) == m.end());
+      REQUIRE(m.count(4) == 1);
+      REQUIRE(m.count(5) == 0);
+      REQUIRE(m.contains(2));
+      REQUIRE(m.erase(2) == 1);
+      REQUIRE(m.erase(2) == 0);
+      REQUIRE(!m.contains(2));
+      REQUIRE(m.size() == 3);
+   }
+
+   SECTION("operator[] + at")
+   {
+      sstl::btree_map<int, int, 10> m;
+      m[1] = 10;
+      m[2];
+      REQUIRE(m.size() == 2);
+      REQUIRE(m.at(1) == 10);
+      REQUIRE(m.at(2) == 0);
+      #if _sstl_has_exceptions()
+      REQUIRE_THROWS_AS(m.at(3), std::out_of_range);
+      #endif
+   }
+
+   SECTION("try_emplace + insert_or_assign")
+   {
+      sstl::btree_map<int, std::unique_ptr<int>, 10> m;
+      auto value = std::unique_ptr<int>(new int(1));
+      REQUIRE(m.try_emplace(1, std::move(value)).second);
+      REQUIRE(value == nullptr);
+      value.reset(new int(2));
+      REQUIRE(!m.try_emplace(1, std::move(value)).second);
+      REQUIRE(value != nullptr); //not moved from
+      REQUIRE(*m.at(1) == 1);
+      REQUIRE(!m.insert_or_assign(1, std::move(value)).second);
+      REQUIRE(*m.at(1) == 2);
+      REQUIRE(m.insert_or_assign(2, std::unique_ptr<int>(new int(3))).second);
+      REQUIRE(*m.at(2) == 3);
+   }
+
+   SECTION("sorted iteration in both directions")
+   {
+      //enough values for a tree of three levels
+      sstl::btree_map<int, int, 2000> m;
+      auto reference = std::map<int, int>{};
+      for(int i=0; i<2000; ++i)
+      {
+         auto key = (i * 7919) % 2000;
+         m.emplace(key, i);
+         reference.emplace(key, i);
+      }
+      REQUIRE(m.full());
+      REQUIRE(is_equal(m, reference));
+      REQUIRE(std::prev(m.end())->first == 1999);
+      REQUIRE(m.begin()->first == 0);
+      auto it = m.end();
+      for(int key=1999; key>=0; --key)
+      {
+         REQUIRE((--it)->first == key);
+      }
+      REQUIRE(it == m.begin());
+   }
+
+   SECTION("lower_bound + upper_bound + equal_range")
+   {
+      sstl::btree_map<int, int, 1000> m;
+      for(int i=0; i<1000; ++i)
+      {
+         m.emplace(i * 2, i);
+      }
+      const auto& cm = m;
+      for(int key=-1; key<=2000; ++key)
+      {
+         auto expected_lower = key < 0 ? 0 : (key + 1) / 2 * 2;
+         auto expected_upper = key < 0 ? 0 : std::min(key / 2 * 2 + 2, 2000);
+         auto lower = cm.lower_bound(key);
+         auto upper = cm.upper_bound(key);
+         REQUIRE((lower == cm.end() ? 2000 : lower->first) == expected_lower);
+         REQUIRE((upper == cm.end() ? 2000 : upper->first) == expected_upper);
+         auto range = m.equal_range(key);
+         REQUIRE(std::distance(range.first, range.second) == (key >= 0 && key % 2 == 0 && key < 2000 ? 1 : 0));
+      }
+   }
+
+   SECTION("erase by iterator returns the next value")
+   {
+      sstl::btree_map<int, int, 1000> m;
+      for(int i=0; i<1000; ++i)
+      {
+         m.emplace(i, i);
+      }
+      for(auto it = m.begin(); it != m.end();)
+      {
+         it = it->first % 3 != 0 ? m.erase(it) : std::next(it);
+      }
+      REQUIRE(m.size() == 334);
+      int expected = 0;
+      for(const auto& value : m)
+      {
+         REQUIRE(value.first == expected);
+         expected += 3;
+      }
+      //the erasures invalidate the iterators
+      auto last_key = std::prev(m.end(), 10)->first;
+      REQUIRE(m.erase(std::next(m.begin(), 10), std::prev(m.end(), 10))->first == last_key);
+      REQUIRE(m.size() == 20);
+      m.erase(m.begin(), m.end());
+      REQUIRE(m.empty());
+      REQUIRE(m.begin() == m.end());
+   }
+
+   SECTION("capacity-agnostic base")
+   {
+      sstl::btree_map<int, int, 5> small{ { 1, 1 }, { 2, 2 } };
+      sstl::btree_map<int, int, 500> large{ { 1, 10 }, { 2, 20 }, { 3, 30 } };
+      REQUIRE(sum_of_values(small) == 3);
+      REQUIRE(sum_of_values(large) == 60);
+   }
+
+   SECTION("copy and move")
+   {
+      btree_map_counted_type_t m;
+      for(int i=0; i<50; ++i)
+      {
+         m.emplace(i, i);
+      }
+
+      SECTION("same capacity")
+      {
+         counted_type::reset_counts();
+         auto copy = m;
+         //the splits of the nodes move the values
+         REQUIRE(counted_type::copy_construction::count == 50);
+         REQUIRE(copy == m);
+
+         auto moved = std::move(copy);
+         REQUIRE(copy.empty());
+         REQUIRE(moved == m);
+      }
+
+      SECTION("different capacity")
+      {
+         sstl::btree_map<int, counted_type, 1000> copy(m);
+         REQUIRE(copy == m);
+
+         m.clear();
+         m = std::move(copy);
+         REQUIRE(copy.empty());
+         REQUIRE(m.size() == 50);
+         for(int i=0; i<50; ++i)
+         {
+            REQUIRE(m.at(i).member == static_cast<size_t>(i));
+         }
+      }
+
+      SECTION("swap")
+      {
+         btree_map_counted_type_t other;
+         other.emplace(100, 100);
+         swap(m, other);
+         REQUIRE(m.size() == 1);
+         REQUIRE(other.size() == 50);
+         REQUIRE(m.at(100).member == 100);
+      }
+
+      SECTION("comparison")
+      {
+         auto copy = m;
+         REQUIRE(copy == m);
+         REQUIRE(!(copy < m));
+         copy.erase(std::prev(copy.end()));
+         REQUIRE(copy != m);
+         REQUIRE(copy < m);
+         REQUIRE(m > copy);
+      }
+   }
+
+   SECTION("values are destroyed")
+   {
+      counted_type::reset_counts();
+      {
+         btree_map_counted_type_t m;
+         for(int i=0; i<100; ++i)
+         {
+            m.try_emplace(i, i);
+         }
+         m.erase(3);
+         m.erase(m.find(4));
+      }
+      REQUIRE(counted_type::parameter_construction::count == 100);
+      REQUIRE(counted_type::destruction::count == counted_type::construction::count);
+   }
+
+   SECTION("heterogeneous lookup")
+   {
+      sstl::btree_map<std::string, int, 10, string_less> m;
+      m.emplace("one", 1);
+      m.emplace("two", 2);
+      REQUIRE(m.find("one")->second == 1);
+      REQUIRE(m.count("two") == 1);
+      REQUIRE(!m.contains("three"));
+      REQUIRE(m.lower_bound("p")->second == 2);
+      REQUIRE(m.upper_bound("one")->second == 2);
+      REQUIRE(m.equal_range("two").first->second == 2);
+      REQUIRE(std::distance(m.equal_range("three").first, m.equal_range("three").second) == 0);
+   }
+
+   SECTION("custom comparator")
+   {
+      sstl::btree_map<int, int, 100, std::greater<int>> m;
+      for(int i=0; i<100; ++i)
+      {
+         m.emplace(i, i);
+      }
+      REQUIRE(m.begin()->first == 99);
+      REQUIRE(m.lower_bound(50)->first == 50);
+      REQUIRE(m.upper_bound(50)->first == 49);
+   }
+
+   SECTION("random operations against std::map")
+   {
+      //a small capacity for many splits and merges of a tree of several levels
+      sstl::btree_map<int, int, 500> m;
+      auto reference = std::map<int, int>{};
+      unsigned seed = 5;
+      auto next = [&seed]() { seed = seed * 1103515245 + 12345; return static_cast<int>((seed >> 16) % 800); };
+      for(int i=0; i<50000; ++i)
+      {
+         auto key = next();
+         if(next() % 2 == 0 && !m.full())
+         {
+            REQUIRE(m.emplace(key, i).second == reference.emplace(key, i).second);
+         }
+         else
+         {
+            REQUIRE(m.erase(key) == reference.erase(key));
+         }
+         REQUIRE(m.size() == reference.size());
+         auto it = m.lower_bound(key);
+         auto reference_it = reference.lower_bound(key);
+         REQUIRE((it == m.end()) == (reference_it == reference.end()));
+         if(it != m.end())
+         {
+            REQUIRE(*it == *reference_it);
+         }
+      }
+      REQUIRE(is_equal(m, reference));
+   }
+
+   SECTION("search of the arithmetic keys")
+   {
+      //the keys are scanned with SIMD comparisons, including the signed/unsigned boundaries
+      sstl::btree_map<uint32_t, int, 1000> unsigned_keys;
+      sstl::btree_map<int16_t, int, 1000> short_keys;
+      sstl::btree_map<double, int, 1000> double_keys;
+      sstl::btree_map<int64_t, int, 1000> long_keys;
+      for(int i=0; i<1000; ++i)
+      {
+         unsigned_keys.emplace(static_cast<uint32_t>(i) * 4294967u, i);
+         short_keys.emplace(static_cast<int16_t>(i * 61 - 30000), i);
+         double_keys.emplace(i * 0.5 - 250.0, i);
+         long_keys.emplace((static_cast<int64_t>(i) - 500) * (int64_t{ 1 } << 40), i);
+      }
+      for(int i=0; i<1000; ++i)
+      {
+         REQUIRE(unsigned_keys.at(static_cast<uint32_t>(i) * 4294967u) == i);
+         REQUIRE(short_keys.at(static_cast<int16_t>(i * 61 - 30000)) == i);
+         REQUIRE(double_keys.lower_bound(i * 0.5 - 250.1)->second == i);
+         REQUIRE(long_keys.upper_bound(((static_cast<int64_t>(i) - 500) * (int64_t{ 1 } << 40)) - 1)->second == i);
+      }
+      for(int i=0; i<999; ++i)
+      {
+         REQUIRE(unsigned_keys.lower_bound(static_cast<uint32_t>(i) * 4294967u + 1)->second == i + 1);
+      }
+      REQUIRE(unsigned_keys.lower_bound(999u * 4294967u + 1) == unsigned_keys.end());
+   }
+
+   #if _sstl_has_exceptions()
+   SECTION("construction of the value throws")
+   {
+      btree_map_counted_type_t m;
+      for(int i=0; i<99; ++i)
+      {
+         m.emplace(i * 2, i);
+      }
+      counted_type::reset_counts();
+      counted_type::throw_at_nth_parameter_construction(1);
+      REQUIRE_THROWS_AS(m.try_emplace(51, 51), counted_type::parameter_construction::exception);
+      REQUIRE(m.size() == 99);
+      REQUIRE(!m.contains(51));
+      int expected = 0;
+      for(const auto& value : m)
+      {
+         REQUIRE(value.first == expected);
+         expected += 2;
+      }
+   }
+
+   SECTION("copy construction throws")
+   {
+      btree_map_counted_type_t m;
+      for(int i=0; i<5; ++i)
+      {
+         m.emplace(i, i);
+      }
+      counted_type::reset_counts();
+      counted_type::throw_at_nth_copy_construction(3);
+      REQUIRE_THROWS_AS(btree_map_counted_type_t{m}, counted_type::copy_construction::exception);
+      REQUIRE(counted_type::check().copy_constructions(2).destructions(2));
+   }
+   #endif
+}
+}
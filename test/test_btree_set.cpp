@@ -0,0 +1,114 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <cstdint>
+#include <string>
+#include <set>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <sstl/btree_set.h>
+
+namespace sstl_test
+{
+using btree_set_int_base_t = sstl::btree_set<int>;
+
+namespace
+{
+   //random insertions and erasures of keys of the specified type, checked against std::set
+   template<class TKey, size_t CAPACITY>
+   void check_random_operations(int range)
+   {
+      sstl::btree_set<TKey, CAPACITY> s;
+      auto reference = std::set<TKey>{};
+      unsigned seed = 7;
+      auto next = [&seed, range]() { seed = seed * 1103515245 + 12345; return static_cast<int>((seed >> 8) % range) - range / 2; };
+      for(int i=0; i<20000; ++i)
+      {
+         auto key = static_cast<TKey>(next());
+         if(next() % 2 == 0 && !s.full())
+         {
+            REQUIRE(s.insert(key).second == reference.insert(key).second);
+         }
+         else
+         {
+            REQUIRE(s.erase(key) == reference.erase(key));
+         }
+         auto it = s.lower_bound(key);
+         auto reference_it = reference.lower_bound(key);
+         REQUIRE((it == s.end()) == (reference_it == reference.end()));
+         if(it != s.end())
+         {
+            REQUIRE(*it == *reference_it);
+         }
+      }
+      REQUIRE(s.size() == reference.size());
+      REQUIRE(std::equal(s.cbegin(), s.cend(), reference.cbegin()));
+   }
+}
+
+TEST_CASE("btree_set")
+{
+   SECTION("user cannot directly construct the base class")
+   {
+      REQUIRE(!std::is_default_constructible<btree_set_int_base_t>::value);
+      REQUIRE(!std::is_copy_constructible<btree_set_int_base_t>::value);
+      REQUIRE(!std::is_move_constructible<btree_set_int_base_t>::value);
+   }
+
+   SECTION("insert + find + erase")
+   {
+      sstl::btree_set<std::string, 10> s{ "one", "two" };
+      REQUIRE(s.insert("three").second);
+      REQUIRE(!s.insert("three").second);
+      REQUIRE(s.size() == 3);
+      REQUIRE(*s.begin() == "one");
+      REQUIRE(*s.rbegin() == "two");
+      REQUIRE(s.count("two") == 1);
+      REQUIRE(s.find("four") == s.end());
+      REQUIRE(*s.lower_bound("p") == "three");
+      REQUIRE(s.erase("two") == 1);
+      REQUIRE(!s.contains("two"));
+      REQUIRE(s.size() == 2);
+   }
+
+   SECTION("copy, move and swap")
+   {
+      sstl::btree_set<int, 500> s;
+      for(int i=0; i<500; ++i)
+      {
+         s.insert(i);
+      }
+      sstl::btree_set<int, 1000> copy(s);
+      REQUIRE(copy == s);
+      sstl::btree_set<int, 500> moved(std::move(copy));
+      REQUIRE(copy.empty());
+      REQUIRE(moved == s);
+      sstl::btree_set<int, 500> other{ 1000 };
+      swap(other, moved);
+      REQUIRE(other.size() == 500);
+      REQUIRE(moved.size() == 1);
+      REQUIRE(*moved.begin() == 1000);
+   }
+
+   SECTION("random operations against std::set")
+   {
+      //all the kinds of SIMD comparisons of the keys, the 64 bits keys are scanned without SIMD
+      check_random_operations<signed char, 200>(256);
+      check_random_operations<unsigned char, 200>(256);
+      check_random_operations<int16_t, 500>(1000);
+      check_random_operations<uint16_t, 500>(1000);
+      check_random_operations<int32_t, 500>(1000);
+      check_random_operations<uint32_t, 500>(1000);
+      check_random_operations<float, 500>(1000);
+      check_random_operations<double, 500>(1000);
+      check_random_operations<int64_t, 500>(1000);
+      check_random_operations<uint64_t, 500>(1000);
+   }
+}
+}
@@ -2205,6 +2205,210 @@ TEST_CASE("deque")
       REQUIRE(d == (deque_counted_type_t{}));
    }
 
+   SECTION("power-of-two capacity (mask-based wrap-around)")
+   {
+      auto d = sstl::deque<counted_type, 8>{};
+      sstl::deque<counted_type>& base = d;
+      for(size_t i=0; i<5; ++i)
+      {
+         d.push_back(i);
+      }
+      for(size_t i=5; i<21; ++i)
+      {
+         d.pop_front();
+         d.emplace_back(i);
+         REQUIRE(d.front() == counted_type(i-4));
+         REQUIRE(d.back() == counted_type(i));
+         REQUIRE(d[0] == base[0]);
+         REQUIRE(d[4] == base[4]);
+         REQUIRE(base == (deque_counted_type_t{i-4, i-3, i-2, i-1, i}));
+      }
+      const auto& cd = d;
+      REQUIRE(cd[2] == counted_type(18));
+      for(size_t i=21; i<24; ++i)
+      {
+         d.push_back(i);
+      }
+      REQUIRE(d.full());
+      REQUIRE(d == (deque_counted_type_t{16, 17, 18, 19, 20, 21, 22, 23}));
+      base.pop_back();
+      base.push_front(15);
+      REQUIRE(d == (deque_counted_type_t{15, 16, 17, 18, 19, 20, 21, 22}));
+   }
+
+   SECTION("push_back_n + append_range")
+   {
+      SECTION("contained values + number of operations")
+      {
+         auto values = std::initializer_list<counted_type>{3, 4, 5, 6};
+         auto d = make_noncontiguous_deque<counted_type>({0, 1, 2});
+         counted_type::reset_counts();
+         auto it = d.push_back_n(values.begin(), 3);
+         REQUIRE(it == values.begin()+3);
+         REQUIRE(counted_type::check().copy_constructions(3));
+         REQUIRE(d == (deque_counted_type_t{0, 1, 2, 3, 4, 5}));
+         d.append_range(values.begin()+3, values.end());
+         REQUIRE(d == (deque_counted_type_t{0, 1, 2, 3, 4, 5, 6}));
+      }
+      SECTION("trivially copyable values (two chunks)")
+      {
+         auto values = std::initializer_list<int>{3, 4, 5, 6, 7, 8, 9, 10};
+         auto d = make_noncontiguous_deque<int>({0, 1, 2});
+         d.append_range(values.begin(), values.end());
+         REQUIRE(d.full());
+         REQUIRE(d == (sstl::deque<int, 11>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+      }
+      SECTION("input iterators")
+      {
+         auto values = std::initializer_list<counted_type>{3, 4};
+         auto d = deque_counted_type_t{0, 1, 2};
+         d.append_range(counted_type_stream_iterator{values}, counted_type_stream_iterator{});
+         REQUIRE(d == (deque_counted_type_t{0, 1, 2, 3, 4}));
+      }
+      #if _sstl_has_exceptions()
+      SECTION("exception handling")
+      {
+         auto values = std::initializer_list<counted_type>{3, 4, 5, 6};
+         auto d = make_noncontiguous_deque<counted_type>({0, 1, 2});
+         counted_type::reset_counts();
+         counted_type::throw_at_nth_copy_construction(4);
+         REQUIRE_THROWS_AS(d.push_back_n(values.begin(), 4), counted_type::copy_construction::exception);
+         REQUIRE(counted_type::check().copy_constructions(3));
+         REQUIRE(d == (deque_counted_type_t{0, 1, 2, 3, 4, 5}));
+      }
+      #endif
+   }
+
+   SECTION("pop_front_n")
+   {
+      SECTION("destruction only")
+      {
+         auto d = make_noncontiguous_deque<counted_type>({0, 1, 2, 3, 4, 5});
+         counted_type::reset_counts();
+         d.pop_front_n(5);
+         REQUIRE(counted_type::check().destructions(5));
+         REQUIRE(d == (deque_counted_type_t{5}));
+         d.push_back(6);
+         REQUIRE(d == (deque_counted_type_t{5, 6}));
+      }
+      SECTION("into output range")
+      {
+         auto d = make_noncontiguous_deque<counted_type>({0, 1, 2, 3, 4, 5});
+         counted_type out[5];
+         counted_type::reset_counts();
+         auto it = d.pop_front_n(5, out);
+         REQUIRE(it == out+5);
+         REQUIRE(counted_type::check().move_assignments(5).destructions(5));
+         REQUIRE(std::equal(out, out+5, std::initializer_list<counted_type>{0, 1, 2, 3, 4}.begin()));
+         REQUIRE(d == (deque_counted_type_t{5}));
+      }
+      SECTION("trivially copyable values (two chunks)")
+      {
+         auto d = make_noncontiguous_deque<int>({0, 1, 2, 3, 4, 5});
+         int out[6];
+         d.pop_front_n(6, out);
+         REQUIRE(d.empty());
+         REQUIRE(std::equal(out, out+6, std::initializer_list<int>{0, 1, 2, 3, 4, 5}.begin()));
+      }
+      #if _sstl_has_exceptions()
+      SECTION("exception handling")
+      {
+         auto d = make_noncontiguous_deque<counted_type>({0, 1, 2, 3, 4, 5});
+         counted_type out[5];
+         counted_type::reset_counts();
+         counted_type::throw_at_nth_move_assignment(4);
+         REQUIRE_THROWS_AS(d.pop_front_n(5, out), counted_type::move_assignment::exception);
+         REQUIRE(counted_type::check().move_assignments(3).destructions(3));
+         REQUIRE(d == (deque_counted_type_t{3, 4, 5}));
+      }
+      #endif
+   }
+
+   SECTION("array_one + array_two")
+   {
+      SECTION("empty")
+      {
+         auto d = deque_counted_type_t{};
+         REQUIRE(d.array_one().second == 0);
+         REQUIRE(d.array_two().second == 0);
+         REQUIRE(d.is_linearized());
+      }
+      SECTION("contiguous values")
+      {
+         const auto d = deque_counted_type_t{0, 1, 2};
+         auto one = d.array_one();
+         REQUIRE(one.second == 3);
+         REQUIRE(std::equal(one.first, one.first+one.second, d.cbegin()));
+         REQUIRE(d.array_two().second == 0);
+         REQUIRE(d.is_linearized());
+      }
+      SECTION("non-contiguous values")
+      {
+         auto d = make_noncontiguous_deque<counted_type>({0, 1, 2, 3, 4, 5});
+         auto one = d.array_one();
+         auto two = d.array_two();
+         REQUIRE(one.second == 4);
+         REQUIRE(two.second == 2);
+         REQUIRE(std::equal(one.first, one.first+one.second, d.cbegin()));
+         REQUIRE(std::equal(two.first, two.first+two.second, d.cbegin()+4));
+         REQUIRE(!d.is_linearized());
+      }
+   }
+
+   SECTION("linearize")
+   {
+      SECTION("contiguous values")
+      {
+         auto d = deque_counted_type_t{0, 1, 2};
+         counted_type::reset_counts();
+         auto p = d.linearize();
+         REQUIRE(counted_type::check().constructions(0).destructions(0).move_assignments(0));
+         REQUIRE(p == &d.front());
+      }
+      SECTION("second array is smaller")
+      {
+         auto d = make_noncontiguous_deque<counted_type>({0, 1, 2, 3, 4, 5});
+         auto p = d.linearize();
+         REQUIRE(d.is_linearized());
+         REQUIRE(p == &d.front());
+         REQUIRE(d == (deque_counted_type_t{0, 1, 2, 3, 4, 5}));
+         REQUIRE(std::equal(p, p+d.size(), d.cbegin()));
+      }
+      SECTION("first array is smaller")
+      {
+         auto d = deque_counted_type_t{};
+         for(size_t i=0; i<9; ++i)
+         {
+            d.push_back(0);
+            d.pop_front();
+         }
+         for(size_t i=0; i<7; ++i)
+         {
+            d.push_back(i);
+         }
+         REQUIRE(d.array_one().second == 2);
+         auto p = d.linearize();
+         REQUIRE(d.is_linearized());
+         REQUIRE(p == &d.front());
+         REQUIRE(d == (deque_counted_type_t{0, 1, 2, 3, 4, 5, 6}));
+      }
+      SECTION("full")
+      {
+         auto d = make_noncontiguous_deque<counted_type>({0, 1, 2, 3, 4, 5});
+         for(size_t i=6; i<11; ++i)
+         {
+            d.push_back(i);
+         }
+         REQUIRE(d.full());
+         d.linearize();
+         REQUIRE(d.is_linearized());
+         REQUIRE(d == (deque_counted_type_t{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+         d.pop_front();
+         d.push_back(11);
+         REQUIRE(d == (deque_counted_type_t{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+      }
+   }
+
    SECTION("swap")
    {
       SECTION("rhs' capacity is same")
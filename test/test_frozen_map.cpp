@@ -0,0 +1,130 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <sstl/__internal/_except.h>
+#include <sstl/vector.h>
+#include <sstl/frozen_map.h>
+
+#include "counted_type.h"
+
+namespace sstl_test
+{
+using frozen_map_int_base_t = sstl::frozen_map<int, int>;
+using frozen_map_counted_type_t = sstl::frozen_map<int, counted_type, 100>;
+
+namespace
+{
+   size_t sum_of_values(const sstl::frozen_map<int, int>& map)
+   {
+      size_t sum = 0;
+      for(const auto& value : map)
+      {
+         sum += value.second;
+      }
+      return sum;
+   }
+}
+
+TEST_CASE("frozen_map")
+{
+   SECTION("user cannot directly construct the base class")
+   {
+      REQUIRE(!std::is_default_constructible<frozen_map_int_base_t>::value);
+      REQUIRE(!std::is_copy_constructible<frozen_map_int_base_t>::value);
+      REQUIRE(!std::is_move_constructible<frozen_map_int_base_t>::value);
+   }
+
+   SECTION("construction from a sorted sstl::vector")
+   {
+      auto values = sstl::vector<std::pair<uint64_t, int>, 1000>{};
+      for(int i=0; i<1000; ++i)
+      {
+         values.push_back(std::make_pair(static_cast<uint64_t>(i + 1) << 40, i));
+      }
+      sstl::frozen_map<uint64_t, int, 1000> m(values.cbegin(), values.cend());
+      REQUIRE(m.size() == 1000);
+      for(int i=0; i<1000; ++i)
+      {
+         auto key = static_cast<uint64_t>(i + 1) << 40;
+         REQUIRE(m.at(key) == i);
+         REQUIRE(m.find(key)->second == i);
+         REQUIRE(m.lower_bound(key - 1)->second == i);
+         REQUIRE(m.find(key + 1) == m.end());
+      }
+      REQUIRE(m.lower_bound((uint64_t{1000} << 40) + 1) == m.end());
+      REQUIRE(std::equal(m.cbegin(), m.cend(), values.cbegin(),
+         [](const std::pair<const uint64_t, int>& lhs, const std::pair<uint64_t, int>& rhs)
+         {
+            return lhs.first == rhs.first && lhs.second == rhs.second;
+         }));
+   }
+
+   SECTION("at")
+   {
+      sstl::frozen_map<int, int, 10> m{ {1, 10}, {2, 20} };
+      REQUIRE(m.at(2) == 20);
+      #if _sstl_has_exceptions()
+      REQUIRE_THROWS_AS(m.at(3), std::out_of_range);
+      #endif
+   }
+
+   SECTION("capacity-agnostic base")
+   {
+      sstl::frozen_map<int, int, 10> m{ {1, 10}, {2, 20}, {3, 30} };
+      REQUIRE(sum_of_values(m) == 60);
+      REQUIRE(m.value_comp()(*m.begin(), *m.rbegin()));
+   }
+
+   SECTION("values destroyed")
+   {
+      counted_type::reset_counts();
+      {
+         auto values = sstl::vector<std::pair<int, counted_type>, 100>{};
+         for(int i=0; i<100; ++i)
+         {
+            values.emplace_back(i, i);
+         }
+         frozen_map_counted_type_t m(values.cbegin(), values.cend());
+         frozen_map_counted_type_t moved(std::move(m));
+         REQUIRE(counted_type::copy_construction::count == 100);
+         REQUIRE(counted_type::move_construction::count == 100);
+      }
+      REQUIRE(counted_type::destruction::count == counted_type::construction::count);
+   }
+
+   #if _sstl_has_exceptions()
+   SECTION("construction of a value throws")
+   {
+      auto values = sstl::vector<std::pair<int, counted_type>, 100>{};
+      for(int i=0; i<10; ++i)
+      {
+         values.emplace_back(i, i);
+      }
+      counted_type::reset_counts();
+      counted_type::throw_at_nth_copy_construction(5);
+      REQUIRE_THROWS_AS(frozen_map_counted_type_t(values.cbegin(), values.cend()), counted_type::copy_construction::exception);
+      REQUIRE(counted_type::check().copy_constructions(4).destructions(4));
+   }
+
+   SECTION("copy construction throws")
+   {
+      frozen_map_counted_type_t m{ {0, 0}, {1, 1}, {2, 2}, {3, 3}, {4, 4} };
+      counted_type::reset_counts();
+      counted_type::throw_at_nth_copy_construction(3);
+      REQUIRE_THROWS_AS(frozen_map_counted_type_t{m}, counted_type::copy_construction::exception);
+      REQUIRE(counted_type::check().copy_constructions(2).destructions(2));
+   }
+   #endif
+}
+}
@@ -0,0 +1,136 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <cstring>
+#include <string>
+#include <algorithm>
+#include <iterator>
+#include <functional>
+#include <type_traits>
+#include <sstl/vector.h>
+#include <sstl/frozen_set.h>
+
+namespace sstl_test
+{
+using frozen_set_int_base_t = sstl::frozen_set<int>;
+
+namespace
+{
+   //transparent comparator: lookup of std::string keys with C strings
+   struct string_less
+   {
+      using is_transparent = void;
+
+      bool operator()(const std::string& lhs, const std::string& rhs) const
+      {
+         return lhs < rhs;
+      }
+
+      bool operator()(const char* lhs, const std::string& rhs) const
+      {
+         return std::strcmp(lhs, rhs.c_str()) < 0;
+      }
+
+      bool operator()(const std::string& lhs, const char* rhs) const
+      {
+         return std::strcmp(lhs.c_str(), rhs) < 0;
+      }
+   };
+}
+
+TEST_CASE("frozen_set")
+{
+   SECTION("user cannot directly construct the base class")
+   {
+      REQUIRE(!std::is_default_constructible<frozen_set_int_base_t>::value);
+      REQUIRE(!std::is_copy_constructible<frozen_set_int_base_t>::value);
+      REQUIRE(!std::is_move_constructible<frozen_set_int_base_t>::value);
+   }
+
+   SECTION("default constructor")
+   {
+      sstl::frozen_set<int, 10> s;
+      REQUIRE(s.empty());
+      REQUIRE(s.capacity() == 10);
+      REQUIRE(s.begin() == s.end());
+      REQUIRE(s.find(0) == s.end());
+      REQUIRE(s.lower_bound(0) == s.end());
+   }
+
+   SECTION("lookups and iteration for every size of the tree")
+   {
+      //complete and incomplete last levels, the keys are the even numbers
+      for(int size=0; size<=130; ++size)
+      {
+         auto keys = sstl::vector<int, 130>{};
+         for(int i=0; i<size; ++i)
+         {
+            keys.push_back(i * 2);
+         }
+         sstl::frozen_set<int, 130> s(keys.cbegin(), keys.cend());
+         REQUIRE(s.size() == static_cast<size_t>(size));
+         REQUIRE(std::equal(s.cbegin(), s.cend(), keys.cbegin()));
+         REQUIRE(std::equal(s.crbegin(), s.crend(), keys.crbegin()));
+         for(int key=-1; key<=size*2; ++key)
+         {
+            auto expected = std::lower_bound(keys.cbegin(), keys.cend(), key);
+            auto it = s.lower_bound(key);
+            REQUIRE(std::distance(s.cbegin(), it) == std::distance(keys.cbegin(), expected));
+            auto expected_upper = std::upper_bound(keys.cbegin(), keys.cend(), key);
+            REQUIRE(std::distance(s.cbegin(), s.upper_bound(key)) == std::distance(keys.cbegin(), expected_upper));
+            REQUIRE(s.contains(key) == (key >= 0 && key < size * 2 && key % 2 == 0));
+            REQUIRE((s.find(key) == s.end()) == !s.contains(key));
+            REQUIRE(std::distance(s.equal_range(key).first, s.equal_range(key).second) == static_cast<ptrdiff_t>(s.count(key)));
+         }
+      }
+   }
+
+   SECTION("strings and heterogeneous lookup")
+   {
+      sstl::frozen_set<std::string, 10, string_less> s{ "four", "one", "three", "two" };
+      REQUIRE(*s.begin() == "four");
+      REQUIRE(*s.rbegin() == "two");
+      REQUIRE(s.contains("one"));
+      REQUIRE(!s.contains("five"));
+      REQUIRE(*s.find("three") == "three");
+      REQUIRE(*s.lower_bound("p") == "three");
+      REQUIRE(s.upper_bound("two") == s.end());
+   }
+
+   SECTION("custom comparator")
+   {
+      sstl::frozen_set<int, 10, std::greater<int>> s{ 5, 3, 1 };
+      REQUIRE(*s.begin() == 5);
+      REQUIRE(*s.lower_bound(4) == 3);
+      REQUIRE(s.lower_bound(0) == s.end());
+   }
+
+   SECTION("copy, move and swap")
+   {
+      auto keys = sstl::vector<int, 500>{};
+      for(int i=0; i<500; ++i)
+      {
+         keys.push_back(i);
+      }
+      sstl::frozen_set<int, 500> s(keys.cbegin(), keys.cend());
+      sstl::frozen_set<int, 1000> copy(s);
+      REQUIRE(copy == s);
+      sstl::frozen_set<int, 500> moved(std::move(copy));
+      REQUIRE(copy.empty());
+      REQUIRE(moved == s);
+      sstl::frozen_set<int, 500> other{ 1000 };
+      REQUIRE(other > moved);
+      swap(other, moved);
+      REQUIRE(other.size() == 500);
+      REQUIRE(moved.size() == 1);
+      REQUIRE(*moved.begin() == 1000);
+      moved = s;
+      REQUIRE(moved == s);
+   }
+}
+}
@@ -0,0 +1,180 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <cstdint>
+#include <string>
+#include <set>
+#include <vector>
+#include <bitset>
+#include <utility>
+#include <functional>
+#include <sstl/hash.h>
+#include <sstl/unordered_set.h>
+
+namespace sstl_test
+{
+struct point
+{
+   int x;
+   int y;
+};
+
+bool operator==(const point& lhs, const point& rhs)
+{
+   return lhs.x == rhs.x && lhs.y == rhs.y;
+}
+}
+
+namespace sstl
+{
+template<>
+struct hash<sstl_test::point>
+{
+   using is_avalanching = void;
+
+   size_t operator()(const sstl_test::point& value) const
+   {
+      return hash<std::pair<int, int>>()(std::make_pair(value.x, value.y));
+   }
+};
+}
+
+namespace sstl_test
+{
+namespace
+{
+   enum class side { buy, sell };
+
+   //number of distinct values of the low bits of the hashes of the keys
+   template<class THash, class TKeys>
+   size_t count_buckets(const TKeys& keys, size_t bits)
+   {
+      auto buckets = std::set<size_t>{};
+      for(const auto& key : keys)
+      {
+         buckets.insert(THash()(key) & ((size_t{ 1 } << bits) - 1));
+      }
+      return buckets.size();
+   }
+
+   size_t count_different_bits(size_t lhs, size_t rhs)
+   {
+      return std::bitset<64>(static_cast<unsigned long long>(lhs ^ rhs)).count();
+   }
+}
+
+TEST_CASE("hash")
+{
+   SECTION("hash functions are avalanching")
+   {
+      REQUIRE(sstl::_is_avalanching<sstl::hash<int>>::value);
+      REQUIRE(sstl::_is_avalanching<sstl::hash<std::string>>::value);
+      REQUIRE(sstl::_is_avalanching<sstl::hash<std::pair<int, std::string>>>::value);
+      REQUIRE(sstl::_is_avalanching<sstl::hash<point>>::value);
+      REQUIRE(!sstl::_is_avalanching<std::hash<int>>::value);
+   }
+
+   SECTION("integers that differ in the high bits only")
+   {
+      auto keys = std::vector<uint64_t>{};
+      for(uint64_t i=0; i<256; ++i)
+      {
+         keys.push_back(i << 56);
+      }
+      //a random function fills about 162 of the 256 buckets
+      REQUIRE(count_buckets<sstl::hash<uint64_t>>(keys, 8) > 140);
+      REQUIRE(count_buckets<std::hash<uint64_t>>(keys, 8) == 1);
+   }
+
+   SECTION("sequential and strided integers")
+   {
+      auto sequential = std::vector<uint32_t>{};
+      auto strided = std::vector<uint32_t>{};
+      for(uint32_t i=0; i<1024; ++i)
+      {
+         sequential.push_back(i);
+         strided.push_back(i * 4096);
+      }
+      REQUIRE(count_buckets<sstl::hash<uint32_t>>(sequential, 10) > 600);
+      REQUIRE(count_buckets<sstl::hash<uint32_t>>(strided, 10) > 600);
+   }
+
+   SECTION("enums, pointers and floating points")
+   {
+      REQUIRE(sstl::hash<side>()(side::buy) != sstl::hash<side>()(side::sell));
+      int values[2];
+      REQUIRE(sstl::hash<int*>()(&values[0]) != sstl::hash<int*>()(&values[1]));
+      REQUIRE(sstl::hash<double>()(0.0) == sstl::hash<double>()(-0.0));
+      REQUIRE(sstl::hash<double>()(1.0) != sstl::hash<double>()(2.0));
+      REQUIRE(sstl::hash<float>()(1.0f) != sstl::hash<float>()(-1.0f));
+   }
+
+   SECTION("strings")
+   {
+      auto hasher = sstl::hash<std::string>();
+      REQUIRE(hasher(std::string("AAPL")) == hasher(std::string("AAPL")));
+      REQUIRE(hasher(std::string("AAPL")) != hasher(std::string("AAPM")));
+      REQUIRE(hasher(std::string("AAPL")) == sstl::hash_bytes("AAPL", 4));
+      REQUIRE(sstl::hash_bytes("AAPL", 4) != sstl::hash_bytes("AAPL", 4, 1));
+      REQUIRE(sstl::hash<std::u16string>()(u"AAPL") != sstl::hash<std::u16string>()(u"AAPM"));
+
+      //all the lengths go through different code paths
+      auto hashes = std::set<size_t>{};
+      auto text = std::string{};
+      for(size_t size=0; size<=200; ++size)
+      {
+         hashes.insert(hasher(text));
+         text.push_back('a');
+      }
+      REQUIRE(hashes.size() == 201);
+   }
+
+   SECTION("each bit of a string changes about half of the bits of its hash")
+   {
+      for(size_t size : { 3, 8, 13, 16, 40, 100 })
+      {
+         auto text = std::string(size, 'x');
+         auto hash = sstl::hash<std::string>()(text);
+         size_t changed_bits = 0;
+         for(size_t bit=0; bit<size*8; ++bit)
+         {
+            auto flipped = text;
+            flipped[bit / 8] = static_cast<char>(flipped[bit / 8] ^ (1 << (bit % 8)));
+            auto flipped_hash = sstl::hash<std::string>()(flipped);
+            REQUIRE(flipped_hash != hash);
+            changed_bits += count_different_bits(hash, flipped_hash);
+         }
+         auto average = static_cast<double>(changed_bits) / static_cast<double>(size * 8);
+         REQUIRE(average > sizeof(size_t) * 8 * 0.4);
+         REQUIRE(average < sizeof(size_t) * 8 * 0.6);
+      }
+   }
+
+   SECTION("composite keys")
+   {
+      auto hasher = sstl::hash<std::pair<int, int>>();
+      REQUIRE(hasher(std::make_pair(1, 2)) != hasher(std::make_pair(2, 1)));
+      REQUIRE(hasher(std::make_pair(0, 0)) != hasher(std::make_pair(0, 1)));
+   }
+
+   SECTION("user specialization as hash of a table")
+   {
+      sstl::unordered_set<point, 100> s;
+      for(int i=0; i<10; ++i)
+      {
+         for(int j=0; j<10; ++j)
+         {
+            s.insert(point{ i, j });
+         }
+      }
+      REQUIRE(s.full());
+      REQUIRE(s.count(point{ 3, 7 }) == 1);
+      REQUIRE(s.count(point{ 7, 30 }) == 0);
+   }
+}
+}
@@ -0,0 +1,269 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <map>
+#include <algorithm>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <sstl/__internal/_except.h>
+#include <sstl/indexed_priority_queue.h>
+
+#include "counted_type.h"
+
+namespace sstl_test
+{
+using indexed_priority_queue_counted_type_t = sstl::indexed_priority_queue<counted_type, 10>;
+
+namespace
+{
+template<class TIndexedPriorityQueue>
+std::vector<int> pop_all(TIndexedPriorityQueue& q)
+{
+   auto values = std::vector<int>{};
+   while(!q.empty())
+   {
+      values.push_back(q.top());
+      q.pop();
+   }
+   return values;
+}
+}
+
+TEST_CASE("indexed_priority_queue")
+{
+   SECTION("push + pop")
+   {
+      sstl::indexed_priority_queue<int, 10> q;
+      REQUIRE(q.empty());
+      REQUIRE(q.capacity() == 10);
+      for(auto value : {3, 7, 1, 9, 5})
+      {
+         q.push(value);
+      }
+      REQUIRE(q.size() == 5);
+      REQUIRE(q.top() == 9);
+      REQUIRE(pop_all(q) == (std::vector<int>{9, 7, 5, 3, 1}));
+   }
+
+   SECTION("compare")
+   {
+      sstl::indexed_priority_queue<int, 10, std::greater<int>> q;
+      for(auto value : {3, 7, 1, 9, 5})
+      {
+         q.push(value);
+      }
+      REQUIRE(pop_all(q) == (std::vector<int>{1, 3, 5, 7, 9}));
+   }
+
+   SECTION("handles are stable")
+   {
+      sstl::indexed_priority_queue<int, 10> q;
+      auto handles = std::vector<sstl::indexed_priority_queue<int, 10>::handle>{};
+      for(int value=0; value<10; ++value)
+      {
+         handles.push_back(q.push(value));
+      }
+      REQUIRE(q.full());
+      REQUIRE(q.top_handle() == handles[9]);
+      for(int value=0; value<10; ++value)
+      {
+         REQUIRE(q.contains(handles[value]));
+         REQUIRE(q[handles[value]] == value);
+      }
+      q.pop();
+      REQUIRE(!q.contains(handles[9]));
+      for(int value=0; value<9; ++value)
+      {
+         REQUIRE(q[handles[value]] == value);
+      }
+   }
+
+   SECTION("update")
+   {
+      sstl::indexed_priority_queue<int, 10> q;
+      auto h1 = q.push(1);
+      auto h5 = q.push(5);
+      auto h3 = q.push(3);
+
+      //increase priority
+      q.update(h1, 10);
+      REQUIRE(q.top_handle() == h1);
+      REQUIRE(q.top() == 10);
+
+      //decrease priority
+      q.update(h1, 0);
+      REQUIRE(q.top_handle() == h5);
+
+      //modification through operator[]
+      q[h3] = 6;
+      q.update(h3);
+      REQUIRE(q.top_handle() == h3);
+
+      REQUIRE(pop_all(q) == (std::vector<int>{6, 5, 0}));
+   }
+
+   SECTION("erase")
+   {
+      sstl::indexed_priority_queue<int, 20> q;
+      auto handles = std::vector<sstl::indexed_priority_queue<int, 20>::handle>{};
+      for(int value=0; value<20; ++value)
+      {
+         handles.push_back(q.push((value * 7) % 20));
+      }
+      for(int i=0; i<20; i+=3)
+      {
+         q.erase(handles[i]);
+         REQUIRE(!q.contains(handles[i]));
+      }
+      auto expected = std::vector<int>{};
+      for(int value=0; value<20; ++value)
+      {
+         if(value % 3 != 0)
+            expected.push_back((value * 7) % 20);
+      }
+      std::sort(expected.begin(), expected.end(), std::greater<int>{});
+      REQUIRE(pop_all(q) == expected);
+   }
+
+   SECTION("released handles are reused")
+   {
+      sstl::indexed_priority_queue<int, 2> q;
+      auto h0 = q.push(0);
+      auto h1 = q.push(1);
+      q.erase(h0);
+      auto h2 = q.push(2);
+      REQUIRE(h2 == h0);
+      REQUIRE(q.contains(h1));
+      REQUIRE(q[h2] == 2);
+   }
+
+   SECTION("pop_top with move-only values")
+   {
+      auto less = [](const std::unique_ptr<int>& lhs, const std::unique_ptr<int>& rhs) { return *lhs < *rhs; };
+      sstl::indexed_priority_queue<std::unique_ptr<int>, 4, decltype(less)> q(less);
+      q.emplace(new int(1));
+      auto h = q.push(std::unique_ptr<int>(new int(2)));
+      q.update(h, std::unique_ptr<int>(new int(0)));
+      REQUIRE(*q.pop_top() == 1);
+      REQUIRE(*q.pop_top() == 0);
+      REQUIRE(q.empty());
+   }
+
+   SECTION("copy and move keep the handles")
+   {
+      indexed_priority_queue_counted_type_t q;
+      auto h0 = q.push(counted_type(0));
+      auto h1 = q.push(counted_type(1));
+      auto h2 = q.push(counted_type(2));
+      q.erase(h1);
+
+      counted_type::reset_counts();
+      auto copy = q;
+      REQUIRE(counted_type::check().copy_constructions(2));
+      REQUIRE(copy.size() == 2);
+      REQUIRE(copy[h0].member == 0);
+      REQUIRE(copy[h2].member == 2);
+      REQUIRE(!copy.contains(h1));
+
+      counted_type::reset_counts();
+      auto moved = std::move(copy);
+      REQUIRE(counted_type::check().move_constructions(2).destructions(2));
+      REQUIRE(copy.empty());
+      REQUIRE(moved[h0].member == 0);
+      REQUIRE(moved[h2].member == 2);
+   }
+
+   SECTION("values are destroyed")
+   {
+      counted_type::reset_counts();
+      {
+         indexed_priority_queue_counted_type_t q;
+         for(size_t i=0; i<5; ++i)
+         {
+            q.emplace(i);
+         }
+         q.pop();
+      }
+      REQUIRE(counted_type::check().parameter_constructions(5).destructions(5));
+   }
+
+   #if _sstl_has_exceptions()
+   SECTION("copy construction throws")
+   {
+      indexed_priority_queue_counted_type_t q;
+      for(size_t i=0; i<5; ++i)
+      {
+         q.emplace(i);
+      }
+      counted_type::reset_counts();
+      counted_type::throw_at_nth_copy_construction(3);
+      REQUIRE_THROWS_AS(indexed_priority_queue_counted_type_t{q}, counted_type::copy_construction::exception);
+      REQUIRE(counted_type::check().copy_constructions(2).destructions(2));
+   }
+   #endif
+
+   SECTION("random operations against std::multimap")
+   {
+      using queue_type = sstl::indexed_priority_queue<int, 64, std::less<int>, 3>;
+      queue_type q;
+      auto reference = std::multimap<int, queue_type::handle, std::greater<int>>{};
+      auto handles = std::vector<queue_type::handle>{};
+      unsigned seed = 1;
+      auto next = [&seed]() { seed = seed * 1103515245 + 12345; return static_cast<int>((seed >> 16) % 100); };
+      auto find_in_reference = [&reference](queue_type::handle h)
+      {
+         auto it = reference.begin();
+         while(it->second != h)
+            ++it;
+         return it;
+      };
+
+      for(int i=0; i<5000; ++i)
+      {
+         auto operation = next() % 4;
+         if(operation == 0 && !q.full())
+         {
+            auto value = next();
+            auto h = q.push(value);
+            reference.emplace(value, h);
+            handles.push_back(h);
+         }
+         else if(operation == 1 && !q.empty())
+         {
+            REQUIRE(q.top() == reference.begin()->first);
+            auto h = q.top_handle();
+            reference.erase(find_in_reference(h));
+            handles.erase(std::find(handles.begin(), handles.end(), h));
+            q.pop();
+         }
+         else if(operation == 2 && !handles.empty())
+         {
+            auto h = handles[next() % handles.size()];
+            auto value = next();
+            reference.erase(find_in_reference(h));
+            reference.emplace(value, h);
+            q.update(h, value);
+         }
+         else if(operation == 3 && !handles.empty())
+         {
+            auto idx = next() % handles.size();
+            auto h = handles[idx];
+            reference.erase(find_in_reference(h));
+            handles.erase(handles.begin() + idx);
+            q.erase(h);
+         }
+         REQUIRE(q.size() == reference.size());
+         if(!q.empty())
+         {
+            REQUIRE(q.top() == reference.begin()->first);
+         }
+      }
+   }
+}
+}
@@ -36,6 +36,7 @@ SOFTWARE.
 #include <vector>
 
 #include <sstl/map.h>
+#include "counted_type.h"
 
 static const size_t SIZE = 10;
 
@@ -872,5 +873,305 @@ namespace sstl_test
 #endif
     }
 
+    //*************************************************************************
+    TEST(test_iterate_after_erase_insert)
+    {
+      sstl::map<int, int, 128> data;
+      std::map<int, int> compare_data;
+
+      unsigned seed = 11;
+      for (int i = 0; i < 4000; ++i)
+      {
+        seed = seed * 1103515245 + 12345;
+        int key = (seed >> 16) % 200;
+        if (data.erase(key) == 0 && !data.full())
+        {
+          data.insert(std::make_pair(key, i));
+          compare_data.insert(std::make_pair(key, i));
+        }
+        else
+        {
+          compare_data.erase(key);
+        }
+
+        CHECK(std::equal(compare_data.begin(), compare_data.end(), data.begin()));
+        CHECK(std::equal(compare_data.rbegin(), compare_data.rend(), data.rbegin()));
+      }
+    }
+
+    //*************************************************************************
+    TEST_FIXTURE(SetupFixture, test_for_each)
+    {
+      Compare_Data compare_data(initial_data.begin(), initial_data.end());
+      Data data(initial_data.begin(), initial_data.end());
+
+      data.for_each([](Data::value_type& value) { value.second *= 2; });
+      for (Compare_Data::iterator i = compare_data.begin(); i != compare_data.end(); ++i)
+      {
+        i->second *= 2;
+      }
+
+      std::vector<Compare_Data::value_type> visited;
+      const Data& const_data = data;
+      const_data.for_each([&visited](const Data::value_type& value) { visited.push_back(value); });
+
+      CHECK_EQUAL(compare_data.size(), visited.size());
+      CHECK(std::equal(compare_data.begin(), compare_data.end(), visited.begin()));
+    }
+
+    //*************************************************************************
+    TEST(test_insert_rvalue_and_emplace)
+    {
+      typedef sstl_test::counted_type counted_type;
+      typedef sstl::map<int, counted_type, 4> Counted_Data;
+      Counted_Data data;
+
+      Counted_Data::value_type value(1, counted_type(1));
+      counted_type::reset_counts();
+      CHECK(data.insert(std::move(value)).second);
+      CHECK(counted_type::check().move_constructions(1).destructions(0));
+
+      // Nothing is moved if the key exists
+      counted_type::reset_counts();
+      CHECK(!data.insert(std::make_pair(1, counted_type(2))).second);
+      CHECK_EQUAL(1U, data.at(1).member);
+
+      counted_type::reset_counts();
+      std::pair<Counted_Data::iterator, bool> result = data.emplace(std::piecewise_construct,
+                                                                    std::forward_as_tuple(2),
+                                                                    std::forward_as_tuple(20));
+      CHECK(result.second);
+      CHECK_EQUAL(20U, result.first->second.member);
+      CHECK(counted_type::check().parameter_constructions(1).destructions(0));
+
+      CHECK_EQUAL(2U, data.size());
+    }
+
+    //*************************************************************************
+    TEST(test_try_emplace)
+    {
+      typedef sstl_test::counted_type counted_type;
+      typedef sstl::map<std::string, counted_type, 4> Counted_Data;
+      Counted_Data data;
+
+      counted_type::reset_counts();
+      std::pair<Counted_Data::iterator, bool> result = data.try_emplace("one", 1);
+      CHECK(result.second);
+      CHECK_EQUAL(1U, result.first->second.member);
+      CHECK(counted_type::check().parameter_constructions(1).destructions(0));
+
+      // Nothing is constructed if the key exists
+      counted_type::reset_counts();
+      result = data.try_emplace("one", 2);
+      CHECK(!result.second);
+      CHECK_EQUAL(1U, result.first->second.member);
+      CHECK(counted_type::check().constructions(0).destructions(0));
+
+      std::string key("a key too long for the small string optimization");
+      CHECK(data.try_emplace(std::move(key), 3).second);
+      CHECK_EQUAL(3U, data.at("a key too long for the small string optimization").member);
+
+      counted_type::reset_counts();
+      data["two"];
+      CHECK(counted_type::check().default_constructions(1).destructions(0));
+      CHECK_EQUAL(3U, data.size());
+    }
+
+    //*************************************************************************
+    TEST(test_insert_or_assign)
+    {
+      typedef sstl_test::counted_type counted_type;
+      typedef sstl::map<int, counted_type, 4> Counted_Data;
+      Counted_Data data;
+
+      counted_type::reset_counts();
+      CHECK(data.insert_or_assign(1, counted_type(1)).second);
+      CHECK(counted_type::check().parameter_constructions(1).move_constructions(1).move_assignments(0));
+
+      counted_type::reset_counts();
+      std::pair<Counted_Data::iterator, bool> result = data.insert_or_assign(1, counted_type(2));
+      CHECK(!result.second);
+      CHECK_EQUAL(2U, result.first->second.member);
+      CHECK(counted_type::check().parameter_constructions(1).move_assignments(1));
+      CHECK_EQUAL(1U, data.size());
+    }
+
+    //*************************************************************************
+    TEST(test_extract_and_insert_node)
+    {
+      typedef sstl_test::counted_type counted_type;
+      typedef sstl::map<int, counted_type, 4> Counted_Data;
+      Counted_Data data;
+      data.try_emplace(1, 10);
+      data.try_emplace(2, 20);
+      data.try_emplace(3, 30);
+
+      // Re-key an element without copying it
+      counted_type::reset_counts();
+      Counted_Data::node_type node = data.extract(2);
+      CHECK(!node.empty());
+      CHECK_EQUAL(2, node.key());
+      CHECK_EQUAL(20U, node.mapped().member);
+      CHECK_EQUAL(2U, data.size());
+      CHECK_EQUAL(1U, data.available());
+      CHECK(data.find(2) == data.end());
+
+      node.key() = 5;
+      Counted_Data::insert_return_type result = data.insert(std::move(node));
+      CHECK(result.inserted);
+      CHECK(result.node.empty());
+      CHECK(node.empty());
+      CHECK_EQUAL(5, result.position->first);
+      CHECK_EQUAL(20U, data.at(5).member);
+      CHECK_EQUAL(3U, data.size());
+      CHECK_EQUAL(1U, data.available());
+      CHECK(counted_type::check().constructions(0).destructions(0));
+
+      // A node whose key is in the map is given back
+      node = data.extract(data.find(1));
+      node.key() = 3;
+      result = data.insert(std::move(node));
+      CHECK(!result.inserted);
+      CHECK(!result.node.empty());
+      CHECK_EQUAL(3, result.position->first);
+      CHECK_EQUAL(30U, result.position->second.member);
+      CHECK_EQUAL(2U, data.size());
+      CHECK_EQUAL(1U, data.available());
+
+      // Destroying the node gives its block back to the pool
+      result.node = Counted_Data::node_type();
+      CHECK(counted_type::check().constructions(0).destructions(1));
+      CHECK_EQUAL(2U, data.available());
+
+      CHECK(data.extract(42).empty());
+      CHECK(!data.insert(Counted_Data::node_type()).inserted);
+    }
+
+    //*************************************************************************
+    TEST(test_insert_node_from_other_map)
+    {
+      typedef sstl_test::counted_type counted_type;
+      sstl::map<int, counted_type, 4> data;
+      sstl::map<int, counted_type, 8> other;
+      data.try_emplace(1, 10);
+      other.try_emplace(2, 20);
+
+      // The element is moved into the pool of the other map
+      counted_type::reset_counts();
+      CHECK(other.insert(data.extract(1)).inserted);
+      CHECK(counted_type::check().move_constructions(1).destructions(1));
+      CHECK(data.empty());
+      CHECK_EQUAL(4U, data.available());
+      CHECK_EQUAL(2U, other.size());
+      CHECK_EQUAL(10U, other.at(1).member);
+    }
+
+    //*************************************************************************
+    TEST(test_transparent_lookup)
+    {
+      // Compares the elements with the plain values of their member
+      struct Member_Compare
+      {
+        typedef void is_transparent;
+
+        bool operator()(const sstl_test::counted_type& lhs, const sstl_test::counted_type& rhs) const
+        {
+          return lhs.member < rhs.member;
+        }
+        bool operator()(const sstl_test::counted_type& lhs, size_t rhs) const
+        {
+          return lhs.member < rhs;
+        }
+        bool operator()(size_t lhs, const sstl_test::counted_type& rhs) const
+        {
+          return lhs < rhs.member;
+        }
+      };
+
+      typedef sstl::map<sstl_test::counted_type, int, 8, Member_Compare> Counted_Data;
+      typedef sstl_test::counted_type counted_type;
+      Counted_Data data;
+      data.emplace(1, 10);
+      data.emplace(3, 30);
+      data.emplace(5, 50);
+      const Counted_Data& const_data = data;
+
+      counted_type::reset_counts();
+      CHECK_EQUAL(30, data.find(size_t(3))->second);
+      CHECK(const_data.find(size_t(4)) == const_data.end());
+      CHECK_EQUAL(1U, data.count(size_t(5)));
+      CHECK_EQUAL(0U, data.count(size_t(2)));
+      CHECK_EQUAL(30, data.lower_bound(size_t(2))->second);
+      CHECK_EQUAL(50, const_data.upper_bound(size_t(3))->second);
+      std::pair<Counted_Data::iterator, Counted_Data::iterator> range = data.equal_range(size_t(3));
+      CHECK_EQUAL(1, std::distance(range.first, range.second));
+      CHECK(counted_type::check().constructions(0));
+    }
+
+    //*************************************************************************
+    TEST_FIXTURE(SetupFixture, test_assign_sorted)
+    {
+      for (size_t size = 0; size <= initial_data.size(); ++size)
+      {
+        Compare_Data compare_data(initial_data.begin(), std::next(initial_data.begin(), size));
+        Data data(initial_data.begin(), initial_data.end());
+        data.assign_sorted(compare_data.begin(), compare_data.end());
+
+        CHECK_EQUAL(compare_data.size(), data.size());
+        CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+
+        // The tree is rebalanced as usual by the following erases and inserts
+        while (!compare_data.empty())
+        {
+          size_t middle = compare_data.size() / 2;
+          data.erase(std::next(data.begin(), middle));
+          compare_data.erase(std::next(compare_data.begin(), middle));
+          CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+        }
+        data.insert(initial_data.begin(), initial_data.end());
+        compare_data.insert(initial_data.begin(), initial_data.end());
+        CHECK_EQUAL(compare_data.size(), data.size());
+        CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+      }
+    }
+
+    //*************************************************************************
+    TEST_FIXTURE(SetupFixture, test_insert_with_hint)
+    {
+      Compare_Data compare_data(initial_data.begin(), initial_data.end());
+
+      // Appended in order at end()
+      Data data;
+      for (Compare_Data::const_iterator i = compare_data.begin(); i != compare_data.end(); ++i)
+      {
+        Data::iterator position = data.insert(data.cend(), *i);
+        CHECK(*position == *i);
+      }
+      CHECK_EQUAL(compare_data.size(), data.size());
+      CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+
+      // Inserted in reverse order, each one before the previous one
+      Data reversed;
+      Data::iterator position = reversed.end();
+      for (Compare_Data::const_reverse_iterator i = compare_data.rbegin(); i != compare_data.rend(); ++i)
+      {
+        position = reversed.insert(position, *i);
+      }
+      CHECK(std::equal(reversed.begin(), reversed.end(), compare_data.begin()));
+
+      // The hints that aren't next to the insertion point are ignored
+      Data misplaced;
+      for (Compare_Data::const_iterator i = compare_data.begin(); i != compare_data.end(); ++i)
+      {
+        misplaced.insert(misplaced.begin(), *i);
+      }
+      CHECK(std::equal(misplaced.begin(), misplaced.end(), compare_data.begin()));
+
+      // A key already in the map is found at the hint
+      Data::iterator existing = std::next(data.begin(), 3);
+      CHECK(data.insert(existing, *existing) == existing);
+      CHECK(data.insert(std::next(existing), *existing) == existing);
+      CHECK_EQUAL(compare_data.size(), data.size());
+    }
   };
 }
@@ -0,0 +1,186 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <set>
+#include <iterator>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <sstl/minmax_heap.h>
+
+namespace sstl_test
+{
+TEST_CASE("minmax_heap")
+{
+   SECTION("push + min + max")
+   {
+      sstl::minmax_heap<int, 10> h;
+      REQUIRE(h.empty());
+      REQUIRE(h.capacity() == 10);
+      h.push(5);
+      REQUIRE(h.min() == 5);
+      REQUIRE(h.max() == 5);
+      h.push(3);
+      h.emplace(8);
+      h.push(1);
+      h.push(9);
+      REQUIRE(h.size() == 5);
+      REQUIRE(h.min() == 1);
+      REQUIRE(h.max() == 9);
+   }
+
+   SECTION("pop_min + pop_max")
+   {
+      sstl::minmax_heap<int, 10> h;
+      for(auto value : {4, 9, 0, 6, 2, 8, 1, 7, 3, 5})
+      {
+         h.push(value);
+      }
+      REQUIRE(h.full());
+      for(int i=0; i<5; ++i)
+      {
+         REQUIRE(h.min() == i);
+         REQUIRE(h.max() == 9-i);
+         h.pop_min();
+         h.pop_max();
+      }
+      REQUIRE(h.empty());
+   }
+
+   SECTION("range constructor")
+   {
+      auto values = std::vector<int>{4, 9, 0, 6, 2, 8, 1, 7, 3, 5, 4};
+      sstl::minmax_heap<int, 20> h(values.cbegin(), values.cend());
+      auto popped = std::vector<int>{};
+      while(!h.empty())
+      {
+         popped.push_back(h.min());
+         h.pop_min();
+      }
+      REQUIRE(popped == (std::vector<int>{0, 1, 2, 3, 4, 4, 5, 6, 7, 8, 9}));
+   }
+
+   SECTION("compare")
+   {
+      sstl::minmax_heap<int, 10, std::greater<int>> h;
+      for(auto value : {3, 1, 2})
+      {
+         h.push(value);
+      }
+      REQUIRE(h.min() == 3);
+      REQUIRE(h.max() == 1);
+   }
+
+   SECTION("replace_min + replace_max")
+   {
+      sstl::minmax_heap<int, 10> h;
+      for(auto value : {4, 9, 0, 6, 2, 8})
+      {
+         h.push(value);
+      }
+      h.replace_min(10);
+      REQUIRE(h.min() == 2);
+      REQUIRE(h.max() == 10);
+      h.replace_max(-1);
+      REQUIRE(h.min() == -1);
+      REQUIRE(h.max() == 9);
+      h.replace_max(5);
+      REQUIRE(h.max() == 8);
+      REQUIRE(h.size() == 6);
+   }
+
+   SECTION("keep the largest/smallest values")
+   {
+      auto values = std::vector<int>{};
+      for(int i=0; i<1000; ++i)
+      {
+         values.push_back((i * 7919) % 1000);
+      }
+      sstl::minmax_heap<int, 10> largest;
+      sstl::minmax_heap<int, 10> smallest;
+      for(auto value : values)
+      {
+         largest.push_keep_largest(value);
+         smallest.push_keep_smallest(value);
+      }
+      REQUIRE(largest.size() == 10);
+      REQUIRE(largest.min() == 990);
+      REQUIRE(largest.max() == 999);
+      REQUIRE(!largest.push_keep_largest(990));
+      REQUIRE(smallest.min() == 0);
+      REQUIRE(smallest.max() == 9);
+      REQUIRE(!smallest.push_keep_smallest(9));
+      REQUIRE(smallest.push_keep_smallest(-1));
+      REQUIRE(smallest.max() == 8);
+   }
+
+   SECTION("random operations against std::multiset")
+   {
+      sstl::minmax_heap<int, 100> h;
+      auto reference = std::multiset<int>{};
+      unsigned seed = 3;
+      auto next = [&seed]() { seed = seed * 1103515245 + 12345; return static_cast<int>((seed >> 16) % 1000); };
+      for(int i=0; i<20000; ++i)
+      {
+         auto operation = next() % 5;
+         if(operation <= 1 && !h.full())
+         {
+            auto value = next();
+            h.push(value);
+            reference.insert(value);
+         }
+         else if(operation == 2 && !h.empty())
+         {
+            h.pop_min();
+            reference.erase(reference.begin());
+         }
+         else if(operation == 3 && !h.empty())
+         {
+            h.pop_max();
+            reference.erase(std::prev(reference.end()));
+         }
+         else if(operation == 4 && !h.empty())
+         {
+            auto value = next();
+            if(value % 2 == 0)
+            {
+               h.replace_min(value);
+               reference.erase(reference.begin());
+            }
+            else
+            {
+               h.replace_max(value);
+               reference.erase(std::prev(reference.end()));
+            }
+            reference.insert(value);
+         }
+         REQUIRE(h.size() == reference.size());
+         if(!h.empty())
+         {
+            REQUIRE(h.min() == *reference.begin());
+            REQUIRE(h.max() == *reference.rbegin());
+         }
+      }
+   }
+
+   SECTION("move-only values")
+   {
+      auto less = [](const std::unique_ptr<int>& lhs, const std::unique_ptr<int>& rhs) { return *lhs < *rhs; };
+      sstl::minmax_heap<std::unique_ptr<int>, 10, decltype(less)> h(less);
+      for(auto value : {3, 1, 4, 1, 5, 9, 2})
+      {
+         h.push(std::unique_ptr<int>(new int(value)));
+      }
+      h.pop_min();
+      h.pop_max();
+      h.replace_min(std::unique_ptr<int>(new int(6)));
+      REQUIRE(*h.min() == 2);
+      REQUIRE(*h.max() == 6);
+   }
+}
+}
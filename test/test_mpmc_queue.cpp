@@ -0,0 +1,179 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <cstdint>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <sstl/mpmc_queue.h>
+
+namespace sstl_test
+{
+namespace
+{
+struct nothrow_counted_type
+{
+   nothrow_counted_type(int value = 0) noexcept : value(value) { ++instances; }
+   nothrow_counted_type(const nothrow_counted_type& rhs) noexcept : value(rhs.value) { ++instances; }
+   nothrow_counted_type(nothrow_counted_type&& rhs) noexcept : value(rhs.value) { ++instances; }
+   nothrow_counted_type& operator=(const nothrow_counted_type&) noexcept = default;
+   nothrow_counted_type& operator=(nothrow_counted_type&&) noexcept = default;
+   ~nothrow_counted_type() { --instances; }
+
+   int value;
+   static int instances;
+};
+
+int nothrow_counted_type::instances = 0;
+}
+
+TEST_CASE("mpmc_queue")
+{
+   SECTION("try_push + try_pop")
+   {
+      sstl::mpmc_queue<int, 4> q;
+      REQUIRE(q.empty());
+      REQUIRE(q.capacity() == 4);
+      for(int i=0; i<4; ++i)
+      {
+         REQUIRE(q.try_push(i));
+      }
+      REQUIRE(!q.try_push(4));
+      REQUIRE(q.size() == 4);
+      int value;
+      for(int lap=0; lap<3; ++lap)
+      {
+         for(int i=0; i<4; ++i)
+         {
+            REQUIRE(q.try_pop(value));
+            REQUIRE(value == lap*4+i);
+            REQUIRE(q.try_emplace(lap*4+i+4));
+         }
+      }
+      REQUIRE(q.size() == 4);
+   }
+
+   SECTION("blocking push + pop")
+   {
+      sstl::mpmc_queue<int, 2> q;
+      q.push(0);
+      q.emplace(1);
+      int value;
+      q.pop(value);
+      REQUIRE(value == 0);
+      q.pop(value);
+      REQUIRE(value == 1);
+      int empty_value = -1;
+      REQUIRE(!q.try_pop(empty_value));
+      REQUIRE(empty_value == -1);
+   }
+
+   SECTION("contained values are destroyed")
+   {
+      nothrow_counted_type::instances = 0;
+      {
+         sstl::mpmc_queue<nothrow_counted_type, 8> q;
+         for(int i=0; i<8; ++i)
+         {
+            q.push(nothrow_counted_type(i));
+         }
+         nothrow_counted_type value;
+         q.pop(value);
+         q.pop(value);
+         REQUIRE(nothrow_counted_type::instances == 6+1);
+      }
+      REQUIRE(nothrow_counted_type::instances == 0);
+   }
+
+   SECTION("move-only values")
+   {
+      sstl::mpmc_queue<std::unique_ptr<int>, 2> q;
+      q.push(std::unique_ptr<int>(new int(3)));
+      auto value = std::unique_ptr<int>{};
+      REQUIRE(q.try_pop(value));
+      REQUIRE(*value == 3);
+   }
+
+   SECTION("multiple producer threads + multiple consumer threads (stress test)")
+   {
+      //every value is popped exactly once and the values of any single producer
+      //are popped by every single consumer in the order in which they were pushed
+      static const uint64_t number_of_producers = 4;
+      static const uint64_t number_of_consumers = 4;
+      static const uint64_t values_per_producer = 20000;
+      static const uint64_t number_of_values = number_of_producers * values_per_producer;
+
+      sstl::mpmc_queue<uint64_t, 64> q;
+      std::atomic<uint64_t> popped_values{ 0 };
+      std::vector<std::vector<uint64_t>> received(number_of_consumers);
+      std::vector<std::thread> threads;
+
+      for(uint64_t producer=0; producer<number_of_producers; ++producer)
+      {
+         threads.emplace_back([&q, producer]()
+         {
+            for(uint64_t i=0; i<values_per_producer; ++i)
+            {
+               auto value = (producer << 32) | i;
+               if(i % 2 == 0)
+               {
+                  q.push(value);
+               }
+               else
+               {
+                  while(!q.try_push(value))
+                     std::this_thread::yield();
+               }
+            }
+         });
+      }
+      for(uint64_t consumer=0; consumer<number_of_consumers; ++consumer)
+      {
+         threads.emplace_back([&q, &popped_values, &received, consumer]()
+         {
+            uint64_t value;
+            while(popped_values.load() < number_of_values)
+            {
+               if(q.try_pop(value))
+               {
+                  received[consumer].push_back(value);
+                  ++popped_values;
+               }
+               else
+               {
+                  std::this_thread::yield();
+               }
+            }
+         });
+      }
+      for(auto& thread : threads)
+      {
+         thread.join();
+      }
+
+      auto occurrences = std::vector<unsigned>(number_of_values, 0);
+      bool per_producer_order_is_preserved = true;
+      for(auto& values : received)
+      {
+         auto last_seen = std::vector<int64_t>(number_of_producers, -1);
+         for(auto value : values)
+         {
+            auto producer = value >> 32;
+            auto sequence = static_cast<int64_t>(value & 0xffffffff);
+            per_producer_order_is_preserved = per_producer_order_is_preserved && sequence > last_seen[producer];
+            last_seen[producer] = sequence;
+            ++occurrences[producer*values_per_producer + sequence];
+         }
+      }
+      REQUIRE(per_producer_order_is_preserved);
+      REQUIRE(std::all_of(occurrences.cbegin(), occurrences.cend(), [](unsigned count){ return count == 1; }));
+      REQUIRE(q.empty());
+   }
+}
+}
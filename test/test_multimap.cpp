@@ -35,6 +35,7 @@ SOFTWARE.
 #include <string>
 
 #include <sstl/multimap.h>
+#include "counted_type.h"
 
 static const size_t SIZE = 10;
 
@@ -914,5 +915,209 @@ namespace test_sstl
 #endif
     }
 
+    //*************************************************************************
+    TEST(test_erase_insert_many_duplicates)
+    {
+      sstl::multimap<int, int, 64> data;
+      std::multimap<int, int> compare_data;
+      for (int i = 0; i < 56; ++i)
+      {
+        data.insert(std::make_pair(i % 16, i));
+        compare_data.insert(std::make_pair(i % 16, i));
+      }
+
+      unsigned seed = 7;
+      for (int i = 0; i < 5000; ++i)
+      {
+        seed = seed * 1103515245 + 12345;
+        int key = (seed >> 16) % 16;
+        int key2 = (seed >> 20) % 16;
+        if (data.find(key) != data.end())
+        {
+          data.erase(data.find(key));
+          compare_data.erase(compare_data.find(key));
+          data.insert(std::make_pair(key2, i));
+          compare_data.insert(std::make_pair(key2, i));
+        }
+        CHECK_EQUAL(compare_data.size(), data.size());
+        CHECK_EQUAL(compare_data.size(), size_t(std::distance(data.begin(), data.end())));
+        CHECK_EQUAL(compare_data.count(key), data.count(key));
+      }
+    }
+
+    //*************************************************************************
+    TEST_FIXTURE(SetupFixture, test_for_each)
+    {
+      Compare_Data compare_data(initial_data.begin(), initial_data.end());
+      Data data(initial_data.begin(), initial_data.end());
+
+      data.for_each([](Data::value_type& value) { value.second += 1; });
+      for (Compare_Data::iterator i = compare_data.begin(); i != compare_data.end(); ++i)
+      {
+        i->second += 1;
+      }
+
+      std::vector<Compare_Data::value_type> visited;
+      const Data& const_data = data;
+      const_data.for_each([&visited](const Data::value_type& value) { visited.push_back(value); });
+
+      CHECK_EQUAL(compare_data.size(), visited.size());
+      CHECK(std::equal(compare_data.begin(), compare_data.end(), visited.begin()));
+    }
+
+    //*************************************************************************
+    TEST(test_insert_rvalue_and_emplace)
+    {
+      typedef sstl_test::counted_type counted_type;
+      typedef sstl::multimap<int, counted_type, 4> Counted_Data;
+      Counted_Data data;
+
+      counted_type::reset_counts();
+      data.insert(std::make_pair(1, counted_type(1)));
+      CHECK(counted_type::check().parameter_constructions(1).move_constructions(2).destructions(2));
+
+      Counted_Data::value_type value(1, counted_type(2));
+      counted_type::reset_counts();
+      data.insert(std::move(value));
+      CHECK(counted_type::check().move_constructions(1).destructions(0));
+
+      counted_type::reset_counts();
+      data.emplace(std::piecewise_construct, std::forward_as_tuple(2), std::forward_as_tuple(3));
+      CHECK(counted_type::check().parameter_constructions(1).destructions(0));
+
+      CHECK_EQUAL(2U, data.count(1));
+      CHECK_EQUAL(3U, data.size());
+    }
+
+    //*************************************************************************
+    TEST(test_extract_and_insert_node)
+    {
+      typedef sstl::multimap<int, std::string, 4> Node_Data;
+      Node_Data data;
+      data.insert(std::make_pair(1, std::string("a")));
+      data.insert(std::make_pair(2, std::string("b")));
+      data.insert(std::make_pair(2, std::string("c")));
+
+      Node_Data::node_type node = data.extract(2);
+      CHECK_EQUAL(2, node.key());
+      CHECK_EQUAL(std::string("b"), node.mapped());
+      CHECK_EQUAL(1U, data.count(2));
+      CHECK_EQUAL(1U, data.available());
+
+      node.key() = 1;
+      Node_Data::iterator position = data.insert(data.cend(), std::move(node));
+      CHECK_EQUAL(1, position->first);
+      CHECK_EQUAL(std::string("b"), position->second);
+      CHECK_EQUAL(2U, data.count(1));
+
+      sstl::multimap<int, std::string, 2> other;
+      other.insert(data.extract(data.find(2)));
+      CHECK_EQUAL(std::string("c"), other.find(2)->second);
+      CHECK_EQUAL(2U, data.size());
+      CHECK_EQUAL(2U, data.available());
+    }
+
+    //*************************************************************************
+    TEST(test_transparent_lookup)
+    {
+      // Compares the elements with the plain values of their member
+      struct Member_Compare
+      {
+        typedef void is_transparent;
+
+        bool operator()(const sstl_test::counted_type& lhs, const sstl_test::counted_type& rhs) const
+        {
+          return lhs.member < rhs.member;
+        }
+        bool operator()(const sstl_test::counted_type& lhs, size_t rhs) const
+        {
+          return lhs.member < rhs;
+        }
+        bool operator()(size_t lhs, const sstl_test::counted_type& rhs) const
+        {
+          return lhs < rhs.member;
+        }
+      };
+
+      typedef sstl::multimap<sstl_test::counted_type, int, 8, Member_Compare> Counted_Data;
+      typedef sstl_test::counted_type counted_type;
+      Counted_Data data;
+      data.emplace(1, 10);
+      data.emplace(3, 30);
+      data.emplace(3, 31);
+      data.emplace(5, 50);
+      const Counted_Data& const_data = data;
+
+      counted_type::reset_counts();
+      CHECK_EQUAL(3U, data.find(size_t(3))->first.member);
+      CHECK(const_data.find(size_t(4)) == const_data.end());
+      CHECK_EQUAL(2U, data.count(size_t(3)));
+      CHECK_EQUAL(0U, data.count(size_t(2)));
+      CHECK_EQUAL(30, data.lower_bound(size_t(2))->second);
+      CHECK_EQUAL(50, const_data.upper_bound(size_t(3))->second);
+      std::pair<Counted_Data::iterator, Counted_Data::iterator> range = data.equal_range(size_t(3));
+      CHECK_EQUAL(2, std::distance(range.first, range.second));
+      CHECK(counted_type::check().constructions(0));
+    }
+
+    //*************************************************************************
+    TEST_FIXTURE(SetupFixture, test_assign_sorted)
+    {
+      for (size_t size = 0; size <= initial_data.size(); ++size)
+      {
+        Compare_Data compare_data(initial_data.begin(), std::next(initial_data.begin(), size));
+        Data data(initial_data.begin(), initial_data.end());
+        data.assign_sorted(compare_data.begin(), compare_data.end());
+
+        CHECK_EQUAL(compare_data.size(), data.size());
+        CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+
+        // The tree is rebalanced as usual by the following erases and inserts
+        while (!compare_data.empty())
+        {
+          size_t middle = compare_data.size() / 2;
+          data.erase(std::next(data.begin(), middle));
+          compare_data.erase(std::next(compare_data.begin(), middle));
+          CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+        }
+        data.insert(initial_data.begin(), initial_data.end());
+        compare_data.insert(initial_data.begin(), initial_data.end());
+        CHECK_EQUAL(compare_data.size(), data.size());
+        CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+      }
+    }
+
+    //*************************************************************************
+    TEST_FIXTURE(SetupFixture, test_insert_with_hint)
+    {
+      Compare_Data compare_data(initial_data.begin(), initial_data.end());
+
+      // Appended in order at end()
+      Data data;
+      for (Compare_Data::const_iterator i = compare_data.begin(); i != compare_data.end(); ++i)
+      {
+        Data::iterator position = data.insert(data.cend(), *i);
+        CHECK(*position == *i);
+      }
+      CHECK_EQUAL(compare_data.size(), data.size());
+      CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+
+      // Inserted in reverse order, each one before the previous one
+      Data reversed;
+      Data::iterator position = reversed.end();
+      for (Compare_Data::const_reverse_iterator i = compare_data.rbegin(); i != compare_data.rend(); ++i)
+      {
+        position = reversed.insert(position, *i);
+      }
+      CHECK(std::equal(reversed.begin(), reversed.end(), compare_data.begin()));
+
+      // The hints that aren't next to the insertion point are ignored
+      Data misplaced;
+      for (Compare_Data::const_iterator i = compare_data.begin(); i != compare_data.end(); ++i)
+      {
+        misplaced.insert(misplaced.begin(), *i);
+      }
+      CHECK(std::equal(misplaced.begin(), misplaced.end(), compare_data.begin()));
+    }
   };
 }
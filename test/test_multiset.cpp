@@ -33,8 +33,10 @@ SOFTWARE.
 #include <utility>
 #include <iterator>
 #include <string>
+#include <vector>
 
 #include <sstl/multiset.h>
+#include "counted_type.h"
 
 static const size_t SIZE = 10;
 
@@ -885,5 +887,381 @@ namespace sstl_test
 #endif
     }
 
+    //*************************************************************************
+    TEST(test_erase_insert_many_duplicates)
+    {
+      sstl::multiset<int, 64> data;
+      std::multiset<int> compare_data;
+      for (int i = 0; i < 56; ++i)
+      {
+        data.insert(i % 16);
+        compare_data.insert(i % 16);
+      }
+
+      unsigned seed = 7;
+      for (int i = 0; i < 5000; ++i)
+      {
+        seed = seed * 1103515245 + 12345;
+        int key = (seed >> 16) % 16;
+        int key2 = (seed >> 20) % 16;
+        if (data.find(key) != data.end())
+        {
+          data.erase(data.find(key));
+          compare_data.erase(compare_data.find(key));
+          data.insert(key2);
+          compare_data.insert(key2);
+        }
+        CHECK_EQUAL(compare_data.size(), data.size());
+        CHECK_EQUAL(compare_data.size(), size_t(std::distance(data.begin(), data.end())));
+        CHECK_EQUAL(compare_data.count(key), data.count(key));
+      }
+    }
+
+    //*************************************************************************
+    TEST_FIXTURE(SetupFixture, test_for_each)
+    {
+      Compare_Data compare_data(initial_data.begin(), initial_data.end());
+      const Data data(initial_data.begin(), initial_data.end());
+
+      std::vector<int> visited;
+      data.for_each([&visited](int value) { visited.push_back(value); });
+
+      CHECK_EQUAL(compare_data.size(), visited.size());
+      CHECK(std::equal(compare_data.begin(), compare_data.end(), visited.begin()));
+    }
+
+    //*************************************************************************
+    TEST(test_insert_rvalue_and_emplace)
+    {
+      typedef sstl_test::counted_type counted_type;
+      sstl::multiset<counted_type, 4> data;
+
+      counted_type::reset_counts();
+      data.insert(counted_type(1));
+      CHECK(counted_type::check().parameter_constructions(1).move_constructions(1).destructions(1));
+
+      counted_type::reset_counts();
+      data.emplace(1);
+      data.emplace_hint(data.cbegin(), 2);
+      CHECK(counted_type::check().parameter_constructions(2).destructions(0));
+
+      CHECK_EQUAL(2U, data.count(counted_type(1)));
+      CHECK_EQUAL(3U, data.size());
+    }
+
+    //*************************************************************************
+    TEST(test_extract_and_insert_node)
+    {
+      sstl::multiset<int, 4> data;
+      data.insert(1);
+      data.insert(2);
+      data.insert(2);
+
+      sstl::multiset<int, 4>::node_type node = data.extract(2);
+      CHECK_EQUAL(2, node.value());
+      CHECK_EQUAL(1U, data.count(2));
+      CHECK_EQUAL(1U, data.available());
+
+      node.value() = 1;
+      CHECK_EQUAL(1, *data.insert(std::move(node)));
+      CHECK(node.empty());
+      CHECK_EQUAL(2U, data.count(1));
+      CHECK_EQUAL(1U, data.available());
+
+      sstl::multiset<int, 2> other;
+      other.insert(data.extract(data.begin()));
+      CHECK_EQUAL(1U, other.count(1));
+      CHECK_EQUAL(1U, data.count(1));
+      CHECK_EQUAL(2U, data.available());
+
+      CHECK(data.extract(42).empty());
+      CHECK(data.insert(sstl::multiset<int, 4>::node_type()) == data.end());
+    }
+
+    //*************************************************************************
+    TEST(test_transparent_lookup)
+    {
+      // Compares the elements with the plain values of their member
+      struct Member_Compare
+      {
+        typedef void is_transparent;
+
+        bool operator()(const sstl_test::counted_type& lhs, const sstl_test::counted_type& rhs) const
+        {
+          return lhs.member < rhs.member;
+        }
+        bool operator()(const sstl_test::counted_type& lhs, size_t rhs) const
+        {
+          return lhs.member < rhs;
+        }
+        bool operator()(size_t lhs, const sstl_test::counted_type& rhs) const
+        {
+          return lhs < rhs.member;
+        }
+      };
+
+      typedef sstl::multiset<sstl_test::counted_type, 8, Member_Compare> Counted_Data;
+      typedef sstl_test::counted_type counted_type;
+      Counted_Data data;
+      data.emplace(1);
+      data.emplace(3);
+      data.emplace(3);
+      data.emplace(5);
+      const Counted_Data& const_data = data;
+
+      counted_type::reset_counts();
+      CHECK_EQUAL(3U, data.find(size_t(3))->member);
+      CHECK(const_data.find(size_t(4)) == const_data.end());
+      CHECK_EQUAL(2U, data.count(size_t(3)));
+      CHECK_EQUAL(0U, data.count(size_t(2)));
+      CHECK_EQUAL(3U, data.lower_bound(size_t(2))->member);
+      CHECK_EQUAL(5U, const_data.upper_bound(size_t(3))->member);
+      std::pair<Counted_Data::const_iterator, Counted_Data::const_iterator> range = const_data.equal_range(size_t(3));
+      CHECK_EQUAL(2, std::distance(range.first, range.second));
+      CHECK(counted_type::check().constructions(0));
+    }
+
+    //*************************************************************************
+    TEST_FIXTURE(SetupFixture, test_assign_sorted)
+    {
+      for (size_t size = 0; size <= initial_data.size(); ++size)
+      {
+        Compare_Data compare_data(initial_data.begin(), std::next(initial_data.begin(), size));
+        Data data(initial_data.begin(), initial_data.end());
+        data.assign_sorted(compare_data.begin(), compare_data.end());
+
+        CHECK_EQUAL(compare_data.size(), data.size());
+        CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+
+        // The tree is rebalanced as usual by the following erases and inserts
+        while (!compare_data.empty())
+        {
+          size_t middle = compare_data.size() / 2;
+          data.erase(std::next(data.begin(), middle));
+          compare_data.erase(std::next(compare_data.begin(), middle));
+          CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+        }
+        data.insert(initial_data.begin(), initial_data.end());
+        compare_data.insert(initial_data.begin(), initial_data.end());
+        CHECK_EQUAL(compare_data.size(), data.size());
+        CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+      }
+    }
+
+    //*************************************************************************
+    TEST_FIXTURE(SetupFixture, test_insert_with_hint)
+    {
+      Compare_Data compare_data(initial_data.begin(), initial_data.end());
+
+      // Appended in order at end()
+      Data data;
+      for (Compare_Data::const_iterator i = compare_data.begin(); i != compare_data.end(); ++i)
+      {
+        Data::iterator position = data.insert(data.cend(), *i);
+        CHECK(*position == *i);
+      }
+      CHECK_EQUAL(compare_data.size(), data.size());
+      CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+
+      // Inserted in reverse order, each one before the previous one
+      Data reversed;
+      Data::iterator position = reversed.end();
+      for (Compare_Data::const_reverse_iterator i = compare_data.rbegin(); i != compare_data.rend(); ++i)
+      {
+        position = reversed.insert(position, *i);
+      }
+      CHECK(std::equal(reversed.begin(), reversed.end(), compare_data.begin()));
+
+      // The hints that aren't next to the insertion point are ignored
+      Data misplaced;
+      for (Compare_Data::const_iterator i = compare_data.begin(); i != compare_data.end(); ++i)
+      {
+        misplaced.insert(misplaced.begin(), *i);
+      }
+      CHECK(std::equal(misplaced.begin(), misplaced.end(), compare_data.begin()));
+    }
+
+    //*************************************************************************
+    TEST(test_order_statistics)
+    {
+      typedef sstl::multiset<int, 256, std::less<int>, sstl::tree_order_statistics> Ranked_Data;
+      Ranked_Data data;
+      std::multiset<int> compare_data;
+
+      // The subtree sizes are kept by every kind of insertion and erasure,
+      // with many equivalent keys
+      unsigned seed = 13;
+      for (int i = 0; i < 3000; ++i)
+      {
+        seed = seed * 1103515245 + 12345;
+        int key = int((seed >> 8) % 100);
+        switch ((seed >> 20) % 6)
+        {
+          case 0:
+          case 1:
+            if (!data.full())
+            {
+              data.insert(key);
+              compare_data.insert(key);
+            }
+            break;
+          case 2:
+            if (!data.full())
+            {
+              data.insert(data.upper_bound(key), key);
+              compare_data.insert(key);
+            }
+            break;
+          case 3:
+            CHECK_EQUAL(compare_data.erase(key), data.erase(key));
+            break;
+          case 4:
+            if (!data.empty())
+            {
+              Ranked_Data::iterator position = data.nth(size_t(key) % data.size());
+              compare_data.erase(compare_data.find(*position));
+              data.erase(position);
+            }
+            break;
+          default:
+            if (data.count(key) > 0)
+            {
+              Ranked_Data::node_type node = data.extract(key);
+              node.value() = key + 1000;
+              data.insert(std::move(node));
+              compare_data.erase(compare_data.find(key));
+              compare_data.insert(key + 1000);
+            }
+            break;
+        }
+
+        CHECK_EQUAL(compare_data.size(), data.size());
+        size_t expected_rank = std::distance(compare_data.begin(), compare_data.lower_bound(key));
+        CHECK_EQUAL(expected_rank, data.rank(key));
+        size_t expected_count = std::distance(compare_data.lower_bound(key), compare_data.lower_bound(key + 10));
+        CHECK_EQUAL(expected_count, data.count_range(key, key + 10));
+        CHECK_EQUAL(compare_data.count(key), data.count_range(key, key + 1));
+      }
+
+      size_t position = 0;
+      for (std::multiset<int>::const_iterator i = compare_data.begin(); i != compare_data.end(); ++i, ++position)
+      {
+        CHECK_EQUAL(*i, *data.nth(position));
+      }
+      CHECK(data.nth(data.size()) == data.end());
+    }
+
+    //*************************************************************************
+    TEST(test_merge)
+    {
+      typedef std::pair<int, int> Pair;
+      struct Pair_First_Less
+      {
+        bool operator()(const Pair& lhs, const Pair& rhs) const
+        {
+          return lhs.first < rhs.first;
+        }
+      };
+      typedef sstl::multiset<Pair, 8, Pair_First_Less> Pair_Data;
+      Pair_Data data;
+      Pair_Data other;
+      data.insert(Pair(1, 0));
+      data.insert(Pair(3, 0));
+      data.insert(Pair(3, 1));
+      other.insert(Pair(3, 2));
+      other.insert(Pair(0, 2));
+      other.insert(Pair(5, 2));
+
+      // The elements of the other multiset go after the equivalent ones
+      data.merge(other);
+      Pair merged[] = { Pair(0, 2), Pair(1, 0), Pair(3, 0), Pair(3, 1), Pair(3, 2), Pair(5, 2) };
+      CHECK_EQUAL(6U, data.size());
+      CHECK(std::equal(data.begin(), data.end(), std::begin(merged)));
+      CHECK(std::equal(data.rbegin(), data.rend(), std::reverse_iterator<Pair*>(std::end(merged))));
+      CHECK(other.empty());
+
+      // The elements that don't fit are left in the other multiset
+      other.insert(Pair(2, 3));
+      other.insert(Pair(4, 3));
+      other.insert(Pair(4, 4));
+      other.insert(Pair(6, 3));
+      data.merge(other);
+      CHECK_EQUAL(8U, data.size());
+      CHECK_EQUAL(1U, data.count(Pair(4, 0)));
+      CHECK_EQUAL(2U, other.size());
+      CHECK(*other.begin() == Pair(4, 4));
+      CHECK(*other.rbegin() == Pair(6, 3));
+
+      // Both trees are still valid
+      CHECK_EQUAL(3U, data.erase(Pair(3, 0)));
+      other.insert(Pair(1, 5));
+      CHECK_EQUAL(5U, data.size());
+      CHECK(*other.begin() == Pair(1, 5));
+    }
+
+    //*************************************************************************
+    TEST(test_set_operations)
+    {
+      typedef sstl::multiset<int, 512, std::less<int>, sstl::tree_order_statistics> Ranked_Data;
+      Ranked_Data first;
+      Ranked_Data second;
+      Ranked_Data result;
+      std::multiset<int> compare_first;
+      std::multiset<int> compare_second;
+
+      // Equivalent elements are matched one to one, as by the std algorithms
+      unsigned seed = 7;
+      for (int i = 0; i < 200; ++i)
+      {
+        seed = seed * 1103515245 + 12345;
+        int key = int((seed >> 8) % 60);
+        first.insert(key);
+        compare_first.insert(key);
+        seed = seed * 1103515245 + 12345;
+        key = int((seed >> 8) % 60);
+        second.insert(key);
+        compare_second.insert(key);
+      }
+
+      std::vector<int> expected;
+      std::set_union(compare_first.begin(), compare_first.end(), compare_second.begin(), compare_second.end(), std::back_inserter(expected));
+      set_union(first, second, result);
+      CHECK_EQUAL(expected.size(), result.size());
+      CHECK(std::equal(result.begin(), result.end(), expected.begin()));
+
+      expected.clear();
+      std::set_intersection(compare_first.begin(), compare_first.end(), compare_second.begin(), compare_second.end(), std::back_inserter(expected));
+      set_intersection(first, second, result);
+      CHECK_EQUAL(expected.size(), result.size());
+      CHECK(std::equal(result.begin(), result.end(), expected.begin()));
+
+      expected.clear();
+      std::set_difference(compare_first.begin(), compare_first.end(), compare_second.begin(), compare_second.end(), std::back_inserter(expected));
+      set_difference(first, second, result);
+      CHECK_EQUAL(expected.size(), result.size());
+      CHECK(std::equal(result.begin(), result.end(), expected.begin()));
+
+      expected.clear();
+      std::set_symmetric_difference(compare_first.begin(), compare_first.end(), compare_second.begin(), compare_second.end(), std::back_inserter(expected));
+      set_symmetric_difference(first, second, result);
+      CHECK_EQUAL(expected.size(), result.size());
+      CHECK(std::equal(result.begin(), result.end(), expected.begin()));
+      for (size_t i = 0; i < expected.size(); ++i)
+      {
+        CHECK_EQUAL(expected[i], *result.nth(i));
+      }
+
+      // Merging in place moves all the elements
+      compare_first.insert(compare_second.begin(), compare_second.end());
+      first.merge(second);
+      CHECK(second.empty());
+      CHECK_EQUAL(compare_first.size(), first.size());
+      CHECK(std::equal(first.begin(), first.end(), compare_first.begin()));
+      size_t position = 0;
+      for (std::multiset<int>::const_iterator i = compare_first.begin(); i != compare_first.end(); ++i, ++position)
+      {
+        CHECK_EQUAL(*i, *first.nth(position));
+      }
+    }
   };
 }
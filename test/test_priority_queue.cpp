@@ -7,11 +7,64 @@ as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
 
 #include <UnitTest++/UnitTest++.h>
 #include <functional>
+#include <algorithm>
+#include <vector>
+#include <memory>
 #include <sstl/priority_queue.h>
 #include <sstl/vector.h>
 
 namespace sstl_test
 {
+namespace
+{
+    // pseudo-random values with duplicates
+    std::vector<int> make_values(size_t count)
+    {
+        auto values = std::vector<int>{};
+        unsigned seed = 12345;
+        for(size_t i=0; i<count; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            values.push_back(static_cast<int>((seed >> 16) % 50));
+        }
+        return values;
+    }
+
+    template<class TPriorityQueue>
+    std::vector<int> pop_all(TPriorityQueue& priority_queue)
+    {
+        auto values = std::vector<int>{};
+        while(!priority_queue.empty())
+        {
+            values.push_back(priority_queue.top());
+            priority_queue.pop();
+        }
+        return values;
+    }
+
+    template<class TPriorityQueue>
+    void check_push_and_pop()
+    {
+        auto values = make_values(100);
+        auto priority_queue = TPriorityQueue{};
+        for(auto value : values)
+        {
+            priority_queue.push(value);
+        }
+        CHECK_EQUAL(priority_queue.size(), values.size());
+        std::sort(values.begin(), values.end(), std::greater<int>{});
+        CHECK(pop_all(priority_queue) == values);
+    }
+
+    struct unique_ptr_less
+    {
+        bool operator()(const std::unique_ptr<int>& lhs, const std::unique_ptr<int>& rhs) const
+        {
+            return *lhs < *rhs;
+        }
+    };
+}
+
 SUITE(test_priority_queue)
 {
     TEST(constructors_can_be_instantiated)
@@ -40,6 +93,111 @@ SUITE(test_priority_queue)
         priority_queue.empty();
         priority_queue.size();
         priority_queue.swap(priority_queue2);
+        priority_queue2.pop_top();
+        priority_queue.push(1);
+        priority_queue.replace_top(2);
+        priority_queue.pop_push(4);
+        auto values = {1, 2, 3};
+        priority_queue.push_range(values.begin(), values.end());
+        sstl::priority_queue<int, 5>(values.begin(), values.end());
+    }
+
+    TEST(push_and_pop)
+    {
+        check_push_and_pop<sstl::priority_queue<int, 100>>();
+        check_push_and_pop<sstl::priority_queue<int, 100, sstl::vector<int, 100>, std::less<int>, 2>>();
+        check_push_and_pop<sstl::priority_queue<int, 100, sstl::vector<int, 100>, std::less<int>, 3>>();
+        check_push_and_pop<sstl::priority_queue<int, 100, sstl::vector<int, 100>, std::less<int>, 8>>();
+    }
+
+    TEST(compare)
+    {
+        auto priority_queue = sstl::priority_queue<int, 10, sstl::vector<int, 10>, std::greater<int>> {};
+        for(auto value : {5, 1, 4, 2, 3})
+        {
+            priority_queue.push(value);
+        }
+        CHECK(pop_all(priority_queue) == (std::vector<int>{1, 2, 3, 4, 5}));
+    }
+
+    TEST(constructor_from_container_makes_heap)
+    {
+        auto values = make_values(50);
+        auto container = sstl::vector<int, 50>(values.cbegin(), values.cend());
+        auto priority_queue = sstl::priority_queue<int, 50>(std::less<int>{}, container);
+        std::sort(values.begin(), values.end(), std::greater<int>{});
+        CHECK(pop_all(priority_queue) == values);
+    }
+
+    TEST(push_range)
+    {
+        auto values = make_values(100);
+        //into an empty queue (heap construction)
+        {
+            auto priority_queue = sstl::priority_queue<int, 100> {};
+            priority_queue.push_range(values.cbegin(), values.cend());
+            auto expected = values;
+            std::sort(expected.begin(), expected.end(), std::greater<int>{});
+            CHECK(pop_all(priority_queue) == expected);
+        }
+        //a few values into a larger queue (sift-up)
+        {
+            auto priority_queue = sstl::priority_queue<int, 100>(values.cbegin(), values.cbegin()+90);
+            priority_queue.push_range(values.cbegin()+90, values.cend());
+            auto expected = values;
+            std::sort(expected.begin(), expected.end(), std::greater<int>{});
+            CHECK(pop_all(priority_queue) == expected);
+        }
+    }
+
+    TEST(replace_top)
+    {
+        auto priority_queue = sstl::priority_queue<int, 10> {};
+        for(auto value : {5, 1, 4, 2, 3})
+        {
+            priority_queue.push(value);
+        }
+        priority_queue.replace_top(0);
+        CHECK_EQUAL(priority_queue.top(), 4);
+        priority_queue.replace_top(10);
+        CHECK_EQUAL(priority_queue.top(), 10);
+        CHECK(pop_all(priority_queue) == (std::vector<int>{10, 3, 2, 1, 0}));
+    }
+
+    TEST(pop_push)
+    {
+        auto priority_queue = sstl::priority_queue<int, 10> {};
+        for(auto value : {5, 1, 4, 2, 3})
+        {
+            priority_queue.push(value);
+        }
+        CHECK_EQUAL(priority_queue.pop_push(0), 5);
+        CHECK_EQUAL(priority_queue.pop_push(10), 4);
+        CHECK_EQUAL(priority_queue.size(), 5u);
+        CHECK(pop_all(priority_queue) == (std::vector<int>{10, 3, 2, 1, 0}));
+    }
+
+    TEST(move_only_values)
+    {
+        auto priority_queue = sstl::priority_queue<std::unique_ptr<int>,
+                                                   10,
+                                                   sstl::vector<std::unique_ptr<int>, 10>,
+                                                   unique_ptr_less> {};
+        for(auto value : {3, 1, 2})
+        {
+            priority_queue.push(std::unique_ptr<int>(new int(value)));
+        }
+        priority_queue.emplace(new int(5));
+        auto top = priority_queue.pop_top();
+        CHECK_EQUAL(*top, 5);
+        top = priority_queue.pop_push(std::unique_ptr<int>(new int(0)));
+        CHECK_EQUAL(*top, 3);
+        priority_queue.replace_top(new int(4));
+        CHECK_EQUAL(*priority_queue.top(), 4);
+        priority_queue.pop();
+        CHECK_EQUAL(*priority_queue.pop_top(), 1);
+        CHECK_EQUAL(*priority_queue.pop_top(), 0);
+        CHECK(priority_queue.empty());
     }
 };
 }
@@ -0,0 +1,149 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <queue>
+#include <functional>
+#include <sstl/__internal/_except.h>
+#include <sstl/__internal/_bit_width.h>
+#include <sstl/radix_heap.h>
+
+#include "counted_type.h"
+
+namespace sstl_test
+{
+using radix_heap_counted_type_t = sstl::radix_heap<uint32_t, counted_type, 10>;
+
+TEST_CASE("_bit_width")
+{
+   REQUIRE(sstl::_bit_width(uint32_t{ 0 }) == 0);
+   REQUIRE(sstl::_bit_width(uint32_t{ 1 }) == 1);
+   REQUIRE(sstl::_bit_width(uint32_t{ 0x80000000 }) == 32);
+   REQUIRE(sstl::_bit_width(uint64_t{ 0 }) == 0);
+   REQUIRE(sstl::_bit_width(uint64_t{ 0xff }) == 8);
+   REQUIRE(sstl::_bit_width(uint64_t{ 1 } << 40) == 41);
+   REQUIRE(sstl::_bit_width(~uint64_t{ 0 }) == 64);
+}
+
+TEST_CASE("radix_heap")
+{
+   SECTION("push + pop")
+   {
+      sstl::radix_heap<uint32_t, int, 10> h;
+      REQUIRE(h.empty());
+      REQUIRE(h.capacity() == 10);
+      for(auto key : {7u, 3u, 100u, 3u, 0u, 4000000000u})
+      {
+         h.push(key, static_cast<int>(key % 1000));
+      }
+      REQUIRE(h.size() == 6);
+      auto keys = std::vector<uint32_t>{};
+      while(!h.empty())
+      {
+         REQUIRE(h.top_value() == static_cast<int>(h.top_key() % 1000));
+         keys.push_back(h.top_key());
+         h.pop();
+      }
+      REQUIRE(keys == (std::vector<uint32_t>{0, 3, 3, 7, 100, 4000000000u}));
+      REQUIRE(h.last_key() == 4000000000u);
+   }
+
+   SECTION("monotone pushes interleaved with pops (64 bit keys)")
+   {
+      sstl::radix_heap<uint64_t, uint64_t, 256> h;
+      std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> reference;
+      uint64_t seed = 88172645463325252ull;
+      auto next = [&seed]() { seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17; return seed; };
+      for(int i=0; i<100000; ++i)
+      {
+         if(!h.full() && (h.empty() || next() % 3 != 0))
+         {
+            //keys spread over the whole 64 bit range
+            auto key = h.last_key() + (next() >> (next() % 64));
+            key = key < h.last_key() ? h.last_key() : key;
+            h.push(key, key);
+            reference.push(key);
+         }
+         else
+         {
+            REQUIRE(h.top_key() == reference.top());
+            REQUIRE(h.top_value() == reference.top());
+            h.pop();
+            reference.pop();
+         }
+         REQUIRE(h.size() == reference.size());
+      }
+   }
+
+   SECTION("values are not moved")
+   {
+      counted_type::reset_counts();
+      {
+         radix_heap_counted_type_t h;
+         for(uint32_t key=0; key<10; ++key)
+         {
+            h.emplace(1000-key*100, key);
+         }
+         for(uint32_t key=9; key>=5; --key)
+         {
+            REQUIRE(h.top_value().member == key);
+            h.pop();
+         }
+         REQUIRE(counted_type::check().parameter_constructions(10).destructions(5).move_assignments(0).copy_assignments(0));
+      }
+      REQUIRE(counted_type::check().parameter_constructions(10).destructions(10));
+   }
+
+   SECTION("copy and move")
+   {
+      radix_heap_counted_type_t h;
+      h.emplace(5, 5);
+      h.emplace(2, 2);
+      h.pop();
+      h.emplace(7, 7);
+
+      counted_type::reset_counts();
+      auto copy = h;
+      REQUIRE(counted_type::check().copy_constructions(2));
+      REQUIRE(copy.last_key() == 2);
+
+      counted_type::reset_counts();
+      auto moved = std::move(copy);
+      REQUIRE(counted_type::check().move_constructions(2).destructions(2));
+      REQUIRE(copy.empty());
+      REQUIRE(moved.pop_top().member == 5);
+      REQUIRE(moved.pop_top().member == 7);
+   }
+
+   SECTION("move-only values")
+   {
+      sstl::radix_heap<uint32_t, std::unique_ptr<int>, 4> h;
+      h.emplace(3, new int(3));
+      h.push(1, std::unique_ptr<int>(new int(1)));
+      REQUIRE(*h.pop_top() == 1);
+      REQUIRE(*h.pop_top() == 3);
+   }
+
+   #if _sstl_has_exceptions()
+   SECTION("copy construction throws")
+   {
+      radix_heap_counted_type_t h;
+      for(uint32_t key=0; key<5; ++key)
+      {
+         h.emplace(key, key);
+      }
+      counted_type::reset_counts();
+      counted_type::throw_at_nth_copy_construction(3);
+      REQUIRE_THROWS_AS(radix_heap_counted_type_t{h}, counted_type::copy_construction::exception);
+      REQUIRE(counted_type::check().copy_constructions(2).destructions(2));
+   }
+   #endif
+}
+}
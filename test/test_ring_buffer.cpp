@@ -0,0 +1,141 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <sstl/__internal/_except.h>
+#include <sstl/ring_buffer.h>
+
+#include "utility.h"
+#include "counted_type.h"
+
+namespace sstl_test
+{
+using ring_buffer_counted_type_t = sstl::ring_buffer<counted_type, 5>;
+
+TEST_CASE("ring_buffer")
+{
+   SECTION("can be used through a capacity-agnostic deque reference")
+   {
+      auto rb = sstl::ring_buffer<int, 5>{0, 1, 2};
+      sstl::deque<int>& d = rb;
+      REQUIRE(d.size() == 3);
+      REQUIRE(d.capacity() == 5);
+      REQUIRE(are_containers_equal(d, std::initializer_list<int>{0, 1, 2}));
+   }
+
+   SECTION("push_back")
+   {
+      SECTION("not full")
+      {
+         auto rb = ring_buffer_counted_type_t{0, 1, 2};
+         auto value = counted_type(3);
+         counted_type::reset_counts();
+         rb.push_back(value);
+         REQUIRE(counted_type::check().copy_constructions(1));
+         REQUIRE(are_containers_equal(rb, std::initializer_list<counted_type>{0, 1, 2, 3}));
+      }
+      SECTION("full (copy)")
+      {
+         auto rb = ring_buffer_counted_type_t{0, 1, 2, 3, 4};
+         auto value = counted_type(5);
+         counted_type::reset_counts();
+         rb.push_back(value);
+         REQUIRE(counted_type::check().constructions(0).destructions(0).copy_assignments(1));
+         REQUIRE(rb.full());
+         REQUIRE(are_containers_equal(rb, std::initializer_list<counted_type>{1, 2, 3, 4, 5}));
+      }
+      SECTION("full (move)")
+      {
+         auto rb = ring_buffer_counted_type_t{0, 1, 2, 3, 4};
+         counted_type::reset_counts();
+         rb.push_back(counted_type(5));
+         REQUIRE(counted_type::check().parameter_constructions(1).destructions(1).move_assignments(1));
+         REQUIRE(are_containers_equal(rb, std::initializer_list<counted_type>{1, 2, 3, 4, 5}));
+      }
+      SECTION("many wrap-arounds")
+      {
+         auto rb = sstl::ring_buffer<int, 5>{};
+         for(int i=0; i<23; ++i)
+            rb.push_back(i);
+         REQUIRE(are_containers_equal(rb, std::initializer_list<int>{18, 19, 20, 21, 22}));
+         rb.pop_front();
+         rb.push_front(17);
+         REQUIRE(are_containers_equal(rb, std::initializer_list<int>{17, 19, 20, 21, 22}));
+      }
+      #if _sstl_has_exceptions()
+      SECTION("exception handling")
+      {
+         auto rb = ring_buffer_counted_type_t{0, 1, 2, 3, 4};
+         auto value = counted_type(5);
+         counted_type::reset_counts();
+         counted_type::throw_at_nth_copy_assignment(1);
+         REQUIRE_THROWS_AS(rb.push_back(value), counted_type::copy_assignment::exception);
+         REQUIRE(rb.size() == 5);
+         REQUIRE(are_containers_equal(rb, std::initializer_list<counted_type>{0, 1, 2, 3, 4}));
+      }
+      #endif
+   }
+
+   SECTION("emplace_back")
+   {
+      SECTION("full")
+      {
+         auto rb = ring_buffer_counted_type_t{0, 1, 2, 3, 4};
+         counted_type::reset_counts();
+         rb.emplace_back(5);
+         REQUIRE(counted_type::check().parameter_constructions(1).destructions(1));
+         REQUIRE(are_containers_equal(rb, std::initializer_list<counted_type>{1, 2, 3, 4, 5}));
+      }
+      #if _sstl_has_exceptions()
+      SECTION("exception handling")
+      {
+         auto rb = ring_buffer_counted_type_t{0, 1, 2, 3, 4};
+         counted_type::reset_counts();
+         counted_type::throw_at_nth_parameter_construction(1);
+         REQUIRE_THROWS_AS(rb.emplace_back(5), counted_type::parameter_construction::exception);
+         REQUIRE(counted_type::check().constructions(0).destructions(1));
+         REQUIRE(are_containers_equal(rb, std::initializer_list<counted_type>{1, 2, 3, 4}));
+      }
+      #endif
+   }
+
+   SECTION("recent")
+   {
+      auto rb = sstl::ring_buffer<int, 5>{};
+      for(int i=0; i<8; ++i)
+         rb.push_back(i);
+      REQUIRE(rb.recent(0) == 7);
+      REQUIRE(rb.recent(4) == 3);
+      const auto& crb = rb;
+      REQUIRE(crb.recent(1) == 6);
+   }
+
+   SECTION("recent_begin")
+   {
+      auto rb = sstl::ring_buffer<int, 5>{};
+      for(int i=0; i<8; ++i)
+         rb.push_back(i);
+      REQUIRE(rb.recent_begin(0) == rb.end());
+      REQUIRE(rb.recent_begin(5) == rb.begin());
+      REQUIRE(std::equal(rb.recent_begin(3), rb.end(), std::initializer_list<int>{5, 6, 7}.begin()));
+      REQUIRE(std::distance(rb.crecent_begin(2), rb.cend()) == 2);
+   }
+
+   SECTION("copy and move")
+   {
+      auto rb = sstl::ring_buffer<int, 5>{};
+      for(int i=0; i<7; ++i)
+         rb.push_back(i);
+      auto copy = rb;
+      REQUIRE(copy == rb);
+      auto moved = std::move(copy);
+      REQUIRE(moved == rb);
+      moved.push_back(7);
+      REQUIRE(are_containers_equal(moved, std::initializer_list<int>{3, 4, 5, 6, 7}));
+   }
+}
+}
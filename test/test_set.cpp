@@ -36,6 +36,7 @@ SOFTWARE.
 #include <vector>
 
 #include <sstl/set.h>
+#include "counted_type.h"
 
 static const size_t SIZE = 10;
 
@@ -816,5 +817,463 @@ namespace sstl_test
 #endif
     }
 
+    //*************************************************************************
+    TEST(test_iterate_after_erase_insert)
+    {
+      sstl::set<int, 128> data;
+      std::set<int> compare_data;
+
+      unsigned seed = 11;
+      for (int i = 0; i < 4000; ++i)
+      {
+        seed = seed * 1103515245 + 12345;
+        int key = (seed >> 16) % 200;
+        if (data.erase(key) == 0 && !data.full())
+        {
+          data.insert(key);
+          compare_data.insert(key);
+        }
+        else
+        {
+          compare_data.erase(key);
+        }
+
+        CHECK(std::equal(compare_data.begin(), compare_data.end(), data.begin()));
+        CHECK(std::equal(compare_data.rbegin(), compare_data.rend(), data.rbegin()));
+      }
+    }
+
+    //*************************************************************************
+    TEST_FIXTURE(SetupFixture, test_for_each)
+    {
+      Compare_Data compare_data(initial_data.begin(), initial_data.end());
+      const Data data(initial_data.begin(), initial_data.end());
+
+      std::vector<int> visited;
+      data.for_each([&visited](int value) { visited.push_back(value); });
+
+      CHECK_EQUAL(compare_data.size(), visited.size());
+      CHECK(std::equal(compare_data.begin(), compare_data.end(), visited.begin()));
+
+      Data empty;
+      size_t count = 0;
+      empty.for_each([&count](int) { ++count; });
+      CHECK_EQUAL(0U, count);
+    }
+
+    //*************************************************************************
+    TEST(test_insert_rvalue_and_emplace)
+    {
+      typedef sstl_test::counted_type counted_type;
+      sstl::set<counted_type, 4> data;
+
+      counted_type::reset_counts();
+      CHECK(data.insert(counted_type(1)).second);
+      CHECK(counted_type::check().parameter_constructions(1).move_constructions(1).destructions(1));
+
+      counted_type::reset_counts();
+      CHECK(!data.insert(counted_type(1)).second);
+      CHECK(counted_type::check().parameter_constructions(1).destructions(1));
+
+      counted_type::reset_counts();
+      std::pair<sstl::set<counted_type, 4>::iterator, bool> result = data.emplace(2);
+      CHECK(result.second);
+      CHECK_EQUAL(2U, result.first->member);
+      CHECK(counted_type::check().parameter_constructions(1).destructions(0));
+
+      counted_type::reset_counts();
+      CHECK(!data.emplace(2).second);
+      CHECK(counted_type::check().parameter_constructions(1).destructions(1));
+
+      CHECK_EQUAL(2U, data.size());
+      CHECK_EQUAL(3U, data.emplace_hint(data.cend(), 3)->member);
+      CHECK_EQUAL(3U, data.size());
+    }
+
+    //*************************************************************************
+    TEST(test_emplace_exception)
+    {
+#if _sstl_has_exceptions()
+      typedef sstl_test::counted_type counted_type;
+      sstl::set<counted_type, 2> data;
+      data.emplace(1);
+
+      counted_type::reset_counts();
+      counted_type::throw_at_nth_parameter_construction(1);
+      CHECK_THROW(data.emplace(2), counted_type::parameter_construction::exception);
+      CHECK_EQUAL(1U, data.size());
+
+      // The node of the failed construction was released
+      data.emplace(2);
+      CHECK(data.full());
+#endif
+    }
+
+    //*************************************************************************
+    TEST(test_extract_and_insert_node)
+    {
+      typedef sstl_test::counted_type counted_type;
+      typedef sstl::set<counted_type, 4> Counted_Data;
+      Counted_Data data;
+      data.emplace(1);
+      data.emplace(2);
+      data.emplace(3);
+
+      counted_type::reset_counts();
+      Counted_Data::node_type node = data.extract(data.find(counted_type(2)));
+      CHECK_EQUAL(2U, node.value().member);
+      CHECK_EQUAL(2U, data.size());
+      CHECK_EQUAL(1U, data.available());
+
+      node.value().member = 5;
+      Counted_Data::insert_return_type result = data.insert(std::move(node));
+      CHECK(result.inserted);
+      CHECK_EQUAL(5U, result.position->member);
+      CHECK_EQUAL(3U, data.size());
+      CHECK(counted_type::check().parameter_constructions(1).copy_constructions(0).move_constructions(0).destructions(1));
+
+      // The element is moved into the pool of the other set
+      sstl::set<counted_type, 2> other;
+      counted_type::reset_counts();
+      sstl::set<counted_type, 2>::iterator position = other.insert(other.cend(), data.extract(data.begin()));
+      CHECK_EQUAL(1U, position->member);
+      CHECK(counted_type::check().move_constructions(1).destructions(1));
+      CHECK_EQUAL(2U, data.size());
+      CHECK_EQUAL(2U, data.available());
+      CHECK_EQUAL(1U, other.size());
+
+      CHECK(data.extract(counted_type(42)).empty());
+    }
+
+    //*************************************************************************
+    TEST(test_transparent_lookup)
+    {
+      // Compares the elements with the plain values of their member
+      struct Member_Compare
+      {
+        typedef void is_transparent;
+
+        bool operator()(const sstl_test::counted_type& lhs, const sstl_test::counted_type& rhs) const
+        {
+          return lhs.member < rhs.member;
+        }
+        bool operator()(const sstl_test::counted_type& lhs, size_t rhs) const
+        {
+          return lhs.member < rhs;
+        }
+        bool operator()(size_t lhs, const sstl_test::counted_type& rhs) const
+        {
+          return lhs < rhs.member;
+        }
+      };
+
+      typedef sstl::set<sstl_test::counted_type, 8, Member_Compare> Counted_Data;
+      typedef sstl_test::counted_type counted_type;
+      Counted_Data data;
+      data.emplace(1);
+      data.emplace(3);
+      data.emplace(5);
+      const Counted_Data& const_data = data;
+
+      counted_type::reset_counts();
+      CHECK_EQUAL(3U, data.find(size_t(3))->member);
+      CHECK(const_data.find(size_t(4)) == const_data.end());
+      CHECK_EQUAL(1U, data.count(size_t(5)));
+      CHECK_EQUAL(0U, data.count(size_t(2)));
+      CHECK_EQUAL(3U, data.lower_bound(size_t(2))->member);
+      CHECK_EQUAL(5U, const_data.upper_bound(size_t(3))->member);
+      std::pair<Counted_Data::iterator, Counted_Data::iterator> range = data.equal_range(size_t(3));
+      CHECK_EQUAL(1, std::distance(range.first, range.second));
+      CHECK_EQUAL(3U, range.first->member);
+      CHECK(counted_type::check().constructions(0));
+    }
+
+    //*************************************************************************
+    TEST_FIXTURE(SetupFixture, test_assign_sorted)
+    {
+      for (size_t size = 0; size <= initial_data.size(); ++size)
+      {
+        Compare_Data compare_data(initial_data.begin(), std::next(initial_data.begin(), size));
+        Data data(initial_data.begin(), initial_data.end());
+        data.assign_sorted(compare_data.begin(), compare_data.end());
+
+        CHECK_EQUAL(compare_data.size(), data.size());
+        CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+
+        // The tree is rebalanced as usual by the following erases and inserts
+        while (!compare_data.empty())
+        {
+          size_t middle = compare_data.size() / 2;
+          data.erase(std::next(data.begin(), middle));
+          compare_data.erase(std::next(compare_data.begin(), middle));
+          CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+        }
+        data.insert(initial_data.begin(), initial_data.end());
+        compare_data.insert(initial_data.begin(), initial_data.end());
+        CHECK_EQUAL(compare_data.size(), data.size());
+        CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+      }
+    }
+
+    //*************************************************************************
+    TEST(test_assign_sorted_exception)
+    {
+      typedef sstl_test::counted_type counted_type;
+      std::vector<counted_type> values;
+      for (size_t i = 0; i < 4; ++i)
+      {
+        values.push_back(counted_type(i));
+      }
+      sstl::set<counted_type, 4> data;
+      data.emplace(7);
+
+      counted_type::reset_counts();
+      counted_type::throw_at_nth_copy_construction(3);
+      CHECK_THROW(data.assign_sorted(values.begin(), values.end()), counted_type::copy_construction::exception);
+      CHECK(data.empty());
+      CHECK_EQUAL(4U, data.available());
+      CHECK(counted_type::check().copy_constructions(2).destructions(3));
+
+      counted_type::reset_counts();
+      data.assign_sorted(values.begin(), values.end());
+      CHECK_EQUAL(4U, data.size());
+      CHECK(std::equal(data.begin(), data.end(), values.begin()));
+    }
+
+    //*************************************************************************
+    TEST_FIXTURE(SetupFixture, test_insert_with_hint)
+    {
+      Compare_Data compare_data(initial_data.begin(), initial_data.end());
+
+      // Appended in order at end()
+      Data data;
+      for (Compare_Data::const_iterator i = compare_data.begin(); i != compare_data.end(); ++i)
+      {
+        Data::iterator position = data.insert(data.cend(), *i);
+        CHECK(*position == *i);
+      }
+      CHECK_EQUAL(compare_data.size(), data.size());
+      CHECK(std::equal(data.begin(), data.end(), compare_data.begin()));
+
+      // Inserted in reverse order, each one before the previous one
+      Data reversed;
+      Data::iterator position = reversed.end();
+      for (Compare_Data::const_reverse_iterator i = compare_data.rbegin(); i != compare_data.rend(); ++i)
+      {
+        position = reversed.insert(position, *i);
+      }
+      CHECK(std::equal(reversed.begin(), reversed.end(), compare_data.begin()));
+
+      // The hints that aren't next to the insertion point are ignored
+      Data misplaced;
+      for (Compare_Data::const_iterator i = compare_data.begin(); i != compare_data.end(); ++i)
+      {
+        misplaced.insert(misplaced.begin(), *i);
+      }
+      CHECK(std::equal(misplaced.begin(), misplaced.end(), compare_data.begin()));
+
+      // A value already in the set is found at the hint
+      Data::iterator existing = std::next(data.begin(), 3);
+      CHECK(data.insert(existing, *existing) == existing);
+      CHECK(data.insert(std::next(existing), *existing) == existing);
+      CHECK_EQUAL(compare_data.size(), data.size());
+    }
+
+    //*************************************************************************
+    TEST(test_order_statistics)
+    {
+      typedef sstl::set<int, 256, std::less<int>, sstl::tree_order_statistics> Ranked_Data;
+      Ranked_Data data;
+      std::set<int> compare_data;
+
+      // The subtree sizes are kept by every kind of insertion and erasure
+      unsigned seed = 11;
+      for (int i = 0; i < 3000; ++i)
+      {
+        seed = seed * 1103515245 + 12345;
+        int key = int((seed >> 8) % 400);
+        switch ((seed >> 20) % 6)
+        {
+          case 0:
+          case 1:
+            if (!data.full())
+            {
+              data.insert(key);
+              compare_data.insert(key);
+            }
+            break;
+          case 2:
+            if (!data.full())
+            {
+              data.insert(data.lower_bound(key), key);
+              compare_data.insert(key);
+            }
+            break;
+          case 3:
+            CHECK_EQUAL(compare_data.erase(key), data.erase(key));
+            break;
+          case 4:
+            if (!data.empty())
+            {
+              Ranked_Data::iterator position = data.nth(size_t(key) % data.size());
+              compare_data.erase(*position);
+              data.erase(position);
+            }
+            break;
+          default:
+            if (data.count(key) > 0)
+            {
+              Ranked_Data::node_type node = data.extract(key);
+              node.value() = key + 1000;
+              data.insert(std::move(node));
+              compare_data.erase(key);
+              compare_data.insert(key + 1000);
+            }
+            break;
+        }
+
+        CHECK_EQUAL(compare_data.size(), data.size());
+        size_t expected_rank = std::distance(compare_data.begin(), compare_data.lower_bound(key));
+        CHECK_EQUAL(expected_rank, data.rank(key));
+        size_t expected_count = std::distance(compare_data.lower_bound(key), compare_data.lower_bound(key + 50));
+        CHECK_EQUAL(expected_count, data.count_range(key, key + 50));
+        CHECK_EQUAL(0U, data.count_range(key + 50, key));
+      }
+
+      size_t position = 0;
+      for (std::set<int>::const_iterator i = compare_data.begin(); i != compare_data.end(); ++i, ++position)
+      {
+        CHECK_EQUAL(*i, *data.nth(position));
+        CHECK_EQUAL(position, data.rank(*i));
+      }
+      CHECK(data.nth(data.size()) == data.end());
+
+      // Balanced construction
+      std::vector<int> sorted(compare_data.begin(), compare_data.end());
+      Ranked_Data copy;
+      copy.assign_sorted(sorted.begin(), sorted.end());
+      for (size_t i = 0; i < sorted.size(); ++i)
+      {
+        CHECK_EQUAL(sorted[i], *copy.nth(i));
+      }
+      CHECK_EQUAL(sorted.size(), copy.rank(2000));
+    }
+
+    //*************************************************************************
+    TEST(test_merge)
+    {
+      int data_keys[] = { 1, 3, 5, 7 };
+      int other_keys[] = { 0, 3, 4, 7, 8, 9 };
+      sstl::set<int, 8> data(std::begin(data_keys), std::end(data_keys));
+      sstl::set<int, 8> other(std::begin(other_keys), std::end(other_keys));
+
+      // The keys already in the set stay in the other set
+      data.merge(other);
+      int merged[] = { 0, 1, 3, 4, 5, 7, 8, 9 };
+      int left[] = { 3, 7 };
+      CHECK_EQUAL(8U, data.size());
+      CHECK(std::equal(data.begin(), data.end(), std::begin(merged)));
+      CHECK_EQUAL(2U, other.size());
+      CHECK(std::equal(other.begin(), other.end(), std::begin(left)));
+      CHECK(std::equal(other.rbegin(), other.rend(), std::reverse_iterator<int*>(std::end(left))));
+
+      // Both trees are still valid
+      data.erase(4);
+      data.insert(6);
+      other.insert(2);
+      CHECK_EQUAL(6, *data.find(6));
+      CHECK_EQUAL(2, *other.begin());
+
+      // The elements that don't fit are left in the other set
+      int small_keys[] = { 10, 30 };
+      int large_keys[] = { 5, 20, 25, 40 };
+      sstl::set<int, 4> small(std::begin(small_keys), std::end(small_keys));
+      sstl::set<int, 8> large(std::begin(large_keys), std::end(large_keys));
+      small.merge(large);
+      int small_merged[] = { 5, 10, 20, 30 };
+      int large_left[] = { 25, 40 };
+      CHECK(std::equal(small.begin(), small.end(), std::begin(small_merged)));
+      CHECK(std::equal(large.begin(), large.end(), std::begin(large_left)));
+
+      // The elements are moved into the pool of the set
+      typedef sstl_test::counted_type counted_type;
+      sstl::set<counted_type, 4> counted;
+      sstl::set<counted_type, 4> other_counted;
+      counted.insert(counted_type(1));
+      other_counted.insert(counted_type(2));
+      other_counted.insert(counted_type(1));
+      counted_type::reset_counts();
+      counted.merge(other_counted);
+      CHECK(counted_type::check().move_constructions(1).destructions(1));
+      CHECK_EQUAL(2U, counted.size());
+      CHECK_EQUAL(1U, other_counted.size());
+    }
+
+    //*************************************************************************
+    TEST(test_set_operations)
+    {
+      typedef sstl::set<int, 512, std::less<int>, sstl::tree_order_statistics> Ranked_Data;
+      Ranked_Data first;
+      Ranked_Data second;
+      Ranked_Data result;
+      std::set<int> compare_first;
+      std::set<int> compare_second;
+
+      unsigned seed = 7;
+      for (int i = 0; i < 200; ++i)
+      {
+        seed = seed * 1103515245 + 12345;
+        int key = int((seed >> 8) % 300);
+        first.insert(key);
+        compare_first.insert(key);
+        seed = seed * 1103515245 + 12345;
+        key = int((seed >> 8) % 300);
+        second.insert(key);
+        compare_second.insert(key);
+      }
+
+      std::vector<int> expected;
+      std::set_union(compare_first.begin(), compare_first.end(), compare_second.begin(), compare_second.end(), std::back_inserter(expected));
+      set_union(first, second, result);
+      CHECK_EQUAL(expected.size(), result.size());
+      CHECK(std::equal(result.begin(), result.end(), expected.begin()));
+
+      expected.clear();
+      std::set_intersection(compare_first.begin(), compare_first.end(), compare_second.begin(), compare_second.end(), std::back_inserter(expected));
+      set_intersection(first, second, result);
+      CHECK_EQUAL(expected.size(), result.size());
+      CHECK(std::equal(result.begin(), result.end(), expected.begin()));
+
+      expected.clear();
+      std::set_difference(compare_first.begin(), compare_first.end(), compare_second.begin(), compare_second.end(), std::back_inserter(expected));
+      set_difference(first, second, result);
+      CHECK_EQUAL(expected.size(), result.size());
+      CHECK(std::equal(result.begin(), result.end(), expected.begin()));
+
+      expected.clear();
+      std::set_symmetric_difference(compare_first.begin(), compare_first.end(), compare_second.begin(), compare_second.end(), std::back_inserter(expected));
+      set_symmetric_difference(first, second, result);
+      CHECK_EQUAL(expected.size(), result.size());
+      CHECK(std::equal(result.begin(), result.end(), expected.begin()));
+
+      // The result is a valid tree, with its subtree sizes
+      for (size_t i = 0; i < expected.size(); ++i)
+      {
+        CHECK_EQUAL(expected[i], *result.nth(i));
+        CHECK_EQUAL(i, result.rank(expected[i]));
+      }
+
+      // Merging in place gives the union
+      expected.clear();
+      std::set_union(compare_first.begin(), compare_first.end(), compare_second.begin(), compare_second.end(), std::back_inserter(expected));
+      first.merge(second);
+      CHECK_EQUAL(expected.size(), first.size());
+      CHECK(std::equal(first.begin(), first.end(), expected.begin()));
+      for (size_t i = 0; i < expected.size(); ++i)
+      {
+        CHECK_EQUAL(expected[i], *first.nth(i));
+      }
+      CHECK(std::includes(first.begin(), first.end(), second.begin(), second.end()));
+    }
   };
 }
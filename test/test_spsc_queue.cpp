@@ -0,0 +1,169 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <thread>
+#include <vector>
+#include <sstl/__internal/_except.h>
+#include <sstl/spsc_queue.h>
+
+#include "counted_type.h"
+
+namespace sstl_test
+{
+TEST_CASE("spsc_queue")
+{
+   SECTION("try_push + try_pop")
+   {
+      sstl::spsc_queue<int, 3> q;
+      REQUIRE(q.empty());
+      REQUIRE(q.capacity() == 3);
+      REQUIRE(q.try_push(0));
+      REQUIRE(q.try_push(1));
+      REQUIRE(q.try_emplace(2));
+      REQUIRE(!q.try_push(3));
+      REQUIRE(q.size() == 3);
+      int value;
+      REQUIRE(q.try_pop(value));
+      REQUIRE(value == 0);
+      REQUIRE(q.try_push(3));
+      for(int expected=1; expected<4; ++expected)
+      {
+         REQUIRE(q.try_pop(value));
+         REQUIRE(value == expected);
+      }
+      REQUIRE(!q.try_pop(value));
+      REQUIRE(q.empty());
+   }
+
+   SECTION("front + pop")
+   {
+      sstl::spsc_queue<int, 4> q;
+      REQUIRE(q.front() == nullptr);
+      q.try_push(5);
+      q.try_push(6);
+      REQUIRE(*q.front() == 5);
+      *q.front() = 7;
+      REQUIRE(*q.front() == 7);
+      q.pop();
+      REQUIRE(*q.front() == 6);
+      q.pop();
+      REQUIRE(q.front() == nullptr);
+   }
+
+   SECTION("batch try_push + try_pop")
+   {
+      sstl::spsc_queue<int, 8> q;
+      int values[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+      auto it = q.try_push(values, values+5);
+      REQUIRE(it == values+5);
+      int out[10];
+      REQUIRE(q.try_pop(out, 3) == 3);
+      REQUIRE(std::equal(out, out+3, values));
+      it = q.try_push(it, values+10);
+      REQUIRE(it == values+10);
+      REQUIRE(q.size() == 7);
+      it = q.try_push(values, values+10);
+      REQUIRE(it == values+1);
+      REQUIRE(q.try_pop(out, 10) == 8);
+      REQUIRE(std::equal(out, out+7, values+3));
+      REQUIRE(out[7] == 0);
+      REQUIRE(q.try_pop(out, 10) == 0);
+   }
+
+   SECTION("number of operations")
+   {
+      {
+         sstl::spsc_queue<counted_type, 4> q;
+         counted_type::reset_counts();
+         q.try_emplace(0);
+         q.try_push(counted_type(1));
+         q.try_push(counted_type(2));
+         REQUIRE(counted_type::check().parameter_constructions(3).move_constructions(2).destructions(2));
+         counted_type value;
+         counted_type::reset_counts();
+         q.try_pop(value);
+         REQUIRE(counted_type::check().constructions(0).move_assignments(1).destructions(1));
+         counted_type::reset_counts();
+      }
+      REQUIRE(counted_type::check().destructions(2+1));
+   }
+
+   #if _sstl_has_exceptions()
+   SECTION("exception handling")
+   {
+      sstl::spsc_queue<counted_type, 4> q;
+      auto values = std::initializer_list<counted_type>{0, 1, 2};
+      counted_type::reset_counts();
+      counted_type::throw_at_nth_copy_construction(3);
+      REQUIRE_THROWS_AS(q.try_push(values.begin(), values.end()), counted_type::copy_construction::exception);
+      REQUIRE(q.size() == 2);
+      REQUIRE(q.front()->member == 0);
+   }
+   #endif
+
+   SECTION("one producer thread + one consumer thread")
+   {
+      static const size_t number_of_values = 200000;
+      sstl::spsc_queue<size_t, 64> q;
+      auto producer = std::thread([&q]()
+      {
+         size_t batch[7];
+         size_t value = 0;
+         while(value < number_of_values)
+         {
+            if(value % 3 == 0)
+            {
+               auto count = std::min(number_of_values - value, size_t{7});
+               for(size_t i=0; i<count; ++i)
+                  batch[i] = value+i;
+               auto pushed = static_cast<size_t>(q.try_push(batch, batch+count) - batch);
+               if(pushed == 0)
+                  std::this_thread::yield();
+               value += pushed;
+            }
+            else if(q.try_push(value))
+            {
+               ++value;
+            }
+            else
+            {
+               std::this_thread::yield();
+            }
+         }
+      });
+      auto received = std::vector<size_t>{};
+      received.reserve(number_of_values);
+      size_t batch[5];
+      while(received.size() < number_of_values)
+      {
+         if(received.size() % 2 == 0)
+         {
+            auto count = q.try_pop(batch, 5);
+            if(count == 0)
+               std::this_thread::yield();
+            received.insert(received.end(), batch, batch+count);
+         }
+         else if(auto value = q.front())
+         {
+            received.push_back(*value);
+            q.pop();
+         }
+         else
+         {
+            std::this_thread::yield();
+         }
+      }
+      producer.join();
+      bool values_are_in_order = true;
+      for(size_t i=0; i<number_of_values; ++i)
+         values_are_in_order = values_are_in_order && received[i] == i;
+      REQUIRE(values_are_in_order);
+      REQUIRE(q.empty());
+   }
+}
+}
@@ -0,0 +1,187 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <cstdint>
+#include <vector>
+#include <stdexcept>
+#include <sstl/__internal/_except.h>
+#include <sstl/timer_wheel.h>
+
+#include "counted_type.h"
+
+namespace sstl_test
+{
+TEST_CASE("timer_wheel")
+{
+   SECTION("timer fires at its expiry")
+   {
+      sstl::timer_wheel<4> w;
+      REQUIRE(w.empty());
+      REQUIRE(w.capacity() == 4);
+      int fired = 0;
+      auto h = w.schedule_at(10, [&fired](){ ++fired; });
+      REQUIRE(w.size() == 1);
+      REQUIRE(w.is_scheduled(h));
+      REQUIRE(w.tick(9) == 0);
+      REQUIRE(fired == 0);
+      REQUIRE(w.now() == 9);
+      REQUIRE(w.tick(10) == 1);
+      REQUIRE(fired == 1);
+      REQUIRE(!w.is_scheduled(h));
+      REQUIRE(w.empty());
+   }
+
+   SECTION("expiry in the past fires on the next tick")
+   {
+      sstl::timer_wheel<4> w(100);
+      int fired = 0;
+      w.schedule_at(50, [&fired](){ ++fired; });
+      REQUIRE(w.tick(100) == 0);
+      REQUIRE(w.tick(101) == 1);
+      REQUIRE(fired == 1);
+   }
+
+   SECTION("schedule_after")
+   {
+      sstl::timer_wheel<4> w(1000);
+      auto fired_at = sstl::timer_wheel<4>::time_point{ 0 };
+      w.schedule_after(5, [&w, &fired_at](){ fired_at = w.now(); });
+      w.tick(2000);
+      REQUIRE(fired_at == 1005);
+   }
+
+   SECTION("cancel")
+   {
+      sstl::timer_wheel<4> w;
+      int fired = 0;
+      auto h1 = w.schedule_at(10, [&fired](){ fired += 1; });
+      auto h2 = w.schedule_at(10, [&fired](){ fired += 10; });
+      REQUIRE(w.cancel(h1));
+      REQUIRE(!w.cancel(h1));
+      REQUIRE(w.size() == 1);
+      w.tick(20);
+      REQUIRE(fired == 10);
+      REQUIRE(!w.cancel(h2));
+      REQUIRE(!w.cancel(sstl::timer_wheel<4>::handle{}));
+   }
+
+   SECTION("handles of released timers are not valid for reused timers")
+   {
+      sstl::timer_wheel<1> w;
+      auto h1 = w.schedule_at(10, [](){});
+      REQUIRE(w.full());
+      w.cancel(h1);
+      auto h2 = w.schedule_at(10, [](){});
+      REQUIRE(h1 != h2);
+      REQUIRE(!w.is_scheduled(h1));
+      REQUIRE(!w.cancel(h1));
+      REQUIRE(w.is_scheduled(h2));
+   }
+
+   SECTION("timers of the upper wheels are cascaded")
+   {
+      using time_point = sstl::timer_wheel<16>::time_point;
+      sstl::timer_wheel<16> w(3);
+      auto expiries = std::vector<time_point>{ 4, 63, 64, 65, 130, 4095, 4096, 5000, 300000, 16777300, 40000000 };
+      auto fired_at = std::vector<time_point>{};
+      for(auto expiry : expiries)
+      {
+         w.schedule_at(expiry, [&w, &fired_at](){ fired_at.push_back(w.now()); });
+      }
+      //ticks in irregular steps
+      for(time_point now=0; now<=40000000; now+=997)
+      {
+         w.tick(now);
+      }
+      w.tick(40000000);
+      REQUIRE(w.empty());
+      REQUIRE(fired_at.size() == expiries.size());
+      for(size_t i=0; i<expiries.size(); ++i)
+      {
+         REQUIRE(fired_at[i] == expiries[i]);
+      }
+   }
+
+   SECTION("callbacks can schedule and cancel timers")
+   {
+      sstl::timer_wheel<4> w;
+      int fired = 0;
+      sstl::timer_wheel<4>::handle cancelled;
+      w.schedule_at(5, [&w, &fired, &cancelled]()
+      {
+         ++fired;
+         w.cancel(cancelled);
+         w.schedule_after(0, [&fired](){ fired += 10; });
+      });
+      cancelled = w.schedule_at(5, [&fired](){ fired += 100; });
+      REQUIRE(w.tick(5) == 1);
+      REQUIRE(fired == 1);
+      REQUIRE(w.tick(6) == 1);
+      REQUIRE(fired == 11);
+   }
+
+   SECTION("random timers fire exactly once at their expiry")
+   {
+      using time_point = sstl::timer_wheel<256>::time_point;
+      sstl::timer_wheel<256> w;
+      auto late_or_early = 0;
+      auto fired = 0;
+      auto handles = std::vector<sstl::timer_wheel<256>::handle>{};
+      uint32_t seed = 7;
+      auto next = [&seed]() { seed = seed * 1103515245 + 12345; return (seed >> 8) % 100000; };
+      for(time_point now=0; now<200000; now+=next()%50)
+      {
+         while(!w.full())
+         {
+            auto expiry = now + next();
+            handles.push_back(w.schedule_at(expiry, [&w, &late_or_early, &fired, expiry]()
+            {
+               late_or_early += w.now() != expiry;
+               ++fired;
+            }));
+         }
+         if(next() % 2 == 0)
+         {
+            w.cancel(handles[next() % handles.size()]);
+         }
+         w.tick(now);
+      }
+      REQUIRE(fired > 0);
+      REQUIRE(late_or_early == 0);
+   }
+
+   SECTION("callbacks are destroyed")
+   {
+      counted_type::reset_counts();
+      {
+         sstl::timer_wheel<4, sizeof(counted_type)> w;
+         w.schedule_at(1, counted_type());
+         w.schedule_at(2, counted_type());
+         auto h = w.schedule_at(3, counted_type());
+         w.schedule_at(4, counted_type());
+         w.cancel(h);
+         w.tick(1);
+      }
+      REQUIRE(counted_type::check().constructions(8).destructions(8));
+   }
+
+   #if _sstl_has_exceptions()
+   SECTION("callback throws")
+   {
+      sstl::timer_wheel<4> w;
+      int fired = 0;
+      w.schedule_at(5, [](){ throw std::runtime_error("callback"); });
+      w.schedule_at(5, [&fired](){ ++fired; });
+      REQUIRE_THROWS_AS(w.tick(5), std::runtime_error);
+      REQUIRE(w.size() == 1);
+      REQUIRE(w.tick(6) == 1);
+      REQUIRE(fired == 1);
+   }
+   #endif
+}
+}
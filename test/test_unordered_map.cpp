@@ -0,0 +1,332 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+#include <sstl/__internal/_except.h>
+#include <sstl/unordered_map.h>
+
+#include "counted_type.h"
+
+namespace sstl_test
+{
+using unordered_map_int_base_t = sstl::unordered_map<int, int>;
+using unordered_map_counted_type_t = sstl::unordered_map<int, counted_type, 10>;
+
+namespace
+{
+   //all the keys collide
+   struct constant_hash
+   {
+      size_t operator()(int) const
+      {
+         return 42;
+      }
+   };
+
+   //transparent hasher and equality: lookup of std::string keys with C strings
+   struct string_hash
+   {
+      using is_transparent = void;
+
+      size_t operator()(const std::string& key) const
+      {
+         return (*this)(key.c_str());
+      }
+
+      size_t operator()(const char* key) const
+      {
+         size_t hash = 14695981039346656037ull;
+         while(*key != '\0')
+         {
+            hash = (hash ^ static_cast<unsigned char>(*key++)) * 1099511628211ull;
+         }
+         return hash;
+      }
+   };
+
+   struct string_equal
+   {
+      using is_transparent = void;
+
+      bool operator()(const std::string& lhs, const std::string& rhs) const
+      {
+         return lhs == rhs;
+      }
+
+      bool operator()(const char* lhs, const std::string& rhs) const
+      {
+         return std::strcmp(lhs, rhs.c_str()) == 0;
+      }
+   };
+
+   size_t sum_of_values(const sstl::unordered_map<int, int>& map)
+   {
+      size_t sum = 0;
+      for(const auto& value : map)
+      {
+         sum += value.second;
+      }
+      return sum;
+   }
+}
+
+TEST_CASE("unordered_map")
+{
+   SECTION("user cannot directly construct the base class")
+   {
+      REQUIRE(!std::is_default_constructible<unordered_map_int_base_t>::value);
+      REQUIRE(!std::is_copy_constructible<unordered_map_int_base_t>::value);
+      REQUIRE(!std::is_move_constructible<unordered_map_int_base_t>::value);
+   }
+
+   SECTION("default constructor")
+   {
+      sstl::unordered_map<int, int, 10> m;
+      REQUIRE(m.empty());
+      REQUIRE(m.size() == 0);
+      REQUIRE(m.capacity() == 10);
+      REQUIRE(m.bucket_count() >= 10);
+      REQUIRE(m.begin() == m.end());
+   }
+
+   SECTION("insert + find + erase")
+   {
+      sstl::unordered_map<int, int, 10> m;
+      auto result = m.insert(std::make_pair(1, 10));
+      REQUIRE(result.second);
+      REQUIRE(result.first->first == 1);
+      REQUIRE(result.first->second == 10);
+      result = m.insert(std::make_pair(1, 20));
+      REQUIRE(!result.second);
+      REQUIRE(result.first->second == 10);
+      m.emplace(2, 20);
+      m.insert({ { 3, 30 }, { 4, 40 } });
+      REQUIRE(m.size() == 4);
+      REQUIRE(m.find(3)->second == 30);
+      REQUIRE(m.find(5) == m.end());
+      REQUIRE(m.count(4) == 1);
+      REQUIRE(m.count(5) == 0);
+      REQUIRE(m.contains(2));
+      REQUIRE(m.erase(2) == 1);
+      REQUIRE(m.erase(2) == 0);
+      REQUIRE(!m.contains(2));
+      REQUIRE(m.size() == 3);
+   }
+
+   SECTION("operator[] + at")
+   {
+      sstl::unordered_map<int, int, 10> m;
+      m[1] = 10;
+      m[2];
+      REQUIRE(m.size() == 2);
+      REQUIRE(m.at(1) == 10);
+      REQUIRE(m.at(2) == 0);
+      #if _sstl_has_exceptions()
+      REQUIRE_THROWS_AS(m.at(3), std::out_of_range);
+      #endif
+   }
+
+   SECTION("try_emplace + insert_or_assign")
+   {
+      sstl::unordered_map<int, std::unique_ptr<int>, 10> m;
+      auto value = std::unique_ptr<int>(new int(1));
+      REQUIRE(m.try_emplace(1, std::move(value)).second);
+      REQUIRE(value == nullptr);
+      value.reset(new int(2));
+      REQUIRE(!m.try_emplace(1, std::move(value)).second);
+      REQUIRE(value != nullptr); //not moved from
+      REQUIRE(*m.at(1) == 1);
+      REQUIRE(!m.insert_or_assign(1, std::move(value)).second);
+      REQUIRE(*m.at(1) == 2);
+      REQUIRE(m.insert_or_assign(2, std::unique_ptr<int>(new int(3))).second);
+      REQUIRE(*m.at(2) == 3);
+   }
+
+   SECTION("iteration + erase by iterator")
+   {
+      sstl::unordered_map<int, int, 100> m;
+      for(int i=0; i<100; ++i)
+      {
+         m.emplace(i, i);
+      }
+      REQUIRE(m.full());
+      REQUIRE(std::distance(m.begin(), m.end()) == 100);
+      REQUIRE(std::distance(m.cbegin(), m.cend()) == 100);
+      for(auto it = m.begin(); it != m.end();)
+      {
+         it = it->first % 2 == 0 ? m.erase(it) : std::next(it);
+      }
+      REQUIRE(m.size() == 50);
+      for(const auto& value : m)
+      {
+         REQUIRE(value.first % 2 == 1);
+      }
+      m.erase(m.begin(), m.end());
+      REQUIRE(m.empty());
+   }
+
+   SECTION("capacity-agnostic base")
+   {
+      sstl::unordered_map<int, int, 5> small{ { 1, 1 }, { 2, 2 } };
+      sstl::unordered_map<int, int, 500> large{ { 1, 10 }, { 2, 20 }, { 3, 30 } };
+      REQUIRE(sum_of_values(small) == 3);
+      REQUIRE(sum_of_values(large) == 60);
+   }
+
+   SECTION("copy and move")
+   {
+      unordered_map_counted_type_t m;
+      for(int i=0; i<5; ++i)
+      {
+         m.emplace(i, i);
+      }
+
+      SECTION("same capacity")
+      {
+         counted_type::reset_counts();
+         auto copy = m;
+         REQUIRE(counted_type::check().copy_constructions(5));
+         REQUIRE(copy == m);
+
+         counted_type::reset_counts();
+         auto moved = std::move(copy);
+         REQUIRE(counted_type::check().move_constructions(5).destructions(5));
+         REQUIRE(copy.empty());
+         REQUIRE(moved == m);
+      }
+
+      SECTION("different capacity")
+      {
+         counted_type::reset_counts();
+         sstl::unordered_map<int, counted_type, 100> copy(m);
+         REQUIRE(counted_type::check().copy_constructions(5));
+         REQUIRE(copy == m);
+         REQUIRE(copy.bucket_count() != m.bucket_count());
+
+         m.clear();
+         m = std::move(copy);
+         REQUIRE(copy.empty());
+         REQUIRE(m.size() == 5);
+         for(int i=0; i<5; ++i)
+         {
+            REQUIRE(m.at(i).member == static_cast<size_t>(i));
+         }
+      }
+
+      SECTION("swap")
+      {
+         unordered_map_counted_type_t other;
+         other.emplace(100, 100);
+         swap(m, other);
+         REQUIRE(m.size() == 1);
+         REQUIRE(other.size() == 5);
+         REQUIRE(m.at(100).member == 100);
+      }
+   }
+
+   SECTION("values are destroyed")
+   {
+      counted_type::reset_counts();
+      {
+         unordered_map_counted_type_t m;
+         for(int i=0; i<10; ++i)
+         {
+            m.try_emplace(i, i);
+         }
+         m.erase(3);
+         m.erase(m.find(4));
+      }
+      REQUIRE(counted_type::check().parameter_constructions(10).destructions(10));
+   }
+
+   SECTION("heterogeneous lookup")
+   {
+      sstl::unordered_map<std::string, int, 10, string_hash, string_equal> m;
+      m.emplace("one", 1);
+      m.emplace("two", 2);
+      REQUIRE(m.find("one")->second == 1);
+      REQUIRE(m.count("two") == 1);
+      REQUIRE(!m.contains("three"));
+      REQUIRE(m.equal_range("two").first->second == 2);
+      REQUIRE(std::distance(m.equal_range("three").first, m.equal_range("three").second) == 0);
+   }
+
+   SECTION("colliding hashes")
+   {
+      sstl::unordered_map<int, int, 40, constant_hash> m;
+      for(int i=0; i<40; ++i)
+      {
+         m.emplace(i, i);
+      }
+      for(int i=0; i<40; i+=3)
+      {
+         m.erase(i);
+      }
+      for(int i=0; i<40; ++i)
+      {
+         REQUIRE(m.contains(i) == (i % 3 != 0));
+      }
+   }
+
+   SECTION("random operations against std::unordered_map")
+   {
+      //a full table with a high turnover: the tombstones are dropped over and over again
+      sstl::unordered_map<int, int, 200> m;
+      auto reference = std::unordered_map<int, int>{};
+      unsigned seed = 5;
+      auto next = [&seed]() { seed = seed * 1103515245 + 12345; return static_cast<int>((seed >> 16) % 400); };
+      for(int i=0; i<100000; ++i)
+      {
+         auto key = next();
+         if(next() % 2 == 0 && !m.full())
+         {
+            REQUIRE(m.emplace(key, i).second == reference.emplace(key, i).second);
+         }
+         else
+         {
+            REQUIRE(m.erase(key) == reference.erase(key));
+         }
+         REQUIRE(m.size() == reference.size());
+         auto it = m.find(key);
+         auto reference_it = reference.find(key);
+         REQUIRE((it == m.end()) == (reference_it == reference.end()));
+         if(it != m.end())
+         {
+            REQUIRE(it->second == reference_it->second);
+         }
+      }
+      REQUIRE(static_cast<size_t>(std::distance(m.begin(), m.end())) == reference.size());
+      for(const auto& value : reference)
+      {
+         REQUIRE(m.at(value.first) == value.second);
+      }
+   }
+
+   #if _sstl_has_exceptions()
+   SECTION("copy construction throws")
+   {
+      unordered_map_counted_type_t m;
+      for(int i=0; i<5; ++i)
+      {
+         m.emplace(i, i);
+      }
+      counted_type::reset_counts();
+      counted_type::throw_at_nth_copy_construction(3);
+      REQUIRE_THROWS_AS(unordered_map_counted_type_t{m}, counted_type::copy_construction::exception);
+      REQUIRE(counted_type::check().copy_constructions(2).destructions(2));
+   }
+   #endif
+}
+}
@@ -0,0 +1,272 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <sstl/__internal/_except.h>
+#include <sstl/unordered_multimap.h>
+
+#include "counted_type.h"
+
+namespace sstl_test
+{
+using unordered_multimap_int_base_t = sstl::unordered_multimap<int, int>;
+using unordered_multimap_counted_type_t = sstl::unordered_multimap<int, counted_type, 10>;
+
+namespace
+{
+   //all the keys collide
+   struct constant_hash
+   {
+      size_t operator()(int) const
+      {
+         return 7;
+      }
+   };
+
+   template<class TRange>
+   std::vector<int> sorted_values(const TRange& range)
+   {
+      auto values = std::vector<int>{};
+      for(auto it = range.first; it != range.second; ++it)
+      {
+         values.push_back(it->second);
+      }
+      std::sort(values.begin(), values.end());
+      return values;
+   }
+
+   //true if the values with equivalent keys are adjacent in the iteration
+   template<class TMap>
+   bool are_equal_keys_contiguous(const TMap& map)
+   {
+      auto completed_keys = std::set<int>{};
+      auto previous = map.begin();
+      for(auto it = map.begin(); it != map.end(); ++it)
+      {
+         if(it != map.begin() && previous->first != it->first)
+         {
+            if(!completed_keys.insert(previous->first).second)
+               return false;
+         }
+         previous = it;
+      }
+      return map.empty() || completed_keys.count(previous->first) == 0;
+   }
+
+   size_t count_values(const sstl::unordered_multimap<int, int>& map)
+   {
+      return static_cast<size_t>(std::distance(map.begin(), map.end()));
+   }
+}
+
+TEST_CASE("unordered_multimap")
+{
+   SECTION("user cannot directly construct the base class")
+   {
+      REQUIRE(!std::is_default_constructible<unordered_multimap_int_base_t>::value);
+      REQUIRE(!std::is_copy_constructible<unordered_multimap_int_base_t>::value);
+      REQUIRE(!std::is_move_constructible<unordered_multimap_int_base_t>::value);
+   }
+
+   SECTION("insert + count + equal_range")
+   {
+      sstl::unordered_multimap<int, int, 10> m;
+      REQUIRE(m.empty());
+      REQUIRE(m.capacity() == 10);
+      m.insert(std::make_pair(1, 10));
+      m.emplace(2, 20);
+      m.insert({ { 1, 11 }, { 3, 30 }, { 1, 12 } });
+      REQUIRE(m.size() == 5);
+      REQUIRE(m.count(1) == 3);
+      REQUIRE(m.count(2) == 1);
+      REQUIRE(m.count(4) == 0);
+      REQUIRE(m.contains(3));
+      REQUIRE(m.find(4) == m.end());
+      REQUIRE(m.find(1)->first == 1);
+      REQUIRE(sorted_values(m.equal_range(1)) == (std::vector<int>{ 10, 11, 12 }));
+      REQUIRE(sorted_values(m.equal_range(4)).empty());
+      REQUIRE(count_values(m) == 5);
+   }
+
+   SECTION("erase")
+   {
+      sstl::unordered_multimap<int, int, 20> m{ { 1, 1 }, { 2, 2 }, { 1, 1 }, { 3, 3 }, { 1, 1 }, { 2, 2 } };
+      REQUIRE(m.erase(1) == 3);
+      REQUIRE(m.erase(1) == 0);
+      REQUIRE(m.size() == 3);
+      auto it = m.erase(m.find(2));
+      REQUIRE(m.count(2) == 1);
+      REQUIRE((it == m.end() || it->first == 2 || it->first == 3));
+      auto range = m.equal_range(3);
+      m.erase(range.first, range.second);
+      REQUIRE(m.size() == 1);
+      m.erase(m.begin(), m.end());
+      REQUIRE(m.empty());
+   }
+
+   SECTION("erase while iterating")
+   {
+      sstl::unordered_multimap<int, int, 100> m;
+      for(int i=0; i<100; ++i)
+      {
+         m.emplace(i % 30, i);
+      }
+      REQUIRE(m.full());
+      for(auto it = m.begin(); it != m.end();)
+      {
+         it = it->second % 2 == 0 ? m.erase(it) : std::next(it);
+      }
+      REQUIRE(m.size() == 50);
+      for(const auto& value : m)
+      {
+         REQUIRE(value.second % 2 == 1);
+      }
+   }
+
+   SECTION("insert a value of the container")
+   {
+      sstl::unordered_multimap<int, int, 20> m;
+      for(int i=0; i<10; ++i)
+      {
+         m.emplace(i, i);
+      }
+      for(int i=0; i<5; ++i)
+      {
+         m.insert(*m.find(i));
+      }
+      for(int i=0; i<10; ++i)
+      {
+         REQUIRE(m.count(i) == (i < 5 ? 2u : 1u));
+         REQUIRE(sorted_values(m.equal_range(i)) == std::vector<int>(i < 5 ? 2 : 1, i));
+      }
+   }
+
+   SECTION("colliding hashes + long runs of equal keys")
+   {
+      sstl::unordered_multimap<int, int, 100, constant_hash> m;
+      for(int i=0; i<100; ++i)
+      {
+         m.emplace(i % 4, i);
+      }
+      REQUIRE(are_equal_keys_contiguous(m));
+      for(int key=0; key<4; ++key)
+      {
+         REQUIRE(m.count(key) == 25);
+      }
+      REQUIRE(m.erase(2) == 25);
+      REQUIRE(are_equal_keys_contiguous(m));
+      REQUIRE(m.count(1) == 25);
+      REQUIRE(m.count(3) == 25);
+   }
+
+   SECTION("copy and move")
+   {
+      unordered_multimap_counted_type_t m;
+      for(int i=0; i<6; ++i)
+      {
+         m.emplace(i % 2, i);
+      }
+
+      SECTION("same capacity")
+      {
+         counted_type::reset_counts();
+         auto copy = m;
+         REQUIRE(counted_type::check().copy_constructions(6));
+         REQUIRE(copy == m);
+
+         counted_type::reset_counts();
+         auto moved = std::move(copy);
+         REQUIRE(counted_type::check().move_constructions(6).destructions(6));
+         REQUIRE(copy.empty());
+         REQUIRE(moved == m);
+      }
+
+      SECTION("different capacity")
+      {
+         sstl::unordered_multimap<int, counted_type, 100> copy(m);
+         REQUIRE(copy == m);
+         REQUIRE(copy.bucket_count() != m.bucket_count());
+         copy.emplace(0, 0);
+         REQUIRE(copy != m);
+         m.clear();
+         m = std::move(copy);
+         REQUIRE(copy.empty());
+         REQUIRE(m.count(0) == 4);
+      }
+
+      SECTION("swap")
+      {
+         unordered_multimap_counted_type_t other;
+         other.emplace(7, 7);
+         swap(m, other);
+         REQUIRE(m.size() == 1);
+         REQUIRE(other.size() == 6);
+      }
+   }
+
+   SECTION("values are destroyed")
+   {
+      counted_type::reset_counts();
+      {
+         unordered_multimap_counted_type_t m;
+         for(int i=0; i<10; ++i)
+         {
+            m.emplace(i % 3, i);
+         }
+         m.erase(1);
+      }
+      REQUIRE(counted_type::construction::count > 10);
+      REQUIRE(counted_type::destruction::count == counted_type::construction::count);
+   }
+
+   SECTION("random operations against std::unordered_multimap")
+   {
+      sstl::unordered_multimap<int, int, 300> m;
+      auto reference = std::unordered_multimap<int, int>{};
+      unsigned seed = 11;
+      auto next = [&seed]() { seed = seed * 1103515245 + 12345; return static_cast<int>((seed >> 16) % 100); };
+      for(int i=0; i<30000; ++i)
+      {
+         auto key = next();
+         auto operation = next() % 4;
+         if(operation <= 1 && !m.full())
+         {
+            m.emplace(key, i);
+            reference.emplace(key, i);
+         }
+         else if(operation == 2)
+         {
+            REQUIRE(m.erase(key) == reference.erase(key));
+         }
+         else if(m.contains(key))
+         {
+            //erases the same value from both
+            auto it = m.find(key);
+            auto range = reference.equal_range(key);
+            reference.erase(std::find(range.first, range.second, *it));
+            m.erase(it);
+         }
+         REQUIRE(m.size() == reference.size());
+         REQUIRE(m.count(key) == reference.count(key));
+         if(i % 100 == 0)
+         {
+            REQUIRE(are_equal_keys_contiguous(m));
+            for(int k=0; k<100; ++k)
+            {
+               REQUIRE(sorted_values(m.equal_range(k)) == sorted_values(reference.equal_range(k)));
+            }
+         }
+      }
+   }
+}
+}
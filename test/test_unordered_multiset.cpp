@@ -0,0 +1,95 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <cstdint>
+#include <vector>
+#include <unordered_set>
+#include <iterator>
+#include <type_traits>
+#include <sstl/unordered_multiset.h>
+
+namespace sstl_test
+{
+TEST_CASE("unordered_multiset")
+{
+   SECTION("iterators are constant")
+   {
+      using iterator = sstl::unordered_multiset<int, 10>::iterator;
+      REQUIRE(std::is_const<std::remove_reference<decltype(*std::declval<iterator>())>::type>::value);
+   }
+
+   SECTION("insert + count + erase")
+   {
+      sstl::unordered_multiset<int, 10> s{ 3, 1, 4, 1, 5, 9, 2, 6, 5, 3 };
+      REQUIRE(s.full());
+      REQUIRE(s.count(1) == 2);
+      REQUIRE(s.count(5) == 2);
+      REQUIRE(s.count(7) == 0);
+      auto range = s.equal_range(3);
+      REQUIRE(std::distance(range.first, range.second) == 2);
+      REQUIRE(*range.first == 3);
+      REQUIRE(s.erase(5) == 2);
+      REQUIRE(s.size() == 8);
+      REQUIRE(*s.insert(7) == 7);
+   }
+
+   SECTION("range constructor + equality")
+   {
+      auto values = std::vector<int>{ 1, 2, 2, 3, 3, 3 };
+      sstl::unordered_multiset<int, 6> s(values.cbegin(), values.cend());
+      sstl::unordered_multiset<int, 60> t{ 3, 2, 3, 1, 3, 2 };
+      REQUIRE(s == t);
+      t.erase(t.find(3));
+      REQUIRE(s != t);
+      t.insert(2);
+      REQUIRE(s != t);
+   }
+
+   SECTION("a full table of the minimum size")
+   {
+      sstl::unordered_multiset<uint64_t, 7> s;
+      REQUIRE(s.bucket_count() == 8);
+      for(uint64_t i=0; i<1000; ++i)
+      {
+         while(!s.full())
+         {
+            s.insert(i % 3);
+         }
+         REQUIRE(s.count(i % 3) >= 1);
+         s.erase(s.begin());
+      }
+      REQUIRE(s.size() == 6);
+   }
+
+   SECTION("random operations against std::unordered_multiset")
+   {
+      sstl::unordered_multiset<uint64_t, 1000> s;
+      auto reference = std::unordered_multiset<uint64_t>{};
+      uint64_t seed = 88172645463325252ull;
+      auto next = [&seed]() { seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17; return seed; };
+      for(int i=0; i<100000; ++i)
+      {
+         //keys that differ in the high bits only
+         auto key = (next() % 700) << 40;
+         if(next() % 2 == 0 && !s.full())
+         {
+            s.insert(key);
+            reference.insert(key);
+         }
+         else if(s.contains(key))
+         {
+            s.erase(s.find(key));
+            reference.erase(reference.find(key));
+         }
+         REQUIRE(s.size() == reference.size());
+         REQUIRE(s.count(key) == reference.count(key));
+      }
+      REQUIRE(static_cast<size_t>(std::distance(s.begin(), s.end())) == reference.size());
+   }
+}
+}
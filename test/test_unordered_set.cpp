@@ -0,0 +1,121 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <cstdint>
+#include <vector>
+#include <unordered_set>
+#include <type_traits>
+#include <sstl/unordered_set.h>
+
+namespace sstl_test
+{
+using unordered_set_int_base_t = sstl::unordered_set<int>;
+
+namespace
+{
+   size_t count_values(const sstl::unordered_set<int>& set)
+   {
+      return static_cast<size_t>(std::distance(set.begin(), set.end()));
+   }
+}
+
+TEST_CASE("unordered_set")
+{
+   SECTION("user cannot directly construct the base class")
+   {
+      REQUIRE(!std::is_default_constructible<unordered_set_int_base_t>::value);
+      REQUIRE(!std::is_copy_constructible<unordered_set_int_base_t>::value);
+   }
+
+   SECTION("iterators are constant")
+   {
+      using iterator = sstl::unordered_set<int, 10>::iterator;
+      REQUIRE(std::is_const<std::remove_reference<decltype(*std::declval<iterator>())>::type>::value);
+   }
+
+   SECTION("insert + find + erase")
+   {
+      sstl::unordered_set<int, 10> s{ 3, 1, 4, 1, 5 };
+      REQUIRE(s.size() == 4);
+      REQUIRE(s.insert(9).second);
+      REQUIRE(!s.insert(9).second);
+      REQUIRE(*s.find(4) == 4);
+      REQUIRE(s.find(2) == s.end());
+      REQUIRE(s.erase(1) == 1);
+      REQUIRE(!s.contains(1));
+      REQUIRE(count_values(s) == 4);
+   }
+
+   SECTION("range constructor + equality")
+   {
+      auto values = std::vector<int>{ 5, 4, 3, 2, 1 };
+      sstl::unordered_set<int, 5> s(values.cbegin(), values.cend());
+      sstl::unordered_set<int, 50> t{ 1, 2, 3, 4, 5 };
+      REQUIRE(s.full());
+      REQUIRE(s == t);
+      t.erase(5);
+      REQUIRE(s != t);
+   }
+
+   SECTION("copy + move between capacities")
+   {
+      sstl::unordered_set<int, 100> large;
+      for(int i=0; i<20; ++i)
+      {
+         large.insert(i * 1000);
+      }
+      sstl::unordered_set<int, 20> small(large);
+      REQUIRE(small == large);
+      sstl::unordered_set<int, 30> moved(std::move(small));
+      REQUIRE(small.empty());
+      REQUIRE(moved == large);
+      small = moved;
+      REQUIRE(small == large);
+   }
+
+   SECTION("a table of the minimum size")
+   {
+      sstl::unordered_set<uint64_t, 1> s;
+      for(uint64_t i=0; i<1000; ++i)
+      {
+         s.insert(i);
+         REQUIRE(s.contains(i));
+         REQUIRE(s.size() == 1);
+         s.erase(s.begin());
+      }
+      REQUIRE(s.empty());
+   }
+
+   SECTION("random operations against std::unordered_set")
+   {
+      sstl::unordered_set<uint64_t, 1000> s;
+      auto reference = std::unordered_set<uint64_t>{};
+      uint64_t seed = 88172645463325252ull;
+      auto next = [&seed]() { seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17; return seed; };
+      for(int i=0; i<100000; ++i)
+      {
+         //keys that differ in the high bits only
+         auto key = (next() % 1500) << 40;
+         if(next() % 2 == 0 && !s.full())
+         {
+            REQUIRE(s.insert(key).second == reference.insert(key).second);
+         }
+         else
+         {
+            REQUIRE(s.erase(key) == reference.erase(key));
+         }
+         REQUIRE(s.size() == reference.size());
+         REQUIRE(s.contains(key) == (reference.count(key) == 1));
+      }
+      for(auto key : s)
+      {
+         REQUIRE(reference.count(key) == 1);
+      }
+   }
+}
+}
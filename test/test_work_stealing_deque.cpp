@@ -0,0 +1,130 @@
+/*
+Copyright © 2015 Kean Mariotti <kean.mariotti@gmail.com>
+This work is free. You can redistribute it and/or modify it under the
+terms of the Do What The Fuck You Want To Public License, Version 2,
+as published by Sam Hocevar. See http://www.wtfpl.net/ for more details.
+*/
+
+#include <catch.hpp>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <sstl/work_stealing_deque.h>
+
+namespace sstl_test
+{
+TEST_CASE("work_stealing_deque")
+{
+   SECTION("push + pop (LIFO)")
+   {
+      sstl::work_stealing_deque<int, 4> d;
+      REQUIRE(d.empty());
+      REQUIRE(d.capacity() == 4);
+      for(int i=0; i<4; ++i)
+      {
+         REQUIRE(d.push(i));
+      }
+      REQUIRE(!d.push(4));
+      REQUIRE(d.size() == 4);
+      int value;
+      for(int i=3; i>=0; --i)
+      {
+         REQUIRE(d.pop(value));
+         REQUIRE(value == i);
+      }
+      REQUIRE(!d.pop(value));
+      REQUIRE(d.empty());
+   }
+
+   SECTION("push + steal (FIFO)")
+   {
+      sstl::work_stealing_deque<int, 4> d;
+      int value;
+      REQUIRE(!d.steal(value));
+      for(int lap=0; lap<3; ++lap)
+      {
+         for(int i=0; i<4; ++i)
+         {
+            REQUIRE(d.push(lap*4+i));
+         }
+         for(int i=0; i<3; ++i)
+         {
+            REQUIRE(d.steal(value));
+            REQUIRE(value == lap*4+i);
+         }
+         REQUIRE(d.pop(value));
+         REQUIRE(value == lap*4+3);
+         REQUIRE(d.empty());
+      }
+   }
+
+   SECTION("owner thread + thief threads (stress test)")
+   {
+      //every pushed value is obtained exactly once, either by the owner or by a thief
+      static const int number_of_values = 100000;
+      static const int number_of_thieves = 3;
+      sstl::work_stealing_deque<int, 256> d;
+      std::atomic<int> obtained_values{ 0 };
+      std::vector<std::vector<int>> obtained(number_of_thieves+1);
+      std::vector<std::thread> thieves;
+
+      for(int thief=0; thief<number_of_thieves; ++thief)
+      {
+         thieves.emplace_back([&d, &obtained_values, &obtained, thief]()
+         {
+            int value;
+            while(obtained_values.load() < number_of_values)
+            {
+               if(d.steal(value))
+               {
+                  obtained[thief].push_back(value);
+                  ++obtained_values;
+               }
+               else
+               {
+                  std::this_thread::yield();
+               }
+            }
+         });
+      }
+
+      int value;
+      for(int i=0; i<number_of_values; ++i)
+      {
+         while(!d.push(i))
+         {
+            if(d.pop(value))
+            {
+               obtained[number_of_thieves].push_back(value);
+               ++obtained_values;
+            }
+         }
+         if(i % 3 == 0 && d.pop(value))
+         {
+            obtained[number_of_thieves].push_back(value);
+            ++obtained_values;
+         }
+      }
+      while(d.pop(value))
+      {
+         obtained[number_of_thieves].push_back(value);
+         ++obtained_values;
+      }
+      for(auto& thief : thieves)
+      {
+         thief.join();
+      }
+
+      auto occurrences = std::vector<unsigned>(number_of_values, 0);
+      for(auto& values : obtained)
+      {
+         for(auto v : values)
+         {
+            ++occurrences[v];
+         }
+      }
+      REQUIRE(std::all_of(occurrences.cbegin(), occurrences.cend(), [](unsigned count){ return count == 1; }));
+   }
+}
+}